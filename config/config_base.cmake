@@ -93,12 +93,16 @@ set(CONFIG_TFM_HALT_ON_CORE_PANIC       OFF         CACHE BOOL       "On fatal e
 set(CONFIG_TFM_BACKTRACE_ON_CORE_PANIC  OFF         CACHE BOOL       "On fatal errors in secure firmware, log backtrace and then halt")
 
 set(CONFIG_TFM_STACK_WATERMARKS         OFF         CACHE BOOL      "Whether to pre-fill partition stacks with a set value to help determine stack usage")
+set(CONFIG_TFM_SPM_TRACE                OFF         CACHE BOOL      "Whether to record SPM events and service latency histograms, readable via the Platform service")
+set(CONFIG_TFM_SPM_LOG_DEFERRED         OFF         CACHE BOOL      "Whether SPM and partition logs are stored as binary records and output from the idle partition")
 
 set(CONFIG_TFM_BRANCH_PROTECTION_FEAT   BRANCH_PROTECTION_DISABLED   CACHE STRING    "Set default branch protection usage to disabled")
 
 ############################ Platform ##########################################
 
 set(NUM_MAILBOX_QUEUE_SLOT              1           CACHE BOOL      "Number of mailbox queue slots")
+set(TFM_MAILBOX_RING_TRANSPORT          OFF         CACHE BOOL      "Use single-producer single-consumer rings instead of mailbox queue slots")
+set(MAILBOX_RING_SIZE                   16          CACHE STRING    "Number of entries in each mailbox ring, a power of 2")
 set(TFM_PLAT_SPECIFIC_MULTI_CORE_COMM   OFF         CACHE BOOL      "Whether to use a platform specific inter-core communication instead of mailbox in dual-cpu topology")
 
 set(DEBUG_AUTHENTICATION                CHIP_DEFAULT CACHE STRING   "Debug authentication setting. [CHIP_DEFAULT, NONE, NS_ONLY, FULL")
@@ -51,6 +51,44 @@
 #define CRYPTO_CONC_OPER_NUM                   8
 #endif
 
+/* The max number of concurrent operations a single client can hold, 0 for no limit */
+#ifndef CRYPTO_CONC_OPER_PER_OWNER
+#define CRYPTO_CONC_OPER_PER_OWNER             0
+#endif
+
+/*
+ * The number of contexts dedicated to each type of operation, sized for that
+ * type only. Types with 0 dedicated contexts use the CRYPTO_CONC_OPER_NUM
+ * contexts shared by all types.
+ */
+#ifndef CRYPTO_CONC_OPER_NUM_CIPHER
+#define CRYPTO_CONC_OPER_NUM_CIPHER            0
+#endif
+
+#ifndef CRYPTO_CONC_OPER_NUM_MAC
+#define CRYPTO_CONC_OPER_NUM_MAC               0
+#endif
+
+#ifndef CRYPTO_CONC_OPER_NUM_HASH
+#define CRYPTO_CONC_OPER_NUM_HASH              0
+#endif
+
+#ifndef CRYPTO_CONC_OPER_NUM_KEY_DERIVATION
+#define CRYPTO_CONC_OPER_NUM_KEY_DERIVATION    0
+#endif
+
+#ifndef CRYPTO_CONC_OPER_NUM_AEAD
+#define CRYPTO_CONC_OPER_NUM_AEAD              0
+#endif
+
+/*
+ * The number of keys derived from builtin keys for their users that are kept
+ * by the builtin key loader, to avoid deriving them again. 0 to disable.
+ */
+#ifndef CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM
+#define CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM   0
+#endif
+
 /* Enable PSA Crypto random number generator module */
 #ifndef CRYPTO_RNG_MODULE_ENABLED
 #define CRYPTO_RNG_MODULE_ENABLED              1
@@ -141,6 +179,16 @@
 #define FWU_STACK_SIZE                         0x600
 #endif
 
+/* Skip the erase of the staging area sectors which are already blank */
+#ifndef FWU_SKIP_BLANK_SECTOR_ERASE
+#define FWU_SKIP_BLANK_SECTOR_ERASE            0
+#endif
+
+/* Number of staging area sectors erased ahead of the written blocks */
+#ifndef FWU_ERASE_AHEAD_SECTORS
+#define FWU_ERASE_AHEAD_SECTORS                1
+#endif
+
 /* Attest Partition Configs */
 
 /* Include optional claims in initial attestation token */
@@ -153,6 +201,14 @@
 #define ATTEST_INCLUDE_COSE_KEY_ID             0
 #endif
 
+/*
+ * Size of the buffer holding the claims that don't change until the next boot,
+ * encoded once at init instead of in each token. 0 to encode them each time.
+ */
+#ifndef ATTEST_STATIC_CLAIMS_BUF_SIZE
+#define ATTEST_STATIC_CLAIMS_BUF_SIZE          0
+#endif
+
 /* The stack size of the Initial Attestation Secure Partition */
 #ifndef ATTEST_STACK_SIZE
 #define ATTEST_STACK_SIZE                      0x800
@@ -200,6 +256,36 @@
 #define ITS_NUM_ASSETS                         10
 #endif
 
+/* Keep an index of the stored files in RAM for the Internal Trusted Storage */
+#ifndef ITS_RAM_INDEX
+#define ITS_RAM_INDEX                          0
+#endif
+
+/* Number of slots in the Internal Trusted Storage RAM file index (power of two) */
+#ifndef ITS_RAM_INDEX_SIZE
+#define ITS_RAM_INDEX_SIZE                     32
+#endif
+
+/* Maximum number of logical data blocks tracked by the Internal Trusted Storage RAM file index */
+#ifndef ITS_RAM_INDEX_MAX_DBLOCKS
+#define ITS_RAM_INDEX_MAX_DBLOCKS              8
+#endif
+
+/* Stage file operations in batches applied with a single metadata block update */
+#ifndef ITS_BATCH_COMMIT
+#define ITS_BATCH_COMMIT                       0
+#endif
+
+/* Maximum number of file operations in an Internal Trusted Storage batch */
+#ifndef ITS_BATCH_MAX_OPS
+#define ITS_BATCH_MAX_OPS                      8
+#endif
+
+/* Program data appended to Internal Trusted Storage files in place */
+#ifndef ITS_APPEND_IN_PLACE
+#define ITS_APPEND_IN_PLACE                    0
+#endif
+
 /* The stack size of the Internal Trusted Storage Secure Partition */
 #ifndef ITS_STACK_SIZE
 #define ITS_STACK_SIZE                         0x720
@@ -220,6 +306,11 @@
 #define TFM_ITS_ENC_NONCE_LENGTH               12
 #endif
 
+/* The size of the chunks encrypted separately when ITS file encryption is enabled, 0 to encrypt whole files */
+#ifndef ITS_ENCRYPTION_CHUNK_SIZE
+#define ITS_ENCRYPTION_CHUNK_SIZE              0
+#endif
+
 /* PS Partition Configs */
 
 /* Create flash FS if it doesn't exist for Protected Storage partition */
@@ -252,6 +343,21 @@
 #define PS_NUM_ASSETS                          10
 #endif
 
+/* Save object table updates in journal records instead of the whole table */
+#ifndef PS_OBJ_TABLE_JOURNAL
+#define PS_OBJ_TABLE_JOURNAL                   0
+#endif
+
+/* The number of journal records before the object table is saved again */
+#ifndef PS_OBJ_TABLE_JOURNAL_SIZE
+#define PS_OBJ_TABLE_JOURNAL_SIZE              8
+#endif
+
+/* The size of the independently encrypted segments of the PS objects */
+#ifndef PS_OBJECT_SEGMENT_SIZE
+#define PS_OBJECT_SEGMENT_SIZE                 0
+#endif
+
 /* The stack size of the Protected Storage Secure Partition */
 #ifndef PS_STACK_SIZE
 #define PS_STACK_SIZE                          0x700
@@ -302,6 +408,21 @@
 #endif
 #endif
 
+/* The maximal number of threads scheduled by SPM in the IPC backend, one per partition */
+#ifndef CONFIG_TFM_SPM_MAX_THREADS
+#define CONFIG_TFM_SPM_MAX_THREADS              32
+#endif
+
+/* The number of events kept in the SPM trace ring buffer, a power of two */
+#ifndef CONFIG_TFM_SPM_TRACE_EVENT_NUM
+#define CONFIG_TFM_SPM_TRACE_EVENT_NUM          64
+#endif
+
+/* The size in bytes of the deferred log buffer, a power of two */
+#ifndef CONFIG_TFM_SPM_LOG_DEFERRED_BUF_SIZE
+#define CONFIG_TFM_SPM_LOG_DEFERRED_BUF_SIZE    1024
+#endif
+
 /* Disable the doorbell APIs */
 #ifndef CONFIG_TFM_DOORBELL_API
 #define CONFIG_TFM_DOORBELL_API                 0
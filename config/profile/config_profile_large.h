@@ -153,6 +153,11 @@
 #define ATTEST_INCLUDE_COSE_KEY_ID             0
 #endif
 
+/* Size of the buffer holding the claims encoded once at init */
+#ifndef ATTEST_STATIC_CLAIMS_BUF_SIZE
+#define ATTEST_STATIC_CLAIMS_BUF_SIZE          0x200
+#endif
+
 /* The stack size of the Initial Attestation Secure Partition */
 #ifndef ATTEST_STACK_SIZE
 #define ATTEST_STACK_SIZE                      0x800
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Ring buffer transport of the mailbox, shared by NSPE and SPE.
+ *
+ * NSPE posts requests into a request ring and SPE posts results into a
+ * completion ring. Each ring has a single producer and a single consumer.
+ * The producer only writes the head index and the entries, the consumer only
+ * writes the tail index. So no lock between the cores is needed.
+ */
+
+#ifndef __TFM_MAILBOX_RING_H__
+#define __TFM_MAILBOX_RING_H__
+
+#include <stdint.h>
+
+#include "tfm_mailbox.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (MAILBOX_RING_SIZE < 2) || ((MAILBOX_RING_SIZE & (MAILBOX_RING_SIZE - 1)) != 0)
+#error "Error: Invalid MAILBOX_RING_SIZE. The value should be a power of 2"
+#endif
+
+#define MAILBOX_RING_MASK           (MAILBOX_RING_SIZE - 1)
+
+/*
+ * The including side provides the cache maintenance of the shared memory,
+ * as MAILBOX_CLEAN_CACHE() and MAILBOX_INVALIDATE_CACHE().
+ */
+#if !defined(MAILBOX_CLEAN_CACHE) || !defined(MAILBOX_INVALIDATE_CACHE)
+#error "Error: Define the mailbox cache maintenance before the ring transport"
+#endif
+
+/* Orders the accesses to the entries against the accesses to the indices */
+#ifndef MAILBOX_RING_BARRIER
+#define MAILBOX_RING_BARRIER()      __DMB()
+#endif
+
+/*
+ * A ring index. Indices are free running and wrap at UINT32_MAX. Each index is
+ * written by one core only, so each one sits alone in its cache line.
+ */
+struct mailbox_ring_idx_t {
+    volatile uint32_t val;
+} MAILBOX_ALIGN;
+
+/* Entry of the request ring */
+struct mailbox_ring_req_t {
+    struct mailbox_msg_t msg;
+    uint32_t             token;     /* Identifies the request in NSPE. SPE
+                                     * returns it in the completion.
+                                     */
+};
+
+/* Entry of the completion ring */
+struct mailbox_ring_cpl_t {
+    uint32_t             token;     /* Token of the completed request */
+    int32_t              return_val;
+};
+
+/*
+ * Rings in shared memory, allocated by NSPE. NSPE limits the requests posted
+ * and not completed yet to MAILBOX_RING_SIZE, so that the completion ring
+ * never overflows.
+ */
+struct mailbox_ring_shared_t {
+    struct mailbox_ring_idx_t req_head;    /* Written by NSPE */
+    struct mailbox_ring_idx_t req_tail;    /* Written by SPE  */
+    struct mailbox_ring_idx_t cpl_head;    /* Written by SPE  */
+    struct mailbox_ring_idx_t cpl_tail;    /* Written by NSPE */
+
+    struct mailbox_ring_req_t req[MAILBOX_RING_SIZE] MAILBOX_ALIGN;
+    struct mailbox_ring_cpl_t cpl[MAILBOX_RING_SIZE] MAILBOX_ALIGN;
+} MAILBOX_ALIGN;
+
+/*
+ * One side of a ring, in the private memory of that side. The local position
+ * runs ahead of the shared index until the entries are committed.
+ */
+struct mailbox_ring_end_t {
+    struct mailbox_ring_idx_t *own;         /* Index written by this side */
+    struct mailbox_ring_idx_t *peer;        /* Index written by the peer  */
+    uint32_t                  pos;          /* Local copy of own index    */
+};
+
+static inline uint32_t mailbox_ring_load_idx(struct mailbox_ring_idx_t *idx)
+{
+    MAILBOX_INVALIDATE_CACHE(idx, sizeof(*idx));
+    return idx->val;
+}
+
+static inline void mailbox_ring_init_end(struct mailbox_ring_end_t *end,
+                                         struct mailbox_ring_idx_t *own,
+                                         struct mailbox_ring_idx_t *peer)
+{
+    end->own = own;
+    end->peer = peer;
+    end->pos = mailbox_ring_load_idx(own);
+}
+
+/**
+ * \brief Get the number of entries a producer can write.
+ *
+ * \param[in] end               The producer side of the ring.
+ *
+ * \return The number of free entries.
+ */
+static inline uint32_t mailbox_ring_space(struct mailbox_ring_end_t *end)
+{
+    return MAILBOX_RING_SIZE - (end->pos - mailbox_ring_load_idx(end->peer));
+}
+
+/**
+ * \brief Get the number of entries a consumer can read. The entries are
+ *        visible to the caller once this returns.
+ *
+ * \param[in] end               The consumer side of the ring.
+ *
+ * \return The number of entries to read.
+ */
+static inline uint32_t mailbox_ring_avail(struct mailbox_ring_end_t *end)
+{
+    uint32_t avail = mailbox_ring_load_idx(end->peer) - end->pos;
+
+    /* Do not read the entries before the index */
+    MAILBOX_RING_BARRIER();
+
+    return avail;
+}
+
+/**
+ * \brief Publish the local position to the peer. A producer calls it after it
+ *        wrote and cleaned the new entries, a consumer after it read them.
+ *
+ * \param[in] end               One side of the ring.
+ */
+static inline void mailbox_ring_commit(struct mailbox_ring_end_t *end)
+{
+    /* The entries must be written, or read, before the index moves */
+    MAILBOX_RING_BARRIER();
+
+    end->own->val = end->pos;
+    MAILBOX_CLEAN_CACHE(end->own, sizeof(*end->own));
+}
+
+static inline struct mailbox_ring_req_t *mailbox_ring_req_entry(
+                                        struct mailbox_ring_shared_t *rings,
+                                        uint32_t pos)
+{
+    return &rings->req[pos & MAILBOX_RING_MASK];
+}
+
+static inline struct mailbox_ring_cpl_t *mailbox_ring_cpl_entry(
+                                        struct mailbox_ring_shared_t *rings,
+                                        uint32_t pos)
+{
+    return &rings->cpl[pos & MAILBOX_RING_MASK];
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_MAILBOX_RING_H__ */
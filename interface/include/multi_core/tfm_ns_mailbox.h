@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  * Copyright (c) 2024 Cypress Semiconductor Corporation (an Infineon company)
  * or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
  *
@@ -196,6 +196,75 @@ uint32_t tfm_ns_mailbox_hal_enter_critical_isr(void);
  */
 void tfm_ns_mailbox_hal_exit_critical_isr(uint32_t state);
 
+#ifdef TFM_MAILBOX_RING_TRANSPORT
+struct mailbox_ring_shared_t;
+struct mailbox_ring_cpl_t;
+
+/**
+ * \brief NSPE initialization of the mailbox ring transport
+ *
+ * \param[in] rings             The base address of the rings in memory shared
+ *                              with SPE.
+ *
+ * \retval MAILBOX_SUCCESS      Operation succeeded.
+ * \retval Other return code    Operation failed with an error code.
+ */
+int32_t tfm_ns_mailbox_ring_init(struct mailbox_ring_shared_t *rings);
+
+/**
+ * \brief Write a PSA client call into the request ring. It is not visible to
+ *        SPE until \ref tfm_ns_mailbox_ring_submit() is called, so that
+ *        several requests can be submitted at once.
+ *
+ * \note The ring has a single producer. Callers serialize the calls to this
+ *       function and to \ref tfm_ns_mailbox_ring_submit().
+ *
+ * \param[in] call_type         PSA client call type
+ * \param[in] params            Parameters used for PSA client call
+ * \param[in] client_id         Optional client ID of non-secure caller.
+ * \param[in] token             Identifies the request in its completion.
+ *
+ * \retval MAILBOX_SUCCESS      The request is written.
+ * \retval MAILBOX_QUEUE_FULL   MAILBOX_RING_SIZE requests are not completed
+ *                              yet.
+ * \retval Other return code    Operation failed with an error code.
+ */
+int32_t tfm_ns_mailbox_ring_post(uint32_t call_type,
+                                 const struct psa_client_params_t *params,
+                                 int32_t client_id,
+                                 uint32_t token);
+
+/**
+ * \brief Make the requests written by \ref tfm_ns_mailbox_ring_post()
+ *        visible to SPE and notify SPE once.
+ */
+void tfm_ns_mailbox_ring_submit(void);
+
+/**
+ * \brief Read the completions of the requests from the completion ring.
+ *
+ * \note The ring has a single consumer. Callers serialize the calls.
+ *
+ * \param[out] cpl              Buffer written with the completions.
+ * \param[in] max               Number of completions the buffer can hold.
+ *
+ * \return The number of completions read.
+ */
+uint32_t tfm_ns_mailbox_ring_reap(struct mailbox_ring_cpl_t *cpl, uint32_t max);
+
+/**
+ * \brief Platform specific initialization of the NSPE side of the mailbox
+ *        ring transport. It passes the address of the rings to SPE.
+ *        Invoked by \ref tfm_ns_mailbox_ring_init().
+ *
+ * \param[in] rings             The base address of the rings.
+ *
+ * \retval MAILBOX_SUCCESS      Operation succeeded.
+ * \retval Other return code    Operation failed with an error code.
+ */
+int32_t tfm_ns_mailbox_hal_ring_init(struct mailbox_ring_shared_t *rings);
+#endif /* TFM_MAILBOX_RING_TRANSPORT */
+
 #ifdef TFM_MULTI_CORE_NS_OS
 /**
  * \brief Initialize the multi-core lock for synchronizing PSA client call(s)
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -12,6 +12,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "psa/client.h"
+#include "tfm_spm_trace_defs.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -27,6 +28,7 @@ extern "C" {
 #define TFM_PLATFORM_API_ID_NV_INCREMENT  (1011)
 #define TFM_PLATFORM_API_ID_SYSTEM_RESET  (1012)
 #define TFM_PLATFORM_API_ID_IOCTL         (1013)
+#define TFM_PLATFORM_API_ID_SPM_TRACE     (1014)
 
 /*!
  * \enum tfm_platform_err_t
@@ -93,6 +95,28 @@ enum tfm_platform_err_t
 tfm_platform_nv_counter_read(uint32_t counter_id,
                              uint32_t size, uint8_t *val);
 
+/*!
+ * \brief Reads the SPM trace data, when the secure image is built with
+ *        CONFIG_TFM_SPM_TRACE. Only secure clients may read it.
+ *
+ * \param[in]     type    TFM_SPM_TRACE_TYPE_EVENTS to read the recorded
+ *                        events as \ref tfm_spm_trace_event_t, or
+ *                        TFM_SPM_TRACE_TYPE_HISTOGRAMS to read the service
+ *                        latency histograms as \ref tfm_spm_trace_hist_t.
+ * \param[in]     start   Sequence number of the first event to read, or
+ *                        index of the first histogram to read. Reading
+ *                        events from the sequence number following the
+ *                        last one read returns only the new events.
+ * \param[out]    buf     Buffer to store the records.
+ * \param[in,out] len     Size of the buffer in bytes. Updated with the
+ *                        number of bytes written, whole records only.
+ *
+ * \return Returns values as specified by the \ref tfm_platform_err_t
+ */
+enum tfm_platform_err_t
+tfm_platform_spm_trace_read(uint32_t type, uint32_t start,
+                            void *buf, size_t *len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_SPM_TRACE_DEFS_H__
+#define __TFM_SPM_TRACE_DEFS_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Types of SPM trace data that can be read */
+#define TFM_SPM_TRACE_TYPE_EVENTS       (1U)
+#define TFM_SPM_TRACE_TYPE_HISTOGRAMS   (2U)
+
+/* SPM trace events */
+#define TFM_SPM_TRACE_EV_CALL           (1U) /* arg: SID of the service       */
+#define TFM_SPM_TRACE_EV_REPLY          (2U) /* arg: status of the reply      */
+#define TFM_SPM_TRACE_EV_SCHEDULE       (3U) /* arg: ID of the next partition */
+#define TFM_SPM_TRACE_EV_IOVEC_CHECK    (4U) /* arg: cycles spent on checks   */
+#define TFM_SPM_TRACE_EV_IRQ_ENTER      (5U) /* arg: interrupt source         */
+#define TFM_SPM_TRACE_EV_IRQ_EXIT       (6U) /* arg: FLIH result              */
+
+/*
+ * Number of buckets of a service latency histogram. Bucket i counts the
+ * requests with latency in [2^(i + BASE), 2^(i + BASE + 1)) timestamp ticks.
+ * The first and last buckets also count the latencies below and above them.
+ */
+#define TFM_SPM_TRACE_HIST_BUCKETS      (16U)
+#define TFM_SPM_TRACE_HIST_BASE_LOG2    (8U)
+
+/* An event recorded by SPM */
+struct tfm_spm_trace_event_t {
+    uint32_t seq;       /* Sequence number of the event, starting from 1 */
+    uint32_t timestamp; /* Timestamp from the platform trace timer       */
+    uint32_t event;     /* One of TFM_SPM_TRACE_EV_*                     */
+    uint32_t arg;       /* Event specific argument                       */
+};
+
+/* The latency histogram of the requests to a service */
+struct tfm_spm_trace_hist_t {
+    uint32_t sid;                                 /* SID of the service   */
+    uint32_t count;                               /* Replied requests     */
+    uint32_t max;                                 /* Highest latency seen */
+    uint32_t buckets[TFM_SPM_TRACE_HIST_BUCKETS];
+};
+
+/* Request of the platform service to read SPM trace data */
+struct tfm_spm_trace_req_t {
+    uint32_t type;      /* One of TFM_SPM_TRACE_TYPE_*                    */
+    uint32_t start;     /*
+                         * For events, the first sequence number to read.
+                         * For histograms, the index of the first service.
+                         */
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_SPM_TRACE_DEFS_H__ */
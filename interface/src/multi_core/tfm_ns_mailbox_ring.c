@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+
+#include "tfm_ns_mailbox.h"
+#include "tfm_mailbox_ring.h"
+
+/* The rings shared with SPE */
+static struct mailbox_ring_shared_t *ns_rings = NULL;
+static struct mailbox_ring_end_t req_ring;      /* Producer of the requests    */
+static struct mailbox_ring_end_t cpl_ring;      /* Consumer of the completions */
+
+/* Requests posted and whose completions are not read yet */
+static uint32_t nr_outstanding;
+
+int32_t tfm_ns_mailbox_ring_init(struct mailbox_ring_shared_t *rings)
+{
+    if (!rings) {
+        return MAILBOX_INVAL_PARAMS;
+    }
+
+    memset(rings, 0, sizeof(*rings));
+    MAILBOX_CLEAN_CACHE(rings, sizeof(*rings));
+
+    mailbox_ring_init_end(&req_ring, &rings->req_head, &rings->req_tail);
+    mailbox_ring_init_end(&cpl_ring, &rings->cpl_tail, &rings->cpl_head);
+    nr_outstanding = 0;
+
+    ns_rings = rings;
+
+    /* Platform specific initialization. */
+    return tfm_ns_mailbox_hal_ring_init(rings);
+}
+
+int32_t tfm_ns_mailbox_ring_post(uint32_t call_type,
+                                 const struct psa_client_params_t *params,
+                                 int32_t client_id,
+                                 uint32_t token)
+{
+    struct mailbox_ring_req_t *req;
+
+    if (!ns_rings) {
+        return MAILBOX_INIT_ERROR;
+    }
+
+    if (!params) {
+        return MAILBOX_INVAL_PARAMS;
+    }
+
+    /*
+     * Bounding the outstanding requests, rather than the free request entries,
+     * guarantees that SPE always has room for the completions.
+     */
+    if (nr_outstanding >= MAILBOX_RING_SIZE) {
+        return MAILBOX_QUEUE_FULL;
+    }
+
+    /* Entries of requests consumed by SPE may not be released yet */
+    if (mailbox_ring_space(&req_ring) == 0) {
+        return MAILBOX_QUEUE_FULL;
+    }
+
+    req = mailbox_ring_req_entry(ns_rings, req_ring.pos);
+
+    req->msg.call_type = call_type;
+    memcpy(&req->msg.params, params, sizeof(req->msg.params));
+    req->msg.client_id = client_id;
+    req->token = token;
+    MAILBOX_CLEAN_CACHE(req, sizeof(*req));
+
+    req_ring.pos++;
+    nr_outstanding++;
+
+    return MAILBOX_SUCCESS;
+}
+
+void tfm_ns_mailbox_ring_submit(void)
+{
+    if (!ns_rings || (req_ring.pos == req_ring.own->val)) {
+        return;
+    }
+
+    mailbox_ring_commit(&req_ring);
+
+    tfm_ns_mailbox_hal_notify_peer();
+}
+
+uint32_t tfm_ns_mailbox_ring_reap(struct mailbox_ring_cpl_t *cpl, uint32_t max)
+{
+    struct mailbox_ring_cpl_t *entry;
+    uint32_t avail, nr_cpl = 0;
+
+    if (!ns_rings || !cpl) {
+        return 0;
+    }
+
+    avail = mailbox_ring_avail(&cpl_ring);
+
+    while ((nr_cpl < avail) && (nr_cpl < max)) {
+        entry = mailbox_ring_cpl_entry(ns_rings, cpl_ring.pos);
+        MAILBOX_INVALIDATE_CACHE(entry, sizeof(*entry));
+        cpl[nr_cpl] = *entry;
+
+        cpl_ring.pos++;
+        nr_cpl++;
+    }
+
+    if (nr_cpl) {
+        mailbox_ring_commit(&cpl_ring);
+        nr_outstanding -= nr_cpl;
+    }
+
+    return nr_cpl;
+}
+
+#ifndef TFM_MULTI_CORE_NS_OS
+/*
+ * In a bare metal NSPE a single PSA client call is in flight at a time, so
+ * the next completion belongs to it. NS OS integrations dispatch completions
+ * to the waiting tasks by the token instead.
+ */
+int32_t tfm_ns_mailbox_client_call(uint32_t call_type,
+                                   const struct psa_client_params_t *params,
+                                   int32_t client_id,
+                                   int32_t *reply)
+{
+    struct mailbox_ring_cpl_t cpl;
+    int32_t ret;
+
+    if (!reply) {
+        return MAILBOX_INVAL_PARAMS;
+    }
+
+    ret = tfm_ns_mailbox_ring_post(call_type, params, client_id, 0);
+    if (ret != MAILBOX_SUCCESS) {
+        return ret;
+    }
+
+    tfm_ns_mailbox_ring_submit();
+
+    while (tfm_ns_mailbox_ring_reap(&cpl, 1) == 0) {
+    }
+
+    *reply = cpl.return_val;
+
+    return MAILBOX_SUCCESS;
+}
+#endif /* TFM_MULTI_CORE_NS_OS */
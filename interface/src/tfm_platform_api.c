@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -107,3 +107,38 @@ tfm_platform_nv_counter_read(uint32_t counter_id,
         return (enum tfm_platform_err_t)status;
     }
 }
+
+enum tfm_platform_err_t
+tfm_platform_spm_trace_read(uint32_t type, uint32_t start,
+                            void *buf, size_t *len)
+{
+    psa_status_t status = PSA_ERROR_CONNECTION_REFUSED;
+    struct tfm_spm_trace_req_t req;
+    struct psa_invec in_vec[1];
+    struct psa_outvec out_vec[1];
+
+    if (len == NULL) {
+        return TFM_PLATFORM_ERR_INVALID_PARAM;
+    }
+
+    req.type = type;
+    req.start = start;
+
+    in_vec[0].base = &req;
+    in_vec[0].len = sizeof(req);
+
+    out_vec[0].base = buf;
+    out_vec[0].len = *len;
+
+    status = psa_call(TFM_PLATFORM_SERVICE_HANDLE,
+                      TFM_PLATFORM_API_ID_SPM_TRACE,
+                      in_vec, 1, out_vec, 1);
+
+    if (status < PSA_SUCCESS) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    }
+
+    *len = out_vec[0].len;
+
+    return (enum tfm_platform_err_t)status;
+}
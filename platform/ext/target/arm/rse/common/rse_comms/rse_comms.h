@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -12,20 +12,32 @@
 #include "cmsis_compiler.h"
 #include "config_tfm.h"
 #include "rse_comms_atu.h"
+#include "rse_comms_protocol.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/*
+ * The number of requests that can be in flight at the same time, from all the
+ * MHU channels together. Each request holds a whole message, so platforms with
+ * several AP cores issuing calls in parallel may raise it in their
+ * config_tfm_target.h at the cost of RAM.
+ */
+#ifndef RSE_COMMS_MAX_CONCURRENT_REQ
+#define RSE_COMMS_MAX_CONCURRENT_REQ 2
+#endif
+
 /*
  * Allocated for each client request.
  *
- * TODO: Sizing of payload_buf, this should be platform dependent:
- * - sum in_vec size
- * - sum out_vec size
+ * The message is received straight into the request. With the embed protocol
+ * the vectors point into its payload, so the payload is not copied again
+ * before the service reads it.
  */
 struct client_request_t {
     void *mhu_sender_dev; /* Pointer to MHU sender device to reply on */
+    uint32_t mhu_irq;     /* Receiver interrupt of the channel of the request */
     uint8_t protocol_ver;
     uint8_t seq_num;
     uint16_t client_id;
@@ -37,8 +49,9 @@ struct client_request_t {
     psa_outvec out_vec[PSA_MAX_IOVEC];
     int32_t return_val;
     uint64_t out_vec_host_addr[PSA_MAX_IOVEC];
-    uint8_t param_copy_buf[RSE_COMMS_PAYLOAD_MAX_SIZE];
     comms_atu_region_set_t atu_regions;
+    /* Must be the last member, it is not cleared when a request is allocated */
+    __ALIGNED(4) struct serialized_psa_msg_t msg;
 };
 
 #ifdef __cplusplus
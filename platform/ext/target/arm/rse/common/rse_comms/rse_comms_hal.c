@@ -16,17 +16,56 @@
 #include "tfm_sp_log.h"
 #include "tfm_pools.h"
 #include "rse_comms_protocol.h"
+#include "array.h"
+#include <stddef.h>
 #include <string.h>
 
-/* Declared statically to avoid using huge amounts of stack space. Maybe revisit
- * if functions not being reentrant becomes a problem.
+/* Declared statically to avoid using huge amounts of stack space.
+ *
+ * The MHU receiver interrupts share one priority, so they never pre-empt each
+ * other and the buffers used by tfm_multi_core_hal_receive() are shared by all
+ * the channels. The reply to a serviced request is built in thread mode into
+ * its own buffer, so that a message arriving on another channel meanwhile
+ * does not overwrite it.
  */
-static __ALIGNED(4) struct serialized_psa_msg_t msg;
+/* Receives the messages that are dropped as no request can be allocated */
+static __ALIGNED(4) struct serialized_psa_msg_t drop_msg;
+static __ALIGNED(4) struct serialized_psa_reply_t error_reply;
 static __ALIGNED(4) struct serialized_psa_reply_t reply;
 
 TFM_POOL_DECLARE(req_pool, sizeof(struct client_request_t),
                  RSE_COMMS_MAX_CONCURRENT_REQ);
 
+/*
+ * The receiver interrupts of all the channels, the ones which allocate
+ * requests. Guarded as the channels in initialize_mhu().
+ */
+static const IRQn_Type mhu_receiver_irqs[] = {
+    MAILBOX_IRQ,
+#ifdef MHU_AP_NS_TO_RSE_DEV
+    MAILBOX_IRQ_1,
+#endif
+#ifdef MHU_AP_S_TO_RSE_DEV
+    MAILBOX_IRQ_2,
+#endif
+};
+
+static void free_request(struct client_request_t *req)
+{
+    size_t i;
+
+    /* Short section, the pool is shared with the receiver of every channel */
+    for (i = 0; i < ARRAY_SIZE(mhu_receiver_irqs); i++) {
+        NVIC_DisableIRQ(mhu_receiver_irqs[i]);
+    }
+
+    tfm_pool_free(req_pool, req);
+
+    for (i = 0; i < ARRAY_SIZE(mhu_receiver_irqs); i++) {
+        NVIC_EnableIRQ(mhu_receiver_irqs[i]);
+    }
+}
+
 static enum tfm_plat_err_t initialize_mhu(void)
 {
     enum mhu_error_t err;
@@ -59,7 +98,7 @@ static enum tfm_plat_err_t initialize_mhu(void)
     }
 #endif /* MHU_AP_NS_TO_RSE_DEV */
 
-#ifdef MHU_RSE_TO_AP_S_DEV
+#ifdef MHU_AP_S_TO_RSE_DEV
     err = mhu_init_sender(&MHU_RSE_TO_AP_S_DEV);
     if (err != MHU_ERR_NONE) {
         LOG_ERRFMT("[COMMS] RSE to AP_S MHU driver init failed: %i\r\n", err);
@@ -71,7 +110,7 @@ static enum tfm_plat_err_t initialize_mhu(void)
         LOG_ERRFMT("[COMMS] AP_S to RSE MHU driver init failed: %i\r\n", err);
         return TFM_PLAT_ERR_SYSTEM_ERR;
     }
-#endif /* MHU_RSE_TO_AP_S_DEV */
+#endif /* MHU_AP_S_TO_RSE_DEV */
 
     LOG_DBGFMT("[COMMS] MHU driver initialized successfully.\r\n");
     return TFM_PLAT_ERR_SUCCESS;
@@ -83,14 +122,28 @@ enum tfm_plat_err_t tfm_multi_core_hal_receive(void *mhu_receiver_dev,
 {
     enum mhu_error_t mhu_err;
     enum tfm_plat_err_t err;
-    size_t msg_len = sizeof(msg);
+    struct serialized_psa_msg_t *msg;
+    size_t msg_len;
     size_t reply_size;
+    struct client_request_t *req = tfm_pool_alloc(req_pool);
 
-    memset(&msg, 0, sizeof(msg));
-    memset(&reply, 0, sizeof(reply));
+    /*
+     * Receive the message straight into the request, so that the payload is
+     * not copied again. Only the fields before the message are cleared, the
+     * message itself is overwritten by the received data.
+     */
+    if (req) {
+        memset(req, 0, offsetof(struct client_request_t, msg));
+        msg = &req->msg;
+    } else {
+        msg = &drop_msg;
+    }
+    /* The header is used by the error reply, even for a truncated message */
+    memset(&msg->header, 0, sizeof(msg->header));
+    msg_len = sizeof(*msg);
 
     /* Receive complete message */
-    mhu_err = mhu_receive_data(mhu_receiver_dev, (uint8_t *)&msg, &msg_len);
+    mhu_err = mhu_receive_data(mhu_receiver_dev, (uint8_t *)msg, &msg_len);
 
     /* Clear the pending interrupt for this MHU. This prevents the mailbox
      * interrupt handler from being called without the next request arriving
@@ -100,21 +153,23 @@ enum tfm_plat_err_t tfm_multi_core_hal_receive(void *mhu_receiver_dev,
 
     if (mhu_err != MHU_ERR_NONE) {
         /* Can't respond, since we don't know anything about the message */
+        if (req) {
+            tfm_pool_free(req_pool, req);
+        }
         return TFM_PLAT_ERR_SYSTEM_ERR;
     }
 
-    struct client_request_t *req = tfm_pool_alloc(req_pool);
     if (!req) {
         /* No free capacity, drop message */
         err = TFM_PLAT_ERR_SYSTEM_ERR;
         goto out_return_err;
     }
-    memset(req, 0, sizeof(struct client_request_t));
 
-    /* Record the MHU sender device to be used for the reply */
+    /* Record the MHU channel to be used for the reply */
     req->mhu_sender_dev = mhu_sender_dev;
+    req->mhu_irq = source;
 
-    err = rse_protocol_deserialize_msg(req, &msg, msg_len);
+    err = rse_protocol_deserialize_msg(req, msg, msg_len);
     if (err != TFM_PLAT_ERR_SUCCESS) {
         /* Deserialisation failed, drop message */
         goto out_return_err;
@@ -131,11 +186,12 @@ enum tfm_plat_err_t tfm_multi_core_hal_receive(void *mhu_receiver_dev,
 
 out_return_err:
     /* Attempt to respond with a failure message */
-    if (rse_protocol_serialize_error(req, &msg.header,
+    if (rse_protocol_serialize_error(req, &msg->header,
                                      PSA_ERROR_CONNECTION_BUSY,
-                                     &reply, &reply_size)
+                                     &error_reply, &reply_size)
         == TFM_PLAT_ERR_SUCCESS) {
-        mhu_err = mhu_send_data(mhu_sender_dev, (uint8_t *)&reply, reply_size);
+        mhu_err = mhu_send_data(mhu_sender_dev, (uint8_t *)&error_reply,
+                                reply_size);
         if (mhu_err != MHU_ERR_NONE) {
             LOG_ERRFMT("[COMMS] Cannot send failure message: %i\r\n", mhu_err);
         }
@@ -153,18 +209,21 @@ enum tfm_plat_err_t tfm_multi_core_hal_reply(struct client_request_t *req)
     enum tfm_plat_err_t err;
     enum mhu_error_t mhu_err;
     size_t reply_size;
-
-    /* This function is called by the mailbox partition with Thread priority, so
-     * MHU interrupts must be disabled to prevent concurrent accesses by
-     * tfm_multi_core_hal_receive().
-     */
-    NVIC_DisableIRQ(MAILBOX_IRQ);
+    uint32_t mhu_irq;
 
     if (!is_valid_chunk_data_in_pool(req_pool, (uint8_t *)req)) {
-        err = TFM_PLAT_ERR_SYSTEM_ERR;
-        goto out;
+        return TFM_PLAT_ERR_SYSTEM_ERR;
     }
 
+    /* This function is called by the mailbox partition with Thread priority.
+     * Only the receiver interrupt of the channel of the request is disabled
+     * while replying, so that tfm_multi_core_hal_receive() does not send an
+     * error reply on the same channel at the same time. The other channels
+     * keep receiving requests.
+     */
+    mhu_irq = req->mhu_irq;
+    NVIC_DisableIRQ(mhu_irq);
+
     err = rse_protocol_serialize_reply(req, &reply, &reply_size);
     if (err != TFM_PLAT_ERR_SUCCESS) {
         LOG_DBGFMT("[COMMS] Serialize reply failed: %i\r\n", err);
@@ -181,9 +240,8 @@ enum tfm_plat_err_t tfm_multi_core_hal_reply(struct client_request_t *req)
     LOG_DBGFMT("[COMMS] Sent reply\r\n");
 
 out_free_req:
-    tfm_pool_free(req_pool, req);
-out:
-    NVIC_EnableIRQ(MAILBOX_IRQ);
+    free_request(req);
+    NVIC_EnableIRQ(mhu_irq);
     return err;
 }
 
@@ -6,6 +6,7 @@
  */
 
 #include "rse_comms_protocol.h"
+#include "rse_comms.h"
 
 #include <string.h>
 
@@ -42,8 +43,10 @@ enum tfm_plat_err_t rse_protocol_serialize_reply(struct client_request_t *req,
 {
     enum tfm_plat_err_t err;
 
-    memset(reply, 0, sizeof(struct serialized_psa_reply_t));
-
+    /*
+     * The reply is not cleared as a whole, which is costly for large payloads.
+     * The protocols write all the fields they send.
+     */
     reply->header.protocol_ver = req->protocol_ver;
     reply->header.seq_num = req->seq_num;
     reply->header.client_id = req->client_id;
@@ -10,7 +10,7 @@
 
 #include "psa/client.h"
 #include "cmsis_compiler.h"
-#include "rse_comms.h"
+#include "config_tfm.h"
 #include "tfm_platform_system.h"
 
 #ifdef RSE_COMMS_PROTOCOL_EMBED_ENABLED
@@ -25,6 +25,8 @@
 extern "C" {
 #endif
 
+struct client_request_t;
+
 enum rse_comms_protocol_version_t {
 #ifdef RSE_COMMS_PROTOCOL_EMBED_ENABLED
     RSE_COMMS_PROTOCOL_EMBED = 0,
@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 
 #include "rse_comms_protocol_embed.h"
+#include "rse_comms.h"
 
 #include <string.h>
 
@@ -32,32 +33,33 @@ enum tfm_plat_err_t rse_protocol_embed_deserialize_msg(
         return TFM_PLAT_ERR_UNSUPPORTED;
     }
 
+    /*
+     * The message is in the memory of the request, so the vectors point into
+     * its payload. The outvecs follow the invecs in the payload buffer.
+     */
+
     /* Invecs */
     for (i = 0; i < req->in_len; ++i) {
-        req->in_vec[i].base = req->param_copy_buf + payload_size;
+        req->in_vec[i].base = msg->payload + payload_size;
         req->in_vec[i].len = msg->io_size[i];
         payload_size += msg->io_size[i];
     }
 
     /* Check payload is not too big */
-    if (payload_size > sizeof(req->param_copy_buf)
-        || payload_size > sizeof(msg->payload)
+    if (payload_size > sizeof(msg->payload)
         || sizeof(*msg) - sizeof(msg->payload) +  payload_size > msg_len ) {
         return TFM_PLAT_ERR_INVALID_INPUT;
     }
 
-    /* Copy payload into the buffer */
-    memcpy(req->param_copy_buf, msg->payload, payload_size);
-
     /* Outvecs */
     for (i = 0; i < req->out_len; ++i) {
-        req->out_vec[i].base = req->param_copy_buf + payload_size;
+        req->out_vec[i].base = msg->payload + payload_size;
         req->out_vec[i].len = msg->io_size[req->in_len + i];
         payload_size += msg->io_size[req->in_len + i];
     }
 
     /* Check payload is not too big */
-    if (payload_size > sizeof(req->param_copy_buf)) {
+    if (payload_size > sizeof(msg->payload)) {
         return TFM_PLAT_ERR_INVALID_INPUT;
     }
 
@@ -74,8 +76,13 @@ enum tfm_plat_err_t rse_protocol_embed_serialize_reply(
 
     reply->return_val = req->return_val;
 
-    /* Outvecs */
-    for (i = 0; i < req->out_len; ++i) {
+    /* Outvecs. Only the used part of the payload is written. */
+    for (i = 0; i < PSA_MAX_IOVEC; ++i) {
+        if (i >= req->out_len) {
+            reply->out_size[i] = 0;
+            continue;
+        }
+
         len = req->out_vec[i].len;
 
         if (payload_size + len > sizeof(reply->payload)) {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -10,13 +10,15 @@
 
 #include "psa/client.h"
 #include "cmsis_compiler.h"
-#include "rse_comms.h"
+#include "config_tfm.h"
 #include "tfm_platform_system.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+struct client_request_t;
+
 __PACKED_STRUCT rse_embed_msg_t {
     psa_handle_t handle;
     uint32_t ctrl_param; /* type, in_len, out_len */
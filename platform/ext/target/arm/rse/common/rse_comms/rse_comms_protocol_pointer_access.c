@@ -6,6 +6,7 @@
  */
 
 #include "rse_comms_protocol_pointer_access.h"
+#include "rse_comms.h"
 
 #include "tfm_psa_call_pack.h"
 #include "rse_comms_permissions_hal.h"
@@ -110,8 +111,8 @@ enum tfm_plat_err_t rse_protocol_pointer_access_serialize_reply(
     reply->return_val = req->return_val;
 
     /* Outvecs */
-    for (idx = 0; idx < req->out_len; idx++) {
-        reply->out_size[idx] = req->out_vec[idx].len;
+    for (idx = 0; idx < PSA_MAX_IOVEC; idx++) {
+        reply->out_size[idx] = (idx < req->out_len) ? req->out_vec[idx].len : 0;
     }
 
     *reply_size = sizeof(*reply);
@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __CONFIG_TFM_H__
+#define __CONFIG_TFM_H__
+
+/* The RSE comms configuration of the unit tests */
+
+#ifndef RSE_COMMS_PAYLOAD_MAX_SIZE
+#define RSE_COMMS_PAYLOAD_MAX_SIZE      (0x40 + 0x800)
+#endif
+
+#ifndef RSE_COMMS_MAX_CONCURRENT_REQ
+#define RSE_COMMS_MAX_CONCURRENT_REQ    4
+#endif
+
+#endif /* __CONFIG_TFM_H__ */
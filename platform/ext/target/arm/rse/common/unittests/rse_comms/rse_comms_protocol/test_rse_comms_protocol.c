@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+
+#include "unity.h"
+
+#include "rse_comms.h"
+#include "rse_comms_protocol.h"
+#include "tfm_psa_call_pack.h"
+
+#define MSG_HEADER_SIZE     (sizeof(struct serialized_rse_comms_header_t) + \
+                             offsetof(struct rse_embed_msg_t, payload))
+#define REPLY_HEADER_SIZE   (sizeof(struct serialized_rse_comms_header_t) + \
+                             offsetof(struct rse_embed_reply_t, payload))
+
+static struct client_request_t req;
+static struct serialized_psa_reply_t reply;
+
+/* Builds an embed message in the request, as the receiver does */
+static size_t build_msg(uint32_t in_len, uint32_t out_len,
+                        const uint16_t *io_size)
+{
+    struct serialized_psa_msg_t *msg = &req.msg;
+    size_t payload_size = 0;
+    uint32_t i;
+
+    msg->header.protocol_ver = RSE_COMMS_PROTOCOL_EMBED;
+    msg->header.seq_num = 0x5A;
+    msg->header.client_id = 0x1234;
+    msg->msg.embed.handle = 0x40000101;
+    msg->msg.embed.ctrl_param = PARAM_PACK(3, in_len, out_len);
+
+    for (i = 0; i < PSA_MAX_IOVEC; i++) {
+        msg->msg.embed.io_size[i] = (i < in_len + out_len) ? io_size[i] : 0;
+    }
+
+    /* Only the input payload is sent */
+    for (i = 0; i < in_len; i++) {
+        memset(msg->msg.embed.payload + payload_size, (int)(i + 1),
+               io_size[i]);
+        payload_size += io_size[i];
+    }
+
+    return MSG_HEADER_SIZE + payload_size;
+}
+
+static void assert_bytes(uint8_t val, const void *buf, size_t len)
+{
+    static uint8_t expected[RSE_COMMS_PAYLOAD_MAX_SIZE];
+
+    memset(expected, val, len);
+    TEST_ASSERT_EQUAL_MEMORY(expected, buf, len);
+}
+
+void setUp(void)
+{
+    memset(&req, 0, sizeof(req));
+    memset(&reply, 0, sizeof(reply));
+}
+
+void test_rse_comms_protocol_embed_vectors_in_msg(void)
+{
+    const uint16_t io_size[] = {16, 1024, 64};
+    size_t msg_len = build_msg(2, 1, io_size);
+    uint8_t *payload = req.msg.msg.embed.payload;
+
+    TEST_ASSERT_EQUAL(TFM_PLAT_ERR_SUCCESS,
+                      rse_protocol_deserialize_msg(&req, &req.msg, msg_len));
+
+    TEST_ASSERT_EQUAL(0x5A, req.seq_num);
+    TEST_ASSERT_EQUAL(0x1234, req.client_id);
+    TEST_ASSERT_EQUAL(0x40000101, req.handle);
+    TEST_ASSERT_EQUAL(3, req.type);
+    TEST_ASSERT_EQUAL(2, req.in_len);
+    TEST_ASSERT_EQUAL(1, req.out_len);
+
+    /* The vectors point into the received message, the payload is not copied */
+    TEST_ASSERT_EQUAL_PTR(payload, req.in_vec[0].base);
+    TEST_ASSERT_EQUAL(16, req.in_vec[0].len);
+    TEST_ASSERT_EQUAL_PTR(payload + 16, req.in_vec[1].base);
+    TEST_ASSERT_EQUAL(1024, req.in_vec[1].len);
+    TEST_ASSERT_EQUAL_PTR(payload + 16 + 1024, req.out_vec[0].base);
+    TEST_ASSERT_EQUAL(64, req.out_vec[0].len);
+
+    assert_bytes(2, req.in_vec[1].base, 1024);
+}
+
+void test_rse_comms_protocol_embed_invalid_msg(void)
+{
+    const uint16_t io_size[] = {16, 16, 16, 16};
+    const uint16_t big_size[] = {RSE_COMMS_PAYLOAD_MAX_SIZE, 1};
+    size_t msg_len;
+
+    /* Shorter than the header */
+    TEST_ASSERT_EQUAL(TFM_PLAT_ERR_INVALID_INPUT,
+                      rse_protocol_deserialize_msg(&req, &req.msg, 2));
+
+    /* More than PSA_MAX_IOVEC vectors */
+    msg_len = build_msg(4, 1, io_size);
+    TEST_ASSERT_EQUAL(TFM_PLAT_ERR_UNSUPPORTED,
+                      rse_protocol_deserialize_msg(&req, &req.msg, msg_len));
+
+    /* The input vectors are longer than the received message */
+    msg_len = build_msg(2, 0, io_size);
+    TEST_ASSERT_EQUAL(TFM_PLAT_ERR_INVALID_INPUT,
+                      rse_protocol_deserialize_msg(&req, &req.msg,
+                                                   msg_len - 1));
+
+    /* The output vectors do not fit in the payload */
+    msg_len = build_msg(1, 1, big_size);
+    TEST_ASSERT_EQUAL(TFM_PLAT_ERR_INVALID_INPUT,
+                      rse_protocol_deserialize_msg(&req, &req.msg, msg_len));
+
+    /* Unknown protocol */
+    msg_len = build_msg(1, 0, io_size);
+    req.msg.header.protocol_ver = 0x7F;
+    TEST_ASSERT_EQUAL(TFM_PLAT_ERR_UNSUPPORTED,
+                      rse_protocol_deserialize_msg(&req, &req.msg, msg_len));
+}
+
+void test_rse_comms_protocol_embed_reply(void)
+{
+    const uint16_t io_size[] = {8, 32, 100};
+    size_t msg_len = build_msg(1, 2, io_size);
+    size_t reply_size;
+
+    TEST_ASSERT_EQUAL(TFM_PLAT_ERR_SUCCESS,
+                      rse_protocol_deserialize_msg(&req, &req.msg, msg_len));
+
+    /* The service writes less than the output vectors can hold */
+    memset(req.out_vec[0].base, 0xA0, 32);
+    req.out_vec[0].len = 20;
+    req.out_vec[1].len = 0;
+    req.return_val = PSA_SUCCESS;
+
+    /* Bytes past the written payload are not touched */
+    memset(reply.reply.embed.payload, 0xEE, sizeof(reply.reply.embed.payload));
+
+    TEST_ASSERT_EQUAL(TFM_PLAT_ERR_SUCCESS,
+                      rse_protocol_serialize_reply(&req, &reply, &reply_size));
+
+    TEST_ASSERT_EQUAL(REPLY_HEADER_SIZE + 20, reply_size);
+    TEST_ASSERT_EQUAL(0x5A, reply.header.seq_num);
+    TEST_ASSERT_EQUAL(0x1234, reply.header.client_id);
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, reply.reply.embed.return_val);
+    TEST_ASSERT_EQUAL(20, reply.reply.embed.out_size[0]);
+    TEST_ASSERT_EQUAL(0, reply.reply.embed.out_size[1]);
+    TEST_ASSERT_EQUAL(0, reply.reply.embed.out_size[2]);
+    TEST_ASSERT_EQUAL(0, reply.reply.embed.out_size[3]);
+    assert_bytes(0xA0, reply.reply.embed.payload, 20);
+    TEST_ASSERT_EQUAL(0xEE, reply.reply.embed.payload[20]);
+}
+
+void test_rse_comms_protocol_embed_error(void)
+{
+    const uint16_t io_size[] = {8, 32};
+    size_t msg_len = build_msg(1, 1, io_size);
+    size_t reply_size;
+
+    TEST_ASSERT_EQUAL(TFM_PLAT_ERR_SUCCESS,
+                      rse_protocol_deserialize_msg(&req, &req.msg, msg_len));
+
+    TEST_ASSERT_EQUAL(TFM_PLAT_ERR_SUCCESS,
+                      rse_protocol_serialize_error(&req, &req.msg.header,
+                                                   PSA_ERROR_CONNECTION_BUSY,
+                                                   &reply, &reply_size));
+
+    TEST_ASSERT_EQUAL(REPLY_HEADER_SIZE, reply_size);
+    TEST_ASSERT_EQUAL(0x5A, reply.header.seq_num);
+    TEST_ASSERT_EQUAL(PSA_ERROR_CONNECTION_BUSY, reply.reply.embed.return_val);
+    TEST_ASSERT_EQUAL(0, reply.reply.embed.out_size[0]);
+}
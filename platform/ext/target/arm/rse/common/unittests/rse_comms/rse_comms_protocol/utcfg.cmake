@@ -0,0 +1,52 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2024, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+set(PLATFORM_DIR ${TFM_ROOT_DIR}/platform)
+set(RSE_COMMON_SOURCE_DIR ${PLATFORM_DIR}/ext/target/arm/rse/common)
+
+#-------------------------------------------------------------------------------
+# Unit under test
+#-------------------------------------------------------------------------------
+set(UNIT_UNDER_TEST ${RSE_COMMON_SOURCE_DIR}/rse_comms/rse_comms_protocol.c)
+
+#-------------------------------------------------------------------------------
+# Test suite
+#-------------------------------------------------------------------------------
+
+set(UNIT_TEST_SUITE ${CMAKE_CURRENT_LIST_DIR}/test_rse_comms_protocol.c)
+
+#-------------------------------------------------------------------------------
+# Dependencies
+#-------------------------------------------------------------------------------
+list(APPEND UNIT_TEST_DEPS ${RSE_COMMON_SOURCE_DIR}/rse_comms/rse_comms_protocol_embed.c)
+
+#-------------------------------------------------------------------------------
+# Include dirs
+#-------------------------------------------------------------------------------
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${RSE_COMMON_SOURCE_DIR}/unittests/rse_comms/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${RSE_COMMON_SOURCE_DIR}/unittests/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${RSE_COMMON_SOURCE_DIR}/rse_comms)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${PLATFORM_DIR}/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/interface/include)
+
+#-------------------------------------------------------------------------------
+# Compiledefs for UUT
+#-------------------------------------------------------------------------------
+list(APPEND UNIT_TEST_COMPILE_DEFS RSE_COMMS_PROTOCOL_EMBED_ENABLED)
+
+#-------------------------------------------------------------------------------
+# Link libs for UUT
+#-------------------------------------------------------------------------------
+
+#-------------------------------------------------------------------------------
+# Mocks for UUT
+#-------------------------------------------------------------------------------
+
+#-------------------------------------------------------------------------------
+# Labels for UT (Optional, tests can be grouped by labels)
+#-------------------------------------------------------------------------------
+list(APPEND UT_LABELS "RSE_COMMS")
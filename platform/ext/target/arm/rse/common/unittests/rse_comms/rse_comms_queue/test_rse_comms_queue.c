@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "unity.h"
+
+#include "rse_comms.h"
+#include "rse_comms_queue.h"
+
+static struct client_request_t reqs[RSE_COMMS_MAX_CONCURRENT_REQ];
+
+static void drain(void)
+{
+    void *entry;
+
+    while (queue_dequeue(&entry) == 0) {
+    }
+}
+
+void setUp(void)
+{
+    drain();
+}
+
+void test_rse_comms_queue_empty(void)
+{
+    void *entry = NULL;
+
+    TEST_ASSERT_EQUAL(-1, queue_dequeue(&entry));
+    TEST_ASSERT_NULL(entry);
+}
+
+/* All the requests that can be in flight fit in the queue */
+void test_rse_comms_queue_all_requests(void)
+{
+    void *entry;
+    uint32_t i;
+
+    for (i = 0; i < RSE_COMMS_MAX_CONCURRENT_REQ; i++) {
+        TEST_ASSERT_EQUAL(0, queue_enqueue(&reqs[i]));
+    }
+    TEST_ASSERT_EQUAL(-1, queue_enqueue(&reqs[0]));
+
+    for (i = 0; i < RSE_COMMS_MAX_CONCURRENT_REQ; i++) {
+        TEST_ASSERT_EQUAL(0, queue_dequeue(&entry));
+        TEST_ASSERT_EQUAL_PTR(&reqs[i], entry);
+    }
+    TEST_ASSERT_EQUAL(-1, queue_dequeue(&entry));
+}
+
+/* The requests are handled in the order they were received, across wraps */
+void test_rse_comms_queue_order(void)
+{
+    void *entry;
+    uint32_t next_in = 0, next_out = 0;
+    uint32_t round, n;
+
+    for (round = 0; round < 100; round++) {
+        for (n = 0; n <= (round % RSE_COMMS_MAX_CONCURRENT_REQ); n++) {
+            TEST_ASSERT_EQUAL(0,
+                queue_enqueue(&reqs[next_in % RSE_COMMS_MAX_CONCURRENT_REQ]));
+            next_in++;
+        }
+
+        while (next_out < next_in) {
+            TEST_ASSERT_EQUAL(0, queue_dequeue(&entry));
+            TEST_ASSERT_EQUAL_PTR(&reqs[next_out % RSE_COMMS_MAX_CONCURRENT_REQ],
+                                  entry);
+            next_out++;
+        }
+    }
+}
@@ -38,7 +38,6 @@
 
 /* Affect all 8 subregions */
 #define ALL_ENABLED 0
-#define SMPU_NAME_MAX_SIZE 18
 
 struct smpu_resources {
     PROT_SMPU_SMPU_STRUCT_Type *smpu;
@@ -46,43 +45,61 @@ struct smpu_resources {
     cy_stc_smpu_cfg_t master_config;
 };
 
-static const char * smpu_name(const SMPU_Resources *smpu_dev)
+/* The log messages are string literals, so that they can be deferred */
+static void print_smpu_name(const SMPU_Resources *smpu_dev)
 {
     switch ((int)smpu_dev->smpu) {
     case (int)PROT_SMPU_SMPU_STRUCT0:
-        return "SMPU 0";
+        SPMLOG_INFMSG("SMPU 0");
+        break;
     case (int)PROT_SMPU_SMPU_STRUCT1:
-        return "SMPU 1";
+        SPMLOG_INFMSG("SMPU 1");
+        break;
     case (int)PROT_SMPU_SMPU_STRUCT2:
-        return "SMPU 2";
+        SPMLOG_INFMSG("SMPU 2");
+        break;
     case (int)PROT_SMPU_SMPU_STRUCT3:
-        return "SMPU 3";
+        SPMLOG_INFMSG("SMPU 3");
+        break;
     case (int)PROT_SMPU_SMPU_STRUCT4:
-        return "SMPU 4";
+        SPMLOG_INFMSG("SMPU 4");
+        break;
     case (int)PROT_SMPU_SMPU_STRUCT5:
-        return "SMPU 5";
+        SPMLOG_INFMSG("SMPU 5");
+        break;
     case (int)PROT_SMPU_SMPU_STRUCT6:
-        return "SMPU 6";
+        SPMLOG_INFMSG("SMPU 6");
+        break;
     case (int)PROT_SMPU_SMPU_STRUCT7:
-        return "SMPU 7";
+        SPMLOG_INFMSG("SMPU 7");
+        break;
     case (int)PROT_SMPU_SMPU_STRUCT8:
-        return "SMPU 8";
+        SPMLOG_INFMSG("SMPU 8");
+        break;
     case (int)PROT_SMPU_SMPU_STRUCT9:
-        return "SMPU 9";
+        SPMLOG_INFMSG("SMPU 9");
+        break;
     case (int)PROT_SMPU_SMPU_STRUCT10:
-        return "SMPU 10";
+        SPMLOG_INFMSG("SMPU 10");
+        break;
     case (int)PROT_SMPU_SMPU_STRUCT11:
-        return "SMPU 11";
+        SPMLOG_INFMSG("SMPU 11");
+        break;
     case (int)PROT_SMPU_SMPU_STRUCT12:
-        return "SMPU 12";
+        SPMLOG_INFMSG("SMPU 12");
+        break;
     case (int)PROT_SMPU_SMPU_STRUCT13:
-        return "SMPU 13";
+        SPMLOG_INFMSG("SMPU 13");
+        break;
     case (int)PROT_SMPU_SMPU_STRUCT14:
-        return "SMPU 14";
+        SPMLOG_INFMSG("SMPU 14");
+        break;
     case (int)PROT_SMPU_SMPU_STRUCT15:
-        return "SMPU 15";
+        SPMLOG_INFMSG("SMPU 15");
+        break;
     default:
-        return "Unrecognised SMPU";
+        SPMLOG_INFMSG("Unrecognised SMPU");
+        break;
     }
 }
 
@@ -460,10 +477,7 @@ void SMPU_Get_Access_Rules(const void *p, size_t s,
 
 void SMPU_Print_Config(const SMPU_Resources *smpu_dev)
 {
-    char smpu_str[SMPU_NAME_MAX_SIZE] = {0};
-
-    strcpy(smpu_str, smpu_name(smpu_dev));
-    SPMLOG_INFMSG(smpu_str);
+    print_smpu_name(smpu_dev);
     if (is_runtime(smpu_dev)) {
         SPMLOG_INFMSG(" - configured algorithmically.\r\n");
 
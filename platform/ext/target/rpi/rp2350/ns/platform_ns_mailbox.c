@@ -42,24 +42,23 @@ void SIO_IRQ_FIFO_NS_IRQHandler(void)
     {
         msg = multicore_fifo_pop_blocking();
         if (msg == NOTIFY_FROM_CORE0) {
+#ifndef TFM_MAILBOX_RING_TRANSPORT
             /* Handle all the pending replies */
             tfm_ns_mailbox_wake_reply_owner_isr();
+#endif
+            /*
+             * With the ring transport, the caller reads the replies from the
+             * completion ring by tfm_ns_mailbox_ring_reap().
+             */
         }
     }
 }
 
-int32_t tfm_ns_mailbox_hal_init(struct ns_mailbox_queue_t *queue)
+/* Pass the address of the shared mailbox memory to SPE */
+static void ns_mailbox_send_addr(uint32_t addr)
 {
     uint32_t stage;
 
-    if(sio_hw->cpuid == 0) {
-        return MAILBOX_SUCCESS;
-    }
-
-    if (!queue) {
-        return MAILBOX_INVAL_PARAMS;
-    }
-
     NVIC_SetVector(SIO_IRQ_FIFO_NS_IRQn, (uint32_t) SIO_IRQ_FIFO_NS_IRQHandler);
 
     /*
@@ -74,11 +73,7 @@ int32_t tfm_ns_mailbox_hal_init(struct ns_mailbox_queue_t *queue)
     }
 
     /* Send out the address */
-    struct mailbox_init_t ns_init;
-    ns_init.status = &queue->status;
-    ns_init.slot_count = NUM_MAILBOX_QUEUE_SLOT;
-    ns_init.slots = &queue->slots[0];
-    multicore_fifo_push_blocking((uint32_t) &ns_init);
+    multicore_fifo_push_blocking(addr);
 
     /* Wait until SPE mailbox service is ready */
     while (1) {
@@ -89,9 +84,44 @@ int32_t tfm_ns_mailbox_hal_init(struct ns_mailbox_queue_t *queue)
     }
 
     NVIC_EnableIRQ(SIO_IRQ_FIFO_NS_IRQn);
+}
+
+int32_t tfm_ns_mailbox_hal_init(struct ns_mailbox_queue_t *queue)
+{
+    struct mailbox_init_t ns_init;
+
+    if(sio_hw->cpuid == 0) {
+        return MAILBOX_SUCCESS;
+    }
+
+    if (!queue) {
+        return MAILBOX_INVAL_PARAMS;
+    }
+
+    ns_init.status = &queue->status;
+    ns_init.slot_count = NUM_MAILBOX_QUEUE_SLOT;
+    ns_init.slots = &queue->slots[0];
+    ns_mailbox_send_addr((uint32_t) &ns_init);
+
+    return MAILBOX_SUCCESS;
+}
+
+#ifdef TFM_MAILBOX_RING_TRANSPORT
+int32_t tfm_ns_mailbox_hal_ring_init(struct mailbox_ring_shared_t *rings)
+{
+    if(sio_hw->cpuid == 0) {
+        return MAILBOX_SUCCESS;
+    }
+
+    if (!rings) {
+        return MAILBOX_INVAL_PARAMS;
+    }
+
+    ns_mailbox_send_addr((uint32_t) rings);
 
     return MAILBOX_SUCCESS;
 }
+#endif /* TFM_MAILBOX_RING_TRANSPORT */
 
 int32_t tfm_ns_mailbox_hal_notify_peer(void)
 {
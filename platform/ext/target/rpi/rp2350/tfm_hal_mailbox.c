@@ -43,6 +43,29 @@ int32_t tfm_mailbox_hal_init(struct secure_mailbox_queue_t *s_queue)
     return MAILBOX_SUCCESS;
 }
 
+#ifdef TFM_MAILBOX_RING_TRANSPORT
+int32_t tfm_mailbox_hal_ring_init(struct mailbox_ring_shared_t **rings)
+{
+    multicore_ns_fifo_push_blocking_inline(NS_MAILBOX_INIT);
+
+    *rings = (struct mailbox_ring_shared_t *)
+             multicore_ns_fifo_pop_blocking_inline();
+
+    /*
+     * FIXME
+     * Necessary sanity check of the address of NPSE mailbox rings should
+     * be implemented there.
+     */
+    if (*rings == NULL) {
+        return MAILBOX_INIT_ERROR;
+    }
+
+    multicore_ns_fifo_push_blocking_inline(S_MAILBOX_READY);
+
+    return MAILBOX_SUCCESS;
+}
+#endif /* TFM_MAILBOX_RING_TRANSPORT */
+
 int32_t tfm_mailbox_hal_notify_peer(void)
 {
     multicore_ns_fifo_push_blocking_inline(NOTIFY_FROM_CORE0);
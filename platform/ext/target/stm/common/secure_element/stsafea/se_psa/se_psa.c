@@ -75,13 +75,31 @@ psa_status_t se_st_to_psa_error(int32_t  ret);
   */
 int32_t debug_print(char const *fmt, ...)
 {
+  /*
+   * The trace is formatted at run time, so it is output directly rather than
+   * through the SPM log macros, which only take string literals. The deferred
+   * log only records messages of the image, so the traces are not output.
+   */
+#if (TFM_SPM_LOG_LEVEL == TFM_SPM_LOG_LEVEL_DEBUG) && \
+    !defined(CONFIG_TFM_SPM_LOG_DEFERRED)
   int32_t len;
   va_list args;
   va_start(args, fmt);
   char trace_buf[500];
 
   len = vsnprintf(trace_buf, sizeof(trace_buf), fmt, args);
-  SPMLOG_DBGMSG(trace_buf);
+  va_end(args);
+  if (len > 0)
+  {
+    if (len >= (int32_t)sizeof(trace_buf))
+    {
+      len = sizeof(trace_buf) - 1;
+    }
+    (void)tfm_hal_output_spm_log(trace_buf, (uint32_t)len);
+  }
+#else
+  (void)fmt;
+#endif
   return 0;
 }
 
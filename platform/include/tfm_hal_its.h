@@ -37,6 +37,15 @@ extern "C" {
 #error "TFM_HAL_ITS_PROGRAM_UNIT must be a power of two"
 #endif
 
+/* Whether a program unit of the ITS flash device that has been programmed with
+ * the erase value can be programmed again without an erase. This is not the
+ * case of flash devices with ECC, for instance. Enables ITS_APPEND_IN_PLACE
+ * for the ITS filesystem.
+ */
+#ifndef TFM_HAL_ITS_REPROGRAM_ERASED
+#define TFM_HAL_ITS_REPROGRAM_ERASED 0
+#endif
+
 /**
  * \brief Struct containing information required from the platform at runtime
  *        to configure the ITS filesystem.
@@ -72,4 +72,20 @@ uint32_t tfm_mailbox_hal_enter_critical(void);
  */
 void tfm_mailbox_hal_exit_critical(uint32_t state);
 
+#ifdef TFM_MAILBOX_RING_TRANSPORT
+struct mailbox_ring_shared_t;
+
+/**
+ * \brief Platform specific initialization of the SPE side of the mailbox ring
+ *        transport.
+ *
+ * \param[out] rings            Written with the address of the rings
+ *                              allocated by NSPE.
+ *
+ * \retval MAILBOX_SUCCESS      Operation succeeded.
+ * \retval Other return code    Operation failed with an error code.
+ */
+int32_t tfm_mailbox_hal_ring_init(struct mailbox_ring_shared_t **rings);
+#endif /* TFM_MAILBOX_RING_TRANSPORT */
+
 #endif /* __TFM_HAL_MAILBOX_H__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2024, Arm Limited. All rights reserved.
  * Copyright (c) 2022 Cypress Semiconductor Corporation (an Infineon company)
  * or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
  *
@@ -73,6 +73,19 @@ uint32_t tfm_hal_get_ns_VTOR(void);
  */
 uint32_t tfm_hal_get_ns_entry_point(void);
 
+/**
+ * \brief Start the timer used to timestamp SPM trace events. A default based
+ *        on the DWT cycle counter is provided as a weak symbol.
+ */
+void tfm_hal_spm_trace_timer_init(void);
+
+/**
+ * \brief Get the current value of the SPM trace timer
+ *
+ * \return Returns a free running 32-bit timestamp
+ */
+uint32_t tfm_hal_spm_trace_timestamp(void);
+
 #ifdef TFM_PARTITION_NS_AGENT_TZ
 /**
  * \brief Get the initial address of non-secure image main stack
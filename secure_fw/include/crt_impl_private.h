@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -13,6 +13,26 @@
 
 #define ADDR_WORD_UNALIGNED(x)        ((x) & 0x3)
 
+/*
+ * Words moved per iteration of the bulk loops. The compilers turn the loads
+ * and stores of a burst into one LDM and one STM.
+ */
+#define CRT_BURST_WORDS               4
+#define CRT_BURST_BYTES               (CRT_BURST_WORDS * sizeof(uint32_t))
+
+/*
+ * Build the word starting 'shift' bits into the word 'lo', with 'hi' being the
+ * next word in memory. 'shift' must be 8, 16 or 24. Words are always accessed
+ * aligned as the unaligned accesses may be trapped by the platform.
+ */
+#ifdef __ARM_BIG_ENDIAN
+#define CRT_MERGE_WORDS(lo, hi, shift) \
+    (((lo) << (shift)) | ((hi) >> (32 - (shift))))
+#else
+#define CRT_MERGE_WORDS(lo, hi, shift) \
+    (((lo) >> (shift)) | ((hi) << (32 - (shift))))
+#endif
+
 union composite_addr_t {
     uintptr_t uint_addr;        /* Address as integer value  */
     uint8_t   *p_byte;          /* Address in BYTE pointer   */
@@ -19,4 +19,13 @@
 #error "Invalid config: NOT CRYPTO_NV_SEED AND NOT CRYPTO_EXT_RNG!"
 #endif
 
+#if CRYPTO_CONC_OPER_PER_OWNER > (CRYPTO_CONC_OPER_NUM +                 \
+                                   CRYPTO_CONC_OPER_NUM_CIPHER +          \
+                                   CRYPTO_CONC_OPER_NUM_MAC +             \
+                                   CRYPTO_CONC_OPER_NUM_HASH +            \
+                                   CRYPTO_CONC_OPER_NUM_KEY_DERIVATION +  \
+                                   CRYPTO_CONC_OPER_NUM_AEAD)
+#error "Invalid config: CRYPTO_CONC_OPER_PER_OWNER > number of contexts!"
+#endif
+
 #endif /* __CONFIG_PARTITION_CRYPTO_H__ */
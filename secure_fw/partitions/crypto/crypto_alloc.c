@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -14,6 +14,7 @@
 
 #include "tfm_crypto_api.h"
 #include "tfm_crypto_defs.h"
+#include "tfm_sp_log.h"
 
 /**
  * \brief Define miscellaneous literal constants that are used in the service
@@ -28,26 +29,255 @@ enum {
  */
 #define TFM_CRYPTO_INVALID_HANDLE (0x0u)
 
+/**
+ * \brief Layout of the handles returned to clients. The low bits hold the
+ *        slot index plus one, so that a valid handle is never zero, and the
+ *        high bits hold the generation of the slot at allocation time. The
+ *        generation is bumped on each release, so a stale handle kept by a
+ *        client after releasing its context does not match a slot that has
+ *        been reallocated since.
+ */
+#define TFM_CRYPTO_HANDLE_IDX_BITS (8u)
+#define TFM_CRYPTO_HANDLE_IDX_MASK ((1u << TFM_CRYPTO_HANDLE_IDX_BITS) - 1u)
+#define TFM_CRYPTO_HANDLE_GEN_MASK (UINT32_MAX >> TFM_CRYPTO_HANDLE_IDX_BITS)
+
+#define TFM_CRYPTO_HANDLE(idx, gen) \
+    (((gen) << TFM_CRYPTO_HANDLE_IDX_BITS) | ((idx) + 1u))
+#define TFM_CRYPTO_HANDLE_IDX(h)    (((h) & TFM_CRYPTO_HANDLE_IDX_MASK) - 1u)
+#define TFM_CRYPTO_HANDLE_GEN(h)    ((h) >> TFM_CRYPTO_HANDLE_IDX_BITS)
+
+/**
+ * \brief Marks the end of the free list and unused owner entries
+ */
+#define TFM_CRYPTO_NO_SLOT (UINT8_MAX)
+
+/**
+ * \brief Total number of contexts, across the shared pool and the pools
+ *        dedicated to a single operation type
+ */
+#define TFM_CRYPTO_TOTAL_OPER_NUM (CRYPTO_CONC_OPER_NUM +                  \
+                                   CRYPTO_CONC_OPER_NUM_CIPHER +           \
+                                   CRYPTO_CONC_OPER_NUM_MAC +              \
+                                   CRYPTO_CONC_OPER_NUM_HASH +             \
+                                   CRYPTO_CONC_OPER_NUM_KEY_DERIVATION +   \
+                                   CRYPTO_CONC_OPER_NUM_AEAD)
+
+#if TFM_CRYPTO_TOTAL_OPER_NUM >= TFM_CRYPTO_NO_SLOT
+#error "The total number of concurrent operations must be lower than 255"
+#endif
+
+#if TFM_CRYPTO_TOTAL_OPER_NUM == 0
+#error "At least one concurrent operation context must be available"
+#endif
+
+/**
+ * \brief Pools of contexts. The shared pool holds contexts large enough for
+ *        any type of operation, the others are dedicated to one type and
+ *        indexed by it.
+ */
+#define TFM_CRYPTO_SHARED_POOL (0u)
+#define TFM_CRYPTO_NUM_POOLS   (TFM_CRYPTO_AEAD_OPERATION + 1u)
+
 /**
  * \brief A type describing the context stored in Secure memory by the TF-M Crypto
  *        service to support multipart calls on secure side
  */
+union tfm_crypto_operation_u {
+    psa_cipher_operation_t cipher;    /*!< Cipher operation context */
+    psa_mac_operation_t mac;          /*!< MAC operation context */
+    psa_hash_operation_t hash;        /*!< Hash operation context */
+    psa_key_derivation_operation_t key_deriv; /*!< Key derivation operation context */
+    psa_aead_operation_t aead;        /*!< AEAD operation context */
+};
+
+/**
+ * \brief Book-keeping of a context slot. The context itself lives in the
+ *        storage of the pool the slot belongs to.
+ */
 struct tfm_crypto_operation_s {
     uint32_t in_use;                /*!< Indicates if the operation is in use */
     int32_t owner;                  /*!< Indicates an ID of the owner of
                                      *   the context
                                      */
+    uint32_t generation;            /*!< Generation of the slot, bumped on
+                                     *   each release
+                                     */
+    uint8_t next_free;              /*!< Next slot in the free list */
+    uint8_t pool;                   /*!< Pool the slot belongs to */
+#if CRYPTO_CONC_OPER_PER_OWNER
+    uint8_t owner_idx;              /*!< Quota entry of the owner */
+#endif
     enum tfm_crypto_operation_type type; /*!< Type of the operation */
-    union {
-        psa_cipher_operation_t cipher;    /*!< Cipher operation context */
-        psa_mac_operation_t mac;          /*!< MAC operation context */
-        psa_hash_operation_t hash;        /*!< Hash operation context */
-        psa_key_derivation_operation_t key_deriv; /*!< Key derivation operation context */
-        psa_aead_operation_t aead;        /*!< AEAD operation context */
-    } operation;
 };
 
-static struct tfm_crypto_operation_s operations[CRYPTO_CONC_OPER_NUM] = {{0}};
+/**
+ * \brief A pool of contexts of the same size, backed by a range of slots
+ */
+struct tfm_crypto_pool_s {
+    void *contexts;                 /*!< Storage of the contexts */
+    size_t ctx_size;                /*!< Size of each context */
+    uint8_t first;                  /*!< First slot of the pool */
+    uint8_t num;                    /*!< Number of slots in the pool */
+};
+
+#if CRYPTO_CONC_OPER_NUM
+static union tfm_crypto_operation_u shared_contexts[CRYPTO_CONC_OPER_NUM];
+#endif
+#if CRYPTO_CONC_OPER_NUM_CIPHER
+static psa_cipher_operation_t cipher_contexts[CRYPTO_CONC_OPER_NUM_CIPHER];
+#endif
+#if CRYPTO_CONC_OPER_NUM_MAC
+static psa_mac_operation_t mac_contexts[CRYPTO_CONC_OPER_NUM_MAC];
+#endif
+#if CRYPTO_CONC_OPER_NUM_HASH
+static psa_hash_operation_t hash_contexts[CRYPTO_CONC_OPER_NUM_HASH];
+#endif
+#if CRYPTO_CONC_OPER_NUM_KEY_DERIVATION
+static psa_key_derivation_operation_t
+    key_deriv_contexts[CRYPTO_CONC_OPER_NUM_KEY_DERIVATION];
+#endif
+#if CRYPTO_CONC_OPER_NUM_AEAD
+static psa_aead_operation_t aead_contexts[CRYPTO_CONC_OPER_NUM_AEAD];
+#endif
+
+#define TFM_CRYPTO_POOL(contexts, first, num) \
+    { (contexts), sizeof((contexts)[0]), (first), (num) }
+
+#define TFM_CRYPTO_FIRST_CIPHER  (CRYPTO_CONC_OPER_NUM)
+#define TFM_CRYPTO_FIRST_MAC     (TFM_CRYPTO_FIRST_CIPHER + \
+                                  CRYPTO_CONC_OPER_NUM_CIPHER)
+#define TFM_CRYPTO_FIRST_HASH    (TFM_CRYPTO_FIRST_MAC + \
+                                  CRYPTO_CONC_OPER_NUM_MAC)
+#define TFM_CRYPTO_FIRST_KDF     (TFM_CRYPTO_FIRST_HASH + \
+                                  CRYPTO_CONC_OPER_NUM_HASH)
+#define TFM_CRYPTO_FIRST_AEAD    (TFM_CRYPTO_FIRST_KDF + \
+                                  CRYPTO_CONC_OPER_NUM_KEY_DERIVATION)
+
+static const struct tfm_crypto_pool_s pools[TFM_CRYPTO_NUM_POOLS] = {
+#if CRYPTO_CONC_OPER_NUM
+    [TFM_CRYPTO_SHARED_POOL] =
+        TFM_CRYPTO_POOL(shared_contexts, 0, CRYPTO_CONC_OPER_NUM),
+#endif
+#if CRYPTO_CONC_OPER_NUM_CIPHER
+    [TFM_CRYPTO_CIPHER_OPERATION] =
+        TFM_CRYPTO_POOL(cipher_contexts, TFM_CRYPTO_FIRST_CIPHER,
+                        CRYPTO_CONC_OPER_NUM_CIPHER),
+#endif
+#if CRYPTO_CONC_OPER_NUM_MAC
+    [TFM_CRYPTO_MAC_OPERATION] =
+        TFM_CRYPTO_POOL(mac_contexts, TFM_CRYPTO_FIRST_MAC,
+                        CRYPTO_CONC_OPER_NUM_MAC),
+#endif
+#if CRYPTO_CONC_OPER_NUM_HASH
+    [TFM_CRYPTO_HASH_OPERATION] =
+        TFM_CRYPTO_POOL(hash_contexts, TFM_CRYPTO_FIRST_HASH,
+                        CRYPTO_CONC_OPER_NUM_HASH),
+#endif
+#if CRYPTO_CONC_OPER_NUM_KEY_DERIVATION
+    [TFM_CRYPTO_KEY_DERIVATION_OPERATION] =
+        TFM_CRYPTO_POOL(key_deriv_contexts, TFM_CRYPTO_FIRST_KDF,
+                        CRYPTO_CONC_OPER_NUM_KEY_DERIVATION),
+#endif
+#if CRYPTO_CONC_OPER_NUM_AEAD
+    [TFM_CRYPTO_AEAD_OPERATION] =
+        TFM_CRYPTO_POOL(aead_contexts, TFM_CRYPTO_FIRST_AEAD,
+                        CRYPTO_CONC_OPER_NUM_AEAD),
+#endif
+};
+
+static struct tfm_crypto_operation_s operations[TFM_CRYPTO_TOTAL_OPER_NUM] = {{0}};
+
+/* Head of the list of slots not in use, for each pool */
+static uint8_t free_head[TFM_CRYPTO_NUM_POOLS];
+
+/* Contexts in use and highest number ever in use, for each operation type */
+static uint32_t type_in_use[TFM_CRYPTO_NUM_POOLS];
+static uint32_t type_high_water[TFM_CRYPTO_NUM_POOLS];
+
+#if CRYPTO_CONC_OPER_PER_OWNER
+/**
+ * \brief Number of contexts held by an owner. There can't be more owners
+ *        holding contexts than there are contexts, so the table is sized
+ *        after TFM_CRYPTO_TOTAL_OPER_NUM. An entry does not move while its
+ *        owner holds contexts, so the slots keep the index of the entry of
+ *        their owner to release it in constant time. The entry of an owner
+ *        holding no context is reused for the next new owner.
+ */
+struct tfm_crypto_owner_s {
+    int32_t owner;                  /*!< ID of the owner */
+    uint32_t count;                 /*!< Contexts allocated to the owner */
+};
+
+static struct tfm_crypto_owner_s owners[TFM_CRYPTO_TOTAL_OPER_NUM] = {{0}};
+
+/* Number of entries at the start of owners[] used since initialisation */
+static uint32_t num_owner_entries;
+
+/*
+ * \brief Finds the quota entry of an owner, or assigns one to it if it holds
+ *        no context. The search is bounded by the highest number of owners
+ *        that have held contexts at once.
+ *
+ * \note A context must be free, so that an entry is available.
+ *
+ * \param[in] owner ID of the owner
+ *
+ * \return Index of the entry
+ */
+static uint32_t owner_entry(int32_t owner)
+{
+    uint32_t i;
+    uint32_t free_idx = num_owner_entries;
+
+    for (i = 0; i < num_owner_entries; i++) {
+        if (owners[i].count == 0) {
+            if (free_idx == num_owner_entries) {
+                free_idx = i;
+            }
+        } else if (owners[i].owner == owner) {
+            return i;
+        }
+    }
+
+    if (free_idx == num_owner_entries) {
+        num_owner_entries++;
+    }
+    owners[free_idx].owner = owner;
+
+    return free_idx;
+}
+#endif /* CRYPTO_CONC_OPER_PER_OWNER */
+
+/*
+ * \brief Returns the pool that the contexts of an operation type are
+ *        allocated from
+ *
+ * \param[in] type Type of the operation
+ *
+ * \return Index of the pool
+ */
+static uint32_t type_to_pool(enum tfm_crypto_operation_type type)
+{
+    if (pools[type].num != 0) {
+        return (uint32_t)type;
+    }
+
+    return TFM_CRYPTO_SHARED_POOL;
+}
+
+/*
+ * \brief Returns the backend context of a slot
+ *
+ * \param[in] index Numerical index in the database of the backend contexts
+ *
+ * \return Pointer to the context
+ */
+static void *operation_context(uint32_t index)
+{
+    const struct tfm_crypto_pool_s *pool = &pools[operations[index].pool];
+
+    return (uint8_t *)pool->contexts + (index - pool->first) * pool->ctx_size;
+}
 
 /*
  * \brief Function used to clear the memory associated to a backend context
@@ -60,8 +290,34 @@ static struct tfm_crypto_operation_s operations[CRYPTO_CONC_OPER_NUM] = {{0}};
 static void memset_operation_context(uint32_t index)
 {
     /* Clear the contents of the backend context */
-    (void)memset((uint8_t *)&(operations[index].operation), 0,
-                 sizeof(operations[index].operation));
+    (void)memset(operation_context(index), 0,
+                 pools[operations[index].pool].ctx_size);
+}
+
+/*
+ * \brief Returns the index of the slot a handle refers to, if that slot is
+ *        still allocated to the handle
+ *
+ * \param[in] handle Handle of the context
+ *
+ * \return Index of the slot, TFM_CRYPTO_NO_SLOT if the handle is not valid
+ */
+static uint32_t handle_to_index(uint32_t handle)
+{
+    uint32_t idx;
+
+    if (handle == TFM_CRYPTO_INVALID_HANDLE) {
+        return TFM_CRYPTO_NO_SLOT;
+    }
+
+    idx = TFM_CRYPTO_HANDLE_IDX(handle);
+    if ((idx >= TFM_CRYPTO_TOTAL_OPER_NUM) ||
+        (operations[idx].in_use != TFM_CRYPTO_IN_USE) ||
+        (operations[idx].generation != TFM_CRYPTO_HANDLE_GEN(handle))) {
+        return TFM_CRYPTO_NO_SLOT;
+    }
+
+    return idx;
 }
 
 /*!
@@ -73,8 +329,30 @@ static void memset_operation_context(uint32_t index)
 /*!@{*/
 psa_status_t tfm_crypto_init_alloc(void)
 {
+    uint32_t p, i;
+
     /* Clear the contents of the local contexts */
     (void)memset(operations, 0, sizeof(operations));
+    (void)memset(type_in_use, 0, sizeof(type_in_use));
+    (void)memset(type_high_water, 0, sizeof(type_high_water));
+#if CRYPTO_CONC_OPER_PER_OWNER
+    (void)memset(owners, 0, sizeof(owners));
+    num_owner_entries = 0;
+#endif
+
+    /* Chain the slots of each pool in its free list */
+    for (p = 0; p < TFM_CRYPTO_NUM_POOLS; p++) {
+        free_head[p] = (pools[p].num != 0) ? pools[p].first :
+                                             TFM_CRYPTO_NO_SLOT;
+
+        for (i = pools[p].first; i < pools[p].first + pools[p].num; i++) {
+            operations[i].pool = (uint8_t)p;
+            memset_operation_context(i);
+            operations[i].next_free = (i + 1 < pools[p].first + pools[p].num) ?
+                                      (uint8_t)(i + 1) : TFM_CRYPTO_NO_SLOT;
+        }
+    }
+
     return PSA_SUCCESS;
 }
 
@@ -83,8 +361,12 @@ psa_status_t tfm_crypto_operation_alloc(enum tfm_crypto_operation_type type,
                                         void **ctx)
 {
     uint32_t i = 0;
+    uint32_t pool;
     int32_t partition_id = 0;
     psa_status_t status;
+#if CRYPTO_CONC_OPER_PER_OWNER
+    uint32_t owner_idx;
+#endif
 
     /* Handle must be initialised before calling a setup function */
     if (*handle != TFM_CRYPTO_INVALID_HANDLE) {
@@ -97,36 +379,66 @@ psa_status_t tfm_crypto_operation_alloc(enum tfm_crypto_operation_type type,
     }
     *ctx = NULL;
 
+    if ((type <= TFM_CRYPTO_OPERATION_NONE) ||
+        (type >= (enum tfm_crypto_operation_type)TFM_CRYPTO_NUM_POOLS)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
     status = tfm_crypto_get_caller_id(&partition_id);
     if (status != PSA_SUCCESS) {
         return status;
     }
 
-    for (i = 0; i < CRYPTO_CONC_OPER_NUM; i++) {
-        if (operations[i].in_use == TFM_CRYPTO_NOT_IN_USE) {
-            operations[i].in_use = TFM_CRYPTO_IN_USE;
-            operations[i].owner = partition_id;
-            operations[i].type = type;
-            *handle = i + 1;
-            *ctx = (void *) &(operations[i].operation);
-            return PSA_SUCCESS;
-        }
+    pool = type_to_pool(type);
+    if (free_head[pool] == TFM_CRYPTO_NO_SLOT) {
+        return PSA_ERROR_NOT_PERMITTED;
     }
 
-    return PSA_ERROR_NOT_PERMITTED;
+#if CRYPTO_CONC_OPER_PER_OWNER
+    /* A free slot exists, so the owner table can't be full either */
+    owner_idx = owner_entry(partition_id);
+    if (owners[owner_idx].count >= CRYPTO_CONC_OPER_PER_OWNER) {
+        return PSA_ERROR_NOT_PERMITTED;
+    }
+    owners[owner_idx].count++;
+#endif
+
+    i = free_head[pool];
+    free_head[pool] = operations[i].next_free;
+
+    operations[i].in_use = TFM_CRYPTO_IN_USE;
+    operations[i].owner = partition_id;
+    operations[i].type = type;
+    operations[i].next_free = TFM_CRYPTO_NO_SLOT;
+#if CRYPTO_CONC_OPER_PER_OWNER
+    operations[i].owner_idx = (uint8_t)owner_idx;
+#endif
+    *handle = TFM_CRYPTO_HANDLE(i, operations[i].generation);
+    *ctx = operation_context(i);
+
+    type_in_use[type]++;
+    if (type_in_use[type] > type_high_water[type]) {
+        /* Logged when it grows only, to help sizing the context pools */
+        type_high_water[type] = type_in_use[type];
+        LOG_DBGFMT("[DBG][Crypto] Operation type %u: %u contexts in use\r\n",
+                   (uint32_t)type, type_high_water[type]);
+    }
+
+    return PSA_SUCCESS;
 }
 
 psa_status_t tfm_crypto_operation_release(uint32_t *handle)
 {
     uint32_t h_val = *handle;
+    uint32_t idx;
     int32_t partition_id = 0;
     psa_status_t status;
 
     /* Handle shall be cleaned up always at first */
     *handle = TFM_CRYPTO_INVALID_HANDLE;
 
-    if ((h_val == TFM_CRYPTO_INVALID_HANDLE) ||
-        (h_val > CRYPTO_CONC_OPER_NUM)) {
+    idx = handle_to_index(h_val);
+    if (idx == TFM_CRYPTO_NO_SLOT) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
@@ -135,29 +447,37 @@ psa_status_t tfm_crypto_operation_release(uint32_t *handle)
         return status;
     }
 
-    if ((operations[h_val - 1].in_use == TFM_CRYPTO_IN_USE) &&
-        (operations[h_val - 1].owner == partition_id)) {
+    if (operations[idx].owner != partition_id) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
 
-        memset_operation_context(h_val - 1);
-        operations[h_val - 1].in_use = TFM_CRYPTO_NOT_IN_USE;
-        operations[h_val - 1].type = TFM_CRYPTO_OPERATION_NONE;
-        operations[h_val - 1].owner = 0;
+    memset_operation_context(idx);
+    type_in_use[operations[idx].type]--;
+    operations[idx].in_use = TFM_CRYPTO_NOT_IN_USE;
+    operations[idx].type = TFM_CRYPTO_OPERATION_NONE;
+    operations[idx].owner = 0;
+    operations[idx].generation =
+        (operations[idx].generation + 1u) & TFM_CRYPTO_HANDLE_GEN_MASK;
+#if CRYPTO_CONC_OPER_PER_OWNER
+    owners[operations[idx].owner_idx].count--;
+#endif
 
-        return PSA_SUCCESS;
-    }
+    operations[idx].next_free = free_head[operations[idx].pool];
+    free_head[operations[idx].pool] = (uint8_t)idx;
 
-    return PSA_ERROR_INVALID_ARGUMENT;
+    return PSA_SUCCESS;
 }
 
 psa_status_t tfm_crypto_operation_lookup(enum tfm_crypto_operation_type type,
                                          uint32_t handle,
                                          void **ctx)
 {
+    uint32_t idx;
     int32_t partition_id = 0;
     psa_status_t status;
 
-    if ((handle == TFM_CRYPTO_INVALID_HANDLE) ||
-        (handle > CRYPTO_CONC_OPER_NUM)) {
+    idx = handle_to_index(handle);
+    if (idx == TFM_CRYPTO_NO_SLOT) {
         return PSA_ERROR_BAD_STATE;
     }
 
@@ -170,13 +490,28 @@ psa_status_t tfm_crypto_operation_lookup(enum tfm_crypto_operation_type type,
         return status;
     }
 
-    if ((operations[handle - 1].in_use == TFM_CRYPTO_IN_USE) &&
-        (operations[handle - 1].type == type) &&
-        (operations[handle - 1].owner == partition_id)) {
-        *ctx = (void *) &(operations[handle - 1].operation);
+    if ((operations[idx].type == type) &&
+        (operations[idx].owner == partition_id)) {
+        *ctx = operation_context(idx);
         return PSA_SUCCESS;
     }
 
     return PSA_ERROR_BAD_STATE;
 }
+
+psa_status_t tfm_crypto_operation_usage(enum tfm_crypto_operation_type type,
+                                        uint32_t *in_use,
+                                        uint32_t *high_water)
+{
+    if ((type <= TFM_CRYPTO_OPERATION_NONE) ||
+        (type >= (enum tfm_crypto_operation_type)TFM_CRYPTO_NUM_POOLS) ||
+        (in_use == NULL) || (high_water == NULL)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    *in_use = type_in_use[type];
+    *high_water = type_high_water[type];
+
+    return PSA_SUCCESS;
+}
 /*!@}*/
@@ -4,12 +4,17 @@
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
+#include <stdbool.h>
 #include <string.h>
+#include "config_tfm.h"
 #include "tfm_builtin_key_loader.h"
 #include "tfm_mbedcrypto_include.h"
 #include "psa_manifest/pid.h"
 #include "tfm_plat_crypto_keys.h"
 #include "crypto_library.h"
+#if CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM > 0
+#include "tfm_plat_otp.h"
+#endif
 
 #ifndef TFM_BUILTIN_MAX_KEY_LEN
 #define TFM_BUILTIN_MAX_KEY_LEN (48)
@@ -37,6 +42,119 @@ struct tfm_builtin_key_t {
  */
 static struct tfm_builtin_key_t g_builtin_key_slots[TFM_BUILTIN_MAX_KEYS] = {0};
 
+#if CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM > 0
+/*!
+ * \brief A structure which describes a key derived from a builtin key for a user
+ */
+struct tfm_builtin_key_derived_t {
+    uint8_t __attribute__((aligned(4))) key[TFM_BUILTIN_MAX_KEY_LEN]; /*!< Derived key material, 4-byte aligned */
+    size_t key_len;                       /*!< Size of the derived key material, 0 if the entry is free */
+    psa_drv_slot_number_t slot_number;    /*!< Slot of the builtin key the key is derived from */
+    int32_t user;                         /*!< User the key is derived for */
+    uint32_t last_use;                    /*!< Value of the use counter when last used, for the LRU */
+};
+
+/*!
+ * \brief The keys derived for the users most recently, to avoid running the
+ *        key derivation each time a user accesses a builtin key. The entries
+ *        are only valid in the lifecycle state they have been derived in.
+ */
+static struct tfm_builtin_key_derived_t g_derived_key_cache[CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM];
+static uint32_t g_derived_key_use_cnt;
+static enum plat_otp_lcs_t g_derived_key_lcs = PLAT_OTP_LCS_UNKNOWN;
+
+/*!
+ * \brief Erase all the derived keys
+ */
+static void derived_key_cache_flush(void)
+{
+    memset(g_derived_key_cache, 0, sizeof(g_derived_key_cache));
+    g_derived_key_use_cnt = 0;
+}
+
+/*!
+ * \brief Erase all the derived keys if the lifecycle state has changed since
+ *        they have been derived. Returns false if the cache can't be used, as
+ *        the lifecycle state can't be read.
+ */
+static bool derived_key_cache_check_lcs(void)
+{
+    enum plat_otp_lcs_t lcs;
+
+    if (tfm_plat_otp_read(PLAT_OTP_ID_LCS, sizeof(lcs), (uint8_t *)&lcs) != TFM_PLAT_ERR_SUCCESS) {
+        lcs = PLAT_OTP_LCS_UNKNOWN;
+    }
+
+    if (lcs != g_derived_key_lcs) {
+        derived_key_cache_flush();
+        g_derived_key_lcs = lcs;
+    }
+
+    return lcs != PLAT_OTP_LCS_UNKNOWN;
+}
+
+/*!
+ * \brief Copies into the buffer the key derived for the user, if it is cached
+ */
+static bool derived_key_cache_get(
+        psa_drv_slot_number_t slot_number, int32_t user,
+        uint8_t *key_buffer, size_t key_buffer_size, size_t *key_buffer_length)
+{
+    if (!derived_key_cache_check_lcs()) {
+        return false;
+    }
+
+    for (size_t idx = 0; idx < NUMBER_OF_ELEMENTS_OF(g_derived_key_cache); idx++) {
+        struct tfm_builtin_key_derived_t *entry = &g_derived_key_cache[idx];
+
+        /* The length of the derived key is set by the buffer size */
+        if (entry->key_len != 0 && entry->key_len == key_buffer_size &&
+            entry->slot_number == slot_number && entry->user == user) {
+            memcpy(key_buffer, entry->key, entry->key_len);
+            *key_buffer_length = entry->key_len;
+            entry->last_use = ++g_derived_key_use_cnt;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*!
+ * \brief Stores the key derived for the user, in place of the least recently
+ *        used one if there is no free entry
+ */
+static void derived_key_cache_put(
+        psa_drv_slot_number_t slot_number, int32_t user,
+        const uint8_t *key, size_t key_len)
+{
+    struct tfm_builtin_key_derived_t *entry = &g_derived_key_cache[0];
+
+    if (key_len == 0 || key_len > TFM_BUILTIN_MAX_KEY_LEN ||
+        g_derived_key_lcs == PLAT_OTP_LCS_UNKNOWN) {
+        return;
+    }
+
+    for (size_t idx = 0; idx < NUMBER_OF_ELEMENTS_OF(g_derived_key_cache); idx++) {
+        if (g_derived_key_cache[idx].key_len == 0) {
+            entry = &g_derived_key_cache[idx];
+            break;
+        }
+        if (g_derived_key_cache[idx].last_use < entry->last_use) {
+            entry = &g_derived_key_cache[idx];
+        }
+    }
+
+    /* Erase the evicted key before reusing the entry */
+    memset(entry, 0, sizeof(*entry));
+    memcpy(entry->key, key, key_len);
+    entry->key_len = key_len;
+    entry->slot_number = slot_number;
+    entry->user = user;
+    entry->last_use = ++g_derived_key_use_cnt;
+}
+#endif /* CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM > 0 */
+
 /*!
  * \brief This functions returns the slot associated to a key id interrogating the
  *        platform HAL table
@@ -127,6 +245,15 @@ static psa_status_t derive_subkey_into_buffer(
     }
 #endif /* TFM_PARTITION_TEST_PS */
 
+#if CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM > 0
+    psa_drv_slot_number_t slot_number = (psa_drv_slot_number_t)(key_slot - g_builtin_key_slots);
+
+    if (derived_key_cache_get(slot_number, user,
+                              key_buffer, key_buffer_size, key_buffer_length)) {
+        return PSA_SUCCESS;
+    }
+#endif /* CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM > 0 */
+
     psa_status_t status;
     tfm_crypto_library_key_id_t output_key_id_local = tfm_crypto_library_key_id_init_default();
     tfm_crypto_library_key_id_t builtin_key = psa_get_key_id(&key_slot->attr);
@@ -180,6 +307,10 @@ static psa_status_t derive_subkey_into_buffer(
         goto wrap_up;
     }
 
+#if CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM > 0
+    derived_key_cache_put(slot_number, user, key_buffer, *key_buffer_length);
+#endif /* CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM > 0 */
+
 wrap_up:
     (void)psa_key_derivation_abort(&deriv_ops);
     (void)psa_destroy_key(input_key_id_local);
@@ -206,6 +337,12 @@ psa_status_t tfm_builtin_key_loader_init(void)
     psa_algorithm_t algorithm;
     psa_key_type_t type;
 
+#if CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM > 0
+    /* Keys derived from previously loaded material must not be used anymore */
+    derived_key_cache_flush();
+    g_derived_key_lcs = PLAT_OTP_LCS_UNKNOWN;
+#endif /* CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM > 0 */
+
     for (size_t key = 0; key < number_of_keys; key++) {
         if (desc_table[key].lifetime != TFM_BUILTIN_KEY_LOADER_LIFETIME) {
             /* If the key is not bound to this driver, just don't load it */
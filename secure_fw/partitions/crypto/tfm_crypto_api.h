@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -92,6 +92,20 @@ psa_status_t tfm_crypto_operation_release(uint32_t *handle);
 psa_status_t tfm_crypto_operation_lookup(enum tfm_crypto_operation_type type,
                                          uint32_t handle,
                                          void **ctx);
+/**
+ * \brief Report how many operation contexts of a type are in use, and the
+ *        highest number that has been in use at once since initialisation.
+ *        This is meant to help sizing the context pools.
+ *
+ * \param[in]  type       Type of the operation contexts
+ * \param[out] in_use     Number of contexts currently in use
+ * \param[out] high_water Highest number of contexts in use at once
+ *
+ * \return Return values as described in \ref psa_status_t
+ */
+psa_status_t tfm_crypto_operation_usage(enum tfm_crypto_operation_type type,
+                                        uint32_t *in_use,
+                                        uint32_t *high_water);
 /**
  * \brief This function acts as interface for the Key management module
  *
@@ -4,7 +4,9 @@
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
+#include <stdbool.h>
 #include <string.h>
+#include "config_tfm.h"
 #include "psa/crypto.h"
 #include "psa/error.h"
 #include "tfm_sp_log.h"
@@ -44,6 +46,21 @@ typedef struct tfm_fwu_mcuboot_ctx_s {
 
     /* The size of the downloaded data in the FWU process. */
     size_t loaded_size;
+
+    /* The size from the start of the flash area which has been erased in the
+     * FWU process, in whole sectors.
+     */
+    uint32_t erased_size;
+
+    /* The running hash of the downloaded data. It is only kept while the
+     * blocks are written in order from the start of the image.
+     */
+    psa_hash_operation_t hash_op;
+    bool hash_running;
+
+    /* The digest of the downloaded data, valid when digest_size is not 0. */
+    uint8_t digest[TFM_FWU_MAX_DIGEST_SIZE];
+    size_t digest_size;
 } tfm_fwu_mcuboot_ctx_t;
 
 static tfm_fwu_mcuboot_ctx_t mcuboot_ctx[FWU_COMPONENT_NUMBER];
@@ -103,6 +120,209 @@ psa_status_t fwu_bootloader_init(void)
     return PSA_SUCCESS;
 }
 
+#if FWU_SKIP_BLANK_SECTOR_ERASE
+static bool is_area_blank(const struct flash_area *fap, uint32_t off,
+                          uint32_t len)
+{
+    uint8_t buf[BOOT_TMPBUF_SZ];
+    uint8_t erased_val = flash_area_erased_val(fap);
+    uint32_t blk_sz;
+    uint32_t i;
+
+    while (len > 0) {
+        blk_sz = (len > sizeof(buf)) ? sizeof(buf) : len;
+        if (flash_area_read(fap, off, buf, blk_sz) != 0) {
+            return false;
+        }
+        for (i = 0; i < blk_sz; i++) {
+            if (buf[i] != erased_val) {
+                return false;
+            }
+        }
+        off += blk_sz;
+        len -= blk_sz;
+    }
+
+    return true;
+}
+#endif /* FWU_SKIP_BLANK_SECTOR_ERASE */
+
+static psa_status_t erase_sector(const struct flash_area *fap,
+                                 const struct flash_sector *sector)
+{
+#if FWU_SKIP_BLANK_SECTOR_ERASE
+    if (is_area_blank(fap, sector->fs_off, sector->fs_size)) {
+        return PSA_SUCCESS;
+    }
+#endif
+
+    if (flash_area_erase(fap, sector->fs_off, sector->fs_size) != 0) {
+        LOG_ERRFMT("TFM FWU: erasing flash failed.\r\n");
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+
+    return PSA_SUCCESS;
+}
+
+/* Erase the sectors of the staging area below the offset 'end' which are not
+ * erased yet. The staging area is erased progressively, ahead of the blocks
+ * written, rather than at once when the FWU process starts.
+ */
+static psa_status_t erase_staging_area(psa_fwu_component_t component,
+                                       size_t end)
+{
+    const struct flash_area *fap = mcuboot_ctx[component].fap;
+    struct flash_sector sector;
+    psa_status_t status;
+
+    if (end > flash_area_get_size(fap)) {
+        end = flash_area_get_size(fap);
+    }
+
+    while (mcuboot_ctx[component].erased_size < end) {
+        if (flash_area_get_sector(fap, mcuboot_ctx[component].erased_size,
+                                  &sector) != 0) {
+            return PSA_ERROR_STORAGE_FAILURE;
+        }
+
+        status = erase_sector(fap, &sector);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+
+        mcuboot_ctx[component].erased_size = sector.fs_off + sector.fs_size;
+    }
+
+    return PSA_SUCCESS;
+}
+
+#if FWU_ERASE_AHEAD_SECTORS > 0
+/* Erase the FWU_ERASE_AHEAD_SECTORS sectors following the sector which holds
+ * the end of the written data, so that the next blocks are written without
+ * waiting for their sectors to be erased.
+ */
+static psa_status_t erase_staging_area_ahead(psa_fwu_component_t component,
+                                             size_t written_end)
+{
+    const struct flash_area *fap = mcuboot_ctx[component].fap;
+    struct flash_sector sector;
+    uint32_t end = written_end;
+    uint32_t n = 0;
+
+    while ((n < FWU_ERASE_AHEAD_SECTORS) && (end < flash_area_get_size(fap))) {
+        if (flash_area_get_sector(fap, end, &sector) != 0) {
+            return PSA_ERROR_STORAGE_FAILURE;
+        }
+
+        /* A sector partly written is not ahead of the data */
+        if (sector.fs_off == end) {
+            n++;
+        }
+        end = sector.fs_off + sector.fs_size;
+    }
+
+    return erase_staging_area(component, end);
+}
+#endif /* FWU_ERASE_AHEAD_SECTORS > 0 */
+
+/* Size of the image trailer, as computed by boot_trailer_sz() of MCUboot,
+ * which is not built in the FWU partition. The largest write alignment is
+ * used, so the whole trailer is covered on any flash.
+ */
+static inline uint32_t boot_trailer_size(void)
+{
+    return /* Swap status for all sectors */
+           BOOT_STATUS_MAX_ENTRIES * BOOT_STATUS_STATE_COUNT * BOOT_MAX_ALIGN +
+#ifdef MCUBOOT_ENC_IMAGES
+#if MCUBOOT_SWAP_SAVE_ENCTLV
+           BOOT_ENC_TLV_ALIGN_SIZE * 2 +
+#else
+           BOOT_ENC_KEY_ALIGN_SIZE * 2 +
+#endif
+#endif
+           /* swap_type + copy_done + image_ok + swap_size */
+           BOOT_MAX_ALIGN * 4 +
+           BOOT_MAGIC_ALIGN_SIZE;
+}
+
+/* Erase the sectors of the image trailer which are not erased yet, before
+ * boot_set_pending_multi() writes it. The sectors between the end of the
+ * image and the trailer are not part of the image, so they are not erased.
+ */
+static psa_status_t erase_staging_trailer(psa_fwu_component_t component)
+{
+    const struct flash_area *fap = mcuboot_ctx[component].fap;
+    uint32_t size = flash_area_get_size(fap);
+    struct flash_sector sector;
+    psa_status_t status;
+    uint32_t off;
+
+    off = (boot_trailer_size() < size) ? (size - boot_trailer_size()) : 0;
+    if (off < mcuboot_ctx[component].erased_size) {
+        off = mcuboot_ctx[component].erased_size;
+    }
+
+    while (off < size) {
+        if (flash_area_get_sector(fap, off, &sector) != 0) {
+            return PSA_ERROR_STORAGE_FAILURE;
+        }
+
+        status = erase_sector(fap, &sector);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+
+        off = sector.fs_off + sector.fs_size;
+    }
+
+    return PSA_SUCCESS;
+}
+
+/* Stop the running hash of the component. The digest is then computed from
+ * the staging area when it is queried.
+ */
+static void running_hash_abort(psa_fwu_component_t component)
+{
+    if (mcuboot_ctx[component].hash_running) {
+        (void)psa_hash_abort(&mcuboot_ctx[component].hash_op);
+        mcuboot_ctx[component].hash_running = false;
+    }
+}
+
+/* Store the digest of the running hash in the context. The running hash is
+ * ended if 'release' is true, otherwise it is kept for the next blocks.
+ */
+static void running_hash_digest(psa_fwu_component_t component, bool release)
+{
+    tfm_fwu_mcuboot_ctx_t *ctx = &mcuboot_ctx[component];
+    psa_hash_operation_t clone_op = psa_hash_operation_init();
+    psa_hash_operation_t *op = &ctx->hash_op;
+    psa_status_t status;
+
+    if (!ctx->hash_running || (ctx->digest_size != 0)) {
+        if (release) {
+            running_hash_abort(component);
+        }
+        return;
+    }
+
+    if (release) {
+        ctx->hash_running = false;
+    } else {
+        if (psa_hash_clone(&ctx->hash_op, &clone_op) != PSA_SUCCESS) {
+            return;
+        }
+        op = &clone_op;
+    }
+
+    status = psa_hash_finish(op, ctx->digest, sizeof(ctx->digest),
+                             &ctx->digest_size);
+    if (status != PSA_SUCCESS) {
+        (void)psa_hash_abort(op);
+        ctx->digest_size = 0;
+    }
+}
+
 psa_status_t fwu_bootloader_staging_area_init(psa_fwu_component_t component,
                                               const void *manifest,
                                               size_t manifest_size)
@@ -120,16 +340,23 @@ psa_status_t fwu_bootloader_staging_area_init(psa_fwu_component_t component,
         return PSA_ERROR_STORAGE_FAILURE;
     }
 
-    if (flash_area_erase(fap, 0, fap->fa_size) != 0) {
-        LOG_ERRFMT("TFM FWU: erasing flash failed.\r\n");
-        return PSA_ERROR_GENERIC_ERROR;
-    }
-
     mcuboot_ctx[component].fap = fap;
 
     /* Reset the loaded_size. */
     mcuboot_ctx[component].loaded_size = 0;
 
+    /* The sectors are erased when the blocks are written. */
+    mcuboot_ctx[component].erased_size = 0;
+
+    /* The blocks are hashed when they are written. */
+    running_hash_abort(component);
+    mcuboot_ctx[component].digest_size = 0;
+    mcuboot_ctx[component].hash_op = psa_hash_operation_init();
+    if (psa_hash_setup(&mcuboot_ctx[component].hash_op,
+                       PSA_ALG_SHA_256) == PSA_SUCCESS) {
+        mcuboot_ctx[component].hash_running = true;
+    }
+
     return PSA_SUCCESS;
 }
 
@@ -139,6 +366,7 @@ psa_status_t fwu_bootloader_load_image(psa_fwu_component_t component,
                                        size_t block_size)
 {
     const struct flash_area *fap;
+    psa_status_t status;
 
     if ((block == NULL) || (component >= FWU_COMPONENT_NUMBER)) {
         return PSA_ERROR_INVALID_ARGUMENT;
@@ -151,13 +379,40 @@ psa_status_t fwu_bootloader_load_image(psa_fwu_component_t component,
         return PSA_ERROR_BAD_STATE;
     }
 
+    if (image_offset + block_size < image_offset) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    status = erase_staging_area(component, image_offset + block_size);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
     if (flash_area_write(fap, image_offset, block, block_size) != 0) {
         LOG_ERRFMT("TFM FWU: write flash failed.\r\n");
         return PSA_ERROR_STORAGE_FAILURE;
     }
 
+    /* Hash the block if it follows the data already hashed. Otherwise the
+     * digest is computed from the staging area when it is queried.
+     */
+    mcuboot_ctx[component].digest_size = 0;
+    if (mcuboot_ctx[component].hash_running) {
+        if ((image_offset != mcuboot_ctx[component].loaded_size) ||
+            (psa_hash_update(&mcuboot_ctx[component].hash_op,
+                             block, block_size) != PSA_SUCCESS)) {
+            running_hash_abort(component);
+        }
+    }
+
     /* The overflow check has been done in flash_area_write. */
     mcuboot_ctx[component].loaded_size += block_size;
+
+#if FWU_ERASE_AHEAD_SECTORS > 0
+    /* The block is written, a failed erase is retried with the next block. */
+    (void)erase_staging_area_ahead(component, image_offset + block_size);
+#endif
+
     return PSA_SUCCESS;
 }
 
@@ -322,6 +577,22 @@ psa_status_t fwu_bootloader_install_image(const psa_fwu_component_t *candidates,
     }
 #endif
 
+    /* Erase the image trailers. No more blocks are written, so the running
+     * hashes are ended as well.
+     */
+    for (cand_index = 0; cand_index < number; cand_index++) {
+        psa_fwu_component_t candidate = candidates[cand_index];
+
+        if ((candidate >= FWU_COMPONENT_NUMBER) ||
+            (mcuboot_ctx[candidate].fap == NULL)) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        running_hash_digest(candidate, true);
+        if (erase_staging_trailer(candidate) != PSA_SUCCESS) {
+            return PSA_ERROR_STORAGE_FAILURE;
+        }
+    }
+
     /* Write the boot magic in image trailer so that these images will be
      * taken as candidates.
      */
@@ -496,6 +767,8 @@ psa_status_t fwu_bootloader_abort(psa_fwu_component_t component)
     flash_area_close(fap);
     mcuboot_ctx[component].fap = NULL;
     mcuboot_ctx[component].loaded_size = 0;
+    running_hash_abort(component);
+    mcuboot_ctx[component].digest_size = 0;
     return PSA_SUCCESS;
 }
 
@@ -559,6 +832,15 @@ static psa_status_t get_second_image_digest(psa_fwu_component_t component,
     } else {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
+
+    /* Use the running hash when the data was written in order. */
+    running_hash_digest(component, false);
+    if (mcuboot_ctx[component].digest_size != 0) {
+        memcpy(info->impl.candidate_digest, mcuboot_ctx[component].digest,
+               mcuboot_ctx[component].digest_size);
+        return PSA_SUCCESS;
+    }
+
     if ((flash_area_open(FLASH_AREA_IMAGE_SECONDARY(component),
                             &fap)) != 0) {
         LOG_ERRFMT("TFM FWU: opening flash failed.\r\n");
@@ -664,6 +946,8 @@ psa_status_t fwu_bootloader_clean_component(psa_fwu_component_t component)
             return PSA_ERROR_STORAGE_FAILURE;
         }
         mcuboot_ctx[component].fap = NULL;
+        running_hash_abort(component);
+        mcuboot_ctx[component].digest_size = 0;
     } else {
         return PSA_ERROR_DOES_NOT_EXIST;
     }
@@ -11,6 +11,19 @@
 #include "tfm_hal_device_header.h"
 #include "fih.h"
 #include "psa/service.h"
+#ifdef CONFIG_TFM_SPM_LOG_DEFERRED
+#include "service_api.h"
+#endif
+
+/* Output the deferred log while nothing else is runnable */
+static inline void idle_drain_log(void)
+{
+#ifdef CONFIG_TFM_SPM_LOG_DEFERRED
+    while ((tfm_core_log_deferred_drain() != 0) &&
+           (psa_wait(PSA_WAIT_ANY, PSA_POLL) == 0)) {
+    }
+#endif
+}
 
 void tfm_idle_thread(void)
 {
@@ -21,6 +34,7 @@ void tfm_idle_thread(void)
          * It does not expect any signals.
          */
         if (psa_wait(PSA_WAIT_ANY, PSA_POLL) == 0) {
+            idle_drain_log();
             __DSB();
             __WFI();
         }
@@ -40,6 +54,7 @@ void tfm_idle_thread(void)
          * It does not expect any signals.
          */
         if (psa_wait(PSA_WAIT_ANY, PSA_POLL) == 0) {
+            idle_drain_log();
             __DSB();
             __WFI();
         }
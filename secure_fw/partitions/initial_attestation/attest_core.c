@@ -5,6 +5,7 @@
  *
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <stddef.h>
@@ -60,15 +61,6 @@ error_mapping_to_psa_status_t(enum psa_attest_err_t attest_err)
     }
 }
 
-psa_status_t attest_init(void)
-{
-    enum psa_attest_err_t res;
-
-    res = attest_boot_data_init();
-
-    return error_mapping_to_psa_status_t(res);
-}
-
 /*!
  * \brief Static function to map return values between \ref attest_token_err_t
  *        and \ref psa_attest_err_t
@@ -491,11 +483,19 @@ static enum psa_attest_err_t attest_verify_challenge_size(size_t challenge_size)
 static enum psa_attest_err_t attest_get_t_cose_algorithm(
         int32_t *cose_algorithm_id)
 {
+    /* The IAK doesn't change, the algorithm is looked up only once */
+    static int32_t iak_cose_algorithm_id;
+    static bool iak_cose_algorithm_valid;
     psa_status_t status;
     psa_key_attributes_t attr;
     psa_key_handle_t handle = TFM_BUILTIN_KEY_ID_IAK;
     psa_key_type_t key_type;
 
+    if (iak_cose_algorithm_valid) {
+        *cose_algorithm_id = iak_cose_algorithm_id;
+        return PSA_ATTEST_ERR_SUCCESS;
+    }
+
     status = psa_get_key_attributes(handle, &attr);
     if (status != PSA_SUCCESS) {
         return PSA_ATTEST_ERR_GENERAL;
@@ -540,41 +540,264 @@ static enum psa_attest_err_t attest_get_t_cose_algorithm(
         return PSA_ATTEST_ERR_GENERAL;
     }
 
+    iak_cose_algorithm_id = *cose_algorithm_id;
+    iak_cose_algorithm_valid = true;
+
     return PSA_ATTEST_ERR_SUCCESS;
 }
 
+/*
+ * Without the Measured Boot partition, the SW components are read from the
+ * boot data received at boot, so they don't change afterwards.
+ */
+#ifdef TFM_PARTITION_MEASURED_BOOT
+#define ATTEST_SW_COMPONENTS_STATIC false
+#else
+#define ATTEST_SW_COMPONENTS_STATIC true
+#endif
+
+/*!
+ * \struct attest_claim_t
+ *
+ * \brief A claim of the token, and whether its value is the same in all the
+ *        tokens until the next boot.
+ */
+struct attest_claim_t {
+    enum psa_attest_err_t (*add_claim)(struct attest_token_encode_ctx *);
+    bool is_static;
+};
+
 #if ATTEST_TOKEN_PROFILE_PSA_IOT_1 || ATTEST_TOKEN_PROFILE_PSA_2_0_0
-    static enum psa_attest_err_t
-    (*claim_query_funcs[])(struct attest_token_encode_ctx *) = {
-        &attest_add_boot_seed_claim,
-        &attest_add_instance_id_claim,
-        &attest_add_implementation_id_claim,
-        &attest_add_caller_id_claim,
-        &attest_add_security_lifecycle_claim,
-        &attest_add_all_sw_components,
-        &attest_add_profile_definition,
+static const struct attest_claim_t claims[] = {
+    {&attest_add_boot_seed_claim,          true},
+    {&attest_add_instance_id_claim,        true},
+    {&attest_add_implementation_id_claim,  true},
+    {&attest_add_caller_id_claim,          false},
+    {&attest_add_security_lifecycle_claim, false},
+    {&attest_add_all_sw_components,        ATTEST_SW_COMPONENTS_STATIC},
+    {&attest_add_profile_definition,       true},
 #if ATTEST_INCLUDE_OPTIONAL_CLAIMS
-        &attest_add_verification_service,
-        &attest_add_cert_ref_claim
+    {&attest_add_verification_service,     true},
+    {&attest_add_cert_ref_claim,           true},
 #endif
-    };
+};
 #elif ATTEST_TOKEN_PROFILE_ARM_CCA
-
-    static enum psa_attest_err_t
-    (*claim_query_funcs[])(struct attest_token_encode_ctx *) = {
-        &attest_add_instance_id_claim,
-        &attest_add_implementation_id_claim,
-        &attest_add_security_lifecycle_claim,
-        &attest_add_all_sw_components,
-        &attest_add_profile_definition,
-        &attest_add_hash_algo_claim,
-        &attest_add_platform_config_claim,
+static const struct attest_claim_t claims[] = {
+    {&attest_add_instance_id_claim,        true},
+    {&attest_add_implementation_id_claim,  true},
+    {&attest_add_security_lifecycle_claim, false},
+    {&attest_add_all_sw_components,        ATTEST_SW_COMPONENTS_STATIC},
+    {&attest_add_profile_definition,       true},
+    {&attest_add_hash_algo_claim,          true},
+    {&attest_add_platform_config_claim,    true},
 #if ATTEST_INCLUDE_OPTIONAL_CLAIMS
-        &attest_add_verification_service,
+    {&attest_add_verification_service,     true},
 #endif
-    };
+};
 #endif
 
+#if ATTEST_STATIC_CLAIMS_BUF_SIZE > 0
+/*!
+ * \struct attest_static_claim_t
+ *
+ * \brief The encoded value of a static claim, in static_claims_buf
+ */
+struct attest_static_claim_t {
+    int32_t label;
+    uint32_t offset;
+    uint32_t len;       /* 0 if the claim is not in the token */
+};
+
+/*
+ * The static claims are encoded once at init, then copied in each token
+ * instead of being read and encoded again. If they could not be encoded, as
+ * they don't fit or one is not available, they are encoded in each token as
+ * the others.
+ */
+static uint8_t static_claims_buf[ATTEST_STATIC_CLAIMS_BUF_SIZE];
+static struct attest_static_claim_t static_claims[ARRAY_LENGTH(claims)];
+static bool static_claims_valid;
+/* Size of all the encoded static claims, labels included */
+static size_t static_claims_len;
+
+/*!
+ * \brief Static function to decode the label of a claim, encoded as a CBOR
+ *        integer
+ *
+ * \param[in]  encoded    The encoded label, followed by the value
+ * \param[out] label      The label
+ * \param[out] label_len  Size of the encoded label
+ *
+ * \return Returns error code as specified in \ref psa_attest_err_t
+ */
+static enum psa_attest_err_t
+attest_decode_claim_label(struct q_useful_buf_c encoded,
+                          int32_t *label, size_t *label_len)
+{
+    const uint8_t *p = encoded.ptr;
+    uint8_t major_type;
+    uint8_t info;
+    uint32_t value = 0;
+    size_t i;
+
+    if (encoded.len == 0) {
+        return PSA_ATTEST_ERR_GENERAL;
+    }
+
+    major_type = p[0] >> 5;
+    info = p[0] & 0x1F;
+
+    if (info < 24) {
+        value = info;
+        *label_len = 1;
+    } else if (info <= 26) {
+        /* 1, 2 or 4 bytes follow, in big endian */
+        *label_len = 1 + (1 << (info - 24));
+        if (encoded.len < *label_len) {
+            return PSA_ATTEST_ERR_GENERAL;
+        }
+        for (i = 1; i < *label_len; i++) {
+            value = (value << 8) | p[i];
+        }
+    } else {
+        return PSA_ATTEST_ERR_GENERAL;
+    }
+
+    /* The labels are int32_t, encoded as unsigned or negative integers */
+    if (value > INT32_MAX) {
+        return PSA_ATTEST_ERR_GENERAL;
+    }
+    if (major_type == 0) {
+        *label = (int32_t)value;
+    } else if (major_type == 1) {
+        *label = -1 - (int32_t)value;
+    } else {
+        return PSA_ATTEST_ERR_GENERAL;
+    }
+
+    return PSA_ATTEST_ERR_SUCCESS;
+}
+
+/*!
+ * \brief Static function to encode a static claim into static_claims_buf
+ *
+ * \param[in]     idx   Index of the claim in claims[]
+ * \param[in,out] used  Bytes used in static_claims_buf
+ *
+ * \return Returns error code as specified in \ref psa_attest_err_t
+ */
+static enum psa_attest_err_t attest_encode_static_claim(size_t idx,
+                                                        size_t *used)
+{
+    struct attest_token_encode_ctx encode_ctx;
+    struct q_useful_buf out_buf;
+    struct q_useful_buf_c encoded;
+    struct q_useful_buf_c label;
+    enum attest_token_err_t token_err;
+    enum psa_attest_err_t attest_err;
+    size_t label_len;
+
+    out_buf.ptr = &static_claims_buf[*used];
+    out_buf.len = sizeof(static_claims_buf) - *used;
+
+    /* The claim is encoded in a map of its own, holding at most the claim */
+    attest_token_encode_claims_start(&encode_ctx, &out_buf);
+
+    attest_err = claims[idx].add_claim(&encode_ctx);
+    if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
+        return attest_err;
+    }
+
+    token_err = attest_token_encode_claims_finish(&encode_ctx, &encoded);
+    if (token_err != ATTEST_TOKEN_ERR_SUCCESS) {
+        return error_mapping_to_psa_attest_err_t(token_err);
+    }
+
+    *used += encoded.len;
+
+    /* Map of 0 or 1 pair, which has a one byte header */
+    if (((const uint8_t *)encoded.ptr)[0] == 0xA0) {
+        static_claims[idx].len = 0;
+        return PSA_ATTEST_ERR_SUCCESS;
+    } else if (((const uint8_t *)encoded.ptr)[0] != 0xA1) {
+        return PSA_ATTEST_ERR_GENERAL;
+    }
+
+    label.ptr = (const uint8_t *)encoded.ptr + 1;
+    label.len = encoded.len - 1;
+    attest_err = attest_decode_claim_label(label, &static_claims[idx].label,
+                                           &label_len);
+    if ((attest_err != PSA_ATTEST_ERR_SUCCESS) || (label.len <= label_len)) {
+        return PSA_ATTEST_ERR_GENERAL;
+    }
+
+    static_claims[idx].offset = (uint32_t)((const uint8_t *)label.ptr +
+                                           label_len - static_claims_buf);
+    static_claims[idx].len = (uint32_t)(label.len - label_len);
+    static_claims_len += label.len;
+
+    return PSA_ATTEST_ERR_SUCCESS;
+}
+
+/*!
+ * \brief Static function to encode all the static claims in advance
+ */
+static void attest_encode_static_claims(void)
+{
+    size_t used = 0;
+    size_t i;
+
+    static_claims_valid = false;
+    static_claims_len = 0;
+
+    for (i = 0; i < ARRAY_LENGTH(claims); ++i) {
+        if (claims[i].is_static &&
+            attest_encode_static_claim(i, &used) != PSA_ATTEST_ERR_SUCCESS) {
+            LOG_DBGFMT("[DBG][Attest] Static claims encoded in each token\r\n");
+            return;
+        }
+    }
+
+    static_claims_valid = true;
+}
+
+/*!
+ * \brief Static function to add a static claim encoded in advance to the
+ *        attestation token.
+ *
+ * \param[in]  token_ctx  Token encoding context
+ * \param[in]  idx        Index of the claim in claims[]
+ */
+static void attest_add_static_claim(struct attest_token_encode_ctx *token_ctx,
+                                    size_t idx)
+{
+    struct q_useful_buf_c encoded;
+
+    if (static_claims[idx].len == 0) {
+        return;
+    }
+
+    encoded.ptr = &static_claims_buf[static_claims[idx].offset];
+    encoded.len = static_claims[idx].len;
+    attest_token_encode_add_cbor(token_ctx, static_claims[idx].label, &encoded);
+}
+#endif /* ATTEST_STATIC_CLAIMS_BUF_SIZE > 0 */
+
+psa_status_t attest_init(void)
+{
+    enum psa_attest_err_t res;
+
+    res = attest_boot_data_init();
+
+#if ATTEST_STATIC_CLAIMS_BUF_SIZE > 0
+    if (res == PSA_ATTEST_ERR_SUCCESS) {
+        attest_encode_static_claims();
+    }
+#endif
+
+    return error_mapping_to_psa_status_t(res);
+}
+
 /*!
  * \brief Static function to create the initial attestation token
  *
@@ -623,9 +846,15 @@ attest_create_token(struct q_useful_buf_c *challenge,
         goto error;
     }
 
-    for (i = 0; i < ARRAY_LENGTH(claim_query_funcs); ++i) {
+    for (i = 0; i < ARRAY_LENGTH(claims); ++i) {
+#if ATTEST_STATIC_CLAIMS_BUF_SIZE > 0
+        if (claims[i].is_static && static_claims_valid) {
+            attest_add_static_claim(&attest_token_ctx, i);
+            continue;
+        }
+#endif
         /* Calling the attest_add_XXX_claim functions */
-        attest_err = claim_query_funcs[i](&attest_token_ctx);
+        attest_err = claims[i].add_claim(&attest_token_ctx);
         if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
             goto error;
         }
@@ -641,6 +870,145 @@ error:
     return attest_err;
 }
 
+#if ATTEST_STATIC_CLAIMS_BUF_SIZE > 0
+/*!
+ * \brief Static function to get the size of the CBOR head of an item
+ *
+ * \param[in]  value  The length or the value of the item
+ *
+ * \return Returns the size of the head in bytes
+ */
+static size_t attest_cbor_head_size(size_t value)
+{
+    if (value < 24) {
+        return 1;
+    } else if (value <= UINT8_MAX) {
+        return 2;
+    } else if (value <= UINT16_MAX) {
+        return 3;
+    }
+
+    return 5;
+}
+
+/*!
+ * \brief Static function to get the size of a token without its payload, nor
+ *        the head of the byte string holding the payload. It only depends on
+ *        the attestation key, so it is computed once.
+ *
+ * \param[out] size  Size of the token without the payload
+ *
+ * \return Returns error code as specified in \ref psa_attest_err_t
+ */
+static enum psa_attest_err_t attest_get_token_envelope_size(size_t *size)
+{
+    static size_t envelope_size;
+    enum attest_token_err_t token_err;
+    enum psa_attest_err_t attest_err;
+    struct attest_token_encode_ctx attest_token_ctx;
+    struct q_useful_buf token;
+    struct q_useful_buf_c completed_token;
+    int32_t cose_algorithm_id;
+
+    if (envelope_size != 0) {
+        *size = envelope_size;
+        return PSA_ATTEST_ERR_SUCCESS;
+    }
+
+    attest_err = attest_get_t_cose_algorithm(&cose_algorithm_id);
+    if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
+        return attest_err;
+    }
+
+    /* Special value to get the size of the token, but token is not created */
+    token.ptr = NULL;
+    token.len = INT32_MAX;
+
+    /* A token without claims */
+    token_err = attest_token_encode_start(&attest_token_ctx, 0,
+                                          cose_algorithm_id, &token);
+    if (token_err != ATTEST_TOKEN_ERR_SUCCESS) {
+        return error_mapping_to_psa_attest_err_t(token_err);
+    }
+
+    token_err = attest_token_encode_finish(&attest_token_ctx, &completed_token);
+    if (token_err != ATTEST_TOKEN_ERR_SUCCESS) {
+        return error_mapping_to_psa_attest_err_t(token_err);
+    }
+
+    /* Remove the payload, an empty map, and the head of its byte string */
+    envelope_size = completed_token.len - 2;
+    *size = envelope_size;
+
+    return PSA_ATTEST_ERR_SUCCESS;
+}
+
+/*!
+ * \brief Static function to compute the size of the token without creating
+ *        it. Only the claims that are not static are encoded, to get their
+ *        size.
+ *
+ * \param[in]  challenge_size  Size of the challenge
+ * \param[out] token_size      Size of the token
+ *
+ * \return Returns error code as specified in \ref psa_attest_err_t
+ */
+static enum psa_attest_err_t
+attest_compute_token_size(size_t challenge_size, size_t *token_size)
+{
+    enum attest_token_err_t token_err;
+    enum psa_attest_err_t attest_err;
+    struct attest_token_encode_ctx claims_ctx;
+    struct q_useful_buf claims_buf;
+    struct q_useful_buf_c challenge;
+    struct q_useful_buf_c encoded;
+    size_t envelope_size;
+    size_t payload_size;
+    size_t i;
+
+    attest_err = attest_get_token_envelope_size(&envelope_size);
+    if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
+        return attest_err;
+    }
+
+    /* Only the size of the challenge and claims is needed */
+    challenge.ptr = NULL;
+    challenge.len = challenge_size;
+    claims_buf.ptr = NULL;
+    claims_buf.len = INT32_MAX;
+
+    attest_token_encode_claims_start(&claims_ctx, &claims_buf);
+
+    attest_err = attest_add_nonce_claim(&claims_ctx, &challenge);
+    if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
+        return attest_err;
+    }
+
+    for (i = 0; i < ARRAY_LENGTH(claims); ++i) {
+        if (!claims[i].is_static) {
+            attest_err = claims[i].add_claim(&claims_ctx);
+            if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
+                return attest_err;
+            }
+        }
+    }
+
+    token_err = attest_token_encode_claims_finish(&claims_ctx, &encoded);
+    if (token_err != ATTEST_TOKEN_ERR_SUCCESS) {
+        return error_mapping_to_psa_attest_err_t(token_err);
+    }
+
+    /* The head of the payload map is one byte with or without the static
+     * claims, as there are less than 24 claims in total.
+     */
+    payload_size = encoded.len + static_claims_len;
+    *token_size = envelope_size + attest_cbor_head_size(payload_size) +
+                  payload_size;
+
+    return PSA_ATTEST_ERR_SUCCESS;
+}
+#endif /* ATTEST_STATIC_CLAIMS_BUF_SIZE > 0 */
+
 psa_status_t
 initial_attest_get_token(const void *challenge_buf, size_t challenge_size,
                          void *token_buf, size_t token_buf_size,
@@ -698,6 +1066,14 @@ initial_attest_get_token_size(size_t challenge_size, size_t *token_size)
         goto error;
     }
 
+#if ATTEST_STATIC_CLAIMS_BUF_SIZE > 0
+    /* With the static claims encoded, their size is known */
+    if (static_claims_valid && (ARRAY_LENGTH(claims) + 1 < 24)) {
+        attest_err = attest_compute_token_size(challenge_size, token_size);
+        return error_mapping_to_psa_status_t(attest_err);
+    }
+#endif
+
     attest_err = attest_create_token(&challenge, &token, &completed_token);
     if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
         goto error;
@@ -167,6 +167,34 @@ attest_token_encode_start(struct attest_token_encode_ctx *me,
 QCBOREncodeContext *
 attest_token_encode_borrow_cbor_cntxt(struct attest_token_encode_ctx *me);
 
+/**
+ * \brief Start encoding claims alone, outside of a token
+ *
+ * \param[in] me       Token creation context.
+ * \param[out] out_buf The output buffer to write the encoded claims into.
+ *
+ * The claims added to the context afterwards with the
+ * \c attest_token_encode_add_XXX() methods are encoded as a CBOR map
+ * in \c out_buf. Nothing is signed, so this can be used to encode
+ * claims in advance, to be added later to a token with
+ * attest_token_encode_add_cbor().
+ */
+void attest_token_encode_claims_start(struct attest_token_encode_ctx *me,
+                                      const struct q_useful_buf *out_buf);
+
+/**
+ * \brief Finish encoding claims started with
+ *        attest_token_encode_claims_start()
+ *
+ * \param[in] me               Token creation context.
+ * \param[out] encoded_claims  Pointer and length of the encoded map.
+ *
+ * \return one of the \ref attest_token_err_t errors.
+ */
+enum attest_token_err_t
+attest_token_encode_claims_finish(struct attest_token_encode_ctx *me,
+                                  struct q_useful_buf_c *encoded_claims);
+
 /**
  * \brief Add a 64-bit signed integer claim
  *
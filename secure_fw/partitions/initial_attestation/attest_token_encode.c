@@ -321,6 +321,39 @@ attest_token_encode_borrow_cbor_cntxt(struct attest_token_encode_ctx *me)
 }
 
 
+/*
+ * Public function. See attest_token.h
+ */
+void attest_token_encode_claims_start(struct attest_token_encode_ctx *me,
+                                      const struct q_useful_buf *out_buf)
+{
+    QCBOREncode_Init(&(me->cbor_enc_ctx), *out_buf);
+    QCBOREncode_OpenMap(&(me->cbor_enc_ctx));
+}
+
+
+/*
+ * Public function. See attest_token.h
+ */
+enum attest_token_err_t
+attest_token_encode_claims_finish(struct attest_token_encode_ctx *me,
+                                  struct q_useful_buf_c *encoded_claims)
+{
+    QCBORError qcbor_result;
+
+    QCBOREncode_CloseMap(&(me->cbor_enc_ctx));
+
+    qcbor_result = QCBOREncode_Finish(&(me->cbor_enc_ctx), encoded_claims);
+    if (qcbor_result == QCBOR_ERR_BUFFER_TOO_SMALL) {
+        return ATTEST_TOKEN_ERR_TOO_SMALL;
+    } else if (qcbor_result != QCBOR_SUCCESS) {
+        return ATTEST_TOKEN_ERR_CBOR_FORMATTING;
+    }
+
+    return ATTEST_TOKEN_ERR_SUCCESS;
+}
+
+
 /*
  * Public function. See attest_token.h
  */
@@ -17,6 +17,9 @@
 uint8_t its_block_data[ITS_RAM_FS_SIZE];
 
 #elif (TFM_HAL_ITS_PROGRAM_UNIT > 16)
+#if ITS_APPEND_IN_PLACE
+#error "ITS_APPEND_IN_PLACE is not supported with NAND flash"
+#endif
 #ifndef ITS_FLASH_NAND_BUF_SIZE
 #error "ITS_FLASH_NAND_BUF_SIZE must be defined by the target in flash_layout.h"
 #endif
@@ -40,6 +43,9 @@ struct its_flash_nand_dev_t its_flash_nand_dev = {
 uint8_t ps_block_data[PS_RAM_FS_SIZE];
 
 #elif (TFM_HAL_PS_PROGRAM_UNIT > 16)
+#if ITS_APPEND_IN_PLACE
+#error "ITS_APPEND_IN_PLACE is not supported with NAND flash"
+#endif
 #ifndef PS_FLASH_NAND_BUF_SIZE
 #error "PS_FLASH_NAND_BUF_SIZE must be defined by the target in flash_layout.h"
 #endif
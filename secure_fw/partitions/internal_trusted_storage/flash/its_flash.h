@@ -26,6 +26,7 @@ extern uint8_t its_block_data[ITS_RAM_FS_SIZE];
 #define ITS_FLASH_DEV its_block_data
 #define ITS_FLASH_ALIGNMENT 1
 #define ITS_FLASH_OPS its_flash_fs_ops_ram
+#define ITS_FLASH_REPROGRAM_ERASED 1
 
 #elif (TFM_HAL_ITS_PROGRAM_UNIT > 16)
 /* NAND flash: each filesystem block is buffered and then programmed in one
@@ -36,6 +37,7 @@ extern struct its_flash_nand_dev_t its_flash_nand_dev;
 #define ITS_FLASH_DEV its_flash_nand_dev
 #define ITS_FLASH_ALIGNMENT 1
 #define ITS_FLASH_OPS its_flash_fs_ops_nand
+#define ITS_FLASH_REPROGRAM_ERASED 0
 
 #else
 /* NOR flash: no write buffering, require each file in the filesystem to be
@@ -45,6 +47,7 @@ extern struct its_flash_nand_dev_t its_flash_nand_dev;
 #define ITS_FLASH_DEV TFM_HAL_ITS_FLASH_DRIVER
 #define ITS_FLASH_ALIGNMENT TFM_HAL_ITS_PROGRAM_UNIT
 #define ITS_FLASH_OPS its_flash_fs_ops_nor
+#define ITS_FLASH_REPROGRAM_ERASED TFM_HAL_ITS_REPROGRAM_ERASED
 #endif
 
 /* Include the correct flash interface implementation for PS */
@@ -56,6 +59,7 @@ extern uint8_t ps_block_data[];
 #define PS_FLASH_DEV ps_block_data
 #define PS_FLASH_ALIGNMENT 1
 #define PS_FLASH_OPS its_flash_fs_ops_ram
+#define PS_FLASH_REPROGRAM_ERASED 1
 
 #elif (TFM_HAL_PS_PROGRAM_UNIT > 16)
 /* NAND flash: each filesystem block is buffered and then programmed in one
@@ -66,6 +70,7 @@ extern struct its_flash_nand_dev_t ps_flash_nand_dev;
 #define PS_FLASH_DEV ps_flash_nand_dev
 #define PS_FLASH_ALIGNMENT 1
 #define PS_FLASH_OPS its_flash_fs_ops_nand
+#define PS_FLASH_REPROGRAM_ERASED 0
 
 #else
 /* NOR flash: no write buffering, require each file in the filesystem to be
@@ -75,6 +80,7 @@ extern struct its_flash_nand_dev_t ps_flash_nand_dev;
 #define PS_FLASH_DEV TFM_HAL_PS_FLASH_DRIVER
 #define PS_FLASH_ALIGNMENT TFM_HAL_PS_PROGRAM_UNIT
 #define PS_FLASH_OPS its_flash_fs_ops_nor
+#define PS_FLASH_REPROGRAM_ERASED TFM_HAL_PS_REPROGRAM_ERASED
 #endif
 #else /* TFM_PARTITION_PROTECTED_STORAGE */
 #define PS_FLASH_ALIGNMENT 1
@@ -15,11 +15,6 @@
 #include "its_flash_fs_dblock.h"
 #include "its_utils.h"
 
-/* Filesystem-internal flags, which cannot be passed by the caller */
-#define ITS_FLASH_FS_INTERNAL_FLAGS_MASK  (UINT32_MAX - ((1U << 24) - 1))
-/* Flag that indicates the file is to be deleted in the next block update */
-#define ITS_FLASH_FS_FLAG_DELETE          (1U << 24)
-
 static psa_status_t its_flash_fs_delete_idx(struct its_flash_fs_ctx_t *fs_ctx,
                                             uint32_t del_file_idx);
 
@@ -29,16 +24,18 @@ static psa_status_t its_flash_fs_file_write_aligned_data(
                                       const struct its_file_meta_t *file_meta,
                                       size_t offset,
                                       size_t size,
-                                      const uint8_t *data)
+                                      const struct its_flash_fs_data_src_t *src)
 {
+    size_t aligned_size = size;
+
 #if (ITS_FLASH_MAX_ALIGNMENT != 1)
     /* Check that the offset is aligned with the flash program unit */
     if (!ITS_UTILS_IS_ALIGNED(offset, fs_ctx->cfg->program_unit)) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
-    /* Set the size to be aligned with the flash program unit */
-    size = ITS_UTILS_ALIGN(size, fs_ctx->cfg->program_unit);
+    /* The data is programmed up to the next flash program unit boundary */
+    aligned_size = ITS_UTILS_ALIGN(size, fs_ctx->cfg->program_unit);
 #endif
 
     /* It is not permitted to create gaps in the file */
@@ -47,15 +44,106 @@ static psa_status_t its_flash_fs_file_write_aligned_data(
     }
 
     /* Check that the new data is contained within the file's max size */
-    if (its_utils_check_contained_in(file_meta->max_size, offset, size)
+    if (its_utils_check_contained_in(file_meta->max_size, offset, aligned_size)
         != PSA_SUCCESS) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
     return its_flash_fs_dblock_write_file(fs_ctx, block_meta, file_meta, offset,
-                                          size, data);
+                                          size, src);
 }
 
+#if ITS_APPEND_IN_PLACE
+/**
+ * \brief Appends data to a file by programming it directly in the file's
+ *        current data block, instead of rewriting the block in the scratch
+ *        data block.
+ *
+ * \note The data is only appended in place if the file has been created with
+ *       the append flag, it is stored in a dedicated data block, and the
+ *       flash after the end of the file is still erased. The data is not
+ *       visible until the metadata block update which sets the new file size
+ *       completes.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in]     block_meta  Pointer to block meta to write data
+ * \param[in]     file_meta   Pointer to file meta to write data
+ * \param[in]     offset      Offset in the file to write data
+ * \param[in]     size        Size of the data to write
+ * \param[in]     src         Source of the data to write
+ *
+ * \return Returns PSA_ERROR_NOT_SUPPORTED if the data cannot be appended in
+ *         place, otherwise error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_file_append_in_place(
+                                      struct its_flash_fs_ctx_t *fs_ctx,
+                                      const struct its_block_meta_t *block_meta,
+                                      const struct its_file_meta_t *file_meta,
+                                      size_t offset,
+                                      size_t size,
+                                      const struct its_flash_fs_data_src_t *src)
+{
+    uint8_t erased_buf[ITS_UTILS_ALIGN(32, ITS_FLASH_MAX_ALIGNMENT)];
+    psa_status_t err;
+    size_t aligned_size = size;
+    size_t pos;
+    size_t bytes_to_check;
+    size_t i;
+    size_t j;
+
+    if (!fs_ctx->cfg->reprogram_erased ||
+        !(file_meta->flags & ITS_FLASH_FS_FLAG_APPEND) ||
+        (file_meta->lblock == ITS_LOGICAL_DBLOCK0) ||
+        (offset != file_meta->cur_size)) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+
+#if (ITS_FLASH_MAX_ALIGNMENT != 1)
+    /* Unaligned writes are rejected by the regular write path */
+    if (!ITS_UTILS_IS_ALIGNED(offset, fs_ctx->cfg->program_unit)) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+
+    /* The data is programmed up to the next flash program unit boundary */
+    aligned_size = ITS_UTILS_ALIGN(size, fs_ctx->cfg->program_unit);
+#endif
+
+    if (its_utils_check_contained_in(file_meta->max_size, offset, aligned_size)
+        != PSA_SUCCESS) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+
+    /* Check that the flash to program is still erased. It may not be if the
+     * data of a previous append was programmed, but a power failure prevented
+     * the file size from being updated.
+     */
+    pos = file_meta->data_idx + offset;
+    for (i = 0; i < aligned_size; i += bytes_to_check) {
+        bytes_to_check = ITS_UTILS_MIN(aligned_size - i, sizeof(erased_buf));
+
+        err = fs_ctx->ops->read(fs_ctx->cfg, block_meta->phy_id, erased_buf,
+                                pos + i, bytes_to_check);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        for (j = 0; j < bytes_to_check; j++) {
+            if (erased_buf[j] != fs_ctx->cfg->erase_val) {
+                return PSA_ERROR_NOT_SUPPORTED;
+            }
+        }
+    }
+
+    err = its_flash_fs_dblock_write_src(fs_ctx, block_meta->phy_id, pos, size,
+                                        src);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    return fs_ctx->ops->flush(fs_ctx->cfg, block_meta->phy_id);
+}
+#endif /* ITS_APPEND_IN_PLACE */
+
 /* TODO This is very similar to (static) its_num_active_dblocks() */
 static uint32_t its_flash_fs_num_active_dblocks(
                                         const struct its_flash_fs_config_t *cfg)
@@ -202,6 +290,20 @@ psa_status_t its_flash_fs_file_get_info(struct its_flash_fs_ctx_t *fs_ctx,
     psa_status_t err;
     uint32_t idx;
     struct its_file_meta_t tmp_metadata;
+#if ITS_RAM_INDEX && !defined(ITS_ENCRYPTION)
+    const struct its_flash_fs_index_entry_t *entry;
+
+    /* The file information is cached in the index, if it is available */
+    err = its_flash_fs_index_find(fs_ctx, fid, &entry);
+    if (err == PSA_SUCCESS) {
+        info->size_max = entry->max_size;
+        info->size_current = entry->cur_size;
+        info->flags = entry->flags & ITS_FLASH_FS_USER_FLAGS_MASK;
+        return PSA_SUCCESS;
+    } else if (err != PSA_ERROR_BAD_STATE) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+#endif
 
     /* Get the meta data index and meta data */
     err = its_flash_fs_mblock_get_file_idx_meta(fs_ctx, fid, &idx, &tmp_metadata);
@@ -220,12 +322,52 @@ psa_status_t its_flash_fs_file_get_info(struct its_flash_fs_ctx_t *fs_ctx,
     return PSA_SUCCESS;
 }
 
+/**
+ * \brief Gets the data of a flat buffer in a single part.
+ *
+ * \param[in,out] src_ctx    Pointer to the buffer pointer
+ * \param[in]     size       Size of the data still to be written
+ * \param[out]    data       Pointer to the next part of the data
+ * \param[out]    part_size  Size of the next part of the data
+ *
+ * \return Returns PSA_SUCCESS
+ */
+static psa_status_t its_flash_fs_read_buf(void *src_ctx, size_t size,
+                                          const uint8_t **data,
+                                          size_t *part_size)
+{
+    const uint8_t **buf = (const uint8_t **)src_ctx;
+
+    *data = *buf;
+    *part_size = size;
+    *buf += size;
+
+    return PSA_SUCCESS;
+}
+
 psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
                                      const uint8_t *fid,
                                      struct its_flash_fs_file_info_t *finfo,
                                      size_t data_size,
                                      size_t offset,
                                      const uint8_t *data)
+{
+    struct its_flash_fs_data_src_t src = {
+        .read = its_flash_fs_read_buf,
+        .ctx = (void *)&data,
+    };
+
+    return its_flash_fs_file_write_src(fs_ctx, fid, finfo, data_size, offset,
+                                       &src);
+}
+
+psa_status_t its_flash_fs_file_write_src(
+                                      struct its_flash_fs_ctx_t *fs_ctx,
+                                      const uint8_t *fid,
+                                      struct its_flash_fs_file_info_t *finfo,
+                                      size_t data_size,
+                                      size_t offset,
+                                      const struct its_flash_fs_data_src_t *src)
 {
     struct its_block_meta_t block_meta;
     struct its_file_meta_t file_meta = {0};
@@ -235,6 +377,7 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
     uint32_t old_idx = ITS_METADATA_INVALID_INDEX;
     uint32_t new_idx = ITS_METADATA_INVALID_INDEX;
     bool use_spare;
+    bool in_place = false;
 
     if (finfo == NULL) {
         return PSA_ERROR_INVALID_ARGUMENT;
@@ -314,11 +457,26 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
         }
     }
 
-    if (data_size != 0) {
+#if ITS_APPEND_IN_PLACE
+    if ((data_size != 0) && (new_idx == old_idx)) {
+        /* Program data appended to the file in place, if possible */
+        err = its_flash_fs_file_append_in_place(fs_ctx, &block_meta,
+                                                &file_meta, offset, data_size,
+                                                src);
+        if (err == PSA_SUCCESS) {
+            file_meta.cur_size = offset + data_size;
+            in_place = true;
+        } else if (err != PSA_ERROR_NOT_SUPPORTED) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+#endif
+
+    if ((data_size != 0) && !in_place) {
         /* Write the content into scratch data block */
         err = its_flash_fs_file_write_aligned_data(fs_ctx, &block_meta,
                                                    &file_meta, offset,
-                                                   data_size, data);
+                                                   data_size, src);
         if (err != PSA_SUCCESS) {
             return PSA_ERROR_GENERIC_ERROR;
         }
@@ -402,8 +560,18 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
         }
     }
 
+#if ITS_APPEND_IN_PLACE
+    /* Data appended in place has not been written to the scratch data block,
+     * so it does not need erasing. The flag only applies to this update.
+     */
+    fs_ctx->scratch_dblock_unused = in_place;
+#endif
+
     /* Write metadata header, swap metadata blocks and erase scratch blocks */
     err = its_flash_fs_mblock_meta_update_finalize(fs_ctx);
+#if ITS_APPEND_IN_PLACE
+    fs_ctx->scratch_dblock_unused = false;
+#endif
     if (err != PSA_SUCCESS) {
         return err;
     }
@@ -597,3 +765,754 @@ psa_status_t its_flash_fs_file_read(struct its_flash_fs_ctx_t *fs_ctx,
 
     return PSA_SUCCESS;
 }
+
+#if ITS_BATCH_COMMIT
+#if (ITS_BATCH_MAX_OPS > 32)
+#error "ITS_BATCH_MAX_OPS must not be greater than 32"
+#endif
+
+/*!
+ * \struct its_flash_fs_batch_plan_t
+ *
+ * \brief Structure to store the logical blocks updated by a batch. A batch can
+ *        update logical block 0 and at most one dedicated logical block, as
+ *        there is a single scratch data block.
+ */
+struct its_flash_fs_batch_plan_t {
+    uint32_t lblock;                  /*!< Dedicated logical block updated, or
+                                       *   ITS_BLOCK_INVALID_ID if there is none
+                                       */
+    bool lb0_updated;                 /*!< Logical block 0 is updated */
+    struct its_block_meta_t block_meta[2]; /*!< Metadata of logical block 0
+                                            *   and of the dedicated logical
+                                            *   block, after the update
+                                            */
+    size_t data_end[2];               /*!< End of the data in logical block 0
+                                       *   and in the dedicated logical block,
+                                       *   before the update
+                                       */
+};
+
+/**
+ * \brief Gets the staged operation on a file.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     fid     File ID
+ *
+ * \return Returns a pointer to the operation, or NULL if there is none.
+ */
+static struct its_flash_fs_batch_op_t *its_flash_fs_batch_find_op(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              const uint8_t *fid)
+{
+    uint32_t i;
+
+    for (i = 0; i < fs_ctx->batch.num_ops; i++) {
+        if (memcmp(fs_ctx->batch.ops[i].fid, fid, ITS_FILE_ID_SIZE) == 0) {
+            return &fs_ctx->batch.ops[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief Gets the staged operation on a file, adding a new one if the file
+ *        does not have one yet.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     fid     File ID
+ *
+ * \return Returns a pointer to the operation, or NULL if the batch is full.
+ */
+static struct its_flash_fs_batch_op_t *its_flash_fs_batch_get_op(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              const uint8_t *fid)
+{
+    struct its_flash_fs_batch_op_t *op;
+
+    op = its_flash_fs_batch_find_op(fs_ctx, fid);
+    if (op != NULL) {
+        return op;
+    }
+
+    if (fs_ctx->batch.num_ops == ITS_BATCH_MAX_OPS) {
+        return NULL;
+    }
+
+    op = &fs_ctx->batch.ops[fs_ctx->batch.num_ops++];
+    *op = (struct its_flash_fs_batch_op_t){0};
+    memcpy(op->fid, fid, ITS_FILE_ID_SIZE);
+
+    return op;
+}
+
+/**
+ * \brief Marks a logical block as updated by the batch and gets its metadata.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in,out] plan        Blocks updated by the batch
+ * \param[in]     lblock      Logical block number
+ * \param[out]    block_meta  Pointer to the metadata of the block in the plan
+ *
+ * \return Returns PSA_ERROR_NOT_SUPPORTED if the batch already updates another
+ *         dedicated logical block, otherwise error code as specified in
+ *         \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_batch_use_block(
+                                      struct its_flash_fs_ctx_t *fs_ctx,
+                                      struct its_flash_fs_batch_plan_t *plan,
+                                      uint32_t lblock,
+                                      struct its_block_meta_t **block_meta)
+{
+    psa_status_t err;
+
+    if (lblock == ITS_LOGICAL_DBLOCK0) {
+        plan->lb0_updated = true;
+        *block_meta = &plan->block_meta[0];
+        return PSA_SUCCESS;
+    }
+
+    if (plan->lblock == ITS_BLOCK_INVALID_ID) {
+        err = its_flash_fs_mblock_read_block_metadata(fs_ctx, lblock,
+                                                      &plan->block_meta[1]);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        plan->lblock = lblock;
+        plan->data_end[1] = fs_ctx->cfg->block_size
+                            - plan->block_meta[1].free_size;
+    } else if (plan->lblock != lblock) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+
+    *block_meta = &plan->block_meta[1];
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Reserves space for a file of the batch, in the first logical block
+ *        with enough free space.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in,out] plan    Blocks updated by the batch
+ * \param[in,out] op      Operation to reserve the space for
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_batch_reserve_space(
+                                         struct its_flash_fs_ctx_t *fs_ctx,
+                                         struct its_flash_fs_batch_plan_t *plan,
+                                         struct its_flash_fs_batch_op_t *op)
+{
+    struct its_block_meta_t tmp_block_meta;
+    struct its_block_meta_t *block_meta;
+    psa_status_t err;
+    uint32_t lblock = ITS_BLOCK_INVALID_ID;
+    uint32_t i;
+
+    if (plan->block_meta[0].free_size >= op->max_size) {
+        lblock = ITS_LOGICAL_DBLOCK0;
+    } else if ((plan->lblock != ITS_BLOCK_INVALID_ID) &&
+               (plan->block_meta[1].free_size >= op->max_size)) {
+        lblock = plan->lblock;
+    } else {
+        for (i = 1; i < its_flash_fs_num_active_dblocks(fs_ctx->cfg); i++) {
+            if (i == plan->lblock) {
+                continue;
+            }
+
+            err = its_flash_fs_mblock_read_block_metadata(fs_ctx, i,
+                                                          &tmp_block_meta);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+
+            if (tmp_block_meta.free_size >= op->max_size) {
+                lblock = i;
+                break;
+            }
+        }
+    }
+
+    if (lblock == ITS_BLOCK_INVALID_ID) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+
+    err = its_flash_fs_batch_use_block(fs_ctx, plan, lblock, &block_meta);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* New file data is placed after the data which is kept in the block */
+    op->lblock = lblock;
+    op->data_idx = fs_ctx->cfg->block_size - block_meta->free_size;
+    block_meta->free_size -= op->max_size;
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Plans how the staged operations are applied: finds the existing
+ *        files, releases the data of the files deleted or resized, and
+ *        reserves the file metadata entries and the data of the new files.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[out]    plan    Blocks updated by the batch
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_batch_plan(
+                                         struct its_flash_fs_ctx_t *fs_ctx,
+                                         struct its_flash_fs_batch_plan_t *plan)
+{
+    struct its_flash_fs_batch_t *batch = &fs_ctx->batch;
+    struct its_flash_fs_batch_op_t *op;
+    struct its_block_meta_t *block_meta;
+    struct its_file_meta_t file_meta;
+    psa_status_t err;
+    uint32_t num_new_files = 0;
+    bool spare_found;
+    uint32_t idx;
+    uint32_t i;
+
+    plan->lblock = ITS_BLOCK_INVALID_ID;
+    plan->lb0_updated = false;
+
+    err = its_flash_fs_mblock_read_block_metadata(fs_ctx, ITS_LOGICAL_DBLOCK0,
+                                                  &plan->block_meta[0]);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+    plan->data_end[0] = fs_ctx->cfg->block_size - plan->block_meta[0].free_size;
+
+    /* Find the existing files and release the data which is not kept */
+    for (i = 0; i < batch->num_ops; i++) {
+        op = &batch->ops[i];
+
+        err = its_flash_fs_mblock_get_file_idx_meta(fs_ctx, op->fid, &idx,
+                                                    &file_meta);
+        if (err == PSA_SUCCESS) {
+            op->exists = true;
+            op->idx = idx;
+            op->old_lblock = file_meta.lblock;
+            op->old_data_idx = file_meta.data_idx;
+            op->old_max_size = file_meta.max_size;
+        } else if (err == PSA_ERROR_DOES_NOT_EXIST) {
+            /* The create flag must be supplied to create a new file */
+            if (!op->write || !(op->flags & ITS_FLASH_FS_FLAG_CREATE)) {
+                return PSA_ERROR_DOES_NOT_EXIST;
+            }
+            op->exists = false;
+            op->idx = ITS_METADATA_INVALID_INDEX;
+            num_new_files++;
+        } else {
+            return err;
+        }
+
+        /* An existing file which keeps its maximum size is rewritten in place,
+         * otherwise its data is released and new space is reserved for it.
+         */
+        op->release = op->exists &&
+                      (!op->write || (op->max_size != op->old_max_size));
+        op->reserve = op->write && (!op->exists || op->release);
+
+        if (op->exists) {
+            err = its_flash_fs_batch_use_block(fs_ctx, plan, op->old_lblock,
+                                               &block_meta);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+
+            if (op->release) {
+                block_meta->free_size += op->old_max_size;
+            } else {
+                op->lblock = op->old_lblock;
+            }
+        }
+    }
+
+    /* Reserve the data of the new and resized files, in the staging order */
+    for (i = 0; i < batch->num_ops; i++) {
+        op = &batch->ops[i];
+
+        if (op->reserve) {
+            err = its_flash_fs_batch_reserve_space(fs_ctx, plan, op);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+        }
+    }
+
+    /* Reserve the file metadata entries of the new files. As in
+     * its_flash_fs_file_write(), the first free entry is kept as a spare.
+     */
+    i = 0;
+    spare_found = false;
+    for (idx = 0; (idx < fs_ctx->cfg->max_num_files) && (num_new_files > 0);
+         idx++) {
+        err = its_flash_fs_mblock_read_file_meta(fs_ctx, idx, &file_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        if (its_utils_validate_fid(file_meta.id) == PSA_SUCCESS) {
+            continue;
+        }
+
+        if (!spare_found) {
+            spare_found = true;
+            continue;
+        }
+
+        while (batch->ops[i].exists) {
+            i++;
+        }
+        batch->ops[i++].idx = idx;
+        num_new_files--;
+    }
+
+    if (num_new_files > 0) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Gets the offset of the data of a file kept in a logical block, once
+ *        the data released by the batch has been removed from the block.
+ *
+ * \param[in] fs_ctx    Filesystem context
+ * \param[in] lblock    Logical block number
+ * \param[in] data_idx  Offset of the file data before the update
+ *
+ * \return Returns the offset of the file data after the update.
+ */
+static size_t its_flash_fs_batch_new_data_idx(
+                                        const struct its_flash_fs_ctx_t *fs_ctx,
+                                        uint32_t lblock,
+                                        size_t data_idx)
+{
+    const struct its_flash_fs_batch_op_t *op;
+    size_t new_data_idx = data_idx;
+    uint32_t i;
+
+    for (i = 0; i < fs_ctx->batch.num_ops; i++) {
+        op = &fs_ctx->batch.ops[i];
+        if (op->release && (op->old_lblock == lblock) &&
+            (op->old_data_idx < data_idx)) {
+            new_data_idx -= op->old_max_size;
+        }
+    }
+
+    return new_data_idx;
+}
+
+/**
+ * \brief Writes the file data of a batch operation.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     op         Operation to write the data of
+ * \param[in]     dst_block  Physical block to write the data to
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_batch_write_data(
+                                         struct its_flash_fs_ctx_t *fs_ctx,
+                                         const struct its_flash_fs_batch_op_t *op,
+                                         uint32_t dst_block)
+{
+    if (op->data_size == 0) {
+        return PSA_SUCCESS;
+    }
+
+    return its_flash_fs_dblock_write_data(fs_ctx, dst_block, op->data_idx,
+                                          op->data_size, op->data);
+}
+
+/**
+ * \brief Writes the data of a logical block updated by the batch into a
+ *        scratch block. The data released by the batch is removed, the data
+ *        of the files rewritten in place is taken from the batch, the rest of
+ *        the data is copied from the current block, and the data of the new
+ *        files is appended.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in]     lblock      Logical block number
+ * \param[in]     src_block   Physical block currently storing the data
+ * \param[in]     dst_block   Scratch physical block
+ * \param[in]     data_start  Offset of the start of the data in the block
+ * \param[in]     data_end    Offset of the end of the data in the current block
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_batch_write_block(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              uint32_t lblock,
+                                              uint32_t src_block,
+                                              uint32_t dst_block,
+                                              size_t data_start,
+                                              size_t data_end)
+{
+    struct its_flash_fs_batch_t *batch = &fs_ctx->batch;
+    struct its_flash_fs_batch_op_t *op;
+    psa_status_t err;
+    size_t src_offset = data_start;
+    size_t dst_offset = data_start;
+    uint32_t done = 0;
+    uint32_t next;
+    uint32_t i;
+
+    /* Visit the existing files of the batch in the order of their data. Empty
+     * files can share their offset with the next file, so they come first.
+     */
+    for (;;) {
+        next = ITS_BATCH_MAX_OPS;
+        for (i = 0; i < batch->num_ops; i++) {
+            op = &batch->ops[i];
+            if ((done & (1U << i)) || !op->exists ||
+                (op->old_lblock != lblock)) {
+                continue;
+            }
+
+            if ((next == ITS_BATCH_MAX_OPS) ||
+                (op->old_data_idx < batch->ops[next].old_data_idx) ||
+                ((op->old_data_idx == batch->ops[next].old_data_idx) &&
+                 (op->old_max_size < batch->ops[next].old_max_size))) {
+                next = i;
+            }
+        }
+
+        if (next == ITS_BATCH_MAX_OPS) {
+            break;
+        }
+
+        done |= (1U << next);
+        op = &batch->ops[next];
+
+        /* Copy the data kept before the file */
+        err = its_flash_fs_block_to_block_move(fs_ctx, dst_block, dst_offset,
+                                               src_block, src_offset,
+                                               op->old_data_idx - src_offset);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+        dst_offset += op->old_data_idx - src_offset;
+        src_offset = op->old_data_idx + op->old_max_size;
+
+        if (!op->release) {
+            /* Rewrite the file in place */
+            op->data_idx = dst_offset;
+            err = its_flash_fs_batch_write_data(fs_ctx, op, dst_block);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+            dst_offset += op->max_size;
+        }
+    }
+
+    /* Copy the data kept after the last file of the batch */
+    err = its_flash_fs_block_to_block_move(fs_ctx, dst_block, dst_offset,
+                                           src_block, src_offset,
+                                           data_end - src_offset);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Write the data of the new files */
+    for (i = 0; i < batch->num_ops; i++) {
+        op = &batch->ops[i];
+        if (op->reserve && (op->lblock == lblock)) {
+            err = its_flash_fs_batch_write_data(fs_ctx, op, dst_block);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Applies the planned batch to the scratch blocks and swaps the
+ *        metadata blocks.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in,out] plan    Blocks updated by the batch
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_batch_apply(
+                                         struct its_flash_fs_ctx_t *fs_ctx,
+                                         struct its_flash_fs_batch_plan_t *plan)
+{
+    struct its_flash_fs_batch_t *batch = &fs_ctx->batch;
+    const struct its_flash_fs_batch_op_t *op;
+    struct its_block_meta_t block_meta;
+    struct its_file_meta_t file_meta;
+    uint32_t scratch_id = ITS_BLOCK_INVALID_ID;
+    psa_status_t err;
+    uint32_t idx;
+    uint32_t i;
+
+    /* Update the dedicated logical block first, and flush it before the
+     * metadata block is written.
+     */
+    if (plan->lblock != ITS_BLOCK_INVALID_ID) {
+        scratch_id = its_flash_fs_mblock_cur_data_scratch_id(fs_ctx,
+                                                             plan->lblock);
+
+        err = its_flash_fs_batch_write_block(fs_ctx, plan->lblock,
+                                             plan->block_meta[1].phy_id,
+                                             scratch_id,
+                                             plan->block_meta[1].data_start,
+                                             plan->data_end[1]);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        err = fs_ctx->ops->flush(fs_ctx->cfg, scratch_id);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+
+    /* The data of logical block 0 is stored in the metadata block, so it is
+     * always copied to the scratch metadata block.
+     */
+    if (plan->lb0_updated) {
+        err = its_flash_fs_batch_write_block(fs_ctx, ITS_LOGICAL_DBLOCK0,
+                                             fs_ctx->active_metablock,
+                                             fs_ctx->scratch_metablock,
+                                             plan->block_meta[0].data_start,
+                                             plan->data_end[0]);
+    } else {
+        err = its_flash_fs_mblock_migrate_lb0_data_to_scratch(fs_ctx);
+    }
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    /* Write the metadata of all the logical blocks */
+    for (i = 0; i < its_flash_fs_num_active_dblocks(fs_ctx->cfg); i++) {
+        if (i == ITS_LOGICAL_DBLOCK0) {
+            block_meta = plan->block_meta[0];
+            block_meta.phy_id = fs_ctx->scratch_metablock;
+        } else if (i == plan->lblock) {
+            block_meta = plan->block_meta[1];
+            block_meta.phy_id = scratch_id;
+        } else {
+            err = its_flash_fs_mblock_read_block_metadata(fs_ctx, i,
+                                                          &block_meta);
+            if (err != PSA_SUCCESS) {
+                return PSA_ERROR_GENERIC_ERROR;
+            }
+        }
+
+        err = its_flash_fs_mblock_write_scratch_block_meta(fs_ctx, i,
+                                                           &block_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+
+    /* The current physical block of the dedicated logical block becomes the
+     * scratch data block.
+     */
+    if (plan->lblock != ITS_BLOCK_INVALID_ID) {
+        its_flash_fs_mblock_set_data_scratch(fs_ctx, plan->block_meta[1].phy_id,
+                                             plan->lblock);
+    }
+
+    /* Write the metadata of all the files */
+    for (idx = 0; idx < fs_ctx->cfg->max_num_files; idx++) {
+        op = NULL;
+        for (i = 0; i < batch->num_ops; i++) {
+            if (batch->ops[i].idx == idx) {
+                op = &batch->ops[i];
+                break;
+            }
+        }
+
+        if (op == NULL) {
+            err = its_flash_fs_mblock_read_file_meta(fs_ctx, idx, &file_meta);
+            if (err != PSA_SUCCESS) {
+                return PSA_ERROR_GENERIC_ERROR;
+            }
+
+            /* Move the files kept in the updated logical blocks */
+            if ((its_utils_validate_fid(file_meta.id) == PSA_SUCCESS) &&
+                (((file_meta.lblock == ITS_LOGICAL_DBLOCK0) &&
+                  plan->lb0_updated) ||
+                 (file_meta.lblock == plan->lblock))) {
+                file_meta.data_idx = its_flash_fs_batch_new_data_idx(
+                                                            fs_ctx,
+                                                            file_meta.lblock,
+                                                            file_meta.data_idx);
+            }
+        } else if (!op->write) {
+            /* Remove file metadata */
+            file_meta = (struct its_file_meta_t){0};
+        } else {
+            file_meta = (struct its_file_meta_t){0};
+            file_meta.lblock = op->lblock;
+            file_meta.data_idx = op->data_idx;
+            file_meta.cur_size = op->data_size;
+            file_meta.max_size = op->max_size;
+            file_meta.flags = op->flags;
+            memcpy(file_meta.id, op->fid, ITS_FILE_ID_SIZE);
+#ifdef ITS_ENCRYPTION
+            memcpy(file_meta.nonce, op->nonce, sizeof(op->nonce));
+            memcpy(file_meta.tag, op->tag, sizeof(op->tag));
+#endif
+        }
+
+        err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx, idx,
+                                                           &file_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+
+    /* Write metadata header, swap metadata blocks and erase scratch blocks */
+    return its_flash_fs_mblock_meta_update_finalize(fs_ctx);
+}
+
+psa_status_t its_flash_fs_batch_begin(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    if (fs_ctx->batch.active) {
+        return PSA_ERROR_BAD_STATE;
+    }
+
+    fs_ctx->batch.num_ops = 0;
+    fs_ctx->batch.active = true;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_batch_stage_write(
+                                       struct its_flash_fs_ctx_t *fs_ctx,
+                                       const uint8_t *fid,
+                                       struct its_flash_fs_file_info_t *finfo,
+                                       size_t data_size,
+                                       const uint8_t *data)
+{
+    struct its_flash_fs_batch_op_t *op;
+
+    if (!fs_ctx->batch.active) {
+        return PSA_ERROR_BAD_STATE;
+    }
+
+    if ((finfo == NULL) || ((data == NULL) && (data_size != 0))) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* Do not permit the user to pass filesystem-internal flags */
+    if (finfo->flags & ITS_FLASH_FS_INTERNAL_FLAGS_MASK) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+#if (ITS_FLASH_MAX_ALIGNMENT != 1)
+    /* Set the max_size to be aligned with the flash program unit */
+    finfo->size_max = ITS_UTILS_ALIGN(finfo->size_max, fs_ctx->cfg->program_unit);
+#endif
+
+    /* Check that the file's maximum size is valid */
+    if ((finfo->size_max > fs_ctx->cfg->max_file_size) ||
+        (data_size > finfo->size_max)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    op = its_flash_fs_batch_get_op(fs_ctx, fid);
+    if (op == NULL) {
+        return PSA_ERROR_INSUFFICIENT_MEMORY;
+    }
+
+    op->write = true;
+    op->data = data;
+    op->data_size = data_size;
+    op->max_size = finfo->size_max;
+    op->flags = finfo->flags;
+#ifdef ITS_ENCRYPTION
+    memcpy(op->nonce, finfo->nonce, sizeof(op->nonce));
+    memcpy(op->tag, finfo->tag, sizeof(op->tag));
+#endif
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_batch_stage_delete(struct its_flash_fs_ctx_t *fs_ctx,
+                                             const uint8_t *fid)
+{
+    struct its_flash_fs_batch_op_t *op;
+    psa_status_t err;
+    uint32_t idx;
+
+    if (!fs_ctx->batch.active) {
+        return PSA_ERROR_BAD_STATE;
+    }
+
+    op = its_flash_fs_batch_find_op(fs_ctx, fid);
+    if ((op != NULL) && !op->write) {
+        /* The file is already deleted by the batch */
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    err = its_flash_fs_mblock_get_file_idx_meta(fs_ctx, fid, &idx, NULL);
+    if (err == PSA_ERROR_DOES_NOT_EXIST) {
+        if (op == NULL) {
+            return PSA_ERROR_DOES_NOT_EXIST;
+        }
+
+        /* The file was only going to be created by the batch, so drop the
+         * operation.
+         */
+        *op = fs_ctx->batch.ops[--fs_ctx->batch.num_ops];
+        return PSA_SUCCESS;
+    } else if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if (op == NULL) {
+        op = its_flash_fs_batch_get_op(fs_ctx, fid);
+        if (op == NULL) {
+            return PSA_ERROR_INSUFFICIENT_MEMORY;
+        }
+    }
+
+    op->write = false;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_batch_commit(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    struct its_flash_fs_batch_plan_t plan;
+    psa_status_t err = PSA_SUCCESS;
+
+    if (!fs_ctx->batch.active) {
+        return PSA_ERROR_BAD_STATE;
+    }
+
+    if (fs_ctx->batch.num_ops > 0) {
+        err = its_flash_fs_batch_plan(fs_ctx, &plan);
+        if (err == PSA_SUCCESS) {
+            err = its_flash_fs_batch_apply(fs_ctx, &plan);
+        }
+    }
+
+    /* The batch is discarded, whether it has been committed or not */
+    its_flash_fs_batch_abort(fs_ctx);
+
+    return err;
+}
+
+void its_flash_fs_batch_abort(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    fs_ctx->batch.num_ops = 0;
+    fs_ctx->batch.active = false;
+}
+#endif /* ITS_BATCH_COMMIT */
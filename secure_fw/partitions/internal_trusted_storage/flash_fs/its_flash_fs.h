@@ -38,6 +38,16 @@ extern "C" {
 #define ITS_FLASH_FS_FLAG_CREATE       (1UL << 16)
 /* Remove existing file data if it exists */
 #define ITS_FLASH_FS_FLAG_TRUNCATE     (1UL << 17)
+/* Program data appended to the file in place, without rewriting the data
+ * block, when possible. Only effective when ITS_APPEND_IN_PLACE is enabled and
+ * the flash allows it, see its_flash_fs_config_t.reprogram_erased.
+ */
+#define ITS_FLASH_FS_FLAG_APPEND       (1UL << 18)
+
+/* Filesystem-internal flags, which cannot be passed by the caller */
+#define ITS_FLASH_FS_INTERNAL_FLAGS_MASK  (UINT32_MAX - ((1U << 24) - 1))
+/* Flag that indicates the file is to be deleted in the next block update */
+#define ITS_FLASH_FS_FLAG_DELETE          (1U << 24)
 
 /* Invalid block index */
 #define ITS_BLOCK_INVALID_ID 0xFFFFFFFFU
@@ -61,6 +71,12 @@ struct its_flash_fs_config_t {
     uint16_t max_file_size;   /**< Maximum file size */
     uint16_t max_num_files;   /**< Maximum number of files */
     uint8_t erase_val;        /**< Value of a byte after erase (usually 0xFF) */
+#if ITS_APPEND_IN_PLACE
+    bool reprogram_erased;    /**< A program unit programmed with the erase
+                               *   value can be programmed again, which is
+                               *   required to append data in place
+                               */
+#endif
 };
 
 /**
@@ -187,6 +203,35 @@ struct its_flash_fs_file_info_t {
 #endif
 };
 
+/**
+ * \brief Gets the next part of the data to write to a file.
+ *
+ * \param[in,out] src_ctx    Context of the data source
+ * \param[in]     size       Size of the data still to be written
+ * \param[out]    data       Pointer to the next part of the data
+ * \param[out]    part_size  Size of the next part of the data. It must not be
+ *                           zero or greater than \p size, and it must be
+ *                           aligned to the flash program unit unless it is the
+ *                           last part.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+typedef psa_status_t (*its_flash_fs_read_src_t)(void *src_ctx, size_t size,
+                                                const uint8_t **data,
+                                                size_t *part_size);
+
+/*!
+ * \struct its_flash_fs_data_src_t
+ *
+ * \brief Structure describing a source of data to write to a file, which
+ *        provides the data in parts. It allows a file to be written in a single
+ *        filesystem update without the whole data being present in RAM.
+ */
+struct its_flash_fs_data_src_t {
+    its_flash_fs_read_src_t read; /*!< Function to get the next part */
+    void *ctx;                    /*!< Context of the data source */
+};
+
 /**
  * \brief Initialises the filesystem context. Must be called successfully before
  *        any other filesystem API is called.
@@ -258,6 +303,27 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
                                      size_t offset,
                                      const uint8_t *data);
 
+/**
+ * \brief Writes data read from a data source to a file.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     fid        File ID
+ * \param[in]     finfo      Pointer to \ref its_flash_fs_file_info_t
+ * \param[in]     data_size  Size of the incoming write data.
+ * \param[in]     offset     Offset in the file to write. Must be less than or
+ *                           equal to the current file size.
+ * \param[in]     src        Source of the data to be written
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_file_write_src(
+                                      struct its_flash_fs_ctx_t *fs_ctx,
+                                      const uint8_t *fid,
+                                      struct its_flash_fs_file_info_t *finfo,
+                                      size_t data_size,
+                                      size_t offset,
+                                      const struct its_flash_fs_data_src_t *src);
+
 /**
  * \brief Reads data from an existing file.
  *
@@ -286,6 +352,84 @@ psa_status_t its_flash_fs_file_read(struct its_flash_fs_ctx_t *fs_ctx,
 psa_status_t its_flash_fs_file_delete(struct its_flash_fs_ctx_t *fs_ctx,
                                       const uint8_t *fid);
 
+#if ITS_BATCH_COMMIT
+/**
+ * \brief Starts a batch of file operations. The operations staged in the
+ *        batch are applied together by its_flash_fs_batch_commit(), in a
+ *        single metadata block update, so that after a power failure either
+ *        all or none of them are visible.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns PSA_ERROR_BAD_STATE if a batch has already been started,
+ *         otherwise PSA_SUCCESS.
+ */
+psa_status_t its_flash_fs_batch_begin(struct its_flash_fs_ctx_t *fs_ctx);
+
+/**
+ * \brief Stages the write of a whole file in the current batch. The file is
+ *        created if it does not exist, provided that the create flag is set,
+ *        and its content is otherwise replaced. Staging another operation on
+ *        the same file replaces this one.
+ *
+ * \note The data buffer is not copied. It must remain valid until the batch is
+ *       committed or aborted.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     fid        File ID
+ * \param[in]     finfo      Pointer to \ref its_flash_fs_file_info_t
+ * \param[in]     data_size  Size of the file data
+ * \param[in]     data       Pointer to buffer containing the file data
+ *
+ * \return Returns PSA_ERROR_INSUFFICIENT_MEMORY if the batch is full,
+ *         otherwise error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_batch_stage_write(
+                                       struct its_flash_fs_ctx_t *fs_ctx,
+                                       const uint8_t *fid,
+                                       struct its_flash_fs_file_info_t *finfo,
+                                       size_t data_size,
+                                       const uint8_t *data);
+
+/**
+ * \brief Stages the deletion of a file in the current batch. Staging another
+ *        operation on the same file replaces this one.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     fid     File ID
+ *
+ * \return Returns PSA_ERROR_INSUFFICIENT_MEMORY if the batch is full,
+ *         otherwise error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_batch_stage_delete(struct its_flash_fs_ctx_t *fs_ctx,
+                                             const uint8_t *fid);
+
+/**
+ * \brief Applies the operations staged in the current batch, with a single
+ *        metadata block update, and ends the batch. If an error is returned,
+ *        none of the operations have been applied.
+ *
+ * \note The files updated by a batch can be located in logical block 0 and in
+ *       at most one dedicated logical block, as there is a single scratch data
+ *       block.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns PSA_ERROR_NOT_SUPPORTED if the batch updates more than one
+ *         dedicated logical block, otherwise error code as specified in
+ *         \ref psa_status_t
+ */
+psa_status_t its_flash_fs_batch_commit(struct its_flash_fs_ctx_t *fs_ctx);
+
+/**
+ * \brief Discards the operations staged in the current batch and ends the
+ *        batch.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ */
+void its_flash_fs_batch_abort(struct its_flash_fs_ctx_t *fs_ctx);
+#endif /* ITS_BATCH_COMMIT */
+
 #ifdef __cplusplus
 }
 #endif
@@ -7,6 +7,8 @@
 
 #include "its_flash_fs_dblock.h"
 
+#include <string.h>
+
 #include "its_flash_fs.h"
 
 /**
@@ -140,7 +142,7 @@ psa_status_t its_flash_fs_dblock_write_file(
                                       const struct its_file_meta_t *file_meta,
                                       size_t offset,
                                       size_t size,
-                                      const uint8_t *data)
+                                      const struct its_flash_fs_data_src_t *src)
 {
     psa_status_t err;
     uint32_t scratch_id;
@@ -164,7 +166,7 @@ psa_status_t its_flash_fs_dblock_write_file(
     }
 
     /* Write the new file data */
-    err = fs_ctx->ops->write(fs_ctx->cfg, scratch_id, data, pos, size);
+    err = its_flash_fs_dblock_write_src(fs_ctx, scratch_id, pos, size, src);
     if (err != PSA_SUCCESS) {
         return err;
     }
@@ -192,3 +194,86 @@ psa_status_t its_flash_fs_dblock_write_file(
 
     return err;
 }
+
+psa_status_t its_flash_fs_dblock_write_data(struct its_flash_fs_ctx_t *fs_ctx,
+                                            uint32_t block_id,
+                                            size_t offset,
+                                            size_t size,
+                                            const uint8_t *data)
+{
+    psa_status_t err;
+    size_t aligned_size = size;
+#if (ITS_FLASH_MAX_ALIGNMENT != 1)
+    uint8_t tail[ITS_FLASH_MAX_ALIGNMENT];
+
+    aligned_size -= size % fs_ctx->cfg->program_unit;
+#endif
+
+    /* Program the data which is aligned to the program unit directly */
+    if (aligned_size != 0) {
+        err = fs_ctx->ops->write(fs_ctx->cfg, block_id, data, offset,
+                                 aligned_size);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+#if (ITS_FLASH_MAX_ALIGNMENT != 1)
+    /* Program the unaligned tail of the data from the bounce buffer */
+    if (aligned_size != size) {
+        memset(tail, fs_ctx->cfg->erase_val, fs_ctx->cfg->program_unit);
+        memcpy(tail, data + aligned_size, size - aligned_size);
+
+        err = fs_ctx->ops->write(fs_ctx->cfg, block_id, tail,
+                                 offset + aligned_size,
+                                 fs_ctx->cfg->program_unit);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+#endif
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_dblock_write_src(
+                                      struct its_flash_fs_ctx_t *fs_ctx,
+                                      uint32_t block_id,
+                                      size_t offset,
+                                      size_t size,
+                                      const struct its_flash_fs_data_src_t *src)
+{
+    psa_status_t err;
+    const uint8_t *data;
+    size_t part_size;
+
+    while (size > 0) {
+        err = src->read(src->ctx, size, &data, &part_size);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        if ((part_size == 0) || (part_size > size)) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+
+#if (ITS_FLASH_MAX_ALIGNMENT != 1)
+        /* Only the last part can have an unaligned size */
+        if ((part_size != size) &&
+            !ITS_UTILS_IS_ALIGNED(part_size, fs_ctx->cfg->program_unit)) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+#endif
+
+        err = its_flash_fs_dblock_write_data(fs_ctx, block_id, offset,
+                                             part_size, data);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        offset += part_size;
+        size -= part_size;
+    }
+
+    return PSA_SUCCESS;
+}
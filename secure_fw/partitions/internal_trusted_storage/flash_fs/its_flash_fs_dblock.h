@@ -18,6 +18,8 @@
 extern "C" {
 #endif
 
+struct its_flash_fs_data_src_t;
+
 /**
  * \brief Compacts block data for the given logical block.
  *
@@ -68,7 +70,7 @@ psa_status_t its_flash_fs_dblock_read_file(
  * \param[in]     offset      Offset in the scratch data block where to start
  *                            the copy of the incoming data
  * \param[in]     size        Size of the incoming data
- * \param[in]     data        Pointer to data buffer to copy in the scratch data
+ * \param[in]     src         Source of the data to copy in the scratch data
  *                            block
  *
  * \return Returns error code as specified in \ref psa_status_t
@@ -79,7 +81,45 @@ psa_status_t its_flash_fs_dblock_write_file(
                                       const struct its_file_meta_t *file_meta,
                                       size_t offset,
                                       size_t size,
-                                      const uint8_t *data);
+                                      const struct its_flash_fs_data_src_t *src);
+
+/**
+ * \brief Programs data in a physical block. If the data size is not aligned to
+ *        the flash program unit, the last program unit is written from a bounce
+ *        buffer padded with the erase value, so that the data buffer is never
+ *        read beyond its size.
+ *
+ * \param[in,out] fs_ctx    Filesystem context
+ * \param[in]     block_id  Physical block ID
+ * \param[in]     offset    Offset in the block, aligned to the program unit
+ * \param[in]     size      Size of the data
+ * \param[in]     data      Pointer to the data to program
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_dblock_write_data(struct its_flash_fs_ctx_t *fs_ctx,
+                                            uint32_t block_id,
+                                            size_t offset,
+                                            size_t size,
+                                            const uint8_t *data);
+
+/**
+ * \brief Programs data read from a data source in a physical block.
+ *
+ * \param[in,out] fs_ctx    Filesystem context
+ * \param[in]     block_id  Physical block ID
+ * \param[in]     offset    Offset in the block, aligned to the program unit
+ * \param[in]     size      Size of the data
+ * \param[in]     src       Source of the data to program
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_dblock_write_src(
+                                      struct its_flash_fs_ctx_t *fs_ctx,
+                                      uint32_t block_id,
+                                      size_t offset,
+                                      size_t size,
+                                      const struct its_flash_fs_data_src_t *src);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,454 @@
+/*
+ * SPDX-FileCopyrightText: Copyright The TrustedFirmware-M Contributors
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+
+#include "config_tfm.h"
+#include "its_flash_fs_index.h"
+#include "its_flash_fs_mblock.h"
+
+#if ITS_RAM_INDEX
+
+#if (ITS_RAM_INDEX_SIZE & (ITS_RAM_INDEX_SIZE - 1)) != 0
+#error "ITS_RAM_INDEX_SIZE must be a power of two"
+#endif
+
+#if (ITS_RAM_INDEX_MAX_DBLOCKS > 32)
+#error "ITS_RAM_INDEX_MAX_DBLOCKS must not be greater than 32"
+#endif
+
+#define ITS_INDEX_SLOT_MASK  (ITS_RAM_INDEX_SIZE - 1)
+
+#define ITS_INDEX_BIT_IS_SET(bitmap, n) \
+    (((bitmap)[(n) / 32] & (1UL << ((n) % 32))) != 0)
+#define ITS_INDEX_SET_BIT(bitmap, n)    ((bitmap)[(n) / 32] |= (1UL << ((n) % 32)))
+#define ITS_INDEX_CLEAR_BIT(bitmap, n)  ((bitmap)[(n) / 32] &= ~(1UL << ((n) % 32)))
+
+/* FNV-1a 32-bit parameters */
+#define ITS_INDEX_FNV_OFFSET 2166136261U
+#define ITS_INDEX_FNV_PRIME  16777619U
+
+/**
+ * \brief Gets the home slot of a file ID.
+ *
+ * \param[in] fid  File ID
+ *
+ * \return Slot number where the probing for the file ID starts
+ */
+static uint32_t its_index_hash(const uint8_t *fid)
+{
+    uint32_t hash = ITS_INDEX_FNV_OFFSET;
+    uint32_t i;
+
+    for (i = 0; i < ITS_FILE_ID_SIZE; i++) {
+        hash ^= fid[i];
+        hash *= ITS_INDEX_FNV_PRIME;
+    }
+
+    return hash & ITS_INDEX_SLOT_MASK;
+}
+
+/**
+ * \brief Empties all the slots of the index.
+ *
+ * \param[in,out] index  RAM index
+ */
+static void its_index_clear(struct its_flash_fs_index_t *index)
+{
+    uint32_t i;
+
+    for (i = 0; i < ITS_RAM_INDEX_SIZE; i++) {
+        index->slots[i].file_idx = ITS_METADATA_INVALID_INDEX;
+        index->file_slot[i] = ITS_METADATA_INVALID_INDEX;
+    }
+
+    (void)memset(index->dirty, 0, sizeof(index->dirty));
+    (void)memset(index->free_files, 0, sizeof(index->free_files));
+    index->dblock_dirty = 0;
+}
+
+/**
+ * \brief Finds the first free file metadata entry index from a given index.
+ *
+ * \param[in] index      RAM index
+ * \param[in] start      File metadata entry index to start the search from
+ * \param[in] num_files  Number of file metadata entries
+ *
+ * \return Index of the free entry, or ITS_METADATA_INVALID_INDEX if none
+ */
+static uint32_t its_index_next_free_file(const struct its_flash_fs_index_t *index,
+                                         uint32_t start, uint32_t num_files)
+{
+    uint32_t idx = start;
+    uint32_t word;
+
+    while (idx < num_files) {
+        /* Skip whole words without free entries */
+        word = index->free_files[idx / 32] >> (idx % 32);
+        if (word == 0) {
+            idx = ITS_UTILS_ALIGN(idx + 1, 32);
+            continue;
+        }
+
+        while (!(word & 1UL)) {
+            word >>= 1;
+            idx++;
+        }
+
+        return (idx < num_files) ? idx : ITS_METADATA_INVALID_INDEX;
+    }
+
+    return ITS_METADATA_INVALID_INDEX;
+}
+
+/**
+ * \brief Records the state of a file metadata entry in the free entry bitmap.
+ *
+ * \param[in,out] index      RAM index
+ * \param[in]     idx        File metadata entry index
+ * \param[in]     file_meta  File metadata
+ */
+static void its_index_update_free_file(struct its_flash_fs_index_t *index,
+                                       uint32_t idx,
+                                       const struct its_file_meta_t *file_meta)
+{
+    if (its_utils_validate_fid(file_meta->id) != PSA_SUCCESS) {
+        ITS_INDEX_SET_BIT(index->free_files, idx);
+    } else {
+        ITS_INDEX_CLEAR_BIT(index->free_files, idx);
+    }
+}
+
+/**
+ * \brief Inserts a file in the index, unless it is free or marked for deletion.
+ *
+ * \param[in,out] index      RAM index
+ * \param[in]     idx        File metadata entry index
+ * \param[in]     file_meta  File metadata
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_index_insert(struct its_flash_fs_index_t *index,
+                                     uint32_t idx,
+                                     const struct its_file_meta_t *file_meta)
+{
+    struct its_flash_fs_index_entry_t *entry;
+    uint32_t slot;
+    uint32_t i;
+
+    /* A file marked for deletion shares its ID with the file replacing it, and
+     * is only reachable through its metadata entry index.
+     */
+    if ((its_utils_validate_fid(file_meta->id) != PSA_SUCCESS) ||
+        (file_meta->flags & ITS_FLASH_FS_FLAG_DELETE)) {
+        return PSA_SUCCESS;
+    }
+
+    slot = its_index_hash(file_meta->id);
+
+    for (i = 0; i < ITS_RAM_INDEX_SIZE; i++) {
+        entry = &index->slots[slot];
+
+        if (entry->file_idx == ITS_METADATA_INVALID_INDEX) {
+            memcpy(entry->fid, file_meta->id, ITS_FILE_ID_SIZE);
+            entry->file_idx = (uint16_t)idx;
+            entry->flags = file_meta->flags;
+            entry->cur_size = file_meta->cur_size;
+            entry->max_size = file_meta->max_size;
+            index->file_slot[idx] = (uint16_t)slot;
+            return PSA_SUCCESS;
+        }
+
+        slot = (slot + 1) & ITS_INDEX_SLOT_MASK;
+    }
+
+    return PSA_ERROR_INSUFFICIENT_STORAGE;
+}
+
+/**
+ * \brief Removes the file stored at a metadata entry index from the index.
+ *        The following entries of the probe sequence are shifted back, so
+ *        that no tombstones are needed.
+ *
+ * \param[in,out] index  RAM index
+ * \param[in]     idx    File metadata entry index
+ */
+static void its_index_remove(struct its_flash_fs_index_t *index, uint32_t idx)
+{
+    uint32_t slot = index->file_slot[idx];
+    uint32_t next;
+    uint32_t home;
+
+    if (slot == ITS_METADATA_INVALID_INDEX) {
+        return;
+    }
+
+    index->file_slot[idx] = ITS_METADATA_INVALID_INDEX;
+    next = slot;
+
+    for (;;) {
+        next = (next + 1) & ITS_INDEX_SLOT_MASK;
+        if (index->slots[next].file_idx == ITS_METADATA_INVALID_INDEX) {
+            break;
+        }
+
+        /* The entry can fill the hole only if its home slot is not located
+         * cyclically between the hole and the entry.
+         */
+        home = its_index_hash(index->slots[next].fid);
+        if (((next - home) & ITS_INDEX_SLOT_MASK) >=
+            ((next - slot) & ITS_INDEX_SLOT_MASK)) {
+            index->slots[slot] = index->slots[next];
+            index->file_slot[index->slots[slot].file_idx] = (uint16_t)slot;
+            slot = next;
+        }
+    }
+
+    index->slots[slot].file_idx = ITS_METADATA_INVALID_INDEX;
+}
+
+psa_status_t its_flash_fs_index_build(struct its_flash_fs_ctx_t *fs_ctx,
+                                      uint32_t num_dblocks)
+{
+    struct its_flash_fs_index_t *index = &fs_ctx->index;
+    struct its_block_meta_t block_meta;
+    struct its_file_meta_t file_meta;
+    psa_status_t err;
+    uint32_t idx;
+
+    index->valid = false;
+
+    /* At least one slot must always be empty to terminate the probing, and
+     * every logical data block needs an entry in the free space table.
+     */
+    if ((fs_ctx->cfg->max_num_files >= ITS_RAM_INDEX_SIZE) ||
+        (num_dblocks > ITS_RAM_INDEX_MAX_DBLOCKS)) {
+        return PSA_SUCCESS;
+    }
+
+    its_index_clear(index);
+    index->num_dblocks = num_dblocks;
+
+    for (idx = 0; idx < num_dblocks; idx++) {
+        err = its_flash_fs_mblock_read_block_metadata(fs_ctx, idx, &block_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        index->dblock_free_size[idx] = block_meta.free_size;
+    }
+
+    for (idx = 0; idx < fs_ctx->cfg->max_num_files; idx++) {
+        err = its_flash_fs_mblock_read_file_meta(fs_ctx, idx, &file_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        its_index_update_free_file(index, idx, &file_meta);
+
+        err = its_index_insert(index, idx, &file_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_SUCCESS;
+        }
+    }
+
+    index->valid = true;
+
+    return PSA_SUCCESS;
+}
+
+void its_flash_fs_index_invalidate(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    fs_ctx->index.valid = false;
+}
+
+psa_status_t its_flash_fs_index_find(
+                                struct its_flash_fs_ctx_t *fs_ctx,
+                                const uint8_t *fid,
+                                const struct its_flash_fs_index_entry_t **entry)
+{
+    struct its_flash_fs_index_t *index = &fs_ctx->index;
+    uint32_t slot;
+    uint32_t i;
+
+    if (!index->valid) {
+        return PSA_ERROR_BAD_STATE;
+    }
+
+    slot = its_index_hash(fid);
+
+    for (i = 0; i < ITS_RAM_INDEX_SIZE; i++) {
+        if (index->slots[slot].file_idx == ITS_METADATA_INVALID_INDEX) {
+            break;
+        }
+
+        if (!memcmp(index->slots[slot].fid, fid, ITS_FILE_ID_SIZE)) {
+            /* Found */
+            *entry = &index->slots[slot];
+            return PSA_SUCCESS;
+        }
+
+        slot = (slot + 1) & ITS_INDEX_SLOT_MASK;
+    }
+
+    return PSA_ERROR_DOES_NOT_EXIST;
+}
+
+psa_status_t its_flash_fs_index_get_free_file(struct its_flash_fs_ctx_t *fs_ctx,
+                                              bool use_spare,
+                                              uint32_t *idx)
+{
+    struct its_flash_fs_index_t *index = &fs_ctx->index;
+    uint32_t num_files = fs_ctx->cfg->max_num_files;
+    uint32_t free_idx;
+
+    if (!index->valid) {
+        return PSA_ERROR_BAD_STATE;
+    }
+
+    free_idx = its_index_next_free_file(index, 0, num_files);
+
+    /* Keep the first free file index as a spare, unless it can be used */
+    if (!use_spare && (free_idx != ITS_METADATA_INVALID_INDEX)) {
+        free_idx = its_index_next_free_file(index, free_idx + 1, num_files);
+    }
+
+    if (free_idx == ITS_METADATA_INVALID_INDEX) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+
+    *idx = free_idx;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_index_get_free_block(struct its_flash_fs_ctx_t *fs_ctx,
+                                               size_t size,
+                                               uint32_t *lblock)
+{
+    struct its_flash_fs_index_t *index = &fs_ctx->index;
+    uint32_t i;
+
+    if (!index->valid) {
+        return PSA_ERROR_BAD_STATE;
+    }
+
+    for (i = 0; i < index->num_dblocks; i++) {
+        if (index->dblock_free_size[i] >= size) {
+            *lblock = i;
+            return PSA_SUCCESS;
+        }
+    }
+
+    return PSA_ERROR_INSUFFICIENT_STORAGE;
+}
+
+void its_flash_fs_index_stage_file(struct its_flash_fs_ctx_t *fs_ctx,
+                                   uint32_t idx,
+                                   const struct its_file_meta_t *file_meta)
+{
+    struct its_flash_fs_index_t *index = &fs_ctx->index;
+    const struct its_flash_fs_index_entry_t *entry;
+    uint32_t slot;
+
+    if (!index->valid) {
+        return;
+    }
+
+    /* Entries rewritten unchanged, as when a block is compacted, do not need
+     * to be read back when the update is committed.
+     */
+    slot = index->file_slot[idx];
+    if (slot != ITS_METADATA_INVALID_INDEX) {
+        entry = &index->slots[slot];
+        if (!memcmp(entry->fid, file_meta->id, ITS_FILE_ID_SIZE) &&
+            (entry->flags == file_meta->flags) &&
+            (entry->cur_size == file_meta->cur_size) &&
+            (entry->max_size == file_meta->max_size)) {
+            return;
+        }
+    } else if ((its_utils_validate_fid(file_meta->id) != PSA_SUCCESS) &&
+               ITS_INDEX_BIT_IS_SET(index->free_files, idx)) {
+        /* The entry was free and remains free */
+        return;
+    }
+
+    ITS_INDEX_SET_BIT(index->dirty, idx);
+}
+
+void its_flash_fs_index_stage_block(struct its_flash_fs_ctx_t *fs_ctx,
+                                    uint32_t lblock,
+                                    const struct its_block_meta_t *block_meta)
+{
+    struct its_flash_fs_index_t *index = &fs_ctx->index;
+
+    if (!index->valid) {
+        return;
+    }
+
+    if (index->dblock_free_size[lblock] != block_meta->free_size) {
+        index->dblock_dirty |= (1UL << lblock);
+    }
+}
+
+void its_flash_fs_index_commit(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    struct its_flash_fs_index_t *index = &fs_ctx->index;
+    struct its_block_meta_t block_meta;
+    struct its_file_meta_t file_meta;
+    uint32_t idx;
+
+    if (!index->valid) {
+        return;
+    }
+
+    for (idx = 0; idx < index->num_dblocks; idx++) {
+        if (!(index->dblock_dirty & (1UL << idx))) {
+            continue;
+        }
+
+        if (its_flash_fs_mblock_read_block_metadata(fs_ctx, idx, &block_meta)
+            != PSA_SUCCESS) {
+            /* Fall back to the metadata stored in flash */
+            index->valid = false;
+            return;
+        }
+
+        index->dblock_free_size[idx] = block_meta.free_size;
+    }
+
+    index->dblock_dirty = 0;
+
+    /* Remove all the updated entries first, as an updated file can move to
+     * another metadata entry index in the same block update.
+     */
+    for (idx = 0; idx < fs_ctx->cfg->max_num_files; idx++) {
+        if (ITS_INDEX_BIT_IS_SET(index->dirty, idx)) {
+            its_index_remove(index, idx);
+        }
+    }
+
+    for (idx = 0; idx < fs_ctx->cfg->max_num_files; idx++) {
+        if (!ITS_INDEX_BIT_IS_SET(index->dirty, idx)) {
+            continue;
+        }
+
+        if ((its_flash_fs_mblock_read_file_meta(fs_ctx, idx, &file_meta)
+             != PSA_SUCCESS) ||
+            (its_index_insert(index, idx, &file_meta) != PSA_SUCCESS)) {
+            /* Fall back to the metadata stored in flash */
+            index->valid = false;
+            break;
+        }
+
+        its_index_update_free_file(index, idx, &file_meta);
+    }
+
+    (void)memset(index->dirty, 0, sizeof(index->dirty));
+}
+
+#endif /* ITS_RAM_INDEX */
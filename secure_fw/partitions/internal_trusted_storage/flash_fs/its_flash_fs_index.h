@@ -0,0 +1,200 @@
+/*
+ * SPDX-FileCopyrightText: Copyright The TrustedFirmware-M Contributors
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/**
+ * \file  its_flash_fs_index.h
+ *
+ * \brief RAM-resident index of the files stored in the flash filesystem. The
+ *        index maps a file ID to its file metadata entry index and caches the
+ *        file size and flags, so that a file can be found without reading the
+ *        file metadata table from flash. It also tracks the free file metadata
+ *        entries and the free space of each logical data block, so that space
+ *        for a new file can be reserved without scanning the metadata.
+ */
+
+#ifndef __ITS_FLASH_FS_INDEX_H__
+#define __ITS_FLASH_FS_INDEX_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config_tfm.h"
+#include "its_utils.h"
+#include "psa/error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if ITS_RAM_INDEX
+
+struct its_flash_fs_ctx_t;
+struct its_block_meta_t;
+struct its_file_meta_t;
+
+/*!
+ * \struct its_flash_fs_index_entry_t
+ *
+ * \brief Structure to store a file in the RAM index.
+ */
+struct its_flash_fs_index_entry_t {
+    uint8_t fid[ITS_FILE_ID_SIZE]; /*!< ID of the file */
+    uint16_t file_idx;             /*!< Index of the file metadata entry, or
+                                    *   ITS_METADATA_INVALID_INDEX if the slot
+                                    *   is empty
+                                    */
+    uint32_t flags;                /*!< Flags set when the file was created */
+    size_t cur_size;               /*!< Current size of the file */
+    size_t max_size;               /*!< Maximum size of the file */
+};
+
+/*!
+ * \struct its_flash_fs_index_t
+ *
+ * \brief Structure to store the RAM index of a filesystem context. The slots
+ *        form an open-addressed hash table with linear probing.
+ */
+struct its_flash_fs_index_t {
+    struct its_flash_fs_index_entry_t slots[ITS_RAM_INDEX_SIZE]; /*!< Hash
+                                                                  *   table
+                                                                  */
+    uint16_t file_slot[ITS_RAM_INDEX_SIZE]; /*!< Slot of each file metadata
+                                             *   entry index
+                                             */
+    uint32_t dirty[(ITS_RAM_INDEX_SIZE + 31) / 32]; /*!< File metadata entries
+                                                     *   updated in the scratch
+                                                     *   metadata block
+                                                     */
+    uint32_t free_files[(ITS_RAM_INDEX_SIZE + 31) / 32]; /*!< Free file
+                                                          *   metadata entries
+                                                          */
+    size_t dblock_free_size[ITS_RAM_INDEX_MAX_DBLOCKS]; /*!< Free space of each
+                                                         *   logical data block
+                                                         */
+    uint32_t dblock_dirty;                  /*!< Logical data blocks updated in
+                                             *   the scratch metadata block
+                                             */
+    uint32_t num_dblocks;                   /*!< Number of logical data
+                                             *   blocks
+                                             */
+    bool valid;                             /*!< The index reflects the
+                                             *   active metadata block
+                                             */
+};
+
+/**
+ * \brief Builds the RAM index from the active metadata block.
+ *
+ * \note If the index is too small to hold all the files or all the logical
+ *       data blocks of the filesystem, it is left invalid and the callers fall
+ *       back to reading the metadata from flash.
+ *
+ * \param[in,out] fs_ctx       Filesystem context
+ * \param[in]     num_dblocks  Number of logical data blocks
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_index_build(struct its_flash_fs_ctx_t *fs_ctx,
+                                      uint32_t num_dblocks);
+
+/**
+ * \brief Invalidates the RAM index.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ */
+void its_flash_fs_index_invalidate(struct its_flash_fs_ctx_t *fs_ctx);
+
+/**
+ * \brief Looks up a file in the RAM index.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     fid     ID of the file
+ * \param[out]    entry   Pointer to the index entry of the file
+ *
+ * \return Returns PSA_SUCCESS if the file is found, PSA_ERROR_DOES_NOT_EXIST
+ *         if it is not, and PSA_ERROR_BAD_STATE if the index is not valid.
+ */
+psa_status_t its_flash_fs_index_find(
+                               struct its_flash_fs_ctx_t *fs_ctx,
+                               const uint8_t *fid,
+                               const struct its_flash_fs_index_entry_t **entry);
+
+/**
+ * \brief Gets a free file metadata entry index.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     use_spare  If true then the spare file index will be used,
+ *                           otherwise at least one file index will be left free
+ * \param[out]    idx        Index of the free file metadata entry
+ *
+ * \return Returns PSA_SUCCESS if a free entry is found,
+ *         PSA_ERROR_INSUFFICIENT_STORAGE if there is none, and
+ *         PSA_ERROR_BAD_STATE if the index is not valid.
+ */
+psa_status_t its_flash_fs_index_get_free_file(struct its_flash_fs_ctx_t *fs_ctx,
+                                              bool use_spare,
+                                              uint32_t *idx);
+
+/**
+ * \brief Gets the first logical data block with enough free space for a file.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     size    Size of the file
+ * \param[out]    lblock  Logical block number
+ *
+ * \return Returns PSA_SUCCESS if a block is found,
+ *         PSA_ERROR_INSUFFICIENT_STORAGE if there is none, and
+ *         PSA_ERROR_BAD_STATE if the index is not valid.
+ */
+psa_status_t its_flash_fs_index_get_free_block(struct its_flash_fs_ctx_t *fs_ctx,
+                                               size_t size,
+                                               uint32_t *lblock);
+
+/**
+ * \brief Records that a file metadata entry has been written in the scratch
+ *        metadata block. The index is updated when the metadata blocks are
+ *        swapped.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     idx        File metadata entry index
+ * \param[in]     file_meta  File metadata written in the scratch block
+ */
+void its_flash_fs_index_stage_file(struct its_flash_fs_ctx_t *fs_ctx,
+                                   uint32_t idx,
+                                   const struct its_file_meta_t *file_meta);
+
+/**
+ * \brief Records that a logical block's metadata has been written in the
+ *        scratch metadata block. The index is updated when the metadata blocks
+ *        are swapped.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in]     lblock      Logical block number
+ * \param[in]     block_meta  Block metadata written in the scratch block
+ */
+void its_flash_fs_index_stage_block(struct its_flash_fs_ctx_t *fs_ctx,
+                                    uint32_t lblock,
+                                    const struct its_block_meta_t *block_meta);
+
+/**
+ * \brief Applies the staged metadata entries to the RAM index. Must be
+ *        called after the scratch metadata block has become the active one.
+ *
+ * \note If the staged entries cannot be read back, the index is invalidated.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ */
+void its_flash_fs_index_commit(struct its_flash_fs_ctx_t *fs_ctx);
+
+#endif /* ITS_RAM_INDEX */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ITS_FLASH_FS_INDEX_H__ */
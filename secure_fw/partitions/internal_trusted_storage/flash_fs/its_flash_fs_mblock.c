@@ -480,6 +480,15 @@ static uint32_t its_get_free_file_index(struct its_flash_fs_ctx_t *fs_ctx,
     uint32_t i;
     struct its_file_meta_t tmp_metadata;
 
+#if ITS_RAM_INDEX
+    err = its_flash_fs_index_get_free_file(fs_ctx, use_spare, &i);
+    if (err == PSA_SUCCESS) {
+        return i;
+    } else if (err != PSA_ERROR_BAD_STATE) {
+        return ITS_METADATA_INVALID_INDEX;
+    }
+#endif
+
     for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
         err = its_flash_fs_mblock_read_file_meta(fs_ctx, i, &tmp_metadata);
         if (err != PSA_SUCCESS) {
@@ -532,6 +541,15 @@ static psa_status_t its_mblock_erase_scratch_blocks(
      * only data. Otherwise, if the number of blocks is equal to 2, it means
      * that all data is stored in the metadata block.
      */
+#if ITS_APPEND_IN_PLACE
+    /* If file data has been appended in place, the scratch data block has not
+     * been written and is still erased.
+     */
+    if (fs_ctx->scratch_dblock_unused) {
+        return err;
+    }
+#endif
+
     if (fs_ctx->cfg->num_blocks > 2) {
         scratch_datablock =
             its_flash_fs_mblock_cur_data_scratch_id(fs_ctx,
@@ -558,12 +576,21 @@ static psa_status_t its_mblock_update_scratch_block_meta(
                                       const struct its_block_meta_t *block_meta)
 {
     size_t pos;
+    psa_status_t err;
 
     /* Calculate the position */
     pos = its_mblock_block_meta_offset(lblock);
-    return fs_ctx->ops->write(fs_ctx->cfg, fs_ctx->scratch_metablock,
-                              (const uint8_t *)block_meta, pos,
-                              ITS_BLOCK_METADATA_SIZE);
+    err = fs_ctx->ops->write(fs_ctx->cfg, fs_ctx->scratch_metablock,
+                             (const uint8_t *)block_meta, pos,
+                             ITS_BLOCK_METADATA_SIZE);
+
+#if ITS_RAM_INDEX
+    if (err == PSA_SUCCESS) {
+        its_flash_fs_index_stage_block(fs_ctx, lblock, block_meta);
+    }
+#endif
+
+    return err;
 }
 
 /**
@@ -879,9 +906,19 @@ static psa_status_t its_mblock_reserve_file(struct its_flash_fs_ctx_t *fs_ctx,
                                             struct its_block_meta_t *block_meta)
 {
     psa_status_t err;
-    uint32_t i;
+    uint32_t i = 0;
 
-    for (i = 0; i < its_num_active_dblocks(fs_ctx); i++) {
+#if ITS_RAM_INDEX
+    /* Start from the first block with enough space, if the index knows it */
+    err = its_flash_fs_index_get_free_block(fs_ctx, size, &i);
+    if (err == PSA_ERROR_INSUFFICIENT_STORAGE) {
+        return err;
+    } else if (err != PSA_SUCCESS) {
+        i = 0;
+    }
+#endif
+
+    for (; i < its_num_active_dblocks(fs_ctx); i++) {
         err = its_flash_fs_mblock_read_block_metadata(fs_ctx, i, block_meta);
         if (err != PSA_SUCCESS) {
             return PSA_ERROR_GENERIC_ERROR;
@@ -1002,6 +1039,27 @@ psa_status_t its_flash_fs_mblock_get_file_idx_meta(struct its_flash_fs_ctx_t *fs
     psa_status_t err;
     uint32_t i;
     struct its_file_meta_t tmp_metadata;
+#if ITS_RAM_INDEX
+    const struct its_flash_fs_index_entry_t *entry;
+
+    err = its_flash_fs_index_find(fs_ctx, fid, &entry);
+    if (err == PSA_SUCCESS) {
+        if (file_meta != NULL) {
+            err = its_flash_fs_mblock_read_file_meta(fs_ctx, entry->file_idx,
+                                                     file_meta);
+            if ((err != PSA_SUCCESS) ||
+                memcmp(file_meta->id, fid, ITS_FILE_ID_SIZE)) {
+                return PSA_ERROR_GENERIC_ERROR;
+            }
+        }
+        *idx = entry->file_idx;
+        return PSA_SUCCESS;
+    } else if (err != PSA_ERROR_BAD_STATE) {
+        return err;
+    }
+
+    /* The index is not available, so search the file metadata in flash */
+#endif /* ITS_RAM_INDEX */
 
     for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
         err = its_flash_fs_mblock_read_file_meta(fs_ctx, i, &tmp_metadata);
@@ -1077,7 +1135,17 @@ psa_status_t its_flash_fs_mblock_init(struct its_flash_fs_ctx_t *fs_ctx)
     }
 
     /* Upgrade the metadata header if required. */
-    return its_mblock_upgrade_meta_header(fs_ctx);
+    err = its_mblock_upgrade_meta_header(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+#if ITS_RAM_INDEX
+    /* Index the files stored in the active metadata block */
+    err = its_flash_fs_index_build(fs_ctx, its_num_active_dblocks(fs_ctx));
+#endif
+
+    return err;
 }
 
 psa_status_t its_flash_fs_mblock_meta_update_finalize(
@@ -1100,6 +1168,11 @@ psa_status_t its_flash_fs_mblock_meta_update_finalize(
     /* Update the running context */
     its_mblock_swap_metablocks(fs_ctx);
 
+#if ITS_RAM_INDEX
+    /* Bring the index in line with the new active metadata block */
+    its_flash_fs_index_commit(fs_ctx);
+#endif
+
     /* Erase meta block and current scratch block */
     return its_mblock_erase_scratch_blocks(fs_ctx);
 }
@@ -1228,6 +1301,11 @@ psa_status_t its_flash_fs_mblock_reset_metablock(
     uint32_t metablock_to_erase_first = ITS_METADATA_BLOCK0;
     struct its_file_meta_t file_metadata;
 
+#if ITS_RAM_INDEX
+    /* The index is rebuilt when the filesystem is prepared again */
+    its_flash_fs_index_invalidate(fs_ctx);
+#endif
+
     /* Erase both metadata blocks. If at least one metadata block is valid,
      * ensure that the active metadata block is erased last to prevent rollback
      * in the case of a power failure between the two erases.
@@ -1361,18 +1439,35 @@ psa_status_t its_flash_fs_mblock_update_scratch_block_meta(
     return its_mblock_copy_remaining_block_meta(fs_ctx, lblock);
 }
 
+psa_status_t its_flash_fs_mblock_write_scratch_block_meta(
+                                      struct its_flash_fs_ctx_t *fs_ctx,
+                                      uint32_t lblock,
+                                      const struct its_block_meta_t *block_meta)
+{
+    return its_mblock_update_scratch_block_meta(fs_ctx, lblock, block_meta);
+}
+
 psa_status_t its_flash_fs_mblock_update_scratch_file_meta(
                                         struct its_flash_fs_ctx_t *fs_ctx,
                                         uint32_t idx,
                                         const struct its_file_meta_t *file_meta)
 {
     size_t pos;
+    psa_status_t err;
 
     /* Calculate the position */
     pos = its_mblock_file_meta_offset(fs_ctx, idx);
-    return fs_ctx->ops->write(fs_ctx->cfg, fs_ctx->scratch_metablock,
-                              (const uint8_t *)file_meta, pos,
-                              ITS_FILE_METADATA_SIZE);
+    err = fs_ctx->ops->write(fs_ctx->cfg, fs_ctx->scratch_metablock,
+                             (const uint8_t *)file_meta, pos,
+                             ITS_FILE_METADATA_SIZE);
+
+#if ITS_RAM_INDEX
+    if (err == PSA_SUCCESS) {
+        its_flash_fs_index_stage_file(fs_ctx, idx, file_meta);
+    }
+#endif
+
+    return err;
 }
 
 psa_status_t its_flash_fs_block_to_block_move(struct its_flash_fs_ctx_t *fs_ctx,
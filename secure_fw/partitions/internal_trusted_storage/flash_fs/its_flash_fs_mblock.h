@@ -14,6 +14,7 @@
 
 #include "flash/its_flash.h"
 #include "its_flash_fs.h"
+#include "its_flash_fs_index.h"
 #include "its_utils.h"
 #include "psa/error.h"
 
@@ -179,6 +180,51 @@ struct its_file_meta_t {
 };
 #undef _T3
 
+#if ITS_BATCH_COMMIT
+/*!
+ * \struct its_flash_fs_batch_op_t
+ *
+ * \brief Structure to store a file operation staged in a batch, and how it is
+ *        applied to the filesystem when the batch is committed.
+ */
+struct its_flash_fs_batch_op_t {
+    uint8_t fid[ITS_FILE_ID_SIZE]; /*!< ID of the file */
+    bool write;                    /*!< The file is written, otherwise it is
+                                    *   deleted
+                                    */
+    const uint8_t *data;           /*!< File content */
+    size_t data_size;              /*!< Size of the file content */
+    size_t max_size;               /*!< Maximum size of the file */
+    uint32_t flags;                /*!< Flags set when the file is created */
+#ifdef ITS_ENCRYPTION
+    uint8_t nonce[TFM_ITS_ENC_NONCE_LENGTH]; /*!< Nonce/IV of the file */
+    uint8_t tag[TFM_ITS_AUTH_TAG_LENGTH];    /*!< Authentication tag */
+#endif
+    bool exists;                   /*!< The file exists in the filesystem */
+    bool release;                  /*!< The existing file data is released */
+    bool reserve;                  /*!< New space is reserved for the file */
+    uint32_t idx;                  /*!< File metadata entry index */
+    uint32_t old_lblock;           /*!< Logical block of the existing file */
+    size_t old_data_idx;           /*!< Offset of the existing file data */
+    size_t old_max_size;           /*!< Maximum size of the existing file */
+    uint32_t lblock;               /*!< Logical block of the file data */
+    size_t data_idx;               /*!< Offset of the file data */
+};
+
+/*!
+ * \struct its_flash_fs_batch_t
+ *
+ * \brief Structure to store the file operations staged in a batch.
+ */
+struct its_flash_fs_batch_t {
+    struct its_flash_fs_batch_op_t ops[ITS_BATCH_MAX_OPS]; /*!< Staged
+                                                            *   operations
+                                                            */
+    uint32_t num_ops;              /*!< Number of staged operations */
+    bool active;                   /*!< A batch has been started */
+};
+#endif /* ITS_BATCH_COMMIT */
+
 /**
  * \struct its_flash_fs_ctx_t
  *
@@ -192,6 +238,20 @@ struct its_flash_fs_ctx_t {
                                                            */
     uint32_t active_metablock;  /**< Active metadata block */
     uint32_t scratch_metablock; /**< Scratch metadata block */
+#if ITS_RAM_INDEX
+    struct its_flash_fs_index_t index; /**< RAM index of the files */
+#endif
+#if ITS_BATCH_COMMIT
+    struct its_flash_fs_batch_t batch; /**< Staged file operations */
+#endif
+#if ITS_APPEND_IN_PLACE
+    bool scratch_dblock_unused; /**< The scratch data block has not been
+                                 *   written by the metadata block update
+                                 *   being finalized, so it does not need
+                                 *   erasing. Only set around the finalize
+                                 *   call of an in-place append.
+                                 */
+#endif
 };
 
 /**
@@ -390,6 +450,24 @@ psa_status_t its_flash_fs_mblock_update_scratch_block_meta(
                                            uint32_t lblock,
                                            struct its_block_meta_t *block_meta);
 
+/**
+ * \brief Writes a logical block's metadata in the scratch metadata block,
+ *        without copying the metadata of the other logical blocks.
+ *
+ * \note Each logical block's metadata must be written exactly once per
+ *       metadata block update.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in]     lblock      Logical block number
+ * \param[in]     block_meta  Pointer to block's metadata
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_mblock_write_scratch_block_meta(
+                                     struct its_flash_fs_ctx_t *fs_ctx,
+                                     uint32_t lblock,
+                                     const struct its_block_meta_t *block_meta);
+
 /**
  * \brief Writes a file metadata entry into scratch metadata block.
  *
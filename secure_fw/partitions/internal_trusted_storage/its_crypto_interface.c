@@ -9,6 +9,7 @@
 
 #include "flash_fs/its_flash_fs.h"
 #include "flash/its_flash.h"
+#include "its_crypto_interface.h"
 #include "its_utils.h"
 #include "psa_manifest/pid.h"
 #include "tfm_hal_its_encryption.h"
@@ -164,3 +165,124 @@ psa_status_t tfm_its_crypt_file(struct its_flash_fs_file_info_t *finfo,
     return PSA_SUCCESS;
 }
 
+#if ITS_ENCRYPTION_CHUNK_SIZE
+#if TFM_ITS_ENC_NONCE_LENGTH < 4
+#error "TFM_ITS_ENC_NONCE_LENGTH must be at least 4 to hold the chunk index"
+#endif
+
+psa_status_t tfm_its_crypt_chunk(struct its_flash_fs_file_info_t *finfo,
+                                 uint8_t *fid,
+                                 const size_t fid_size,
+                                 const size_t file_size,
+                                 const uint32_t chunk_idx,
+                                 const uint8_t *input,
+                                 const size_t input_size,
+                                 uint8_t *output,
+                                 const size_t output_size,
+                                 const bool is_encrypt)
+{
+    struct tfm_hal_its_auth_crypt_ctx aead_ctx = {0};
+    uint8_t nonce[TFM_ITS_ENC_NONCE_LENGTH];
+    uint8_t tag[TFM_ITS_AUTH_TAG_LENGTH];
+    enum tfm_hal_status_t err;
+    size_t data_size;
+    size_t i;
+
+    if (finfo == NULL || output == NULL) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (is_encrypt) {
+        data_size = input_size;
+        if (data_size > ITS_ENCRYPTION_CHUNK_SIZE ||
+            output_size < data_size + sizeof(tag)) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+    } else {
+        if (input_size < sizeof(tag)) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        data_size = input_size - sizeof(tag);
+        if (data_size > ITS_ENCRYPTION_CHUNK_SIZE || output_size < data_size) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    err =  tfm_its_fill_enc_add(finfo->aad,
+                                sizeof(finfo->aad),
+                                fid,
+                                fid_size,
+                                finfo->flags,
+                                file_size);
+    if (err != TFM_HAL_SUCCESS) {
+        return tfm_hal_to_psa_error(err);
+    }
+
+    if (is_encrypt && chunk_idx == 0) {
+        err = tfm_hal_its_aead_generate_nonce(finfo->nonce,
+                                              sizeof(finfo->nonce));
+
+        if (err != TFM_HAL_SUCCESS) {
+            return tfm_hal_to_psa_error(err);
+        }
+    }
+
+    /* Bind the chunk index to the nonce, so that chunks cannot be reordered */
+    memcpy(nonce, finfo->nonce, sizeof(nonce));
+    for (i = 0; i < sizeof(chunk_idx); i++) {
+        nonce[sizeof(nonce) - 1 - i] ^= (uint8_t)(chunk_idx >> (8 * i));
+    }
+
+    /* Set all required parameters for the aead operation context */
+    aead_ctx.nonce = nonce;
+    aead_ctx.nonce_size = sizeof(nonce);
+    aead_ctx.deriv_label = fid;
+    aead_ctx.deriv_label_size = fid_size;
+    aead_ctx.aad = finfo->aad;
+    aead_ctx.aad_size = sizeof(finfo->aad);
+
+    if (is_encrypt) {
+        err = tfm_hal_its_aead_encrypt(&aead_ctx,
+                                       input,
+                                       data_size,
+                                       output,
+                                       output_size,
+                                       tag,
+                                       sizeof(tag));
+        if (err == TFM_HAL_SUCCESS) {
+            memcpy(output + data_size, tag, sizeof(tag));
+        }
+    } else {
+        /* The tag is copied as the decryption API does not take it as const */
+        memcpy(tag, input + data_size, sizeof(tag));
+        err = tfm_hal_its_aead_decrypt(&aead_ctx,
+                                       input,
+                                       data_size,
+                                       tag,
+                                       sizeof(tag),
+                                       output,
+                                       output_size);
+    }
+
+    if (err != TFM_HAL_SUCCESS) {
+        return tfm_hal_to_psa_error(err);
+    }
+
+    return PSA_SUCCESS;
+}
+
+size_t tfm_its_enc_plain_size(size_t stored_size)
+{
+    size_t last_size = stored_size % ITS_ENC_STORED_CHUNK_SIZE;
+
+    /* A last chunk too short to hold a tag fails to authenticate when read */
+    if (last_size > TFM_ITS_AUTH_TAG_LENGTH) {
+        last_size -= TFM_ITS_AUTH_TAG_LENGTH;
+    } else {
+        last_size = 0;
+    }
+
+    return ((stored_size / ITS_ENC_STORED_CHUNK_SIZE) *
+            ITS_ENCRYPTION_CHUNK_SIZE) + last_size;
+}
+#endif /* ITS_ENCRYPTION_CHUNK_SIZE */
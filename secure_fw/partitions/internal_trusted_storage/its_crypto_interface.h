@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2019-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 
 
+#include "config_tfm.h"
 #include "flash_fs/its_flash_fs.h"
 #include "flash/its_flash.h"
 #include "its_utils.h"
@@ -16,6 +17,37 @@
 #include "tfm_its_defs.h"
 #include "tfm_sp_log.h"
 
+/* The encryption format of a file, which is the size of its chunks or 0 if the
+ * whole file is encrypted at once, is stored in the user flags of the file
+ * above the PSA storage flags. It is authenticated with the file as part of the
+ * additional data.
+ */
+#define ITS_ENC_FORMAT_POS  (3U)
+#define ITS_ENC_FORMAT_MASK (ITS_FLASH_FS_USER_FLAGS_MASK & \
+                             ~((1UL << ITS_ENC_FORMAT_POS) - 1))
+#define ITS_ENC_FORMAT      ((uint32_t)ITS_ENCRYPTION_CHUNK_SIZE << \
+                             ITS_ENC_FORMAT_POS)
+
+#if (ITS_ENCRYPTION_CHUNK_SIZE > (ITS_ENC_FORMAT_MASK >> ITS_ENC_FORMAT_POS))
+#error "ITS_ENCRYPTION_CHUNK_SIZE is too large to be recorded with the files"
+#endif
+
+#if ITS_ENCRYPTION_CHUNK_SIZE
+/* Size of an encrypted chunk stored in the filesystem, followed by its tag */
+#define ITS_ENC_STORED_CHUNK_SIZE (ITS_ENCRYPTION_CHUNK_SIZE + \
+                                   TFM_ITS_AUTH_TAG_LENGTH)
+
+/* Number of chunks of a file. An empty file has a single empty chunk, so that
+ * its tag authenticates the file metadata.
+ */
+#define ITS_ENC_NUM_CHUNKS(size) (((size) == 0) ? 1 : \
+    (((size) + ITS_ENCRYPTION_CHUNK_SIZE - 1) / ITS_ENCRYPTION_CHUNK_SIZE))
+
+/* Size of a file stored in the filesystem for a given plaintext size */
+#define ITS_ENC_STORED_SIZE(size) ((size) + \
+    (ITS_ENC_NUM_CHUNKS(size) * TFM_ITS_AUTH_TAG_LENGTH))
+#endif /* ITS_ENCRYPTION_CHUNK_SIZE */
+
 /**
  * \brief Perform encryption/decryption of the buffer using the
  *        tfm_hal_its APIs
@@ -41,3 +73,50 @@ psa_status_t tfm_its_crypt_file(struct its_flash_fs_file_info_t *finfo,
                                 const size_t output_size,
                                 const bool is_encrypt);
 
+#if ITS_ENCRYPTION_CHUNK_SIZE
+/**
+ * \brief Perform encryption/decryption of a single chunk of a file using the
+ *        tfm_hal_its APIs
+ *
+ * \details Each chunk is authenticated with its own tag, which is stored after
+ *          the chunk ciphertext. The nonce of a chunk is the nonce of the file
+ *          with the chunk index XORed into its last four bytes. The nonce of
+ *          the file is generated when the first chunk is encrypted, so the
+ *          chunks of a file must be encrypted in order.
+ *
+ * \param[in]   finfo         Pointer to \ref its_flash_fs_file_info_t
+ * \param[in]   fid           File identifier
+ * \param[in]   fid_size      File identifier size in bytes
+ * \param[in]   file_size     Plaintext size of the whole file in bytes
+ * \param[in]   chunk_idx     Index of the chunk in the file
+ * \param[in]   input         Input buffer. When decrypting, the ciphertext is
+ *                            followed by the tag.
+ * \param[in]   input_size    Input size in bytes
+ * \param[out]  output        Output buffer. When encrypting, the ciphertext is
+ *                            followed by the tag.
+ * \param[in]   output_size   Output size in bytes
+ * \param[in]   is_encrypt    Set the operation type (encryption/decryption)
+ *
+ * \return PSA_SUCCESS on successful operation or a valid PSA error code
+ *
+ */
+psa_status_t tfm_its_crypt_chunk(struct its_flash_fs_file_info_t *finfo,
+                                 uint8_t *fid,
+                                 const size_t fid_size,
+                                 const size_t file_size,
+                                 const uint32_t chunk_idx,
+                                 const uint8_t *input,
+                                 const size_t input_size,
+                                 uint8_t *output,
+                                 const size_t output_size,
+                                 const bool is_encrypt);
+
+/**
+ * \brief Gets the plaintext size of a file from its size in the filesystem
+ *
+ * \param[in]   stored_size   Size of the file in the filesystem in bytes
+ *
+ * \return Plaintext size of the file in bytes
+ */
+size_t tfm_its_enc_plain_size(size_t stored_size);
+#endif /* ITS_ENCRYPTION_CHUNK_SIZE */
@@ -6,7 +6,7 @@
  */
 #include <string.h>
 #include "psa/framework_feature.h"
-#if PSA_FRAMEWORK_HAS_MM_IOVEC != 1
+#if (PSA_FRAMEWORK_HAS_MM_IOVEC != 1) || defined(ITS_ENCRYPTION)
 #include "cmsis_compiler.h"
 #endif
 #include "config_tfm.h"
@@ -39,14 +39,21 @@ extern uint8_t *p_psa_dest_data;
 static uint8_t g_fid[ITS_FILE_ID_SIZE];
 static struct its_flash_fs_file_info_t g_file_info;
 
-#if (PSA_FRAMEWORK_HAS_MM_IOVEC != 1) && defined(TFM_PARTITION_INTERNAL_TRUSTED_STORAGE)
-/* Buffer to store asset data from the caller.
+#if defined(TFM_PARTITION_INTERNAL_TRUSTED_STORAGE) && \
+    ((PSA_FRAMEWORK_HAS_MM_IOVEC != 1) || defined(ITS_ENCRYPTION))
+/* Buffer to store asset data from the caller. With memory-mapped iovecs, the
+ * asset data is streamed between the mapped client buffer and the filesystem,
+ * so the buffer is only needed to decrypt whole files.
  * Note: size must be aligned to the max flash program unit to meet the
  * alignment requirement of the filesystem.
  */
 #ifndef ITS_ENCRYPTION
 static uint8_t __ALIGNED(4) asset_data[ITS_UTILS_ALIGN(ITS_BUF_SIZE,
                                           ITS_FLASH_MAX_ALIGNMENT)];
+#elif ITS_ENCRYPTION_CHUNK_SIZE
+/* Encrypted files are processed one chunk at a time */
+static uint8_t __ALIGNED(4) asset_data[ITS_UTILS_ALIGN(ITS_ENCRYPTION_CHUNK_SIZE,
+                                          ITS_FLASH_MAX_ALIGNMENT)];
 #else
 static uint8_t __ALIGNED(4) asset_data[ITS_UTILS_ALIGN(ITS_MAX_ASSET_SIZE,
                                               ITS_FLASH_MAX_ALIGNMENT)];
@@ -54,22 +61,43 @@ static uint8_t __ALIGNED(4) asset_data[ITS_UTILS_ALIGN(ITS_MAX_ASSET_SIZE,
 #endif
 
 #ifdef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+#if ITS_RAM_INDEX && ((ITS_NUM_ASSETS + 1) >= ITS_RAM_INDEX_SIZE)
+#error "ITS_RAM_INDEX_SIZE must be greater than ITS_NUM_ASSETS + 1"
+#endif
+
 static struct its_flash_fs_ctx_t fs_ctx_its;
 static struct its_flash_fs_config_t fs_cfg_its = {
     .flash_dev = &ITS_FLASH_DEV,
     .program_unit = ITS_FLASH_ALIGNMENT,
+#if defined(ITS_ENCRYPTION) && ITS_ENCRYPTION_CHUNK_SIZE
+    /* Each chunk of an encrypted file is stored with its authentication tag */
+    .max_file_size = ITS_UTILS_ALIGN(ITS_ENC_STORED_SIZE(ITS_MAX_ASSET_SIZE),
+                                     ITS_FLASH_ALIGNMENT),
+#else
     .max_file_size = ITS_UTILS_ALIGN(ITS_MAX_ASSET_SIZE, ITS_FLASH_ALIGNMENT),
+#endif
     .max_num_files = ITS_NUM_ASSETS + 1, /* Extra file for atomic replacement */
+#if ITS_APPEND_IN_PLACE
+    .reprogram_erased = ITS_FLASH_REPROGRAM_ERASED,
+#endif
 };
 #endif /* TFM_PARTITION_INTERNAL_TRUSTED_STORAGE */
 
 #ifdef TFM_PARTITION_PROTECTED_STORAGE
+/* The PS filesystem also holds the object table and its journal files */
+#if ITS_RAM_INDEX && (PS_MAX_NUM_OBJECTS >= ITS_RAM_INDEX_SIZE)
+#error "ITS_RAM_INDEX_SIZE must be greater than the number of PS objects and object table files"
+#endif
+
 static struct its_flash_fs_ctx_t fs_ctx_ps;
 static struct its_flash_fs_config_t fs_cfg_ps = {
     .flash_dev = &PS_FLASH_DEV,
     .program_unit = PS_FLASH_ALIGNMENT,
     .max_file_size = ITS_UTILS_ALIGN(PS_MAX_OBJECT_SIZE, PS_FLASH_ALIGNMENT),
     .max_num_files = PS_MAX_NUM_OBJECTS,
+#if ITS_APPEND_IN_PLACE
+    .reprogram_erased = PS_FLASH_REPROGRAM_ERASED,
+#endif
 };
 #endif
 
@@ -89,12 +117,24 @@ static struct its_flash_fs_ctx_t *get_fs_ctx(int32_t client_id)
 }
 
 #ifdef ITS_ENCRYPTION
+#if ITS_ENCRYPTION_CHUNK_SIZE
+/* All the chunks but the last one must be programmed with aligned sizes */
+#if (ITS_ENC_STORED_CHUNK_SIZE % ITS_FLASH_ALIGNMENT) != 0
+#error "ITS_ENCRYPTION_CHUNK_SIZE + TFM_ITS_AUTH_TAG_LENGTH must be aligned to the ITS flash program unit"
+#endif
+
+/* Buffer to store an encrypted chunk and its authentication tag */
+static uint8_t __ALIGNED(4) enc_asset_data[ITS_UTILS_ALIGN(
+                                           ITS_ENC_STORED_CHUNK_SIZE,
+                                           ITS_FLASH_MAX_ALIGNMENT)];
+#else
 /* Buffer to store the encrypted asset data and the authentication tag before it
  * is stored in the filesystem.
  */
 static uint8_t __ALIGNED(4) enc_asset_data[ITS_UTILS_ALIGN(ITS_MAX_ASSET_SIZE +
                                            TFM_ITS_AUTH_TAG_LENGTH,
                                            ITS_FLASH_MAX_ALIGNMENT)];
+#endif /* ITS_ENCRYPTION_CHUNK_SIZE */
 
 static psa_status_t buffer_size_check(int32_t client_id, size_t buffer_size)
 {
@@ -105,7 +145,7 @@ static psa_status_t buffer_size_check(int32_t client_id, size_t buffer_size)
     {
 #endif /* TFM_PARTITION_PROTECTED_STORAGE */
         /* When encryption is enabled the whole file needs to fit in the
-         * global buffer.
+         * global buffer, or in the filesystem when it is encrypted in chunks.
          */
         if (buffer_size > ITS_MAX_ASSET_SIZE) {
             return PSA_ERROR_INVALID_ARGUMENT;
@@ -114,6 +154,174 @@ static psa_status_t buffer_size_check(int32_t client_id, size_t buffer_size)
     return PSA_SUCCESS;
 }
 
+#if ITS_ENCRYPTION_CHUNK_SIZE
+/* Context of the data source which encrypts the asset data of the caller */
+struct its_enc_src_ctx_t {
+    size_t file_size;   /* Plaintext size of the file */
+    uint32_t chunk_idx; /* Index of the next chunk to encrypt */
+};
+
+/**
+ * \brief Reads the next chunk of the asset data from the caller and encrypts
+ *        it in the enc_asset_data buffer.
+ *
+ * \param[in,out] src_ctx    Pointer to \ref its_enc_src_ctx_t
+ * \param[in]     size       Size of the data still to be written
+ * \param[out]    data       Pointer to the encrypted chunk and its tag
+ * \param[out]    part_size  Size of the encrypted chunk and its tag
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t tfm_its_read_enc_chunk(void *src_ctx, size_t size,
+                                           const uint8_t **data,
+                                           size_t *part_size)
+{
+    struct its_enc_src_ctx_t *ctx = (struct its_enc_src_ctx_t *)src_ctx;
+    const uint8_t *chunk;
+    size_t chunk_size;
+    psa_status_t status;
+
+    (void)size;
+
+    chunk_size = ITS_UTILS_MIN(ctx->file_size -
+                               ((size_t)ctx->chunk_idx *
+                                ITS_ENCRYPTION_CHUNK_SIZE),
+                               ITS_ENCRYPTION_CHUNK_SIZE);
+
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+    /* The asset data of the caller is mapped, encrypt it from there */
+    chunk = its_req_mngr_get_vec_base() +
+            ((size_t)ctx->chunk_idx * ITS_ENCRYPTION_CHUNK_SIZE);
+#else
+    /* Read asset data from the caller */
+    (void)its_req_mngr_read(asset_data, chunk_size);
+    chunk = asset_data;
+#endif
+
+    status = tfm_its_crypt_chunk(&g_file_info,
+                                 g_fid,
+                                 sizeof(g_fid),
+                                 ctx->file_size,
+                                 ctx->chunk_idx,
+                                 chunk,
+                                 chunk_size,
+                                 enc_asset_data,
+                                 sizeof(enc_asset_data),
+                                 true);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    ctx->chunk_idx++;
+    *data = enc_asset_data;
+    *part_size = chunk_size + TFM_ITS_AUTH_TAG_LENGTH;
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Reads the asset data from the caller and writes it encrypted to the
+ *        filesystem, one chunk at a time, in a single filesystem update.
+ *
+ * \param[in] client_id    Identifier of the caller
+ * \param[in] data_length  Size of the asset data in bytes
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t tfm_its_set_encrypted(int32_t client_id,
+                                          size_t data_length)
+{
+    struct its_enc_src_ctx_t enc_ctx = {
+        .file_size = data_length,
+        .chunk_idx = 0,
+    };
+    struct its_flash_fs_data_src_t src = {
+        .read = tfm_its_read_enc_chunk,
+        .ctx = &enc_ctx,
+    };
+
+    /* The tags are stored with the chunks */
+    memset(g_file_info.tag, 0, sizeof(g_file_info.tag));
+    g_file_info.size_max = ITS_ENC_STORED_SIZE(data_length);
+
+    return its_flash_fs_file_write_src(get_fs_ctx(client_id), g_fid,
+                                       &g_file_info, g_file_info.size_max, 0,
+                                       &src);
+}
+
+static psa_status_t tfm_its_get_encrypted(int32_t client_id,
+                         size_t data_offset,
+                         size_t data_size,
+                         size_t *p_data_length)
+{
+    psa_status_t status;
+    size_t file_size = g_file_info.size_current;
+    uint32_t chunk_idx = data_offset / ITS_ENCRYPTION_CHUNK_SIZE;
+    size_t chunk_offset = data_offset % ITS_ENCRYPTION_CHUNK_SIZE;
+    size_t chunk_size;
+    size_t copy_size;
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+    size_t copied = 0;
+#endif
+
+    /* Reading at the end of the file still authenticates its last chunk */
+    if (chunk_idx >= ITS_ENC_NUM_CHUNKS(file_size)) {
+        chunk_idx = ITS_ENC_NUM_CHUNKS(file_size) - 1;
+        chunk_offset = data_offset - ((size_t)chunk_idx *
+                                      ITS_ENCRYPTION_CHUNK_SIZE);
+    }
+
+    /* Only decrypt the chunks which contain the requested data */
+    do {
+        chunk_size = ITS_UTILS_MIN(file_size -
+                                   ((size_t)chunk_idx *
+                                    ITS_ENCRYPTION_CHUNK_SIZE),
+                                   ITS_ENCRYPTION_CHUNK_SIZE);
+
+        status = its_flash_fs_file_read(get_fs_ctx(client_id),
+                                        g_fid,
+                                        chunk_size + TFM_ITS_AUTH_TAG_LENGTH,
+                                        (size_t)chunk_idx *
+                                        ITS_ENC_STORED_CHUNK_SIZE,
+                                        enc_asset_data);
+        if (status != PSA_SUCCESS) {
+            *p_data_length = 0;
+            return status;
+        }
+
+        status = tfm_its_crypt_chunk(&g_file_info,
+                                     g_fid,
+                                     sizeof(g_fid),
+                                     file_size,
+                                     chunk_idx,
+                                     enc_asset_data,
+                                     chunk_size + TFM_ITS_AUTH_TAG_LENGTH,
+                                     asset_data,
+                                     sizeof(asset_data),
+                                     false);
+        if (status != PSA_SUCCESS) {
+            *p_data_length = 0;
+            return status;
+        }
+
+        /* Write the requested part of the chunk to the caller */
+        copy_size = ITS_UTILS_MIN(data_size, chunk_size - chunk_offset);
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+        memcpy(its_req_mngr_get_vec_base() + copied,
+               asset_data + chunk_offset, copy_size);
+        copied += copy_size;
+#else
+        its_req_mngr_write(asset_data + chunk_offset, copy_size);
+#endif
+
+        data_size -= copy_size;
+        chunk_offset = 0;
+        chunk_idx++;
+    } while (data_size > 0);
+
+    return PSA_SUCCESS;
+}
+#else
 static psa_status_t tfm_its_crypt_data(int32_t client_id,
                                 uint8_t **input,
                                 size_t input_size,
@@ -193,6 +401,7 @@ static psa_status_t tfm_its_get_encrypted(int32_t client_id,
 
     return PSA_SUCCESS;
 }
+#endif /* ITS_ENCRYPTION_CHUNK_SIZE */
 #endif /* ITS_ENCRYPTION */
 
 #ifdef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
@@ -310,6 +519,11 @@ psa_status_t tfm_its_init(void)
         status = its_flash_fs_prepare(&fs_ctx_its);
     }
 #endif /* ITS_CREATE_FLASH_LAYOUT */
+#if ITS_RAM_INDEX
+    if ((status == PSA_SUCCESS) && !fs_ctx_its.index.valid) {
+        LOG_INFFMT("[ITS] Warning: too many data blocks for the RAM file index, increase ITS_RAM_INDEX_MAX_DBLOCKS\r\n");
+    }
+#endif
 #endif /* TFM_PARTITION_INTERNAL_TRUSTED_STORAGE */
 
 #ifdef TFM_PARTITION_PROTECTED_STORAGE
@@ -357,6 +571,11 @@ psa_status_t tfm_its_init(void)
         status = its_flash_fs_prepare(&fs_ctx_ps);
     }
 #endif /* PS_CREATE_FLASH_LAYOUT */
+#if ITS_RAM_INDEX
+    if ((status == PSA_SUCCESS) && !fs_ctx_ps.index.valid) {
+        LOG_INFFMT("[PS] Warning: too many data blocks for the RAM file index, increase ITS_RAM_INDEX_MAX_DBLOCKS\r\n");
+    }
+#endif
 #endif /* TFM_PARTITION_PROTECTED_STORAGE */
 
     return status;
@@ -364,6 +583,10 @@ psa_status_t tfm_its_init(void)
 
 static psa_status_t get_file_info(psa_storage_uid_t uid, int32_t client_id)
 {
+#if defined(ITS_ENCRYPTION) && ITS_ENCRYPTION_CHUNK_SIZE
+    psa_status_t status;
+
+#endif
     /* Check that the UID is valid */
     if (uid == TFM_ITS_INVALID_UID) {
         return PSA_ERROR_INVALID_ARGUMENT;
@@ -374,10 +597,60 @@ static psa_status_t get_file_info(psa_storage_uid_t uid, int32_t client_id)
     memcpy(g_fid + sizeof(client_id), (const void *)&uid, sizeof(uid));
 
     /* Read file info */
+#if defined(ITS_ENCRYPTION) && ITS_ENCRYPTION_CHUNK_SIZE
+    status = its_flash_fs_file_get_info(get_fs_ctx(client_id), g_fid,
+                                        &g_file_info);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    if (client_id != TFM_SP_PS) {
+#else
+    {
+#endif /* TFM_PARTITION_PROTECTED_STORAGE */
+        /* Report the plaintext sizes of encrypted files */
+        g_file_info.size_current =
+                             tfm_its_enc_plain_size(g_file_info.size_current);
+        g_file_info.size_max = tfm_its_enc_plain_size(g_file_info.size_max);
+    }
+
+    return PSA_SUCCESS;
+#else
     return its_flash_fs_file_get_info(get_fs_ctx(client_id), g_fid,
                                       &g_file_info);
+#endif
 }
 
+#if defined(ITS_ENCRYPTION) && defined(TFM_PARTITION_INTERNAL_TRUSTED_STORAGE)
+/**
+ * \brief Checks that the file read by get_file_info() is encrypted in the
+ *        format of this image, which is recorded in the file flags.
+ *
+ * \param[in] client_id  Identifier of the caller
+ *
+ * \return Returns PSA_ERROR_DATA_CORRUPT if the file has been encrypted with
+ *         another ITS_ENCRYPTION_CHUNK_SIZE, otherwise PSA_SUCCESS.
+ */
+static psa_status_t check_enc_format(int32_t client_id)
+{
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    /* With protected storage no encryption is used */
+    if (client_id == TFM_SP_PS) {
+        return PSA_SUCCESS;
+    }
+#else
+    (void)client_id;
+#endif /* TFM_PARTITION_PROTECTED_STORAGE */
+
+    if ((g_file_info.flags & ITS_ENC_FORMAT_MASK) != ITS_ENC_FORMAT) {
+        LOG_ERRFMT("[ITS] File encrypted with another chunk size\r\n");
+        return PSA_ERROR_DATA_CORRUPT;
+    }
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_ENCRYPTION && TFM_PARTITION_INTERNAL_TRUSTED_STORAGE */
 
 static psa_status_t tfm_its_write_data_to_fs(const int32_t client_id,
                                      const uint8_t *fid,
@@ -388,12 +661,12 @@ static psa_status_t tfm_its_write_data_to_fs(const int32_t client_id,
 {
     psa_status_t status;
     uint8_t *buffer_ptr = data;
-#ifdef ITS_ENCRYPTION /* ITS_ENCRYPTION */
+#if defined(ITS_ENCRYPTION) && !ITS_ENCRYPTION_CHUNK_SIZE
     status = tfm_its_crypt_data(client_id, &buffer_ptr, data_size, offset);
     if (status != PSA_SUCCESS) {
         return status;
     }
-#endif /* ITS_ENCRYPTION */
+#endif /* ITS_ENCRYPTION && !ITS_ENCRYPTION_CHUNK_SIZE */
     status = its_flash_fs_file_write(get_fs_ctx(client_id),
                                         fid,
                                         &g_file_info,
@@ -454,6 +727,29 @@ psa_status_t tfm_its_set(int32_t client_id,
     g_file_info.size_max = data_length;
     g_file_info.flags = (uint32_t)create_flags |
                         ITS_FLASH_FS_FLAG_CREATE | ITS_FLASH_FS_FLAG_TRUNCATE;
+#if ITS_APPEND_IN_PLACE
+    /* Data written in several chunks is appended in place after the first,
+     * when the flash of the filesystem allows it.
+     */
+    if (get_fs_ctx(client_id)->cfg->reprogram_erased) {
+        g_file_info.flags |= ITS_FLASH_FS_FLAG_APPEND;
+    }
+#endif
+
+#if defined ITS_ENCRYPTION && ITS_ENCRYPTION_CHUNK_SIZE && \
+    defined TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    if (client_id != TFM_SP_PS) {
+#else
+    {
+#endif /* TFM_PARTITION_PROTECTED_STORAGE */
+        /* Record the chunk size, so that a file is not decrypted with another
+         * one
+         */
+        g_file_info.flags |= ITS_ENC_FORMAT;
+        return tfm_its_set_encrypted(client_id, data_length);
+    }
+#endif /* ITS_ENCRYPTION && ITS_ENCRYPTION_CHUNK_SIZE && ... */
 
 
 #ifndef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
@@ -578,12 +874,13 @@ psa_status_t tfm_its_get(int32_t client_id,
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
-#if defined ITS_ENCRYPTION && defined TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+#if defined ITS_ENCRYPTION && defined TFM_PARTITION_INTERNAL_TRUSTED_STORAGE && \
+    !ITS_ENCRYPTION_CHUNK_SIZE
     status = buffer_size_check(client_id, data_offset + data_size);
     if (status != PSA_SUCCESS) {
         return status;
     }
-#endif /* ITS_ENCRYPTION && TFM_PARTITION_INTERNAL_TRUSTED_STORAGE */
+#endif /* ITS_ENCRYPTION && TFM_PARTITION_INTERNAL_TRUSTED_STORAGE && ... */
 
     /* Read file info */
     status = get_file_info(uid, client_id);
@@ -591,6 +888,13 @@ psa_status_t tfm_its_get(int32_t client_id,
         return status;
     }
 
+#if defined ITS_ENCRYPTION && defined TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+    status = check_enc_format(client_id);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+#endif /* ITS_ENCRYPTION && TFM_PARTITION_INTERNAL_TRUSTED_STORAGE */
+
     /* Boundary check the incoming request */
     if (data_offset > g_file_info.size_current) {
         return PSA_ERROR_INVALID_ARGUMENT;
@@ -631,6 +935,16 @@ psa_status_t tfm_its_get_info(int32_t client_id, psa_storage_uid_t uid,
         return status;
     }
 
+#if defined ITS_ENCRYPTION && defined TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+    /* The plaintext size of the file depends on its encryption format */
+    status = check_enc_format(client_id);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    g_file_info.flags &= ~ITS_ENC_FORMAT_MASK;
+#endif /* ITS_ENCRYPTION && TFM_PARTITION_INTERNAL_TRUSTED_STORAGE */
+
     /* Copy file info to the PSA info struct */
     p_info->capacity = g_file_info.size_current;
     p_info->size = g_file_info.size_current;
@@ -1,26 +1,61 @@
 /*
- * Copyright (c) 2019-2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 
-#include <stddef.h>
-#include <stdint.h>
+#include "crt_impl_private.h"
 
-int memcmp(const void *s1, const void *s2, size_t n)
+static inline int memcmp_bytes(const uint8_t *p1, const uint8_t *p2, size_t n,
+                               int result)
 {
-    int result = 0;
-    const uint8_t *p1 = (const uint8_t *)s1;
-    const uint8_t *p2 = (const uint8_t *)s2;
-
     while (n--) {
         if ((*p1 != *p2) && (result == 0)) {
             result = *p1 - *p2;
-        } else {
-            p1++;
-            p2++;
         }
+        p1++;
+        p2++;
     }
+
     return result;
 }
+
+/*
+ * All the n bytes are always read, the comparison does not stop at the first
+ * difference. Words are compared when both addresses share the same alignment.
+ */
+int memcmp(const void *s1, const void *s2, size_t n)
+{
+    int result = 0;
+    union composite_addr_t p1, p2;
+    size_t head;
+
+    p1.uint_addr = (uintptr_t)s1;
+    p2.uint_addr = (uintptr_t)s2;
+
+    if (ADDR_WORD_UNALIGNED(p1.uint_addr) == ADDR_WORD_UNALIGNED(p2.uint_addr)) {
+        head = (sizeof(uint32_t) - ADDR_WORD_UNALIGNED(p1.uint_addr)) & 0x3;
+        if (head > n) {
+            head = n;
+        }
+
+        result = memcmp_bytes(p1.p_byte, p2.p_byte, head, result);
+        p1.p_byte += head;
+        p2.p_byte += head;
+        n -= head;
+
+        while (n >= sizeof(uint32_t)) {
+            /* Locate the first different byte in memory order */
+            if ((*p1.p_word != *p2.p_word) && (result == 0)) {
+                result = memcmp_bytes(p1.p_byte, p2.p_byte,
+                                      sizeof(uint32_t), result);
+            }
+            p1.p_word++;
+            p2.p_word++;
+            n -= sizeof(uint32_t);
+        }
+    }
+
+    return memcmp_bytes(p1.p_byte, p2.p_byte, n, result);
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -23,4 +23,45 @@ psa_status_t tfm_core_get_boot_data(uint8_t major_type,
                                     struct tfm_boot_data *boot_data,
                                     uint32_t len);
 
+#ifdef CONFIG_TFM_SPM_TRACE
+/**
+ * \brief Copy SPM trace data into a buffer. Only the Platform partition is
+ *        allowed to read it, SPM panics on a call from another partition, an
+ *        unknown type or a buffer the caller cannot write.
+ *
+ * \param[in]  type   Type of the data, TFM_SPM_TRACE_TYPE_EVENTS or
+ *                    TFM_SPM_TRACE_TYPE_HISTOGRAMS.
+ * \param[in]  start  Sequence number of the first event, or index of the
+ *                    first histogram, to copy.
+ * \param[out] buf    Buffer to copy the records into.
+ * \param[in]  len    The length of the buffer. Only whole records are copied.
+ *
+ * \return The number of bytes copied, 0 when no more records are available.
+ */
+uint32_t tfm_core_get_spm_trace(uint32_t type, uint32_t start,
+                                void *buf, uint32_t len);
+#endif /* CONFIG_TFM_SPM_TRACE */
+
+#ifdef CONFIG_TFM_SPM_LOG_DEFERRED
+/**
+ * \brief Store a deferred log record of the calling partition.
+ *
+ * \param[in]  fmt    The format string, recorded by its address only.
+ * \param[in]  args   The arguments, as 32-bit words.
+ * \param[in]  nargs  The number of arguments, up to LOG_DEFERRED_MAX_ARGS.
+ *
+ * \return Always 0.
+ */
+int32_t tfm_core_log_deferred_record(const char *fmt, const uint32_t *args,
+                                     uint32_t nargs);
+
+/**
+ * \brief Output a bounded part of the deferred log. Only the idle partition is
+ *        allowed.
+ *
+ * \return The number of bytes still to output.
+ */
+uint32_t tfm_core_log_deferred_drain(void);
+#endif /* CONFIG_TFM_SPM_LOG_DEFERRED */
+
 #endif /* __SERVICE_API_H__ */
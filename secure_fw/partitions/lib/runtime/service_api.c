@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -22,6 +22,39 @@ psa_status_t tfm_core_get_boot_data(uint8_t major_type,
         );
 }
 
+#ifdef CONFIG_TFM_SPM_TRACE
+__attribute__((naked))
+uint32_t tfm_core_get_spm_trace(uint32_t type, uint32_t start,
+                                void *buf, uint32_t len)
+{
+    __ASM volatile(
+        "SVC    "M2S(TFM_SVC_GET_SPM_TRACE)"               \n"
+        "BX     lr                                         \n"
+        );
+}
+#endif /* CONFIG_TFM_SPM_TRACE */
+
+#ifdef CONFIG_TFM_SPM_LOG_DEFERRED
+__attribute__((naked))
+int32_t tfm_core_log_deferred_record(const char *fmt, const uint32_t *args,
+                                     uint32_t nargs)
+{
+    __ASM volatile(
+        "SVC    "M2S(TFM_SVC_LOG_DEFERRED_RECORD)"         \n"
+        "BX     lr                                         \n"
+        );
+}
+
+__attribute__((naked))
+uint32_t tfm_core_log_deferred_drain(void)
+{
+    __ASM volatile(
+        "SVC    "M2S(TFM_SVC_LOG_DEFERRED_DRAIN)"          \n"
+        "BX     lr                                         \n"
+        );
+}
+#endif /* CONFIG_TFM_SPM_LOG_DEFERRED */
+
 #if TFM_ISOLATION_LEVEL != 1
 /* Entry point when Partition FLIH functions return */
 __attribute__((naked))
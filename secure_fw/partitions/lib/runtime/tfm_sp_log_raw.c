@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -11,6 +11,71 @@
 #include "tfm_hal_defs.h"
 #include "tfm_hal_sp_logdev.h"
 
+#ifdef CONFIG_TFM_SPM_LOG_DEFERRED
+#include "log_deferred_defs.h"
+#include "service_api.h"
+
+/*
+ * Nothing is formatted here. The arguments are collected as the direct output
+ * below consumes them, and SPM stores them with the address of the format
+ * string. tools/tfm_log_decode.py formats them as the direct output does, keep
+ * them in line.
+ */
+int vprintf(const char *fmt, va_list ap)
+{
+    uint32_t args[LOG_DEFERRED_MAX_ARGS];
+    uint32_t nargs = 0;
+    uint32_t val;
+    const char *p;
+
+    if (fmt == NULL) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+
+    for (p = fmt; *p; p++) {
+        if (*p != '%') {
+            continue;
+        }
+
+        /* Skip the % character, and the 02 of %02x and %02X */
+        p++;
+        if (*p == '0' && *(p + 1) == '2' &&
+            (*(p + 2) == 'x' || *(p + 2) == 'X')) {
+            p += 2;
+        }
+
+        switch (*p) {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'p':
+        case 'c':
+            val = va_arg(ap, uint32_t);
+            break;
+        case 's':
+            val = (uint32_t)va_arg(ap, char *);
+            break;
+        case '\0':
+            /* A trailing % */
+            p--;
+            continue;
+        default:
+            /* %% and the unsupported tags take no argument */
+            continue;
+        }
+
+        /* The arguments beyond the maximum are lost */
+        if (nargs < LOG_DEFERRED_MAX_ARGS) {
+            args[nargs++] = val;
+        }
+    }
+
+    return tfm_core_log_deferred_record(fmt, args, nargs);
+}
+#else /* CONFIG_TFM_SPM_LOG_DEFERRED */
+
 #define PRINT_BUFF_SIZE 32
 #define NUM_BUFF_SIZE 12
 
@@ -182,6 +247,7 @@ int vprintf(const char *fmt, va_list ap)
 
     return count;
 }
+#endif /* CONFIG_TFM_SPM_LOG_DEFERRED */
 
 int printf(const char *fmt, ...)
 {
@@ -36,11 +36,16 @@ static int32_t default_process_new_msg(uint32_t *nr_msg)
     return PSA_SUCCESS;
 }
 
+static void default_flush_replies(void)
+{
+}
+
 static struct tfm_rpc_ops_t rpc_ops = {
     .handle_req = default_handle_req,
     .reply      = default_mailbox_reply,
     .handle_req_irq_src = default_handle_req_irq_src,
     .process_new_msg = default_process_new_msg,
+    .flush_replies = default_flush_replies,
 };
 
 int32_t tfm_rpc_register_ops(const struct tfm_rpc_ops_t *ops_ptr)
@@ -65,6 +70,9 @@ int32_t tfm_rpc_register_ops(const struct tfm_rpc_ops_t *ops_ptr)
     if (ops_ptr->process_new_msg != NULL) {
         rpc_ops.process_new_msg = ops_ptr->process_new_msg;
     }
+    if (ops_ptr->flush_replies != NULL) {
+        rpc_ops.flush_replies = ops_ptr->flush_replies;
+    }
 
     return TFM_RPC_SUCCESS;
 }
@@ -91,6 +99,9 @@ int32_t tfm_rpc_register_ops_multi_srcs(const struct tfm_rpc_ops_t *ops_ptr)
     if (ops_ptr->process_new_msg != NULL) {
         rpc_ops.process_new_msg = ops_ptr->process_new_msg;
     }
+    if (ops_ptr->flush_replies != NULL) {
+        rpc_ops.flush_replies = ops_ptr->flush_replies;
+    }
 
     return TFM_RPC_SUCCESS;
 }
@@ -101,6 +112,7 @@ void tfm_rpc_unregister_ops(void)
     rpc_ops.reply = default_mailbox_reply;
     rpc_ops.handle_req_irq_src = default_handle_req_irq_src;
     rpc_ops.process_new_msg = default_process_new_msg;
+    rpc_ops.flush_replies = default_flush_replies;
 }
 
 void tfm_rpc_client_call_handler(psa_signal_t signal)
@@ -124,16 +136,24 @@ void tfm_rpc_client_call_handler(psa_signal_t signal)
 void tfm_rpc_client_call_reply(void)
 {
     psa_msg_t msg;
-    psa_status_t status = psa_get(ASYNC_MSG_REPLY, &msg);
-    struct connection_t *handle = (struct connection_t *)msg.rhandle;
+    psa_status_t status;
+    struct connection_t *handle;
 
-    rpc_ops.reply(handle->client_data, status);
+    /* Drain all the replies available and flush them to NSPE at once */
+    do {
+        status = psa_get(ASYNC_MSG_REPLY, &msg);
+        handle = (struct connection_t *)msg.rhandle;
 
-    if (handle->status == TFM_HANDLE_STATUS_TO_FREE) {
-        spm_free_connection(handle);
-    } else {
-        handle->status = TFM_HANDLE_STATUS_IDLE;
-    }
+        rpc_ops.reply(handle->client_data, status);
+
+        if (handle->status == TFM_HANDLE_STATUS_TO_FREE) {
+            spm_free_connection(handle);
+        } else {
+            handle->status = TFM_HANDLE_STATUS_IDLE;
+        }
+    } while (psa_wait(ASYNC_MSG_REPLY, PSA_POLL) & ASYNC_MSG_REPLY);
+
+    rpc_ops.flush_replies();
 }
 #endif /* CONFIG_TFM_SPM_BACKEND_IPC == 1 */
 
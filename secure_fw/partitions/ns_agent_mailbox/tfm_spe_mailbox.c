@@ -41,6 +41,9 @@
 
 static struct secure_mailbox_queue_t spe_mailbox_queue;
 
+/* NSPE slots replied to but not yet published in the NSPE replied status */
+static mailbox_queue_status_t unpublished_replies;
+
 /*
  * Local copies of invecs and outvecs associated with each mailbox message
  * while it is being processed.
@@ -79,6 +82,22 @@ __STATIC_INLINE bool get_spe_queue_empty_status(uint8_t idx)
     return false;
 }
 
+/* Allocate the lowest empty SPE mailbox queue slot */
+__STATIC_INLINE int32_t alloc_spe_queue_slot(uint8_t *idx)
+{
+    mailbox_queue_status_t empty = spe_mailbox_queue.empty_slots;
+
+    if (!empty) {
+        return MAILBOX_QUEUE_FULL;
+    }
+
+    /* Isolate the lowest set bit and convert it to its index */
+    *idx = (uint8_t)(31U - __CLZ(empty & (~empty + 1U)));
+    clear_spe_queue_empty_status(*idx);
+
+    return MAILBOX_SUCCESS;
+}
+
 __STATIC_INLINE mailbox_queue_status_t get_nspe_queue_pend_status(
                                     const struct mailbox_status_t *ns_status)
 {
@@ -148,7 +167,7 @@ __STATIC_INLINE struct mailbox_reply_t *get_nspe_reply_addr(uint8_t idx)
     }
 
     ns_slot_idx = spe_mailbox_queue.queue[idx].ns_slot_idx;
-    if ((ns_slot_idx >= NUM_MAILBOX_QUEUE_SLOT) || (ns_slot_idx >= spe_mailbox_queue.ns_slot_count)) {
+    if (ns_slot_idx >= spe_mailbox_queue.ns_slot_count) {
         psa_panic();
     }
 
@@ -346,7 +365,7 @@ static int32_t tfm_mailbox_dispatch(const struct mailbox_msg_t *msg_ptr,
 
     /* Any synchronous result should be returned immediately */
     if (sync) {
-        *reply_slots |= (1 << idx);
+        *reply_slots |= (1UL << spe_mailbox_queue.queue[idx].ns_slot_idx);
         mailbox_direct_reply(idx, (uint32_t)psa_ret);
     }
 
@@ -355,8 +374,9 @@ static int32_t tfm_mailbox_dispatch(const struct mailbox_msg_t *msg_ptr,
 
 int32_t tfm_mailbox_handle_msg(void)
 {
-    uint8_t idx;
-    mailbox_queue_status_t mask_bits, pend_slots, reply_slots = 0;
+    uint8_t idx, ns_idx;
+    mailbox_queue_status_t mask_bits, pend_slots, taken_slots = 0;
+    mailbox_queue_status_t reply_slots = 0;
     struct mailbox_status_t *ns_status = spe_mailbox_queue.ns_status;
     struct mailbox_msg_t *msg_ptr;
     uint32_t critical_section;
@@ -376,26 +396,35 @@ int32_t tfm_mailbox_handle_msg(void)
         return MAILBOX_NO_PEND_EVENT;
     }
 
-    for (idx = 0; idx < spe_mailbox_queue.ns_slot_count; idx++) {
-        mask_bits = (1 << idx);
+    for (ns_idx = 0; (ns_idx < spe_mailbox_queue.ns_slot_count) &&
+                     (ns_idx < (sizeof(mailbox_queue_status_t) * 8)); ns_idx++) {
+        mask_bits = (1UL << ns_idx);
         /* Check if current NSPE mailbox queue slot is pending for handling */
         if (!(pend_slots & mask_bits)) {
             continue;
         }
 
         /*
-         * TODO
-         * The operations are simplified here. Use the SPE mailbox queue
-         * slot with the same idx as that of the NSPE mailbox queue slot.
-         * A more general implementation should dynamically search and
-         * select an empty SPE mailbox queue slot.
+         * The SPE slot is independent of the NSPE slot. The platform does not
+         * accept more NSPE slots than SPE slots, and an NSPE slot only becomes
+         * pending again after its reply freed the SPE slot. So the queue can
+         * only be full if NSPE breaks that protocol, and the remaining
+         * requests are then left pending.
          */
-        clear_spe_queue_empty_status(idx);
-        spe_mailbox_queue.queue[idx].ns_slot_idx = idx;
+        if (alloc_spe_queue_slot(&idx) != MAILBOX_SUCCESS) {
+            break;
+        }
+
+        taken_slots |= mask_bits;
+        spe_mailbox_queue.queue[idx].ns_slot_idx = ns_idx;
 
+        /*
+         * The message is copied so that NSPE cannot modify it while it is
+         * checked and dispatched.
+         */
         msg_ptr = &spe_mailbox_queue.queue[idx].msg;
-        MAILBOX_INVALIDATE_CACHE(&spe_mailbox_queue.ns_slots[idx].msg, sizeof(*msg_ptr));
-        spm_memcpy(msg_ptr, &spe_mailbox_queue.ns_slots[idx].msg, sizeof(*msg_ptr));
+        MAILBOX_INVALIDATE_CACHE(&spe_mailbox_queue.ns_slots[ns_idx].msg, sizeof(*msg_ptr));
+        spm_memcpy(msg_ptr, &spe_mailbox_queue.ns_slots[ns_idx].msg, sizeof(*msg_ptr));
 
         if (check_mailbox_msg(msg_ptr) != MAILBOX_SUCCESS) {
             mailbox_clean_queue_slot(idx);
@@ -416,10 +445,15 @@ int32_t tfm_mailbox_handle_msg(void)
 
     critical_section = tfm_mailbox_hal_enter_critical();
 
-    /* Clean the NSPE mailbox pending status. */
-    clear_nspe_queue_pend_status(ns_status, pend_slots);
+    /* Clean the pending status of the NSPE requests taken in this pass */
+    clear_nspe_queue_pend_status(ns_status, taken_slots);
 
-    /* Set the NSPE mailbox replied status */
+    /*
+     * Set the NSPE mailbox replied status, together with any asynchronous
+     * reply not yet published, so that one notification covers them all.
+     */
+    reply_slots |= unpublished_replies;
+    unpublished_replies = 0;
     set_nspe_queue_replied_status(ns_status, reply_slots);
 
     tfm_mailbox_hal_exit_critical(critical_section);
@@ -431,14 +465,16 @@ int32_t tfm_mailbox_handle_msg(void)
     return (int32_t)msg_dispatched;
 }
 
-int32_t tfm_mailbox_reply_msg(mailbox_msg_handle_t handle, int32_t reply)
+/*
+ * Write the result into the NSPE slot of the message and free its SPE slot.
+ * The NSPE replied status is only updated by mailbox_publish_replies().
+ */
+static int32_t mailbox_queue_reply(mailbox_msg_handle_t handle, int32_t reply)
 {
     uint8_t idx;
     int32_t ret;
     uint32_t critical_section;
-    struct mailbox_status_t *ns_status = spe_mailbox_queue.ns_status;
-
-    SPM_ASSERT(ns_status != NULL);
+    mailbox_queue_status_t mask_bits;
 
     /*
      * If handle == MAILBOX_MSG_NULL_HANDLE, reply to the mailbox message
@@ -459,16 +495,55 @@ int32_t tfm_mailbox_reply_msg(mailbox_msg_handle_t handle, int32_t reply)
         return MAILBOX_NO_PEND_EVENT;
     }
 
+    /* The slot is cleaned by the reply, get the NSPE slot first */
+    mask_bits = (1UL << spe_mailbox_queue.queue[idx].ns_slot_idx);
+
     mailbox_direct_reply(idx, (uint32_t)reply);
 
+    critical_section = tfm_mailbox_hal_enter_critical();
+    unpublished_replies |= mask_bits;
+    tfm_mailbox_hal_exit_critical(critical_section);
+
+    return MAILBOX_SUCCESS;
+}
+
+/*
+ * Set the NSPE mailbox replied status of all the replies written since the
+ * last update and notify NSPE once.
+ */
+static void mailbox_publish_replies(void)
+{
+    uint32_t critical_section;
+    mailbox_queue_status_t reply_slots;
+    struct mailbox_status_t *ns_status = spe_mailbox_queue.ns_status;
+
+    SPM_ASSERT(ns_status != NULL);
+
     critical_section = tfm_mailbox_hal_enter_critical();
 
-    /* Set the NSPE mailbox replied status */
-    set_nspe_queue_replied_status(ns_status, (1 << idx));
+    reply_slots = unpublished_replies;
+    unpublished_replies = 0;
+    if (reply_slots) {
+        set_nspe_queue_replied_status(ns_status, reply_slots);
+    }
 
     tfm_mailbox_hal_exit_critical(critical_section);
 
-    tfm_mailbox_hal_notify_peer();
+    if (reply_slots) {
+        tfm_mailbox_hal_notify_peer();
+    }
+}
+
+int32_t tfm_mailbox_reply_msg(mailbox_msg_handle_t handle, int32_t reply)
+{
+    int32_t ret;
+
+    ret = mailbox_queue_reply(handle, reply);
+    if (ret != MAILBOX_SUCCESS) {
+        return ret;
+    }
+
+    mailbox_publish_replies();
 
     return MAILBOX_SUCCESS;
 }
@@ -489,7 +564,14 @@ static void mailbox_reply(const void *owner, int32_t ret)
         handle = *((mailbox_msg_handle_t *)owner);
     }
 
-    (void)tfm_mailbox_reply_msg(handle, ret);
+    /* Published by mailbox_flush_replies() at the end of the batch */
+    (void)mailbox_queue_reply(handle, ret);
+}
+
+/* RPC flush_replies() callback */
+static void mailbox_flush_replies(void)
+{
+    mailbox_publish_replies();
 }
 
 /* Process new mailbox message callback */
@@ -511,6 +593,7 @@ static const struct tfm_rpc_ops_t mailbox_rpc_ops = {
     .handle_req = mailbox_handle_req,
     .reply      = mailbox_reply,
     .process_new_msg = mailbox_process_new_msg,
+    .flush_replies   = mailbox_flush_replies,
 };
 
 static int32_t tfm_mailbox_init(void)
@@ -518,6 +601,7 @@ static int32_t tfm_mailbox_init(void)
     int32_t ret;
 
     spm_memset(&spe_mailbox_queue, 0, sizeof(spe_mailbox_queue));
+    unpublished_replies = 0;
 
     spe_mailbox_queue.empty_slots =
             (mailbox_queue_status_t)((1UL << (NUM_MAILBOX_QUEUE_SLOT - 1)) - 1);
@@ -0,0 +1,443 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cmsis_compiler.h"
+
+#include "async.h"
+#include "config_impl.h"
+#include "internal_status_code.h"
+#include "psa/error.h"
+#include "utilities.h"
+#include "private/assert.h"
+#include "tfm_psa_call_pack.h"
+#include "tfm_spe_mailbox.h"
+#include "tfm_rpc.h"
+#include "tfm_hal_multi_core.h"
+#include "tfm_multi_core.h"
+#include "ffm/mailbox_agent_api.h"
+
+/* If there's no dcache at all, the SCB cache functions won't exist */
+/* If the mailbox is uncached on the S side, no need to flush and invalidate */
+#if !defined(__DCACHE_PRESENT) || (__DCACHE_PRESENT == 0U) || (MAILBOX_IS_UNCACHED_S == 1)
+#define MAILBOX_CLEAN_CACHE(addr, size) __DSB()
+#define MAILBOX_INVALIDATE_CACHE(addr, size) do {} while (0)
+#else
+#define MAILBOX_CLEAN_CACHE(addr, size) SCB_CleanDCache_by_Addr((addr), (size))
+#define MAILBOX_INVALIDATE_CACHE(addr, size) SCB_InvalidateDCache_by_Addr((addr), (size))
+#endif
+
+#include "tfm_mailbox_ring.h"
+
+/* States of a request taken from the request ring */
+#define RING_MSG_FREE               (0U)
+#define RING_MSG_ACTIVE             (1U)    /* Being handled by a service    */
+#define RING_MSG_REPLIED            (2U)    /* Waiting for a completion entry */
+
+/*
+ * A request taken from the request ring, while it is handled in SPE. The
+ * message and the vectors are copied from NSPE, so that NSPE cannot modify
+ * them once they have been checked.
+ */
+struct ring_msg_t {
+    struct mailbox_msg_t msg;
+    uint32_t             token;
+    mailbox_msg_handle_t msg_handle;
+    int32_t              return_val;
+    uint8_t              state;
+
+    psa_invec            in_vec[PSA_MAX_IOVEC];
+    psa_outvec           out_vec[PSA_MAX_IOVEC];
+    psa_outvec           *original_out_vec;
+    size_t               out_len;
+};
+
+static struct mailbox_ring_shared_t *ns_rings;
+static struct mailbox_ring_end_t req_ring;      /* Consumer of the requests   */
+static struct mailbox_ring_end_t cpl_ring;      /* Producer of the completions */
+
+/* At most one request per request ring entry is handled at the same time */
+static struct ring_msg_t ring_msgs[MAILBOX_RING_SIZE];
+
+static struct ring_msg_t *alloc_ring_msg(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < MAILBOX_RING_SIZE; i++) {
+        if (ring_msgs[i].state == RING_MSG_FREE) {
+            ring_msgs[i].state = RING_MSG_ACTIVE;
+            return &ring_msgs[i];
+        }
+    }
+
+    return NULL;
+}
+
+static struct ring_msg_t *get_ring_msg(mailbox_msg_handle_t handle)
+{
+    if ((handle <= MAILBOX_MSG_NULL_HANDLE) || (handle > MAILBOX_RING_SIZE)) {
+        return NULL;
+    }
+
+    return &ring_msgs[handle - 1];
+}
+
+/* Record the result of a request, published by flush_completions() */
+static void ring_msg_reply(struct ring_msg_t *p_msg, int32_t result)
+{
+    /* Copy outvec lengths back if necessary */
+    if ((p_msg->msg.call_type == MAILBOX_PSA_CALL) && (result == PSA_SUCCESS)) {
+        for (size_t i = 0; i < p_msg->out_len; i++) {
+            p_msg->original_out_vec[i].len = p_msg->out_vec[i].len;
+        }
+    }
+
+    p_msg->return_val = result;
+    p_msg->state = RING_MSG_REPLIED;
+}
+
+/*
+ * Write the results of the replied requests into the completion ring, then
+ * publish them and notify NSPE once. The results that do not fit, because
+ * NSPE did not consume the completions yet, are retried on the next flush.
+ */
+static void flush_completions(void)
+{
+    struct mailbox_ring_cpl_t *cpl;
+    uint32_t space, i, nr_cpl = 0;
+
+    space = mailbox_ring_space(&cpl_ring);
+
+    for (i = 0; (i < MAILBOX_RING_SIZE) && (nr_cpl < space); i++) {
+        if (ring_msgs[i].state != RING_MSG_REPLIED) {
+            continue;
+        }
+
+        cpl = mailbox_ring_cpl_entry(ns_rings, cpl_ring.pos);
+        cpl->token = ring_msgs[i].token;
+        cpl->return_val = ring_msgs[i].return_val;
+        MAILBOX_CLEAN_CACHE(cpl, sizeof(*cpl));
+
+        cpl_ring.pos++;
+        nr_cpl++;
+
+        ring_msgs[i].state = RING_MSG_FREE;
+    }
+
+    if (nr_cpl) {
+        mailbox_ring_commit(&cpl_ring);
+        tfm_mailbox_hal_notify_peer();
+    }
+}
+
+/*
+ * Check the local copy of a request before it is dispatched. The vectors are
+ * copied from NSPE memory afterwards, so their numbers are checked here.
+ */
+static int32_t check_mailbox_msg(const struct mailbox_msg_t *msg)
+{
+    const struct psa_client_params_t *params = &msg->params;
+    size_t in_len, out_len;
+
+    switch (msg->call_type) {
+    case MAILBOX_PSA_FRAMEWORK_VERSION:
+    case MAILBOX_PSA_VERSION:
+#if CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1
+    case MAILBOX_PSA_CONNECT:
+    case MAILBOX_PSA_CLOSE:
+#endif
+        return MAILBOX_SUCCESS;
+
+    case MAILBOX_PSA_CALL:
+        break;
+
+    default:
+        return MAILBOX_INVAL_PARAMS;
+    }
+
+    in_len = params->psa_call_params.in_len;
+    out_len = params->psa_call_params.out_len;
+
+    if ((in_len > PSA_MAX_IOVEC) ||
+        (out_len > PSA_MAX_IOVEC) ||
+        ((in_len + out_len) > PSA_MAX_IOVEC)) {
+        return MAILBOX_INVAL_PARAMS;
+    }
+
+    if (((params->psa_call_params.out_vec == NULL) && (out_len != 0)) ||
+        ((params->psa_call_params.in_vec == NULL) && (in_len != 0))) {
+        return MAILBOX_INVAL_PARAMS;
+    }
+
+    return MAILBOX_SUCCESS;
+}
+
+static void local_copy_vects(struct ring_msg_t *p_msg, uint32_t *control)
+{
+    const struct psa_client_params_t *params = &p_msg->msg.params;
+    size_t in_len, out_len;
+
+    in_len = params->psa_call_params.in_len;
+    out_len = params->psa_call_params.out_len;
+
+    for (unsigned int i = 0; i < PSA_MAX_IOVEC; i++) {
+        if (i < in_len) {
+            p_msg->in_vec[i] = params->psa_call_params.in_vec[i];
+        } else {
+            p_msg->in_vec[i].base = 0;
+            p_msg->in_vec[i].len = 0;
+        }
+
+        if (i < out_len) {
+            p_msg->out_vec[i] = params->psa_call_params.out_vec[i];
+        } else {
+            p_msg->out_vec[i].base = 0;
+            p_msg->out_vec[i].len = 0;
+        }
+    }
+
+    *control = PARAM_SET_NS_INVEC(*control);
+    *control = PARAM_SET_NS_OUTVEC(*control);
+
+    p_msg->out_len = out_len;
+    p_msg->original_out_vec = params->psa_call_params.out_vec;
+}
+
+/*
+ * Passes the request into SPM. A synchronous result is recorded at once. The
+ * request must have passed check_mailbox_msg().
+ */
+static void ring_msg_dispatch(struct ring_msg_t *p_msg)
+{
+    const struct psa_client_params_t *params = &p_msg->msg.params;
+    struct client_params_t client_params = {0};
+    uint32_t control = PARAM_PACK(params->psa_call_params.type,
+                                  params->psa_call_params.in_len,
+                                  params->psa_call_params.out_len);
+    int32_t client_id;
+    psa_status_t psa_ret = PSA_ERROR_GENERIC_ERROR;
+
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+    /* Assume asynchronous. Set to synchronous when an error happens. */
+    bool sync = false;
+#else
+    /* Assume synchronous. */
+    bool sync = true;
+#endif
+
+    switch (p_msg->msg.call_type) {
+    case MAILBOX_PSA_FRAMEWORK_VERSION:
+        psa_ret = tfm_rpc_psa_framework_version();
+        sync = true;
+        break;
+
+    case MAILBOX_PSA_VERSION:
+        psa_ret = tfm_rpc_psa_version(params->psa_version_params.sid);
+        sync = true;
+        break;
+
+    case MAILBOX_PSA_CALL:
+        local_copy_vects(p_msg, &control);
+
+        if (tfm_multi_core_hal_client_id_translate(CLIENT_ID_OWNER_MAGIC,
+                                                   p_msg->msg.client_id,
+                                                   &client_id) != SPM_SUCCESS) {
+            sync = true;
+            psa_ret = PSA_ERROR_INVALID_ARGUMENT;
+            break;
+        }
+        client_params.ns_client_id_stateless = client_id;
+        client_params.p_invecs = p_msg->in_vec;
+        client_params.p_outvecs = p_msg->out_vec;
+        psa_ret = tfm_rpc_psa_call(params->psa_call_params.handle,
+                                   control, &client_params,
+                                   &p_msg->msg_handle);
+        if (psa_ret != PSA_SUCCESS) {
+            sync = true;
+        }
+        break;
+
+/* Following cases are only needed by connection-based services */
+#if CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1
+    case MAILBOX_PSA_CONNECT:
+        if (tfm_multi_core_hal_client_id_translate(CLIENT_ID_OWNER_MAGIC,
+                                                   p_msg->msg.client_id,
+                                                   &client_id) != SPM_SUCCESS) {
+            sync = true;
+            psa_ret = PSA_ERROR_INVALID_ARGUMENT;
+            break;
+        }
+        psa_ret = tfm_rpc_psa_connect(params->psa_connect_params.sid,
+                                      params->psa_connect_params.version,
+                                      client_id,
+                                      &p_msg->msg_handle);
+        if (psa_ret != PSA_SUCCESS) {
+            sync = true;
+        }
+        break;
+
+    case MAILBOX_PSA_CLOSE:
+        if (tfm_multi_core_hal_client_id_translate(CLIENT_ID_OWNER_MAGIC,
+                                                   p_msg->msg.client_id,
+                                                   &client_id) != SPM_SUCCESS) {
+            sync = true;
+            psa_ret = PSA_ERROR_INVALID_ARGUMENT;
+            break;
+        }
+        psa_ret = tfm_rpc_psa_close(params->psa_close_params.handle, client_id);
+        if (psa_ret != PSA_SUCCESS) {
+            sync = true;
+        }
+        break;
+#endif /* CONFIG_TFM_CONNECTION_BASED_SERVICE_API */
+
+    default:
+        sync = true;
+        psa_ret = PSA_ERROR_NOT_SUPPORTED;
+        break;
+    }
+
+    if (sync) {
+        ring_msg_reply(p_msg, (int32_t)psa_ret);
+    }
+}
+
+/*
+ * Take all the requests available in the request ring, or as many as there
+ * are free request contexts. The consumed entries are released to NSPE at
+ * once, and the synchronous results are returned with a single notification.
+ */
+static int32_t ring_handle_msg(void)
+{
+    struct mailbox_ring_req_t *req;
+    struct ring_msg_t *p_msg;
+    uint32_t avail, nr_msg = 0;
+
+    avail = mailbox_ring_avail(&req_ring);
+
+    /* NSPE cannot have written more requests than there are entries */
+    if (avail > MAILBOX_RING_SIZE) {
+        avail = 0;
+    }
+
+    while (nr_msg < avail) {
+        p_msg = alloc_ring_msg();
+        if (p_msg == NULL) {
+            /* The remaining requests are taken when contexts are freed */
+            break;
+        }
+
+        req = mailbox_ring_req_entry(ns_rings, req_ring.pos);
+        MAILBOX_INVALIDATE_CACHE(req, sizeof(*req));
+        spm_memcpy(&p_msg->msg, &req->msg, sizeof(p_msg->msg));
+        p_msg->token = req->token;
+
+        req_ring.pos++;
+        nr_msg++;
+
+        /*
+         * An invalid request still gets a completion, so that NSPE does not
+         * wait for it forever.
+         */
+        if (check_mailbox_msg(&p_msg->msg) != MAILBOX_SUCCESS) {
+            ring_msg_reply(p_msg, PSA_ERROR_INVALID_ARGUMENT);
+            continue;
+        }
+
+        ring_msg_dispatch(p_msg);
+    }
+
+    if (nr_msg) {
+        mailbox_ring_commit(&req_ring);
+    }
+
+    flush_completions();
+
+    return (int32_t)nr_msg;
+}
+
+/* RPC handle_req() callback */
+static void ring_handle_req(void)
+{
+    (void)ring_handle_msg();
+}
+
+/* RPC reply() callback */
+static void ring_reply(const void *owner, int32_t ret)
+{
+    struct ring_msg_t *p_msg;
+
+    if (owner == NULL) {
+        return;
+    }
+
+    p_msg = get_ring_msg(*((mailbox_msg_handle_t *)owner));
+    if ((p_msg == NULL) || (p_msg->state != RING_MSG_ACTIVE)) {
+        return;
+    }
+
+    /* Published by ring_flush_replies() at the end of the batch */
+    ring_msg_reply(p_msg, ret);
+}
+
+/* RPC flush_replies() callback */
+static void ring_flush_replies(void)
+{
+    flush_completions();
+
+    /* Replies freed request contexts. Take the requests left in the ring. */
+    (void)ring_handle_msg();
+}
+
+/* Process new mailbox message callback */
+static int32_t ring_process_new_msg(uint32_t *nr_msg)
+{
+    *nr_msg = (uint32_t)ring_handle_msg();
+
+    return MAILBOX_SUCCESS;
+}
+
+/* Mailbox ring specific operations callback for TF-M RPC */
+static const struct tfm_rpc_ops_t ring_rpc_ops = {
+    .handle_req      = ring_handle_req,
+    .reply           = ring_reply,
+    .process_new_msg = ring_process_new_msg,
+    .flush_replies   = ring_flush_replies,
+};
+
+int32_t tfm_inter_core_comm_init(void)
+{
+    int32_t ret;
+    uint32_t i;
+
+    spm_memset(ring_msgs, 0, sizeof(ring_msgs));
+    for (i = 0; i < MAILBOX_RING_SIZE; i++) {
+        ring_msgs[i].msg_handle = (mailbox_msg_handle_t)(i + 1);
+    }
+
+    /* Register RPC callbacks */
+    ret = tfm_rpc_register_ops(&ring_rpc_ops);
+    if (ret != TFM_RPC_SUCCESS) {
+        return MAILBOX_CALLBACK_REG_ERROR;
+    }
+
+    /* Platform specific initialization. Get the rings allocated by NSPE. */
+    ret = tfm_mailbox_hal_ring_init(&ns_rings);
+    if ((ret != MAILBOX_SUCCESS) || (ns_rings == NULL)) {
+        tfm_rpc_unregister_ops();
+
+        return (ret != MAILBOX_SUCCESS) ? ret : MAILBOX_INIT_ERROR;
+    }
+
+    mailbox_ring_init_end(&req_ring, &ns_rings->req_tail, &ns_rings->req_head);
+    mailbox_ring_init_end(&cpl_ring, &ns_rings->cpl_head, &ns_rings->cpl_tail);
+
+    return MAILBOX_SUCCESS;
+}
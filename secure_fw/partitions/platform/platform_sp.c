@@ -16,6 +16,10 @@
 #include "tfm_plat_nv_counters.h"
 #endif /* !PLATFORM_NV_COUNTER_MODULE_DISABLED */
 
+#ifdef CONFIG_TFM_SPM_TRACE
+#include "service_api.h"
+#endif /* CONFIG_TFM_SPM_TRACE */
+
 #include "psa/client.h"
 #include "psa/service.h"
 #include "region_defs.h"
@@ -26,6 +30,11 @@
 #define NV_COUNTER_SIZE     4
 #endif /* !PLATFORM_NV_COUNTER_MODULE_DISABLED */
 
+#ifdef CONFIG_TFM_SPM_TRACE
+/* Number of SPM trace bytes fetched from SPM at once, a multiple of records */
+#define SPM_TRACE_CHUNK_SIZE    (2 * sizeof(struct tfm_spm_trace_hist_t))
+#endif /* CONFIG_TFM_SPM_TRACE */
+
 typedef enum tfm_platform_err_t (*plat_func_t)(const psa_msg_t *msg);
 
 enum tfm_platform_err_t platform_sp_system_reset(void)
@@ -149,6 +158,62 @@ static psa_status_t platform_sp_nv_increment_psa_api(const psa_msg_t *msg)
 }
 #endif /* !PLATFORM_NV_COUNTER_MODULE_DISABLED*/
 
+#ifdef CONFIG_TFM_SPM_TRACE
+static psa_status_t platform_sp_spm_trace_psa_api(const psa_msg_t *msg)
+{
+    struct tfm_spm_trace_req_t req;
+    uint32_t chunk[SPM_TRACE_CHUNK_SIZE / sizeof(uint32_t)];
+    const struct tfm_spm_trace_event_t *p_last;
+    size_t written = 0, len, num;
+    uint32_t copied;
+
+    /* Trace data reveals the timing of all services, keep it from NSPE */
+    if (msg->client_id < 0) {
+        return TFM_PLATFORM_ERR_NOT_SUPPORTED;
+    }
+
+    if ((msg->in_size[0] != sizeof(req)) || (msg->out_size[0] == 0)) {
+        return TFM_PLATFORM_ERR_INVALID_PARAM;
+    }
+
+    num = psa_read(msg->handle, 0, &req, sizeof(req));
+    if (num != sizeof(req)) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    }
+
+    if ((req.type != TFM_SPM_TRACE_TYPE_EVENTS) &&
+        (req.type != TFM_SPM_TRACE_TYPE_HISTOGRAMS)) {
+        return TFM_PLATFORM_ERR_INVALID_PARAM;
+    }
+
+    /* Only whole records are fetched, stop when SPM has no more of them */
+    while (written < msg->out_size[0]) {
+        len = msg->out_size[0] - written;
+        if (len > sizeof(chunk)) {
+            len = sizeof(chunk);
+        }
+
+        copied = tfm_core_get_spm_trace(req.type, req.start, chunk, len);
+        if (copied == 0) {
+            break;
+        }
+
+        psa_write(msg->handle, 0, chunk, copied);
+        written += copied;
+
+        if (req.type == TFM_SPM_TRACE_TYPE_EVENTS) {
+            p_last = (const struct tfm_spm_trace_event_t *)chunk +
+                     (copied / sizeof(*p_last)) - 1;
+            req.start = p_last->seq + 1;
+        } else {
+            req.start += copied / sizeof(struct tfm_spm_trace_hist_t);
+        }
+    }
+
+    return TFM_PLATFORM_ERR_SUCCESS;
+}
+#endif /* CONFIG_TFM_SPM_TRACE */
+
 static psa_status_t platform_sp_ioctl_psa_api(const psa_msg_t *msg)
 {
     void *input = NULL;
@@ -227,6 +292,10 @@ psa_status_t tfm_platform_service_sfn(const psa_msg_t *msg)
         return platform_sp_system_reset_psa_api(msg);
     case TFM_PLATFORM_API_ID_IOCTL:
         return platform_sp_ioctl_psa_api(msg);
+#ifdef CONFIG_TFM_SPM_TRACE
+    case TFM_PLATFORM_API_ID_SPM_TRACE:
+        return platform_sp_spm_trace_psa_api(msg);
+#endif /* CONFIG_TFM_SPM_TRACE */
     default:
         return PSA_ERROR_NOT_SUPPORTED;
     }
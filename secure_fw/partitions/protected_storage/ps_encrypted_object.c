@@ -9,6 +9,7 @@
 
 #include "ps_encrypted_object.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
 
@@ -44,6 +45,30 @@ __PACKED_STRUCT auth_data_t {
 #endif
 };
 
+#if PS_OBJECT_SEGMENT_SIZE
+/* Size of the encrypted object header, which holds the object information and
+ * the crypto metadata of the data segments.
+ */
+#define PS_ENCRYPTED_HEADER_SIZE PS_ENCRYPT_SIZE(0)
+
+/* Position of the first data segment in the stored object */
+#define PS_SEGMENTS_START_POSITION (STORED_HEADER_DATA_SIZE + \
+                                    PS_ENCRYPTED_HEADER_SIZE)
+
+/* Gets the index of the segment holding the given object data offset */
+#define PS_SEGMENT_IDX(offset) ((offset) / PS_OBJECT_SEGMENT_SIZE)
+
+/* Gets the object data offset of the given segment */
+#define PS_SEGMENT_OFFSET(idx) ((idx) * PS_OBJECT_SEGMENT_SIZE)
+
+/* The segment tags are authenticated by the object header, so the associated
+ * data of a segment only needs to bind it to its position in the object.
+ */
+__PACKED_STRUCT seg_auth_data_t {
+    uint32_t seg_idx;
+};
+#endif /* PS_OBJECT_SEGMENT_SIZE */
+
 /**
  * \brief Performs authenticated decryption on object data, with the header as
  *        the associated data.
@@ -216,3 +241,287 @@ psa_status_t ps_encrypted_object_write(uint32_t fid, struct ps_object_t *obj)
     return psa_its_set(fid, wrt_size, (const void *)obj->header.crypto.ref.iv,
                        PSA_STORAGE_FLAG_NONE);
 }
+
+#if PS_OBJECT_SEGMENT_SIZE
+/**
+ * \brief Gets the size of a data segment of an object.
+ *
+ * \param[in] size     Size of the object data
+ * \param[in] seg_idx  Segment index
+ *
+ * \return Returns the segment size
+ */
+static uint32_t ps_object_segment_size(uint32_t size, uint32_t seg_idx)
+{
+    return PS_UTILS_MIN(PS_OBJECT_SEGMENT_SIZE,
+                        size - PS_SEGMENT_OFFSET(seg_idx));
+}
+
+/**
+ * \brief Encrypts or decrypts in place a data segment of an object.
+ *
+ * \param[in,out] obj      Pointer to the object structure
+ * \param[in]     seg_idx  Segment index
+ * \param[in]     encrypt  If true, the segment is encrypted and its crypto
+ *                         metadata is updated in the object header. Otherwise,
+ *                         it is authenticated and decrypted.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_segment_crypt(struct ps_object_t *obj,
+                                            uint32_t seg_idx,
+                                            bool encrypt)
+{
+    psa_status_t err;
+    const struct seg_auth_data_t auth_data = {
+        .seg_idx = seg_idx,
+    };
+    struct ps_obj_segment_t *seg = &obj->header.seg[seg_idx];
+    union ps_crypto_t crypto = obj->header.crypto;
+    uint8_t *p_seg_data = obj->data + PS_SEGMENT_OFFSET(seg_idx);
+    uint32_t seg_size = ps_object_segment_size(obj->header.info.current_size,
+                                               seg_idx);
+    uint8_t next_data[PS_TAG_LEN_BYTES];
+    size_t out_len;
+
+    /* The crypto layer uses the bytes after the segment to hold the tag, so
+     * preserve the start of the next segment.
+     */
+    (void)memcpy(next_data, p_seg_data + seg_size, PS_TAG_LEN_BYTES);
+
+    if (encrypt) {
+        err = ps_crypto_get_iv(&crypto);
+        if (err == PSA_SUCCESS) {
+            err = ps_crypto_encrypt_and_tag(&crypto,
+                                            (const uint8_t *)&auth_data,
+                                            sizeof(auth_data),
+                                            p_seg_data, seg_size,
+                                            p_seg_data,
+                                            seg_size + PS_TAG_LEN_BYTES,
+                                            &out_len);
+        }
+        if (err == PSA_SUCCESS) {
+            (void)memcpy(seg->iv, crypto.ref.iv, PS_IV_LEN_BYTES);
+            (void)memcpy(seg->tag, crypto.ref.tag, PS_TAG_LEN_BYTES);
+        }
+    } else {
+        (void)memcpy(crypto.ref.iv, seg->iv, PS_IV_LEN_BYTES);
+        (void)memcpy(crypto.ref.tag, seg->tag, PS_TAG_LEN_BYTES);
+
+        err = ps_crypto_auth_and_decrypt(&crypto,
+                                         (const uint8_t *)&auth_data,
+                                         sizeof(auth_data),
+                                         p_seg_data, seg_size,
+                                         p_seg_data,
+                                         seg_size + PS_TAG_LEN_BYTES,
+                                         &out_len);
+    }
+
+    (void)memcpy(p_seg_data + seg_size, next_data, PS_TAG_LEN_BYTES);
+
+    if (err != PSA_SUCCESS || out_len != seg_size) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Reads the stored data segments of an object, without decrypting
+ *        them.
+ *
+ * \param[in]  fid          File ID
+ * \param[out] obj          Pointer to the object structure to fill in
+ * \param[in]  first_seg    Index of the first segment to read
+ * \param[in]  last_seg     Index of the last segment to read
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_read_segments(uint32_t fid,
+                                            struct ps_object_t *obj,
+                                            uint32_t first_seg,
+                                            uint32_t last_seg)
+{
+    psa_status_t err;
+    uint32_t start = PS_SEGMENT_OFFSET(first_seg);
+    uint32_t end = PS_SEGMENT_OFFSET(last_seg) +
+                   ps_object_segment_size(obj->header.info.current_size,
+                                          last_seg);
+    size_t data_length;
+
+    err = psa_its_get(fid, PS_SEGMENTS_START_POSITION + start, end - start,
+                      (void *)(obj->data + start), &data_length);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if (data_length != end - start) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t ps_encrypted_object_read_header(uint32_t fid,
+                                             struct ps_object_t *obj)
+{
+    psa_status_t err;
+    uint32_t num_blocks;
+    size_t data_length;
+
+    err = psa_its_get(fid, PS_OBJECT_START_POSITION,
+                      PS_SEGMENTS_START_POSITION,
+                      (void *)obj->header.crypto.ref.iv,
+                      &data_length);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if (data_length != PS_SEGMENTS_START_POSITION) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    err = ps_object_auth_decrypt(fid, PS_ENCRYPTED_HEADER_SIZE, obj,
+                                 &num_blocks);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if (obj->header.info.current_size > PS_MAX_OBJECT_DATA_SIZE) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t ps_encrypted_object_read_data(uint32_t fid,
+                                           struct ps_object_t *obj,
+                                           uint32_t offset,
+                                           uint32_t size)
+{
+    psa_status_t err;
+    uint32_t first_seg;
+    uint32_t last_seg;
+    uint32_t i;
+
+    if (offset >= obj->header.info.current_size || size == 0) {
+        return PSA_SUCCESS;
+    }
+
+    size = PS_UTILS_MIN(size, obj->header.info.current_size - offset);
+    first_seg = PS_SEGMENT_IDX(offset);
+    last_seg = PS_SEGMENT_IDX(offset + size - 1);
+
+    err = ps_object_read_segments(fid, obj, first_seg, last_seg);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    for (i = first_seg; i <= last_seg; i++) {
+        err = ps_object_segment_crypt(obj, i, false);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t ps_encrypted_object_prepare_write(uint32_t fid,
+                                               struct ps_object_t *obj,
+                                               uint32_t offset,
+                                               uint32_t size)
+{
+    psa_status_t err;
+    uint32_t cur_size = obj->header.info.current_size;
+    uint32_t seg_start;
+    uint32_t seg_end;
+    uint32_t i;
+
+    if (cur_size == 0) {
+        return PSA_SUCCESS;
+    }
+
+    /* The segments which are not updated are written back as they are
+     * stored.
+     */
+    err = ps_object_read_segments(fid, obj, 0, PS_SEGMENT_IDX(cur_size - 1));
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if (size == 0) {
+        return PSA_SUCCESS;
+    }
+
+    /* The segments partially overwritten are decrypted, so that the new data
+     * can be merged with the old one.
+     */
+    for (i = PS_SEGMENT_IDX(offset); i <= PS_SEGMENT_IDX(cur_size - 1); i++) {
+        seg_start = PS_SEGMENT_OFFSET(i);
+        seg_end = seg_start + ps_object_segment_size(cur_size, i);
+
+        if (seg_start >= offset + size) {
+            break;
+        }
+
+        if (seg_start < offset || seg_end > offset + size) {
+            err = ps_object_segment_crypt(obj, i, false);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t ps_encrypted_object_write_data(uint32_t fid,
+                                            struct ps_object_t *obj,
+                                            uint32_t offset,
+                                            uint32_t size)
+{
+    psa_status_t err;
+    uint8_t old_tag[PS_TAG_LEN_BYTES];
+    uint8_t seg_data[PS_TAG_LEN_BYTES];
+    uint32_t wrt_size = PS_SEGMENTS_START_POSITION +
+                        obj->header.info.current_size;
+    uint32_t i;
+
+    /* Keep the tag of the stored object in case the write fails, as the
+     * object table refers to it.
+     */
+    (void)memcpy(old_tag, obj->header.crypto.ref.tag, PS_TAG_LEN_BYTES);
+
+    if (size != 0) {
+        for (i = PS_SEGMENT_IDX(offset); i <= PS_SEGMENT_IDX(offset + size - 1);
+             i++) {
+            err = ps_object_segment_crypt(obj, i, true);
+            if (err != PSA_SUCCESS) {
+                goto restore_tag_and_return;
+            }
+        }
+    }
+
+    /* The crypto layer uses the start of the data to hold the header tag */
+    (void)memcpy(seg_data, obj->data, PS_TAG_LEN_BYTES);
+
+    err = ps_object_auth_encrypt(fid, PS_ENCRYPTED_HEADER_SIZE, obj);
+
+    (void)memcpy(obj->data, seg_data, PS_TAG_LEN_BYTES);
+
+    if (err != PSA_SUCCESS) {
+        goto restore_tag_and_return;
+    }
+
+    err = psa_its_set(fid, wrt_size, (const void *)obj->header.crypto.ref.iv,
+                      PSA_STORAGE_FLAG_NONE);
+
+restore_tag_and_return:
+    if (err != PSA_SUCCESS) {
+        (void)memcpy(obj->header.crypto.ref.tag, old_tag, PS_TAG_LEN_BYTES);
+    }
+
+    return err;
+}
+#endif /* PS_OBJECT_SEGMENT_SIZE */
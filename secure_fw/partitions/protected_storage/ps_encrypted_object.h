@@ -58,6 +58,76 @@ psa_status_t ps_encrypted_object_write(uint32_t fid,
  */
 uint32_t ps_encrypted_object_blocks(uint32_t size);
 
+#if PS_OBJECT_SEGMENT_SIZE
+/**
+ * \brief Reads and authenticates the header of a segmented object referenced
+ *        by the object File ID. The object data is not read.
+ *
+ * \param[in]  fid      File ID
+ * \param[out] obj      Pointer to the object structure to fill in
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+psa_status_t ps_encrypted_object_read_header(uint32_t fid,
+                                             struct ps_object_t *obj);
+
+/**
+ * \brief Reads and decrypts the data segments of a segmented object which
+ *        hold the given range of the object data.
+ *
+ * \param[in]     fid      File ID
+ * \param[in,out] obj      Pointer to the object structure, whose header has
+ *                         been read by \ref ps_encrypted_object_read_header
+ * \param[in]     offset   Offset in the object data
+ * \param[in]     size     Size of the range. The range is limited to the
+ *                         current object size.
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+psa_status_t ps_encrypted_object_read_data(uint32_t fid,
+                                           struct ps_object_t *obj,
+                                           uint32_t offset,
+                                           uint32_t size);
+
+/**
+ * \brief Prepares a segmented object for a write of the given range of its
+ *        data. The stored data segments are read, and the ones which are only
+ *        partially overwritten are decrypted.
+ *
+ * \param[in]     fid      File ID
+ * \param[in,out] obj      Pointer to the object structure, whose header has
+ *                         been read by \ref ps_encrypted_object_read_header
+ * \param[in]     offset   Offset in the object data of the write
+ * \param[in]     size     Size of the write
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+psa_status_t ps_encrypted_object_prepare_write(uint32_t fid,
+                                               struct ps_object_t *obj,
+                                               uint32_t offset,
+                                               uint32_t size);
+
+/**
+ * \brief Writes a segmented object, in which the given range of the data has
+ *        been updated. Only the data segments holding the range are
+ *        encrypted, the other ones must hold the data as stored.
+ *
+ * \param[in]     fid      File ID
+ * \param[in,out] obj      Pointer to the object structure to write
+ * \param[in]     offset   Offset in the object data of the updated range
+ * \param[in]     size     Size of the updated range
+ *
+ * Note: As \ref ps_encrypted_object_write, the function encrypts obj in place.
+ *       If it fails, the tag of the object is left unchanged.
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+psa_status_t ps_encrypted_object_write_data(uint32_t fid,
+                                            struct ps_object_t *obj,
+                                            uint32_t offset,
+                                            uint32_t size);
+#endif /* PS_OBJECT_SEGMENT_SIZE */
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,6 +30,26 @@ struct ps_object_info_t {
     psa_storage_create_flags_t create_flags; /*!< Object creation flags */
 };
 
+#define PS_MAX_OBJECT_DATA_SIZE  PS_MAX_ASSET_SIZE
+
+#if defined(PS_ENCRYPTION) && PS_OBJECT_SEGMENT_SIZE
+/* Number of data segments of the largest object */
+#define PS_OBJECT_NUM_SEGMENTS ((PS_MAX_OBJECT_DATA_SIZE + \
+                                 PS_OBJECT_SEGMENT_SIZE - 1) / \
+                                PS_OBJECT_SEGMENT_SIZE)
+
+/*!
+ * \struct ps_obj_segment_t
+ *
+ * \brief Crypto metadata of an object data segment, which is encrypted and
+ *        authenticated independently of the other segments.
+ */
+struct ps_obj_segment_t {
+    uint8_t iv[PS_IV_LEN_BYTES];   /*!< IV value of the segment AEAD */
+    uint8_t tag[PS_TAG_LEN_BYTES]; /*!< MAC value of the segment AEAD */
+};
+#endif
+
 /*!
  * \struct ps_obj_header_t
  *
@@ -43,11 +63,14 @@ struct ps_obj_header_t {
     uint32_t fid;                  /*!< File ID */
 #endif
     struct ps_object_info_t info; /*!< Object information */
+#if defined(PS_ENCRYPTION) && PS_OBJECT_SEGMENT_SIZE
+    struct ps_obj_segment_t seg[PS_OBJECT_NUM_SEGMENTS]; /*!< Data segments
+                                                          *   crypto metadata
+                                                          */
+#endif
 };
 
 
-#define PS_MAX_OBJECT_DATA_SIZE  PS_MAX_ASSET_SIZE
-
 #ifdef PS_ENCRYPTION
 #define PS_OBJECT_BUF_SIZE (PS_MAX_OBJECT_DATA_SIZE + PS_TAG_LEN_BYTES)
 #else
@@ -75,8 +98,13 @@ struct ps_object_t {
  *
  * \brief Specifies the maximum number of objects in the system, which is the
  *        number of defined assets, the object table and 2 temporary objects to
- *        store the temporary object table and temporary updated object.
+ *        store the temporary object table and temporary updated object, plus
+ *        the object table journal records if enabled.
  */
+#if PS_OBJ_TABLE_JOURNAL
+#define PS_MAX_NUM_OBJECTS (PS_NUM_ASSETS + 3 + PS_OBJ_TABLE_JOURNAL_SIZE)
+#else
 #define PS_MAX_NUM_OBJECTS (PS_NUM_ASSETS + 3)
+#endif
 
 #endif /* __PS_OBJECT_DEFS_H__ */
@@ -157,6 +157,30 @@ enum read_type_t {
     READ_ALL_OBJECT,
 };
 
+/**
+ * \brief Reads part of the data of an object, whose header has been read by
+ *        \ref ps_read_object, into g_ps_object.
+ *
+ * \param[in] offset  Offset in the object data
+ * \param[in] size    Number of bytes to read
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_read_object_data(uint32_t offset, uint32_t size)
+{
+    size_t data_length;
+
+    if (size == 0) {
+        return PSA_SUCCESS;
+    }
+
+    return psa_its_get(g_obj_tbl_info.fid,
+                       PS_OBJECT_HEADER_SIZE + offset,
+                       size,
+                       (void *)(g_ps_object.data + offset),
+                       &data_length);
+}
+
 /**
  * \brief Reads and validates an object header based on its object table info
  *        stored in g_obj_tbl_info.
@@ -189,15 +213,8 @@ static psa_status_t ps_read_object(enum read_type_t type)
     }
 
     /* Read object data if any */
-    if (type == READ_ALL_OBJECT && g_ps_object.header.info.current_size > 0) {
-        err = psa_its_get(g_obj_tbl_info.fid,
-                          PS_OBJECT_HEADER_SIZE,
-                          g_ps_object.header.info.current_size,
-                          (void *)g_ps_object.data,
-                          &data_length);
-        if (err != PSA_SUCCESS) {
-            return err;
-        }
+    if (type == READ_ALL_OBJECT) {
+        return ps_read_object_data(0, g_ps_object.header.info.current_size);
     }
 
     return PSA_SUCCESS;
@@ -232,12 +249,16 @@ static psa_status_t ps_write_object(uint32_t wrt_size)
  *
  * \param[in]  uid       Unique identifier for the data
  * \param[in]  client_id Identifier of the asset's owner (client)
+ * \param[in]  offset    Offset of the updated object data
+ * \param[in]  size      Size of the updated object data
  * \param[out] p_blocks  New number of encryption blocks needed to read/write
  *                       the object, if changed.
  *
  * \return Returns error code as specified in \ref psa_status_t
  */
-static psa_status_t ps_store_object(psa_storage_uid_t uid, int32_t client_id, uint32_t *p_blocks)
+static psa_status_t ps_store_object(psa_storage_uid_t uid, int32_t client_id,
+                                    uint32_t offset, uint32_t size,
+                                    uint32_t *p_blocks)
 {
     psa_status_t err;
 #ifndef PS_ENCRYPTION
@@ -245,7 +266,11 @@ static psa_status_t ps_store_object(psa_storage_uid_t uid, int32_t client_id, ui
 #endif
 
 #ifdef PS_ENCRYPTION
-#if PS_AES_KEY_USAGE_LIMIT == 0
+#if PS_OBJECT_SEGMENT_SIZE
+    /* Only the segments holding the updated data are encrypted again */
+    err = ps_encrypted_object_write_data(g_obj_tbl_info.fid, &g_ps_object,
+                                         offset, size);
+#elif PS_AES_KEY_USAGE_LIMIT == 0
     err = ps_encrypted_object_write(g_obj_tbl_info.fid, &g_ps_object);
 #else
     uint32_t num_blocks = ps_encrypted_object_blocks(g_ps_object.header.info.current_size);
@@ -324,13 +349,19 @@ psa_status_t ps_object_read(psa_storage_uid_t uid, int32_t client_id,
     g_ps_object.header.crypto.ref.uid = uid;
     g_ps_object.header.crypto.ref.client_id = client_id;
 
+#if PS_OBJECT_SEGMENT_SIZE
+    /* The data segments are read once the request is checked */
+    err = ps_encrypted_object_read_header(g_obj_tbl_info.fid, &g_ps_object);
+    num_blocks = 0;
+#else
     err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object, &num_blocks);
+#endif
 #if PS_AES_KEY_USAGE_LIMIT != 0
     g_obj_tbl_info.num_blocks += num_blocks;
 #endif
 #else
     /* Read object header */
-    err = ps_read_object(READ_ALL_OBJECT);
+    err = ps_read_object(READ_HEADER_ONLY);
 #endif /* PS_ENCRYPTION */
     if (err != PSA_SUCCESS) {
         goto update_table_and_return;
@@ -345,6 +376,17 @@ psa_status_t ps_object_read(psa_storage_uid_t uid, int32_t client_id,
     size = PS_UTILS_MIN(size,
                         g_ps_object.header.info.current_size - offset);
 
+    /* Read the requested object data */
+#ifndef PS_ENCRYPTION
+    err = ps_read_object_data(offset, size);
+#elif PS_OBJECT_SEGMENT_SIZE
+    err = ps_encrypted_object_read_data(g_obj_tbl_info.fid, &g_ps_object,
+                                        offset, size);
+#endif
+    if (err != PSA_SUCCESS) {
+        goto switch_keys_and_return;
+    }
+
     /* Copy the decrypted object data to the output buffer */
     ps_req_mngr_write_asset_data(g_ps_object.data + offset, size);
 
@@ -401,7 +443,14 @@ psa_status_t ps_object_create(psa_storage_uid_t uid, int32_t client_id,
         g_ps_object.header.crypto.ref.uid = uid;
         g_ps_object.header.crypto.ref.client_id = client_id;
 
+#if PS_OBJECT_SEGMENT_SIZE
+        /* The object data is replaced, so only the header is read */
+        err = ps_encrypted_object_read_header(g_obj_tbl_info.fid,
+                                              &g_ps_object);
+        num_blocks = 0;
+#else
         err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object, &num_blocks);
+#endif
 #if PS_AES_KEY_USAGE_LIMIT != 0
         g_obj_tbl_info.num_blocks += num_blocks;
 #endif /* PS_AES_KEY_USAGE_LIMIT */
@@ -457,7 +506,7 @@ psa_status_t ps_object_create(psa_storage_uid_t uid, int32_t client_id,
     /* Update the current object size */
     g_ps_object.header.info.current_size = size;
 
-    err = ps_store_object(uid, client_id, &num_blocks);
+    err = ps_store_object(uid, client_id, 0, size, &num_blocks);
     if (err != PSA_SUCCESS) {
         /* If we failed to store the updated object, we need to keep the old version */
         if (old_fid != PS_INVALID_FID) {
@@ -517,7 +566,13 @@ psa_status_t ps_object_write(psa_storage_uid_t uid, int32_t client_id,
     g_ps_object.header.crypto.ref.uid = uid;
     g_ps_object.header.crypto.ref.client_id = client_id;
 
+#if PS_OBJECT_SEGMENT_SIZE
+    /* The data segments are read once the request is checked */
+    err = ps_encrypted_object_read_header(g_obj_tbl_info.fid, &g_ps_object);
+    num_blocks = 0;
+#else
     err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object, &num_blocks);
+#endif
 #if PS_AES_KEY_USAGE_LIMIT != 0
     g_obj_tbl_info.num_blocks += num_blocks;
 #endif
@@ -549,6 +604,15 @@ psa_status_t ps_object_write(psa_storage_uid_t uid, int32_t client_id,
         goto switch_keys_and_return;
     }
 
+#if PS_OBJECT_SEGMENT_SIZE
+    /* Read the stored object data to merge the new data with */
+    err = ps_encrypted_object_prepare_write(g_obj_tbl_info.fid, &g_ps_object,
+                                            offset, size);
+    if (err != PSA_SUCCESS) {
+        goto switch_keys_and_return;
+    }
+#endif
+
     /* Update the object data */
     err = ps_req_mngr_read_asset_data(g_ps_object.data + offset, size);
     if (err != PSA_SUCCESS) {
@@ -569,7 +633,7 @@ psa_status_t ps_object_write(psa_storage_uid_t uid, int32_t client_id,
         g_ps_object.header.info.current_size = offset + size;
     }
 
-    err = ps_store_object(uid, client_id, &num_blocks);
+    err = ps_store_object(uid, client_id, offset, size, &num_blocks);
     if (err != PSA_SUCCESS) {
         /* We couldn't write the new data, so keep the old */
         g_obj_tbl_info.fid = old_fid;
@@ -625,7 +689,13 @@ psa_status_t ps_object_get_info(psa_storage_uid_t uid, int32_t client_id,
     g_ps_object.header.crypto.ref.uid = uid;
     g_ps_object.header.crypto.ref.client_id = client_id;
 
+#if PS_OBJECT_SEGMENT_SIZE
+    /* Only the object header is needed */
+    err = ps_encrypted_object_read_header(g_obj_tbl_info.fid, &g_ps_object);
+    num_blocks = 0;
+#else
     err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object, &num_blocks);
+#endif
 #if PS_AES_KEY_USAGE_LIMIT != 0
     g_obj_tbl_info.num_blocks += num_blocks;
 #endif
@@ -682,7 +752,13 @@ psa_status_t ps_object_delete(psa_storage_uid_t uid, int32_t client_id)
     g_ps_object.header.crypto.ref.uid = uid;
     g_ps_object.header.crypto.ref.client_id = client_id;
 
+#if PS_OBJECT_SEGMENT_SIZE
+    /* Only the object header is needed */
+    err = ps_encrypted_object_read_header(g_obj_tbl_info.fid, &g_ps_object);
+    num_blocks = 0;
+#else
     err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object, &num_blocks);
+#endif
 #if PS_AES_KEY_USAGE_LIMIT != 0
     g_obj_tbl_info.num_blocks += num_blocks;
 #endif
@@ -9,6 +9,7 @@
 
 #include "ps_object_table.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
 
@@ -28,9 +29,13 @@
 /*!
  * \def PS_OBJECT_SYSTEM_VERSION
  *
- * \brief Current object system version.
+ * \brief Current object system version. The options which change the stored
+ *        format are part of it, so that a PS area stored with other options is
+ *        not used.
  */
-#define PS_OBJECT_SYSTEM_VERSION  0x01
+#define PS_OBJECT_SYSTEM_VERSION  (0x01 | \
+                                   (PS_OBJ_TABLE_JOURNAL ? 0x02 : 0x00) | \
+                                   (PS_OBJECT_SEGMENT_SIZE ? 0x04 : 0x00))
 
 /*!
  * \struct ps_obj_table_info_t
@@ -74,6 +79,12 @@ struct ps_obj_table_t {
                                   */
 #endif /* PS_ROLLBACK_PROTECTION */
 
+#if PS_OBJ_TABLE_JOURNAL
+  uint32_t log_seq;              /*!< Sequence number of the table, to which
+                                  *   the journal records are bound.
+                                  */
+#endif /* PS_OBJ_TABLE_JOURNAL */
+
   struct ps_obj_table_entry_t obj_db[PS_OBJ_TABLE_ENTRIES]; /*!< Table's
                                                              *   entries
                                                              */
@@ -132,6 +143,46 @@ struct ps_obj_table_t {
 #define PS_OBJECT_FS_ID_TO_IDX(fid) ((fid - 1) - \
                                       PS_TABLE_FS_ID(PS_OBJ_TABLE_IDX_1))
 
+/* Specifies that a journal record entry is not used */
+#define PS_OBJ_TABLE_LOG_NO_ENTRY UINT32_MAX
+
+#if PS_OBJ_TABLE_JOURNAL
+/*!
+ * \def PS_OBJ_TABLE_LOG_FS_ID
+ *
+ * \brief File ID to be used in order to store a journal record in the
+ *        file system.
+ *
+ * \param[in] idx  Journal record index to convert into a file ID.
+ *
+ * \return Returns file ID
+ */
+#define PS_OBJ_TABLE_LOG_FS_ID(idx) (PS_OBJECT_FS_ID(PS_OBJ_TABLE_ENTRIES) + \
+                                     (idx))
+
+/* Number of table entries updated by a journal record */
+#define PS_OBJ_TABLE_LOG_NUM_ENTRIES 2
+
+/*!
+ * \struct ps_obj_table_log_t
+ *
+ * \brief Journal record structure. A record stores the new content of the
+ *        table entries updated by a create, write or delete operation, so that
+ *        only the change is written to the file system. The records are
+ *        applied in order to the table they are bound to.
+ */
+struct ps_obj_table_log_t {
+#ifdef PS_ENCRYPTION
+    union ps_crypto_t crypto;   /*!< Crypto metadata */
+#endif
+    uint32_t base_seq;          /*!< Sequence number of the table */
+    uint32_t seq;               /*!< Sequence number of the record */
+    uint32_t idx[PS_OBJ_TABLE_LOG_NUM_ENTRIES]; /*!< Updated entry indexes */
+    /*! New content of the updated entries */
+    struct ps_obj_table_entry_t entry[PS_OBJ_TABLE_LOG_NUM_ENTRIES];
+};
+#endif /* PS_OBJ_TABLE_JOURNAL */
+
 /*!
  * \struct ps_obj_table_ctx_t
  *
@@ -141,11 +192,33 @@ struct ps_obj_table_ctx_t {
     struct ps_obj_table_t obj_table;  /*!< Object tables */
     uint8_t active_table;             /*!< Active object table */
     uint8_t scratch_table;            /*!< Scratch object table */
+#if PS_OBJ_TABLE_JOURNAL
+    bool old_table;                   /*!< The scratch object table is stored */
+    uint32_t log_count;               /*!< Number of journal records */
+    uint32_t log_seq;                 /*!< Last used sequence number */
+#endif
 };
 
 /* Object table context */
 static struct ps_obj_table_ctx_t ps_obj_table_ctx;
 
+/* Number of slots in the object table index. Twice the number of entries keeps
+ * the probe sequences short.
+ */
+#define PS_OBJ_TABLE_INDEX_SIZE (2 * PS_OBJ_TABLE_ENTRIES)
+
+/* Specifies that an object table index slot is empty */
+#define PS_OBJ_TABLE_INDEX_EMPTY 0
+
+#if PS_OBJ_TABLE_ENTRIES >= UINT16_MAX
+#error "PS_NUM_ASSETS is too large for the object table index"
+#endif
+
+/* Hash table which maps a UID and client ID pair to its table entry. Each slot
+ * holds the entry's index plus one, or PS_OBJ_TABLE_INDEX_EMPTY.
+ */
+static uint16_t ps_obj_table_index[PS_OBJ_TABLE_INDEX_SIZE];
+
 /* Object table size */
 #define PS_OBJ_TABLE_SIZE            sizeof(struct ps_obj_table_t)
 
@@ -295,6 +368,102 @@ __STATIC_INLINE psa_status_t ps_object_table_fs_write_table(
     return PSA_SUCCESS;
 }
 
+#if PS_OBJ_TABLE_JOURNAL
+#ifdef PS_ENCRYPTION
+/* The authenticated data of a journal record is the record minus the crypto
+ * data.
+ */
+#define PS_OBJ_TABLE_LOG_AUTH_DATA(log) ((const uint8_t *)(log) + \
+                                         PS_NON_AUTH_OBJ_TABLE_SIZE)
+
+#define PS_OBJ_TABLE_LOG_AUTH_DATA_LEN (sizeof(struct ps_obj_table_log_t) - \
+                                        PS_NON_AUTH_OBJ_TABLE_SIZE)
+#endif /* PS_ENCRYPTION */
+
+/**
+ * \brief Reads the journal records bound to an object table from persistent
+ *        memory and checks them. The records are valid up to the first one
+ *        which is missing, fails authentication, is bound to another table or
+ *        does not have a greater sequence number than the previous one.
+ *
+ * \param[in,out] obj_table  Pointer to the object table
+ * \param[in]     apply      If true, the valid records are applied to the
+ *                           object table
+ * \param[out]    num_logs   Number of valid records
+ * \param[out]    last_seq   Sequence number of the last valid record, or of
+ *                           the object table if there is none
+ */
+static void ps_object_table_replay_log(struct ps_obj_table_t *obj_table,
+                                       bool apply,
+                                       uint32_t *num_logs,
+                                       uint32_t *last_seq)
+{
+    struct ps_obj_table_log_t log;
+    psa_status_t err;
+    size_t data_length;
+    uint32_t i;
+    uint32_t j;
+
+    *num_logs = 0;
+    *last_seq = obj_table->log_seq;
+
+    for (i = 0; i < PS_OBJ_TABLE_JOURNAL_SIZE; i++) {
+        err = psa_its_get(PS_OBJ_TABLE_LOG_FS_ID(i), 0, sizeof(log),
+                          (void *)&log, &data_length);
+        if (err != PSA_SUCCESS || data_length != sizeof(log)) {
+            return;
+        }
+
+        if (log.base_seq != obj_table->log_seq || log.seq <= *last_seq) {
+            return;
+        }
+
+        for (j = 0; j < PS_OBJ_TABLE_LOG_NUM_ENTRIES; j++) {
+            if (log.idx[j] >= PS_OBJ_TABLE_ENTRIES &&
+                log.idx[j] != PS_OBJ_TABLE_LOG_NO_ENTRY) {
+                return;
+            }
+        }
+
+#ifdef PS_ENCRYPTION
+        log.crypto.ref.client_id = PS_OBJ_TABLE_CLIENT_ID;
+        log.crypto.ref.uid = PS_OBJ_TABLE_UID;
+
+        err = ps_crypto_authenticate(&log.crypto,
+                                     PS_OBJ_TABLE_LOG_AUTH_DATA(&log),
+                                     PS_OBJ_TABLE_LOG_AUTH_DATA_LEN);
+        if (err != PSA_SUCCESS) {
+            return;
+        }
+#endif /* PS_ENCRYPTION */
+
+        if (apply) {
+            for (j = 0; j < PS_OBJ_TABLE_LOG_NUM_ENTRIES; j++) {
+                if (log.idx[j] != PS_OBJ_TABLE_LOG_NO_ENTRY) {
+                    (void)memcpy(&obj_table->obj_db[log.idx[j]],
+                                 &log.entry[j], PS_OBJECTS_TABLE_ENTRY_SIZE);
+                }
+            }
+
+#ifdef PS_ENCRYPTION
+#if PS_AES_KEY_USAGE_LIMIT != 0
+            if (log.crypto.ref.key_gen_nr > obj_table->crypto.ref.key_gen_nr) {
+                obj_table->crypto.ref.key_gen_nr = log.crypto.ref.key_gen_nr;
+            }
+#endif
+            /* The records are written after the table, so their IV is the
+             * last one used.
+             */
+            ps_crypto_set_iv(&log.crypto);
+#endif /* PS_ENCRYPTION */
+        }
+
+        (*num_logs)++;
+        *last_seq = log.seq;
+    }
+}
+#endif /* PS_OBJ_TABLE_JOURNAL */
+
 #ifdef PS_ENCRYPTION
 #if PS_ROLLBACK_PROTECTION
 /**
@@ -384,7 +553,38 @@ static void ps_object_table_authenticate(uint8_t table_idx,
     struct ps_crypto_assoc_data_t assoc_data;
     union ps_crypto_t *crypto = &init_ctx->p_table[table_idx]->crypto;
     psa_status_t err;
+#if PS_OBJ_TABLE_JOURNAL
+    uint32_t num_logs;
+    uint32_t last_seq;
 
+    /* The table is authenticated with the NV counter 1 value it was written
+     * with, which is its sequence number. The journal records written after
+     * it must bring it up to the current NV counter value.
+     */
+    assoc_data.nv_counter = init_ctx->p_table[table_idx]->log_seq;
+    (void)memcpy(assoc_data.obj_table_data,
+                 PS_CRYPTO_ASSOCIATED_DATA(crypto),
+                 PS_OBJ_TABLE_AUTH_DATA_SIZE);
+
+    err = ps_crypto_authenticate(crypto, (const uint8_t *)&assoc_data,
+                                 PS_CRYPTO_ASSOCIATED_DATA_LEN);
+    if (err != PSA_SUCCESS) {
+        init_ctx->table_state[table_idx] = PS_OBJ_TABLE_INVALID;
+        return;
+    }
+
+    ps_object_table_replay_log(init_ctx->p_table[table_idx], false, &num_logs,
+                               &last_seq);
+
+    if (last_seq == init_ctx->nvc_1) {
+        init_ctx->table_state[table_idx] = PS_OBJ_TABLE_NVC_1_VALID;
+    } else if (init_ctx->nvc_3 != PS_INVALID_NVC_VALUE &&
+               last_seq == init_ctx->nvc_3) {
+        init_ctx->table_state[table_idx] = PS_OBJ_TABLE_NVC_3_VALID;
+    } else {
+        init_ctx->table_state[table_idx] = PS_OBJ_TABLE_INVALID;
+    }
+#else
     /* Init associated data with NVC 1 */
     assoc_data.nv_counter = init_ctx->nvc_1;
     (void)memcpy(assoc_data.obj_table_data,
@@ -425,6 +625,7 @@ static void ps_object_table_authenticate(uint8_t table_idx,
     } else {
         init_ctx->table_state[table_idx] = PS_OBJ_TABLE_NVC_3_VALID;
     }
+#endif /* PS_OBJ_TABLE_JOURNAL */
 }
 
 /**
@@ -571,6 +772,9 @@ static psa_status_t ps_object_table_save_table(
                                               struct ps_obj_table_t *obj_table)
 {
     psa_status_t err;
+#if PS_OBJ_TABLE_JOURNAL
+    uint32_t old_log_seq = obj_table->log_seq;
+#endif
 
 #if PS_ROLLBACK_PROTECTION
     uint32_t nvc_1 = 0;
@@ -584,6 +788,10 @@ static psa_status_t ps_object_table_save_table(
     if (err != PSA_SUCCESS) {
         return err;
     }
+
+#if PS_OBJ_TABLE_JOURNAL
+    obj_table->log_seq = nvc_1;
+#endif
 #else
     obj_table->swap_count++;
 
@@ -596,6 +804,10 @@ static psa_status_t ps_object_table_save_table(
          */
         obj_table->swap_count = 0;
     }
+
+#if PS_OBJ_TABLE_JOURNAL
+    obj_table->log_seq = ps_obj_table_ctx.log_seq + 1;
+#endif
 #endif /* PS_ROLLBACK_PROTECTION */
 
 #ifdef PS_ENCRYPTION
@@ -615,6 +827,19 @@ static psa_status_t ps_object_table_save_table(
 
     err = ps_object_table_fs_write_table(obj_table);
 
+#if PS_OBJ_TABLE_JOURNAL
+    if (err != PSA_SUCCESS) {
+        /* Keep the journal records bound to the stored table */
+        obj_table->log_seq = old_log_seq;
+        return err;
+    }
+
+    /* The journal restarts from the new table */
+    ps_obj_table_ctx.old_table = true;
+    ps_obj_table_ctx.log_count = 0;
+    ps_obj_table_ctx.log_seq = obj_table->log_seq;
+#endif /* PS_OBJ_TABLE_JOURNAL */
+
 #if PS_ROLLBACK_PROTECTION
     if (err != PSA_SUCCESS) {
         return err;
@@ -627,6 +852,123 @@ static psa_status_t ps_object_table_save_table(
     return err;
 }
 
+#if PS_OBJ_TABLE_JOURNAL
+/**
+ * \brief Saves the given table entries in a journal record in the persistent
+ *        memory.
+ *
+ * \param[in] idx  Indexes of the updated table entries, or
+ *                 PS_OBJ_TABLE_LOG_NO_ENTRY
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_table_save_log(
+                               const uint32_t idx[PS_OBJ_TABLE_LOG_NUM_ENTRIES])
+{
+    struct ps_obj_table_log_t log;
+    struct ps_obj_table_t *p_table = &ps_obj_table_ctx.obj_table;
+    psa_status_t err;
+    uint32_t i;
+
+    (void)memset(&log, PS_DEFAULT_EMPTY_BUFF_VAL, sizeof(log));
+
+    log.base_seq = p_table->log_seq;
+
+    for (i = 0; i < PS_OBJ_TABLE_LOG_NUM_ENTRIES; i++) {
+        log.idx[i] = idx[i];
+        if (idx[i] != PS_OBJ_TABLE_LOG_NO_ENTRY) {
+            (void)memcpy(&log.entry[i], &p_table->obj_db[idx[i]],
+                         PS_OBJECTS_TABLE_ENTRY_SIZE);
+        }
+    }
+
+#if PS_ROLLBACK_PROTECTION
+    /* The sequence number of the record is the NV counter 1 value, so that the
+     * last record is bound to the current NV counter value.
+     */
+    err = ps_increment_nv_counter(TFM_PS_NV_COUNTER_1);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = ps_read_nv_counter(TFM_PS_NV_COUNTER_1, &log.seq);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+#else
+    log.seq = ps_obj_table_ctx.log_seq + 1;
+#endif /* PS_ROLLBACK_PROTECTION */
+
+#ifdef PS_ENCRYPTION
+    log.crypto.ref.client_id = PS_OBJ_TABLE_CLIENT_ID;
+    log.crypto.ref.uid = PS_OBJ_TABLE_UID;
+#if PS_AES_KEY_USAGE_LIMIT != 0
+    log.crypto.ref.key_gen_nr = p_table->crypto.ref.key_gen_nr;
+#endif
+
+    /* Get new IV */
+    err = ps_crypto_get_iv(&log.crypto);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = ps_crypto_generate_auth_tag(&log.crypto,
+                                      PS_OBJ_TABLE_LOG_AUTH_DATA(&log),
+                                      PS_OBJ_TABLE_LOG_AUTH_DATA_LEN);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+#endif /* PS_ENCRYPTION */
+
+    err = psa_its_set(PS_OBJ_TABLE_LOG_FS_ID(ps_obj_table_ctx.log_count),
+                      sizeof(log),
+                      (const void *)&log,
+                      PSA_STORAGE_FLAG_NONE);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    ps_obj_table_ctx.log_count++;
+    ps_obj_table_ctx.log_seq = log.seq;
+
+#if PS_ROLLBACK_PROTECTION
+    /* Align PS NV counters to have the same value */
+    err = ps_object_table_align_nv_counters(log.seq);
+#endif /* PS_ROLLBACK_PROTECTION */
+
+    return err;
+}
+#endif /* PS_OBJ_TABLE_JOURNAL */
+
+/**
+ * \brief Saves the changes to the given table entries in the persistent
+ *        memory. When the journal is enabled, the changes are saved in a
+ *        journal record, unless the journal is full, in which case the whole
+ *        table is saved and the journal is restarted.
+ *
+ * \param[in] idx_0  Index of an updated table entry
+ * \param[in] idx_1  Index of another updated table entry, or
+ *                   PS_OBJ_TABLE_LOG_NO_ENTRY
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_table_save_entries(uint32_t idx_0,
+                                                 uint32_t idx_1)
+{
+#if PS_OBJ_TABLE_JOURNAL
+    const uint32_t idx[PS_OBJ_TABLE_LOG_NUM_ENTRIES] = {idx_0, idx_1};
+
+    if (ps_obj_table_ctx.log_count < PS_OBJ_TABLE_JOURNAL_SIZE) {
+        return ps_object_table_save_log(idx);
+    }
+#else
+    (void)idx_0;
+    (void)idx_1;
+#endif /* PS_OBJ_TABLE_JOURNAL */
+
+    return ps_object_table_save_table(&ps_obj_table_ctx.obj_table);
+}
+
 /**
  * \brief Checks the validity of the table version.
  *
@@ -764,6 +1106,112 @@ static psa_status_t ps_set_active_object_table(
     return PSA_SUCCESS;
 }
 
+/**
+ * \brief Gets the home slot of an object in the object table index.
+ *
+ * \param[in] uid        Object UID
+ * \param[in] client_id  Client UID
+ *
+ * \return Returns the slot number
+ */
+static uint32_t ps_object_table_index_hash(psa_storage_uid_t uid,
+                                           int32_t client_id)
+{
+    uint32_t h;
+
+    h = (uint32_t)uid ^ (uint32_t)(uid >> 32) ^
+        ((uint32_t)client_id * 0x9E3779B1U);
+    h ^= h >> 16;
+    h *= 0x85EBCA6BU;
+    h ^= h >> 13;
+
+    return h % PS_OBJ_TABLE_INDEX_SIZE;
+}
+
+/**
+ * \brief Adds a table entry to the object table index.
+ *
+ * \param[in] idx  Entry index to add
+ *
+ */
+static void ps_object_table_index_insert(uint32_t idx)
+{
+    const struct ps_obj_table_entry_t *entry =
+                                     &ps_obj_table_ctx.obj_table.obj_db[idx];
+    uint32_t slot = ps_object_table_index_hash(entry->uid, entry->client_id);
+
+    /* The index has more slots than the table has entries, so there is always
+     * an empty slot.
+     */
+    while (ps_obj_table_index[slot] != PS_OBJ_TABLE_INDEX_EMPTY) {
+        slot = (slot + 1) % PS_OBJ_TABLE_INDEX_SIZE;
+    }
+
+    ps_obj_table_index[slot] = (uint16_t)(idx + 1);
+}
+
+/**
+ * \brief Removes a table entry from the object table index. The following
+ *        entries of the probe sequence are shifted back, so that lookups do
+ *        not need tombstones.
+ *
+ * \param[in] idx  Entry index to remove
+ *
+ */
+static void ps_object_table_index_remove(uint32_t idx)
+{
+    const struct ps_obj_table_entry_t *entry =
+                                     &ps_obj_table_ctx.obj_table.obj_db[idx];
+    uint32_t hole = ps_object_table_index_hash(entry->uid, entry->client_id);
+    uint32_t next;
+    uint32_t home;
+
+    while (ps_obj_table_index[hole] != (uint16_t)(idx + 1)) {
+        if (ps_obj_table_index[hole] == PS_OBJ_TABLE_INDEX_EMPTY) {
+            return;
+        }
+        hole = (hole + 1) % PS_OBJ_TABLE_INDEX_SIZE;
+    }
+
+    next = (hole + 1) % PS_OBJ_TABLE_INDEX_SIZE;
+
+    while (ps_obj_table_index[next] != PS_OBJ_TABLE_INDEX_EMPTY) {
+        entry = &ps_obj_table_ctx.obj_table.obj_db[
+                                               ps_obj_table_index[next] - 1];
+        home = ps_object_table_index_hash(entry->uid, entry->client_id);
+
+        /* Move the slot into the hole if the hole is not before its home slot
+         * in the probe sequence.
+         */
+        if ((next + PS_OBJ_TABLE_INDEX_SIZE - home) % PS_OBJ_TABLE_INDEX_SIZE >=
+            (next + PS_OBJ_TABLE_INDEX_SIZE - hole) % PS_OBJ_TABLE_INDEX_SIZE) {
+            ps_obj_table_index[hole] = ps_obj_table_index[next];
+            hole = next;
+        }
+
+        next = (next + 1) % PS_OBJ_TABLE_INDEX_SIZE;
+    }
+
+    ps_obj_table_index[hole] = PS_OBJ_TABLE_INDEX_EMPTY;
+}
+
+/**
+ * \brief Builds the object table index from the object table content.
+ */
+static void ps_object_table_index_build(void)
+{
+    uint32_t i;
+
+    (void)memset(ps_obj_table_index, PS_OBJ_TABLE_INDEX_EMPTY,
+                 sizeof(ps_obj_table_index));
+
+    for (i = 0; i < PS_OBJ_TABLE_ENTRIES; i++) {
+        if (ps_obj_table_ctx.obj_table.obj_db[i].uid != TFM_PS_INVALID_UID) {
+            ps_object_table_index_insert(i);
+        }
+    }
+}
+
 /**
  * \brief Gets table's entry index based on the given object UID and client ID.
  *
@@ -778,15 +1226,18 @@ static psa_status_t ps_get_object_entry_idx(psa_storage_uid_t uid,
                                             int32_t client_id,
                                             uint32_t *idx)
 {
+    uint32_t slot = ps_object_table_index_hash(uid, client_id);
     uint32_t i;
     struct ps_obj_table_t *p_table = &ps_obj_table_ctx.obj_table;
 
-    for (i = 0; i < PS_OBJ_TABLE_ENTRIES; i++) {
+    while (ps_obj_table_index[slot] != PS_OBJ_TABLE_INDEX_EMPTY) {
+        i = ps_obj_table_index[slot] - 1U;
         if (p_table->obj_db[i].uid == uid
             && p_table->obj_db[i].client_id == client_id) {
             *idx = i;
             return PSA_SUCCESS;
         }
+        slot = (slot + 1) % PS_OBJ_TABLE_INDEX_SIZE;
     }
 
     return PSA_ERROR_DOES_NOT_EXIST;
@@ -841,14 +1292,50 @@ __STATIC_INLINE psa_status_t ps_table_free_idx(uint32_t idx_num,
  */
 static void ps_table_delete_entry(uint32_t idx)
 {
+    if (ps_obj_table_ctx.obj_table.obj_db[idx].uid != TFM_PS_INVALID_UID) {
+        ps_object_table_index_remove(idx);
+    }
+
     /* Initialise object table entry structure */
     (void)memset(&ps_obj_table_ctx.obj_table.obj_db[idx],
                  PS_DEFAULT_EMPTY_BUFF_VAL, PS_OBJECTS_TABLE_ENTRY_SIZE);
 }
 
+/**
+ * \brief Sets the content of an entry of the table
+ *
+ * \param[in] idx    Entry index to set
+ * \param[in] entry  Pointer to the new entry content
+ *
+ */
+static void ps_table_set_entry(uint32_t idx,
+                               const struct ps_obj_table_entry_t *entry)
+{
+    ps_table_delete_entry(idx);
+
+    (void)memcpy(&ps_obj_table_ctx.obj_table.obj_db[idx], entry,
+                 PS_OBJECTS_TABLE_ENTRY_SIZE);
+
+    if (entry->uid != TFM_PS_INVALID_UID) {
+        ps_object_table_index_insert(idx);
+    }
+}
+
 psa_status_t ps_object_table_create(void)
 {
     struct ps_obj_table_t *p_table = &ps_obj_table_ctx.obj_table;
+#if PS_OBJ_TABLE_JOURNAL
+    psa_status_t err;
+    uint32_t i;
+
+    /* Remove the journal records of a previous object table */
+    for (i = 0; i < PS_OBJ_TABLE_JOURNAL_SIZE; i++) {
+        err = psa_its_remove(PS_OBJ_TABLE_LOG_FS_ID(i));
+        if (err != PSA_SUCCESS && err != PSA_ERROR_DOES_NOT_EXIST) {
+            return err;
+        }
+    }
+#endif /* PS_OBJ_TABLE_JOURNAL */
 
     /* Initialize object structure */
     (void)memset(&ps_obj_table_ctx, PS_DEFAULT_EMPTY_BUFF_VAL,
@@ -870,8 +1357,19 @@ psa_status_t ps_object_table_create(void)
 
     p_table->version = PS_OBJECT_SYSTEM_VERSION;
 
+    ps_object_table_index_build();
+
     /* Save object table contents */
+#if PS_OBJ_TABLE_JOURNAL
+    err = ps_object_table_save_table(p_table);
+
+    /* There is no old table to delete */
+    ps_obj_table_ctx.old_table = false;
+
+    return err;
+#else
     return ps_object_table_save_table(p_table);
+#endif /* PS_OBJ_TABLE_JOURNAL */
 }
 
 psa_status_t ps_object_table_init(uint8_t *obj_data)
@@ -926,6 +1424,16 @@ psa_status_t ps_object_table_init(uint8_t *obj_data)
     ps_crypto_set_iv(&ps_obj_table_ctx.obj_table.crypto);
 #endif
 
+#if PS_OBJ_TABLE_JOURNAL
+    /* Apply the journal records written after the active table */
+    ps_object_table_replay_log(&ps_obj_table_ctx.obj_table, true,
+                               &ps_obj_table_ctx.log_count,
+                               &ps_obj_table_ctx.log_seq);
+    ps_obj_table_ctx.old_table = false;
+#endif /* PS_OBJ_TABLE_JOURNAL */
+
+    ps_object_table_index_build();
+
     return PSA_SUCCESS;
 }
 
@@ -1034,15 +1542,21 @@ psa_status_t ps_object_table_set_obj_tbl_info(psa_storage_uid_t uid,
     p_table->obj_db[idx].version = obj_tbl_info->version;
 #endif
 
-    err = ps_object_table_save_table(p_table);
+    ps_object_table_index_insert(idx);
+
+    if (backup_entry.uid != TFM_PS_INVALID_UID && backup_idx != idx) {
+        err = ps_object_table_save_entries(idx, backup_idx);
+    } else {
+        err = ps_object_table_save_entries(idx, PS_OBJ_TABLE_LOG_NO_ENTRY);
+    }
+
     if (err != PSA_SUCCESS) {
+        ps_table_delete_entry(idx);
+
         if (backup_entry.uid != TFM_PS_INVALID_UID) {
             /* Rollback the change in the table */
-            (void)memcpy(&p_table->obj_db[backup_idx], &backup_entry,
-                         PS_OBJECTS_TABLE_ENTRY_SIZE);
+            ps_table_set_entry(backup_idx, &backup_entry);
         }
-
-        ps_table_delete_entry(idx);
     }
 
     return err;
@@ -1102,11 +1616,10 @@ psa_status_t ps_object_table_delete_object(psa_storage_uid_t uid,
 
     ps_table_delete_entry(backup_idx);
 
-    err = ps_object_table_save_table(p_table);
+    err = ps_object_table_save_entries(backup_idx, PS_OBJ_TABLE_LOG_NO_ENTRY);
     if (err != PSA_SUCCESS) {
        /* Rollback the change in the table */
-       (void)memcpy(&p_table->obj_db[backup_idx], &backup_entry,
-                    PS_OBJECTS_TABLE_ENTRY_SIZE);
+       ps_table_set_entry(backup_idx, &backup_entry);
     }
 
     return err;
@@ -1115,6 +1628,21 @@ psa_status_t ps_object_table_delete_object(psa_storage_uid_t uid,
 psa_status_t ps_object_table_delete_old_table(void)
 {
     uint32_t table_id = PS_TABLE_FS_ID(ps_obj_table_ctx.scratch_table);
+#if PS_OBJ_TABLE_JOURNAL
+    psa_status_t err;
 
+    /* The table is only saved when the journal is full */
+    if (!ps_obj_table_ctx.old_table) {
+        return PSA_SUCCESS;
+    }
+
+    err = psa_its_remove(table_id);
+    if (err == PSA_SUCCESS) {
+        ps_obj_table_ctx.old_table = false;
+    }
+
+    return err;
+#else
     return psa_its_remove(table_id);
+#endif /* PS_OBJ_TABLE_JOURNAL */
 }
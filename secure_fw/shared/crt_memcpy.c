@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -7,24 +7,125 @@
 
 #include "crt_impl_private.h"
 
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+#include <arm_mve.h>
+
+void *memcpy(void *dest, const void *src, size_t n)
+{
+    uint8_t *p_dst = (uint8_t *)dest;
+    const uint8_t *p_src = (const uint8_t *)src;
+    mve_pred16_t pred;
+
+    /*
+     * Byte vectors have no alignment constraint and the predicate covers the
+     * tail. Each vector is loaded before it is stored, which keeps the forward
+     * copy used by memmove() correct.
+     */
+    while (n > 0) {
+        pred = vctp8q(n);
+        vstrbq_p_u8(p_dst, vldrbq_z_u8(p_src, pred), pred);
+
+        if (n <= 16) {
+            break;
+        }
+
+        p_dst += 16;
+        p_src += 16;
+        n -= 16;
+    }
+
+    return dest;
+}
+
+#else /* __ARM_FEATURE_MVE */
+
+/* Copy from a source which is not word aligned to an aligned destination */
+static size_t memcpy_merge(union composite_addr_t *p_dst,
+                           union composite_addr_t *p_src, size_t n)
+{
+    uint32_t shift = (p_src->uint_addr & 0x3) * 8;
+    const uint32_t *p_word = (const uint32_t *)(p_src->uint_addr & ~0x3UL);
+    uint32_t w0, w1, w2, w3, w4;
+
+    /* Only the words holding some bytes of the source are read */
+    w0 = *p_word++;
+
+    while (n >= CRT_BURST_BYTES) {
+        w1 = p_word[0];
+        w2 = p_word[1];
+        w3 = p_word[2];
+        w4 = p_word[3];
+        p_word += CRT_BURST_WORDS;
+
+        p_dst->p_word[0] = CRT_MERGE_WORDS(w0, w1, shift);
+        p_dst->p_word[1] = CRT_MERGE_WORDS(w1, w2, shift);
+        p_dst->p_word[2] = CRT_MERGE_WORDS(w2, w3, shift);
+        p_dst->p_word[3] = CRT_MERGE_WORDS(w3, w4, shift);
+        p_dst->p_word += CRT_BURST_WORDS;
+
+        w0 = w4;
+        n -= CRT_BURST_BYTES;
+    }
+
+    while (n >= sizeof(uint32_t)) {
+        w1 = *p_word++;
+        *(p_dst->p_word)++ = CRT_MERGE_WORDS(w0, w1, shift);
+        w0 = w1;
+        n -= sizeof(uint32_t);
+    }
+
+    /* The remaining bytes start in the last word read */
+    p_src->uint_addr = (uintptr_t)p_word - sizeof(uint32_t) + shift / 8;
+
+    return n;
+}
+
 void *memcpy(void *dest, const void *src, size_t n)
 {
     union composite_addr_t p_dst, p_src;
+    uint32_t w0, w1, w2, w3;
 
     p_dst.uint_addr = (uintptr_t)dest;
     p_src.uint_addr = (uintptr_t)src;
 
-    /* Byte copy for unaligned address. check the last bit of address. */
-    while (n && (ADDR_WORD_UNALIGNED(p_dst.uint_addr) ||
-                 ADDR_WORD_UNALIGNED(p_src.uint_addr))) {
+    /* Byte copy until the destination is aligned. */
+    while (n && ADDR_WORD_UNALIGNED(p_dst.uint_addr)) {
         *p_dst.p_byte++ = *p_src.p_byte++;
         n--;
     }
 
-    /* Quad byte copy for aligned address. */
-    while (n >= sizeof(uint32_t)) {
-        *(p_dst.p_word)++ = *(p_src.p_word)++;
-        n -= sizeof(uint32_t);
+    if (n < sizeof(uint32_t)) {
+        /* Too short for any word access */
+    } else if (ADDR_WORD_UNALIGNED(p_src.uint_addr)) {
+        /* Mutually misaligned, shift and merge the aligned source words. */
+        n = memcpy_merge(&p_dst, &p_src, n);
+    } else {
+        /*
+         * Burst copy for aligned addresses. All the words of a burst are
+         * loaded before any is stored, which keeps the forward copy used by
+         * memmove() correct.
+         */
+        while (n >= CRT_BURST_BYTES) {
+            w0 = p_src.p_word[0];
+            w1 = p_src.p_word[1];
+            w2 = p_src.p_word[2];
+            w3 = p_src.p_word[3];
+            p_src.p_word += CRT_BURST_WORDS;
+
+            p_dst.p_word[0] = w0;
+            p_dst.p_word[1] = w1;
+            p_dst.p_word[2] = w2;
+            p_dst.p_word[3] = w3;
+            p_dst.p_word += CRT_BURST_WORDS;
+
+            n -= CRT_BURST_BYTES;
+        }
+
+        /* Quad byte copy for the remaining words. */
+        while (n >= sizeof(uint32_t)) {
+            *(p_dst.p_word)++ = *(p_src.p_word)++;
+            n -= sizeof(uint32_t);
+        }
     }
 
     /* Byte copy for the remaining bytes. */
@@ -34,3 +135,5 @@ void *memcpy(void *dest, const void *src, size_t n)
 
     return dest;
 }
+
+#endif /* __ARM_FEATURE_MVE */
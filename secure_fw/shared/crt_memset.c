@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -7,20 +7,56 @@
 
 #include "crt_impl_private.h"
 
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+#include <arm_mve.h>
+
+void *memset(void *s, int c, size_t n)
+{
+    uint8_t *p_mem = (uint8_t *)s;
+    uint8x16_t pattern = vdupq_n_u8((uint8_t)c);
+    mve_pred16_t pred;
+
+    /* Byte vectors need no alignment and the predicate covers the tail */
+    while (n > 0) {
+        pred = vctp8q(n);
+        vstrbq_p_u8(p_mem, pattern, pred);
+
+        if (n <= 16) {
+            break;
+        }
+
+        p_mem += 16;
+        n -= 16;
+    }
+
+    return s;
+}
+
+#else /* __ARM_FEATURE_MVE */
+
 void *memset(void *s, int c, size_t n)
 {
     union composite_addr_t p_mem;
     uint32_t pattern_word;
 
     p_mem.p_byte = (uint8_t *)s;
-    pattern_word = (((uint32_t)c) << 24) | (((uint32_t)c) << 16) |
-                   (((uint32_t)c) << 8) | ((uint32_t)c);
+    pattern_word = (((uint32_t)c) & 0xFF) * 0x01010101UL;
 
     while (n && ADDR_WORD_UNALIGNED(p_mem.uint_addr)) {
         *p_mem.p_byte++ = (uint8_t)c;
         n--;
     }
 
+    /* Burst of words, stored by one STM */
+    while (n >= CRT_BURST_BYTES) {
+        p_mem.p_word[0] = pattern_word;
+        p_mem.p_word[1] = pattern_word;
+        p_mem.p_word[2] = pattern_word;
+        p_mem.p_word[3] = pattern_word;
+        p_mem.p_word += CRT_BURST_WORDS;
+        n -= CRT_BURST_BYTES;
+    }
+
     while (n >= sizeof(uint32_t)) {
         *p_mem.p_word++ = pattern_word;
         n -= sizeof(uint32_t);
@@ -32,3 +68,5 @@ void *memset(void *s, int c, size_t n)
 
     return s;
 }
+
+#endif /* __ARM_FEATURE_MVE */
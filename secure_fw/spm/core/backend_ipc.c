@@ -20,6 +20,7 @@
 #include "runtime_defs.h"
 #include "stack_watermark.h"
 #include "spm.h"
+#include "spm_trace.h"
 #include "tfm_hal_isolation.h"
 #include "tfm_hal_platform.h"
 #include "tfm_nspm.h"
@@ -212,6 +213,8 @@ psa_status_t backend_messaging(struct connection_t *p_connection)
     p_owner = p_connection->service->partition;
     signal = p_connection->service->p_ldinf->signal;
 
+    spm_trace_request(p_connection);
+
     UNI_LIST_INSERT_AFTER(p_owner, p_connection, p_reqs);
 
     /* Messages put. Update signals */
@@ -400,6 +403,7 @@ psa_signal_t backend_wait_signals(struct partition_t *p_pt, psa_signal_t signals
     ret = p_pt->signals_asserted & signals;
     if (ret == (psa_signal_t)0) {
         p_pt->signals_waiting = signals;
+        thrd_set_state(&p_pt->thrd, THRD_STATE_BLOCK);
     }
 
     CRITICAL_SECTION_LEAVE(cs_signal);
@@ -460,6 +464,7 @@ psa_status_t backend_assert_signal(struct partition_t *p_pt, psa_signal_t signal
 #endif
 
     if (p_pt->signals_asserted & p_pt->signals_waiting) {
+        thrd_set_state(&p_pt->thrd, THRD_STATE_RET_VAL_AVAIL);
         ret = STATUS_NEED_SCHEDULE;
     }
     CRITICAL_SECTION_LEAVE(cs_signal);
@@ -605,6 +610,8 @@ uint64_t ipc_schedule(uint32_t exc_return)
         AAPCS_DUAL_U32_SET_A1(ctx_ctrls, (uint32_t)pth_next->p_context_ctrl);
 
         CURRENT_THREAD = pth_next;
+
+        spm_trace_event(TFM_SPM_TRACE_EV_SCHEDULE, p_part_next->p_ldinf->pid);
     }
 
     /* Update meta indicator */
@@ -22,6 +22,7 @@
 #include "psa/error.h"
 #include "psa/service.h"
 #include "spm.h"
+#include "spm_trace.h"
 #include "memory_symbols.h"
 #include "private/assert.h"
 
@@ -53,6 +54,8 @@ psa_status_t backend_messaging(struct connection_t *p_connection)
     p_target = p_connection->service->partition;
     p_target->p_reqs = p_connection;
 
+    spm_trace_request(p_connection);
+
     SET_CURRENT_COMPONENT(p_target);
 
     if (p_target->state == SFN_PARTITION_STATE_NOT_INITED) {
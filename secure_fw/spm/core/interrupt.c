@@ -13,6 +13,7 @@
 #include "bitops.h"
 #include "current.h"
 #include "fih.h"
+#include "spm_trace.h"
 #include "svc_num.h"
 #include "tfm_arch.h"
 #include "tfm_hal_interrupt.h"
@@ -186,6 +187,8 @@ void spm_handle_interrupt(struct partition_t *p_pt,
         tfm_core_panic();
     }
 
+    spm_trace_event(TFM_SPM_TRACE_EV_IRQ_ENTER, p_ildi->source);
+
     if (p_ildi->flih_func == NULL) {
         /* SLIH Model Handling */
         tfm_hal_irq_disable(p_ildi->source);
@@ -209,6 +212,8 @@ void spm_handle_interrupt(struct partition_t *p_pt,
 #endif
     }
 
+    spm_trace_event(TFM_SPM_TRACE_EV_IRQ_EXIT, (uint32_t)flih_result);
+
     if (flih_result == PSA_FLIH_SIGNAL) {
         ret = backend_assert_signal(p_pt, p_ildi->signal);
         /* In SFN backend, there is only one thread, no thread switch. */
@@ -18,6 +18,7 @@
 #include "psa/lifecycle.h"
 #include "psa/service.h"
 #include "spm.h"
+#include "spm_trace.h"
 #include "tfm_arch.h"
 #include "load/partition_defs.h"
 #include "load/service_defs.h"
@@ -313,6 +314,8 @@ psa_status_t tfm_spm_partition_psa_reply(psa_handle_t msg_handle,
         }
     }
 
+    spm_trace_reply(handle, ret);
+
     /*
      * TODO: It can be optimized further by moving critical section protection
      * to mailbox. Also need to check implementation when secure context is
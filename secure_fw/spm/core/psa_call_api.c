@@ -12,7 +12,9 @@
 #include "critical_section.h"
 #include "ffm/backend.h"
 #include "ffm/psa_api.h"
+#include "spm_trace.h"
 #include "tfm_hal_isolation.h"
+#include "tfm_hal_platform.h"
 #include "tfm_psa_call_pack.h"
 #include "utilities.h"
 
@@ -39,6 +41,11 @@ psa_status_t spm_associate_call_params(struct connection_t *p_connection,
     p_connection->msg.type = type;
 
     if (!PARAM_HAS_IOVEC(ctrl_param)) {
+        /* A reused connection must not expose the vectors of a former call */
+        spm_memset(p_connection->msg.in_size, 0,
+                   sizeof(p_connection->msg.in_size));
+        spm_memset(p_connection->msg.out_size, 0,
+                   sizeof(p_connection->msg.out_size));
         return PSA_SUCCESS;
     }
 
@@ -65,7 +72,7 @@ psa_status_t spm_associate_call_params(struct connection_t *p_connection,
         return PSA_ERROR_PROGRAMMER_ERROR;
     }
 
-    spm_memset(ivecs_local, 0, sizeof(ivecs_local));
+    /* Only the first ivec_num entries of the local copies are ever read */
     spm_memcpy(ivecs_local, inptr, ivec_num * sizeof(psa_invec));
 
     /*
@@ -80,7 +87,6 @@ psa_status_t spm_associate_call_params(struct connection_t *p_connection,
         return PSA_ERROR_PROGRAMMER_ERROR;
     }
 
-    spm_memset(ovecs_local, 0, sizeof(ovecs_local));
     spm_memcpy(ovecs_local, outptr, ovec_num * sizeof(psa_outvec));
 
     /*
@@ -104,20 +110,25 @@ psa_status_t spm_associate_call_params(struct connection_t *p_connection,
         ns_access = TFM_HAL_ACCESS_NS;
     }
 
-    /* Make sure in_size and out_size arrays in the msg structure are cleared first */
-    spm_memset(p_connection->msg.in_size, 0, sizeof(p_connection->msg.in_size));
-    spm_memset(p_connection->msg.out_size, 0, sizeof(p_connection->msg.out_size));
-
     /*
      * For client input vector, it is a PROGRAMMER ERROR if the provided payload
-     * memory reference was invalid or not readable.
+     * memory reference was invalid or not readable. A zero-length vector is
+     * never accessed and its base is ignored, so it needs no check. The sizes
+     * of the unused vectors are cleared in the same pass.
      */
-    for (i = 0; i < ivec_num; i++) {
-        FIH_CALL(tfm_hal_memory_check, fih_rc,
-                 curr_partition->boundary, (uintptr_t)ivecs_local[i].base,
-                 ivecs_local[i].len, TFM_HAL_ACCESS_READABLE | ns_access);
-        if (fih_not_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
-            return PSA_ERROR_PROGRAMMER_ERROR;
+    for (i = 0; i < PSA_MAX_IOVEC; i++) {
+        if (i >= ivec_num) {
+            p_connection->msg.in_size[i] = 0;
+            continue;
+        }
+
+        if (ivecs_local[i].len != 0) {
+            FIH_CALL(tfm_hal_memory_check, fih_rc,
+                     curr_partition->boundary, (uintptr_t)ivecs_local[i].base,
+                     ivecs_local[i].len, TFM_HAL_ACCESS_READABLE | ns_access);
+            if (fih_not_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
+                return PSA_ERROR_PROGRAMMER_ERROR;
+            }
         }
 
         p_connection->msg.in_size[i]    = ivecs_local[i].len;
@@ -135,12 +146,19 @@ psa_status_t spm_associate_call_params(struct connection_t *p_connection,
      * For client output vector, it is a PROGRAMMER ERROR if the provided
      * payload memory reference was invalid or not read-write.
      */
-    for (i = 0; i < ovec_num; i++) {
-        FIH_CALL(tfm_hal_memory_check, fih_rc,
-                 curr_partition->boundary, (uintptr_t)ovecs_local[i].base,
-                 ovecs_local[i].len, TFM_HAL_ACCESS_READWRITE | ns_access);
-        if (fih_not_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
-            return PSA_ERROR_PROGRAMMER_ERROR;
+    for (i = 0; i < PSA_MAX_IOVEC; i++) {
+        if (i >= ovec_num) {
+            p_connection->msg.out_size[i] = 0;
+            continue;
+        }
+
+        if (ovecs_local[i].len != 0) {
+            FIH_CALL(tfm_hal_memory_check, fih_rc,
+                     curr_partition->boundary, (uintptr_t)ovecs_local[i].base,
+                     ovecs_local[i].len, TFM_HAL_ACCESS_READWRITE | ns_access);
+            if (fih_not_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
+                return PSA_ERROR_PROGRAMMER_ERROR;
+            }
         }
 
         p_connection->msg.out_size[i]   = ovecs_local[i].len;
@@ -162,6 +180,9 @@ psa_status_t tfm_spm_client_psa_call(psa_handle_t handle,
     int32_t client_id;
     bool ns_caller = tfm_spm_is_ns_caller();
     psa_status_t status;
+#ifdef CONFIG_TFM_SPM_TRACE
+    uint32_t trace_start;
+#endif
 
     client_id = tfm_spm_get_client_id(ns_caller);
 
@@ -170,7 +191,17 @@ psa_status_t tfm_spm_client_psa_call(psa_handle_t handle,
         return status;
     }
 
+#ifdef CONFIG_TFM_SPM_TRACE
+    trace_start = tfm_hal_spm_trace_timestamp();
+#endif
+
     status = spm_associate_call_params(p_connection, ctrl_param, inptr, outptr);
+
+#ifdef CONFIG_TFM_SPM_TRACE
+    spm_trace_event(TFM_SPM_TRACE_EV_IOVEC_CHECK,
+                    tfm_hal_spm_trace_timestamp() - trace_start);
+#endif
+
     if (status != PSA_SUCCESS) {
         if (IS_STATIC_HANDLE(handle)) {
             spm_free_connection(p_connection);
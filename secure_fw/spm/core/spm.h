@@ -100,6 +100,9 @@ struct connection_t {
     struct connection_t *p_replied;          /* Replied Handle(s) link         */
     uintptr_t replied_value;                 /* Result of this operation       */
 #endif
+#ifdef CONFIG_TFM_SPM_TRACE
+    uint32_t trace_start;                    /* Timestamp of the request       */
+#endif
 };
 
 /* Partition runtime type */
@@ -126,6 +129,9 @@ struct service_t {
     const struct service_load_info_t *p_ldinf;     /* Service load info      */
     struct partition_t *partition;                 /* Owner of the service   */
     struct service_t *next;                        /* For list operation     */
+#ifdef CONFIG_TFM_SPM_TRACE
+    uint32_t trace_idx;                            /* Latency histogram index */
+#endif
 };
 
 /**
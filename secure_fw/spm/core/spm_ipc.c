@@ -27,6 +27,7 @@
 #include "tfm_hal_interrupt.h"
 #include "tfm_hal_isolation.h"
 #include "spm.h"
+#include "spm_trace.h"
 #include "tfm_peripherals_def.h"
 #include "tfm_nspm.h"
 #include "tfm_core_trustzone.h"
@@ -46,6 +47,20 @@
 static struct service_head_t services_listhead;
 struct service_t *stateless_services_ref_tbl[STATIC_HANDLE_NUM_LIMIT];
 
+/*
+ * Services sorted by SID and partitions sorted by ID, filled once all the
+ * partitions are loaded. The sizes come from the manifest tool.
+ */
+#if CONFIG_TFM_SERVICE_NUM > 0
+static struct service_t *services_by_sid[CONFIG_TFM_SERVICE_NUM];
+#endif
+static uint32_t nservices_by_sid;
+
+#if CONFIG_TFM_DOORBELL_API == 1
+static struct partition_t *partitions_by_id[CONFIG_TFM_PARTITION_NUM];
+static uint32_t npartitions_by_id;
+#endif
+
 /* Partition management functions */
 
 /* This API is only used in IPC backend. */
@@ -112,14 +127,25 @@ struct connection_t *spm_get_handle_by_signal(struct partition_t *p_ptn,
 
 const struct service_t *tfm_spm_get_service_by_sid(uint32_t sid)
 {
-    struct service_t *p_prev, *p_curr;
-
-    UNI_LIST_FOREACH_NODE_PREV(p_prev, p_curr, &services_listhead, next) {
-        if (p_curr->p_ldinf->sid == sid) {
-            UNI_LIST_MOVE_AFTER(&services_listhead, p_prev, p_curr, next);
-            return p_curr;
+#if CONFIG_TFM_SERVICE_NUM > 0
+    uint32_t lo = 0, hi = nservices_by_sid, mid;
+    uint32_t mid_sid;
+
+    /* The table is read only once SPM is initialised */
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        mid_sid = services_by_sid[mid]->p_ldinf->sid;
+        if (mid_sid == sid) {
+            return services_by_sid[mid];
+        } else if (mid_sid < sid) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
     }
+#else
+    (void)sid;
+#endif
 
     return NULL;
 }
@@ -136,11 +162,18 @@ const struct service_t *tfm_spm_get_service_by_sid(uint32_t sid)
  */
 struct partition_t *tfm_spm_get_partition_by_id(int32_t partition_id)
 {
-    struct partition_t *p_part;
-
-    UNI_LIST_FOREACH(p_part, PARTITION_LIST_ADDR, next) {
-        if (p_part->p_ldinf->pid == partition_id) {
-            return p_part;
+    uint32_t lo = 0, hi = npartitions_by_id, mid;
+    int32_t mid_pid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        mid_pid = partitions_by_id[mid]->p_ldinf->pid;
+        if (mid_pid == partition_id) {
+            return partitions_by_id[mid];
+        } else if (mid_pid < partition_id) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
     }
 
@@ -394,6 +427,66 @@ int32_t tfm_spm_get_client_id(bool ns_caller)
     return client_id;
 }
 
+/*
+ * Fill the sorted lookup tables from the loaded partitions and services.
+ * Insertion sort is fine as this runs once with a handful of entries.
+ */
+static void spm_build_lookup_tables(void)
+{
+    struct service_t *p_serv;
+    uint32_t i;
+#if CONFIG_TFM_DOORBELL_API == 1
+    struct partition_t *p_part;
+
+    npartitions_by_id = 0;
+    UNI_LIST_FOREACH(p_part, PARTITION_LIST_ADDR, next) {
+        if (npartitions_by_id >= CONFIG_TFM_PARTITION_NUM) {
+            tfm_core_panic();
+        }
+
+        for (i = npartitions_by_id;
+             (i > 0) && (partitions_by_id[i - 1]->p_ldinf->pid >
+                         p_part->p_ldinf->pid);
+             i--) {
+            partitions_by_id[i] = partitions_by_id[i - 1];
+        }
+        partitions_by_id[i] = p_part;
+        npartitions_by_id++;
+    }
+#endif
+
+    nservices_by_sid = 0;
+    UNI_LIST_FOREACH(p_serv, &services_listhead, next) {
+#if CONFIG_TFM_SERVICE_NUM > 0
+        if (nservices_by_sid >= CONFIG_TFM_SERVICE_NUM) {
+            tfm_core_panic();
+        }
+
+        for (i = nservices_by_sid;
+             (i > 0) && (services_by_sid[i - 1]->p_ldinf->sid >=
+                         p_serv->p_ldinf->sid);
+             i--) {
+            /* SIDs are unique */
+            if (services_by_sid[i - 1]->p_ldinf->sid == p_serv->p_ldinf->sid) {
+                tfm_core_panic();
+            }
+            services_by_sid[i] = services_by_sid[i - 1];
+        }
+        services_by_sid[i] = p_serv;
+        nservices_by_sid++;
+#else
+        (void)i;
+        tfm_core_panic();
+#endif
+    }
+
+#if CONFIG_TFM_SERVICE_NUM > 0
+    spm_trace_init(services_by_sid, nservices_by_sid);
+#else
+    spm_trace_init(NULL, 0);
+#endif
+}
+
 uint32_t tfm_spm_init(void)
 {
     struct partition_t *partition;
@@ -432,6 +525,8 @@ uint32_t tfm_spm_init(void)
         backend_init_comp_assuredly(partition, service_setting);
     }
 
+    spm_build_lookup_tables();
+
 #if CONFIG_TFM_POST_PARTITION_INIT_HOOK == 1
     /*
      * Platform can use CONFIG_TFM_POST_PARTITION_INIT_HOOK option to add extra initialization
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config_spm.h"
+#include "critical_section.h"
+#include "current.h"
+#include "fih.h"
+#include "log_deferred_defs.h"
+#include "psa/error.h"
+#include "spm.h"
+#include "spm_log_deferred.h"
+#include "tfm_hal_isolation.h"
+#include "tfm_hal_spm_logdev.h"
+#include "tfm_spm_log.h"
+#include "utilities.h"
+#include "load/partition_defs.h"
+
+#define LOG_BUF_WORDS           (CONFIG_TFM_SPM_LOG_DEFERRED_BUF_SIZE / \
+                                 sizeof(uint32_t))
+#define LOG_BUF_MASK            (LOG_BUF_WORDS - 1)
+
+/*
+ * Words output by one drain call. It bounds the time spent in the handler, as
+ * the 32 bytes output by one partition log SVC.
+ */
+#define LOG_DRAIN_CHUNK_WORDS   8
+
+/*
+ * Ring buffer of the records, indexed by free running word indices. Records
+ * are written whole inside a critical section, from any context. The drain
+ * only moves the tail, after the words are output.
+ */
+static uint32_t log_buf[LOG_BUF_WORDS];
+static volatile uint32_t log_head;
+static volatile uint32_t log_tail;
+/* Records dropped since the last stored record */
+static uint32_t log_dropped;
+
+static bool log_put(uint32_t hdr, uint32_t fmt,
+                    const uint32_t *args, uint32_t nargs)
+{
+    uint32_t head = log_head;
+    uint32_t i;
+
+    if ((LOG_BUF_WORDS - (head - log_tail)) < (nargs + 2)) {
+        return false;
+    }
+
+    log_buf[head++ & LOG_BUF_MASK] = hdr;
+    log_buf[head++ & LOG_BUF_MASK] = fmt;
+    for (i = 0; i < nargs; i++) {
+        log_buf[head++ & LOG_BUF_MASK] = args[i];
+    }
+
+    log_head = head;
+
+    return true;
+}
+
+/* Tell the decoder how many records were lost since the last stored one */
+static void log_put_dropped(void)
+{
+    if ((log_dropped != 0) &&
+        log_put(LOG_DEFERRED_HDR(LOG_DEFERRED_SOURCE_SPM, 1), 0,
+                &log_dropped, 1)) {
+        log_dropped = 0;
+    }
+}
+
+static void log_record(uint32_t source, uint32_t fmt,
+                       const uint32_t *args, uint32_t nargs)
+{
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+
+    if (nargs > LOG_DEFERRED_MAX_ARGS) {
+        nargs = LOG_DEFERRED_MAX_ARGS;
+    }
+
+    CRITICAL_SECTION_ENTER(cs);
+
+    log_put_dropped();
+
+    if ((log_dropped != 0) ||
+        !log_put(LOG_DEFERRED_HDR(source, nargs), fmt, args, nargs)) {
+        log_dropped++;
+    }
+
+    CRITICAL_SECTION_LEAVE(cs);
+}
+
+/* Output up to 'max_words' words, returns the words still in the buffer */
+static uint32_t log_drain(uint32_t max_words)
+{
+    uint32_t tail = log_tail;
+    uint32_t idx = tail & LOG_BUF_MASK;
+    uint32_t words = log_head - tail;
+
+    /* Only the part before the end of the buffer, the rest comes next time */
+    if (words > (LOG_BUF_WORDS - idx)) {
+        words = LOG_BUF_WORDS - idx;
+    }
+    if (words > max_words) {
+        words = max_words;
+    }
+
+    if (words != 0) {
+        (void)tfm_hal_output_spm_log((const char *)&log_buf[idx],
+                                     words * sizeof(uint32_t));
+        log_tail = tail + words;
+    }
+
+    return log_head - log_tail;
+}
+
+int32_t spm_log_deferred_msgval(const char *msg, uint32_t value, bool has_val)
+{
+    log_record(LOG_DEFERRED_SOURCE_SPM, (uint32_t)(uintptr_t)msg, &value,
+               has_val ? 1 : 0);
+
+    return 0;
+}
+
+void tfm_spm_log_deferred_record_handler(uint32_t args[])
+{
+    uint32_t fmt = args[0];
+    const uint32_t *fmt_args = (const uint32_t *)(uintptr_t)args[1];
+    uint32_t nargs = args[2];
+    const struct partition_t *curr_partition = GET_CURRENT_COMPONENT();
+    fih_int fih_rc = FIH_FAILURE;
+
+    if (nargs > LOG_DEFERRED_MAX_ARGS) {
+        nargs = LOG_DEFERRED_MAX_ARGS;
+    }
+
+    /*
+     * Only the arguments are read by SPM. The format string is recorded by
+     * its address and never accessed.
+     */
+    if (nargs != 0) {
+        FIH_CALL(tfm_hal_memory_check, fih_rc,
+                 curr_partition->boundary, (uintptr_t)fmt_args,
+                 nargs * sizeof(uint32_t), TFM_HAL_ACCESS_READABLE);
+        if (fih_not_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
+            tfm_core_panic();
+        }
+    }
+
+    log_record(curr_partition->p_ldinf->pid, fmt, fmt_args, nargs);
+
+    args[0] = 0;
+}
+
+void tfm_spm_log_deferred_drain_handler(uint32_t args[])
+{
+    const struct partition_t *curr_partition = GET_CURRENT_COMPONENT();
+
+    if (curr_partition->p_ldinf->pid != TFM_SP_IDLE) {
+        args[0] = 0;
+        return;
+    }
+
+    args[0] = log_drain(LOG_DRAIN_CHUNK_WORDS) * sizeof(uint32_t);
+}
+
+void spm_log_deferred_flush(void)
+{
+    while (log_drain(LOG_BUF_WORDS) != 0) {
+    }
+
+    /* The records lost after the last stored one */
+    if (log_dropped != 0) {
+        log_put_dropped();
+        (void)log_drain(LOG_BUF_WORDS);
+    }
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __SPM_LOG_DEFERRED_H__
+#define __SPM_LOG_DEFERRED_H__
+
+#include <stdint.h>
+
+#ifdef CONFIG_TFM_SPM_LOG_DEFERRED
+
+/**
+ * \brief SVC handler storing a deferred log record of the caller partition.
+ *
+ * \param[in,out] args  args[0]: format string address, args[1]: the arguments,
+ *                      args[2]: the number of arguments.
+ *                      args[0] returns 0.
+ */
+void tfm_spm_log_deferred_record_handler(uint32_t args[]);
+
+/**
+ * \brief SVC handler outputting a bounded part of the deferred log. Only the
+ *        idle partition is allowed.
+ *
+ * \param[in,out] args  args[0] returns the bytes still to output.
+ */
+void tfm_spm_log_deferred_drain_handler(uint32_t args[]);
+
+/**
+ * \brief Output the whole deferred log, before a reset or a halt.
+ */
+void spm_log_deferred_flush(void);
+
+#endif /* CONFIG_TFM_SPM_LOG_DEFERRED */
+
+#endif /* __SPM_LOG_DEFERRED_H__ */
@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "cmsis_compiler.h"
+#include "config_impl.h"
+#include "config_spm.h"
+#include "critical_section.h"
+#include "fih.h"
+#include "psa/error.h"
+#include "psa_manifest/pid.h"
+#include "spm.h"
+#include "spm_trace.h"
+#include "tfm_arch.h"
+#include "tfm_hal_isolation.h"
+#include "tfm_hal_platform.h"
+#include "utilities.h"
+#include "load/service_defs.h"
+
+#define TRACE_EVENT_MASK        (CONFIG_TFM_SPM_TRACE_EVENT_NUM - 1)
+
+/* Ring buffer of the events, indexed by the sequence number of the event */
+static struct tfm_spm_trace_event_t trace_events[CONFIG_TFM_SPM_TRACE_EVENT_NUM];
+/* Sequence number of the latest recorded event, 0 if none */
+static uint32_t trace_last_seq;
+
+#if CONFIG_TFM_SERVICE_NUM > 0
+static struct tfm_spm_trace_hist_t trace_hists[CONFIG_TFM_SERVICE_NUM];
+#endif
+static uint32_t trace_hist_num;
+
+/*
+ * Default trace timer, the DWT cycle counter when the core implements it.
+ * Platforms without one, or with a better timer, override these functions.
+ */
+__WEAK void tfm_hal_spm_trace_timer_init(void)
+{
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+#if defined(DCB_DEMCR_TRCENA_Msk)
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+#elif defined(CoreDebug_DEMCR_TRCENA_Msk)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#endif
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+__WEAK uint32_t tfm_hal_spm_trace_timestamp(void)
+{
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+    return DWT->CYCCNT;
+#else
+    return 0;
+#endif
+}
+
+void spm_trace_init(struct service_t *const services[], uint32_t num)
+{
+    uint32_t i;
+
+    tfm_hal_spm_trace_timer_init();
+
+    trace_last_seq = 0;
+    spm_memset(trace_events, 0, sizeof(trace_events));
+
+#if CONFIG_TFM_SERVICE_NUM > 0
+    if (num > CONFIG_TFM_SERVICE_NUM) {
+        tfm_core_panic();
+    }
+
+    spm_memset(trace_hists, 0, sizeof(trace_hists));
+    for (i = 0; i < num; i++) {
+        services[i]->trace_idx = i;
+        trace_hists[i].sid = services[i]->p_ldinf->sid;
+    }
+#else
+    (void)services;
+    (void)i;
+    num = 0;
+#endif
+
+    trace_hist_num = num;
+}
+
+void spm_trace_event(uint32_t event, uint32_t arg)
+{
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+    struct tfm_spm_trace_event_t *p_ev;
+
+    /*
+     * Events come from Thread mode, SVC, PendSV and interrupt handlers. The
+     * entry is written within a critical section so a reader never sees a
+     * half written one; this is a few stores and does not add jitter.
+     */
+    CRITICAL_SECTION_ENTER(cs);
+    trace_last_seq++;
+    p_ev = &trace_events[trace_last_seq & TRACE_EVENT_MASK];
+    p_ev->seq       = trace_last_seq;
+    p_ev->timestamp = tfm_hal_spm_trace_timestamp();
+    p_ev->event     = event;
+    p_ev->arg       = arg;
+    CRITICAL_SECTION_LEAVE(cs);
+}
+
+void spm_trace_request(struct connection_t *p_connection)
+{
+    p_connection->trace_start = tfm_hal_spm_trace_timestamp();
+    spm_trace_event(TFM_SPM_TRACE_EV_CALL, p_connection->service->p_ldinf->sid);
+}
+
+void spm_trace_reply(struct connection_t *p_connection, int32_t status)
+{
+#if CONFIG_TFM_SERVICE_NUM > 0
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+    struct tfm_spm_trace_hist_t *p_hist;
+    uint32_t latency, bucket;
+
+    latency = tfm_hal_spm_trace_timestamp() - p_connection->trace_start;
+
+    /* Logarithmic buckets, clamped at both ends */
+    bucket = (latency == 0) ? 0 : (31 - __CLZ(latency));
+    if (bucket < TFM_SPM_TRACE_HIST_BASE_LOG2) {
+        bucket = 0;
+    } else {
+        bucket -= TFM_SPM_TRACE_HIST_BASE_LOG2;
+    }
+    if (bucket >= TFM_SPM_TRACE_HIST_BUCKETS) {
+        bucket = TFM_SPM_TRACE_HIST_BUCKETS - 1;
+    }
+
+    if (p_connection->service->trace_idx < trace_hist_num) {
+        p_hist = &trace_hists[p_connection->service->trace_idx];
+
+        CRITICAL_SECTION_ENTER(cs);
+        p_hist->count++;
+        p_hist->buckets[bucket]++;
+        if (latency > p_hist->max) {
+            p_hist->max = latency;
+        }
+        CRITICAL_SECTION_LEAVE(cs);
+    }
+#endif
+
+    spm_trace_event(TFM_SPM_TRACE_EV_REPLY, (uint32_t)status);
+}
+
+/* Trace data reveals the timing of all services, only Platform may read it */
+static bool trace_access_allowed(const struct partition_t *p_pt)
+{
+#ifdef TFM_PARTITION_PLATFORM
+    return p_pt->p_ldinf->pid == TFM_SP_PLATFORM;
+#else
+    (void)p_pt;
+    return false;
+#endif
+}
+
+/* Copy the events from sequence number 'seq' on. Returns the bytes copied. */
+static uint32_t copy_events(uint32_t seq, uint8_t *buf, uint32_t len)
+{
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+    const struct tfm_spm_trace_event_t *p_ev;
+    uint32_t copied = 0;
+    bool done = false;
+
+    while (!done && ((len - copied) >= sizeof(*p_ev))) {
+        /* One entry per critical section to keep the interrupt latency low */
+        CRITICAL_SECTION_ENTER(cs);
+
+        /* Skip the events that have been overwritten */
+        if ((trace_last_seq >= CONFIG_TFM_SPM_TRACE_EVENT_NUM) &&
+            (seq <= trace_last_seq - CONFIG_TFM_SPM_TRACE_EVENT_NUM)) {
+            seq = trace_last_seq - CONFIG_TFM_SPM_TRACE_EVENT_NUM + 1;
+        }
+        if (seq == 0) {
+            seq = 1;
+        }
+
+        if (seq > trace_last_seq) {
+            done = true;
+        } else {
+            p_ev = &trace_events[seq & TRACE_EVENT_MASK];
+            spm_memcpy(buf + copied, p_ev, sizeof(*p_ev));
+            copied += sizeof(*p_ev);
+            seq++;
+        }
+
+        CRITICAL_SECTION_LEAVE(cs);
+    }
+
+    return copied;
+}
+
+/* Copy the histograms from index 'idx' on. Returns the bytes copied. */
+static uint32_t copy_hists(uint32_t idx, uint8_t *buf, uint32_t len)
+{
+    uint32_t copied = 0;
+#if CONFIG_TFM_SERVICE_NUM > 0
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+
+    for (; (idx < trace_hist_num) &&
+           ((len - copied) >= sizeof(struct tfm_spm_trace_hist_t)); idx++) {
+        CRITICAL_SECTION_ENTER(cs);
+        spm_memcpy(buf + copied, &trace_hists[idx], sizeof(trace_hists[idx]));
+        CRITICAL_SECTION_LEAVE(cs);
+        copied += sizeof(struct tfm_spm_trace_hist_t);
+    }
+#else
+    (void)idx;
+    (void)buf;
+    (void)len;
+#endif
+
+    return copied;
+}
+
+void tfm_spm_trace_get_data_handler(uint32_t args[])
+{
+    uint32_t type  = args[0];
+    uint32_t start = args[1];
+    uint8_t *buf   = (uint8_t *)args[2];
+    uint32_t len   = args[3];
+    const struct partition_t *curr_partition = GET_CURRENT_COMPONENT();
+    fih_int fih_rc = FIH_FAILURE;
+
+    /* Requests from other partitions are programmer errors */
+    if (!trace_access_allowed(curr_partition)) {
+        tfm_core_panic();
+    }
+
+    FIH_CALL(tfm_hal_memory_check, fih_rc,
+             curr_partition->boundary, (uintptr_t)buf,
+             len, TFM_HAL_ACCESS_READWRITE);
+    if (fih_not_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
+        tfm_core_panic();
+    }
+
+    switch (type) {
+    case TFM_SPM_TRACE_TYPE_EVENTS:
+        args[0] = copy_events(start, buf, len);
+        break;
+    case TFM_SPM_TRACE_TYPE_HISTOGRAMS:
+        args[0] = copy_hists(start, buf, len);
+        break;
+    default:
+        tfm_core_panic();
+        break;
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __SPM_TRACE_H__
+#define __SPM_TRACE_H__
+
+#include <stdint.h>
+#include "spm.h"
+#include "tfm_spm_trace_defs.h"
+
+#ifdef CONFIG_TFM_SPM_TRACE
+/**
+ * \brief Initialize the trace buffers and assign a latency histogram to each
+ *        of the given services.
+ *
+ * \param[in] services  Array of the loaded services.
+ * \param[in] num       Number of services in the array.
+ */
+void spm_trace_init(struct service_t *const services[], uint32_t num);
+
+/**
+ * \brief Record an event in the trace ring buffer. It can be called from
+ *        Thread or Handler mode. When the buffer is full the oldest event is
+ *        overwritten.
+ *
+ * \param[in] event     One of TFM_SPM_TRACE_EV_*.
+ * \param[in] arg       Event specific argument.
+ */
+void spm_trace_event(uint32_t event, uint32_t arg);
+
+/**
+ * \brief Record that a request is delivered to the service of the connection.
+ *
+ * \param[in] p_connection  The connection that carries the request.
+ */
+void spm_trace_request(struct connection_t *p_connection);
+
+/**
+ * \brief Record that the request of the connection is replied and account its
+ *        latency in the histogram of the service.
+ *
+ * \param[in] p_connection  The connection that carries the request.
+ * \param[in] status        The status replied to the client.
+ */
+void spm_trace_reply(struct connection_t *p_connection, int32_t status);
+
+/**
+ * \brief SVC handler to copy trace data into a buffer of the caller. Only
+ *        the Platform partition is allowed to read the data.
+ *
+ * \param[in,out] args  args[0]: type of the data, TFM_SPM_TRACE_TYPE_*.
+ *                      args[1]: first event sequence number or histogram
+ *                               index to copy.
+ *                      args[2]: address of the buffer.
+ *                      args[3]: size of the buffer.
+ *                      On return, args[0] holds the number of bytes copied.
+ *                      An unknown type, an inaccessible buffer or a caller
+ *                      other than Platform panics.
+ */
+void tfm_spm_trace_get_data_handler(uint32_t args[]);
+#else
+#define spm_trace_init(services, num)
+#define spm_trace_event(event, arg)
+#define spm_trace_request(p_connection)
+#define spm_trace_reply(p_connection, status)
+#endif
+
+#endif /* __SPM_TRACE_H__ */
@@ -44,12 +44,16 @@
  *                        Returns the number messages that have been processed.
  *                        If the platform does not use support for Hybrid
  *                        Platform, then this handler must be set to NULL.
+ * flush_replies()      - OPTIONAL: Called after a batch of reply() calls, so
+ *                        that NSPE can be notified once for the whole batch.
+ *                        Set to NULL if reply() notifies NSPE by itself.
  */
 struct tfm_rpc_ops_t {
     void (*handle_req)(void);
     void (*reply)(const void *owner, int32_t ret);
     void (*handle_req_irq_src)(uint32_t irq_src);
     int32_t (*process_new_msg)(uint32_t *nr_msg);
+    void (*flush_replies)(void);
 };
 
 /**
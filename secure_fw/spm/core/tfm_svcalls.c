@@ -16,6 +16,8 @@
 #include "svc_num.h"
 #include "tfm_arch.h"
 #include "tfm_svcalls.h"
+#include "spm_trace.h"
+#include "spm_log_deferred.h"
 #include "tfm_boot_data.h"
 #include "tfm_hal_platform.h"
 #include "tfm_hal_isolation.h"
@@ -210,6 +212,19 @@ static uint32_t handle_spm_svc_requests(uint32_t svc_number, uint32_t exc_return
     case TFM_SVC_GET_BOOT_DATA:
         tfm_core_get_boot_data_handler(svc_args);
         break;
+#ifdef CONFIG_TFM_SPM_TRACE
+    case TFM_SVC_GET_SPM_TRACE:
+        tfm_spm_trace_get_data_handler(svc_args);
+        break;
+#endif
+#ifdef CONFIG_TFM_SPM_LOG_DEFERRED
+    case TFM_SVC_LOG_DEFERRED_RECORD:
+        tfm_spm_log_deferred_record_handler(svc_args);
+        break;
+    case TFM_SVC_LOG_DEFERRED_DRAIN:
+        tfm_spm_log_deferred_drain_handler(svc_args);
+        break;
+#endif
 #if (TFM_ISOLATION_LEVEL != 1) && (CONFIG_TFM_FLIH_API == 1)
     case TFM_SVC_PREPARE_DEPRIV_FLIH:
         exc_return = tfm_flih_prepare_depriv_flih((struct partition_t *)svc_args[0],
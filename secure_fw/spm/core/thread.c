@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited. All rights reserved.
  * Copyright (c) 2023 Cypress Semiconductor Corporation (an Infineon
  * company) or an affiliate of Cypress Semiconductor Corporation. All rights
  * reserved.
@@ -9,6 +9,7 @@
  */
 
 #include <stdint.h>
+#include "config_spm.h"
 #include "thread.h"
 #include "tfm_arch.h"
 #include "utilities.h"
@@ -20,11 +21,22 @@ struct thread_t *p_curr_thrd;
 
 /* Force ZERO in case ZI(bss) clear is missing. */
 static struct thread_t *p_thrd_head = NULL; /* Point to the first thread. */
-static struct thread_t *p_rnbl_head = NULL; /* Point to the first runnable. */
+
+/*
+ * Runnable threads, one bit per thread indexed by its rank in the priority
+ * sorted list. Rank 'r' is bit (31 - r % 32) of word (r / 32), so counting
+ * the leading zeros of the first non-zero word gives the highest priority
+ * runnable thread.
+ */
+#define RNBL_WORDS  ((CONFIG_TFM_SPM_MAX_THREADS + 31) / 32)
+static uint32_t rnbl_bitmap[RNBL_WORDS];
+static struct thread_t *rank_to_thrd[CONFIG_TFM_SPM_MAX_THREADS];
 
 /* Define Macro to fetch global to support future expansion (PERCPU e.g.) */
 #define LIST_HEAD   p_thrd_head
-#define RNBL_HEAD   p_rnbl_head
+
+#define RNBL_WORD(rank)     ((rank) / 32)
+#define RNBL_BIT(rank)      (1UL << (31 - ((rank) % 32)))
 
 /* Callback function pointer for thread to query current state. */
 static thrd_query_state_t query_state_cb = (thrd_query_state_t)NULL;
@@ -34,19 +46,33 @@ void thrd_set_query_callback(thrd_query_state_t fn)
     query_state_cb = fn;
 }
 
+/* Get the highest priority thread marked as runnable, NULL if none. */
+static struct thread_t *highest_runnable(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < RNBL_WORDS; i++) {
+        if (rnbl_bitmap[i] != 0) {
+            return rank_to_thrd[i * 32 + __CLZ(rnbl_bitmap[i])];
+        }
+    }
+
+    return NULL;
+}
+
 struct thread_t *thrd_next(void)
 {
-    struct thread_t *p_thrd = RNBL_HEAD;
+    struct thread_t *p_thrd;
     uint32_t retval = 0;
     struct critical_section_t cs_signal = CRITICAL_SECTION_STATIC_INIT;
 
     CRITICAL_SECTION_ENTER(cs_signal);
     /*
-     * First runnable thread has highest priority since threads are
-     * sorted by priority.
+     * Threads are marked runnable when they are started and when a signal
+     * they wait for is asserted, and unmarked when they block. Only the
+     * picked thread needs its state refreshed, to collect its return value.
      */
-    while (p_thrd) {
-        /* Change thread state if any signal changed */
+    while ((p_thrd = highest_runnable()) != NULL) {
         p_thrd->state = query_state_cb(p_thrd, &retval);
 
         if (p_thrd->state == THRD_STATE_RET_VAL_AVAIL) {
@@ -58,13 +84,43 @@ struct thread_t *thrd_next(void)
             break;
         }
 
-        p_thrd = p_thrd->next;
+        /* Stale mark, the awaited signals were consumed in between */
+        thrd_set_state(p_thrd, p_thrd->state);
     }
     CRITICAL_SECTION_LEAVE(cs_signal);
 
     return p_thrd;
 }
 
+/*
+ * Number the threads in priority order and rebuild the runnable bitmap from
+ * their states. Threads are all started before the scheduler, so this only
+ * runs at initialisation.
+ */
+static void rank_threads(void)
+{
+    struct thread_t *p_thrd;
+    uint32_t rank = 0;
+    uint32_t i;
+
+    for (i = 0; i < RNBL_WORDS; i++) {
+        rnbl_bitmap[i] = 0;
+    }
+
+    for (p_thrd = LIST_HEAD; p_thrd != NULL; p_thrd = p_thrd->next) {
+        if (rank >= CONFIG_TFM_SPM_MAX_THREADS) {
+            tfm_core_panic();
+        }
+
+        p_thrd->rank = rank;
+        rank_to_thrd[rank] = p_thrd;
+        if (p_thrd->state == THRD_STATE_RUNNABLE) {
+            rnbl_bitmap[RNBL_WORD(rank)] |= RNBL_BIT(rank);
+        }
+        rank++;
+    }
+}
+
 static void insert_by_prior(struct thread_t **head, struct thread_t *node)
 {
     if ((*head == NULL) || (node->priority <= (*head)->priority)) {
@@ -89,6 +145,7 @@ void thrd_start(struct thread_t *p_thrd, thrd_fn_t fn, thrd_fn_t exit_fn, void *
 
     /* Insert a new thread with priority */
     insert_by_prior(&LIST_HEAD, p_thrd);
+    rank_threads();
 
     tfm_arch_init_context(p_thrd->p_context_ctrl, (uintptr_t)fn, param,
                           (uintptr_t)exit_fn);
@@ -103,15 +160,11 @@ void thrd_set_state(struct thread_t *p_thrd, uint32_t new_state)
 
     p_thrd->state = new_state;
 
-    /*
-     * Set first runnable thread as head to reduce enumerate
-     * depth while searching for a first runnable thread.
-     */
-    if ((p_thrd->state == THRD_STATE_RUNNABLE) &&
-        ((RNBL_HEAD == NULL) || (p_thrd->priority < RNBL_HEAD->priority))) {
-        RNBL_HEAD = p_thrd;
+    if ((new_state == THRD_STATE_RUNNABLE) ||
+        (new_state == THRD_STATE_RET_VAL_AVAIL)) {
+        rnbl_bitmap[RNBL_WORD(p_thrd->rank)] |= RNBL_BIT(p_thrd->rank);
     } else {
-        RNBL_HEAD = LIST_HEAD;
+        rnbl_bitmap[RNBL_WORD(p_thrd->rank)] &= ~RNBL_BIT(p_thrd->rank);
     }
 }
 
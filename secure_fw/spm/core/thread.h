@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited. All rights reserved.
  * Copyright (c) 2023 Cypress Semiconductor Corporation (an Infineon
  * company) or an affiliate of Cypress Semiconductor Corporation. All rights
  * reserved.
@@ -48,6 +48,7 @@ struct thread_t {
     uint16_t               flags;             /* Flags and align, DO NOT REMOVE!   */
     struct context_ctrl_t *p_context_ctrl;    /* Context control (sp, splimit, lr) */
     struct thread_t       *next;              /* Next thread in list               */
+    uint32_t               rank;              /* Position in priority order        */
 };
 
 /* Query thread state function type */
@@ -106,11 +107,15 @@ extern struct thread_t *p_curr_thrd;
 void thrd_set_query_callback(thrd_query_state_t fn);
 
 /*
- * Set thread state, and updates the runnable head.
+ * Set thread state, and mark the thread as runnable or not for the next
+ * scheduling decision.
  *
  * Parameters :
  *  p_thrd         -     Pointer of thread_t struct
  *  new_state      -     New state of thread
+ *
+ * Note :
+ *  The caller needs to be in a critical section once the scheduler runs.
  */
 void thrd_set_state(struct thread_t *p_thrd, uint32_t new_state);
 
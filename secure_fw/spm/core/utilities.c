@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited. All rights reserved.
  * Copyright (c) 2024 Cypress Semiconductor Corporation (an Infineon
  * company) or an affiliate of Cypress Semiconductor Corporation. All rights
  * reserved.
@@ -12,6 +12,7 @@
 #include "fih.h"
 #include "utilities.h"
 #include "tfm_hal_platform.h"
+#include "spm_log_deferred.h"
 
 #ifdef CONFIG_TFM_BACKTRACE_ON_CORE_PANIC
 #include "tfm_log.h"
@@ -22,6 +23,11 @@ void tfm_core_panic(void)
 {
     (void)fih_delay();
 
+#ifdef CONFIG_TFM_SPM_LOG_DEFERRED
+    /* Output the records stored so far, the last ones may tell the cause */
+    spm_log_deferred_flush();
+#endif
+
 #ifdef CONFIG_TFM_BACKTRACE_ON_CORE_PANIC
     tfm_dump_backtrace(__func__, tfm_log);
 #endif
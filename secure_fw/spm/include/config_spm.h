@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -32,4 +32,17 @@
 #error "Invalid config: CONFIG_TFM_SPM_BACKEND_SFN AND CONFIG_TFM_DOORBELL_API!"
 #endif
 
+#if defined(CONFIG_TFM_SPM_TRACE) && \
+    ((CONFIG_TFM_SPM_TRACE_EVENT_NUM == 0) || \
+     ((CONFIG_TFM_SPM_TRACE_EVENT_NUM & (CONFIG_TFM_SPM_TRACE_EVENT_NUM - 1)) != 0))
+#error "Invalid config: CONFIG_TFM_SPM_TRACE_EVENT_NUM must be a power of two!"
+#endif
+
+#if defined(CONFIG_TFM_SPM_LOG_DEFERRED) && \
+    ((CONFIG_TFM_SPM_LOG_DEFERRED_BUF_SIZE < 64) || \
+     ((CONFIG_TFM_SPM_LOG_DEFERRED_BUF_SIZE & \
+       (CONFIG_TFM_SPM_LOG_DEFERRED_BUF_SIZE - 1)) != 0))
+#error "Invalid config: CONFIG_TFM_SPM_LOG_DEFERRED_BUF_SIZE must be a power of two, at least 64!"
+#endif
+
 #endif /* __CONFIG_PARTITION_SPM_H__ */
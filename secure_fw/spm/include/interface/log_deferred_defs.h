@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __LOG_DEFERRED_DEFS_H__
+#define __LOG_DEFERRED_DEFS_H__
+
+/*
+ * Deferred log record, output as little-endian 32-bit words:
+ *
+ *   word 0: header, LOG_DEFERRED_HDR()
+ *   word 1: address of the format string in the secure image, 0 for the
+ *           record of dropped records
+ *   word 2..: the arguments
+ *
+ * The source is 0 for SPM, and the partition ID for the partitions. SPM
+ * records have the message and optionally a value output as hexadecimal.
+ * Partition records have a printf() format with its arguments, as 32-bit
+ * words. String arguments are recorded by their address.
+ *
+ * tools/tfm_log_decode.py parses this stream, keep them aligned.
+ */
+#define LOG_DEFERRED_SYNC                   0xA5U
+#define LOG_DEFERRED_MAX_ARGS               8U
+
+#define LOG_DEFERRED_HDR(source, nargs)     ((LOG_DEFERRED_SYNC << 24) | \
+                                             (((nargs) & 0xFFU) << 16) | \
+                                             ((source) & 0xFFFFU))
+
+#define LOG_DEFERRED_SOURCE_SPM             0U
+
+#endif /* __LOG_DEFERRED_DEFS_H__ */
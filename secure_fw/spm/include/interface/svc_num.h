@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -73,6 +73,9 @@
 #define TFM_SVC_OUTPUT_UNPRIV_STRING    TFM_SVC_NUM_SPM_THREAD(2)
 #define TFM_SVC_GET_BOOT_DATA           TFM_SVC_NUM_SPM_THREAD(3)
 #define TFM_SVC_THREAD_MODE_SPM_RETURN  TFM_SVC_NUM_SPM_THREAD(4)
+#define TFM_SVC_GET_SPM_TRACE           TFM_SVC_NUM_SPM_THREAD(5)
+#define TFM_SVC_LOG_DEFERRED_RECORD     TFM_SVC_NUM_SPM_THREAD(6)
+#define TFM_SVC_LOG_DEFERRED_DRAIN      TFM_SVC_NUM_SPM_THREAD(7)
 
 /* TF-M SPM and for Handler mode */
 #define TFM_SVC_PREPARE_DEPRIV_FLIH     TFM_SVC_NUM_SPM_HANDLER(0)
@@ -15,7 +15,7 @@
             do {                                        \
                 if (!(cond)) {                          \
                     SPMLOG_INFMSG("Assert:");           \
-                    SPMLOG_INFMSG(__func__);            \
+                    SPMLOG_INFMSG(__FILE__);            \
                     SPMLOG_INFMSGVAL(",", __LINE__);    \
                     while (1) {                         \
                         ;                               \
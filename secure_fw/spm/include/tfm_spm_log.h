@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -8,6 +8,7 @@
 #ifndef __TFM_SPM_LOG_H__
 #define __TFM_SPM_LOG_H__
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include "tfm_hal_defs.h"
@@ -34,25 +35,46 @@
 #error "Incorrect TFM_SPM_LOG_LEVEL value!"
 #endif
 
+/*
+ * The messages must be string literals. With deferred logging, a message is
+ * stored as a binary record holding the address of the message and the value.
+ * The text is restored from the image by the host. The concatenation with an
+ * empty string fails to build for a message which is not a literal, and so
+ * would not be found in the image.
+ */
+#define SPM_LOG_LITERAL(msg) ("" msg)
+
+#ifdef CONFIG_TFM_SPM_LOG_DEFERRED
+#define SPM_LOG_MSGVAL(msg, val) \
+    spm_log_deferred_msgval(SPM_LOG_LITERAL(msg), val, true)
+#define SPM_LOG_MSG(msg) \
+    spm_log_deferred_msgval(SPM_LOG_LITERAL(msg), 0, false)
+#else
+#define SPM_LOG_MSGVAL(msg, val) \
+    spm_log_msgval(SPM_LOG_LITERAL(msg), sizeof(msg), val)
+#define SPM_LOG_MSG(msg) \
+    tfm_hal_output_spm_log(SPM_LOG_LITERAL(msg), sizeof(msg))
+#endif
+
 #if (TFM_SPM_LOG_LEVEL == TFM_SPM_LOG_LEVEL_DEBUG)
-#define SPMLOG_DBGMSGVAL(msg, val) spm_log_msgval(msg, sizeof(msg), val)
-#define SPMLOG_DBGMSG(msg) tfm_hal_output_spm_log(msg, sizeof(msg))
+#define SPMLOG_DBGMSGVAL(msg, val) SPM_LOG_MSGVAL(msg, val)
+#define SPMLOG_DBGMSG(msg) SPM_LOG_MSG(msg)
 #else
 #define SPMLOG_DBGMSGVAL(msg, val) (void)(val)
 #define SPMLOG_DBGMSG(msg)
 #endif
 
 #if (TFM_SPM_LOG_LEVEL >= TFM_SPM_LOG_LEVEL_INFO)
-#define SPMLOG_INFMSGVAL(msg, val) spm_log_msgval(msg, sizeof(msg), val)
-#define SPMLOG_INFMSG(msg) tfm_hal_output_spm_log(msg, sizeof(msg))
+#define SPMLOG_INFMSGVAL(msg, val) SPM_LOG_MSGVAL(msg, val)
+#define SPMLOG_INFMSG(msg) SPM_LOG_MSG(msg)
 #else
 #define SPMLOG_INFMSGVAL(msg, val) (void)(val)
 #define SPMLOG_INFMSG(msg)
 #endif
 
 #if (TFM_SPM_LOG_LEVEL >= TFM_SPM_LOG_LEVEL_ERROR)
-#define SPMLOG_ERRMSGVAL(msg, val) spm_log_msgval(msg, sizeof(msg), val)
-#define SPMLOG_ERRMSG(msg) tfm_hal_output_spm_log(msg, sizeof(msg))
+#define SPMLOG_ERRMSGVAL(msg, val) SPM_LOG_MSGVAL(msg, val)
+#define SPMLOG_ERRMSG(msg) SPM_LOG_MSG(msg)
 #else
 #define SPMLOG_ERRMSGVAL(msg, val) (void)(val)
 #define SPMLOG_ERRMSG(msg)
@@ -71,4 +93,17 @@
  */
 int32_t spm_log_msgval(const char *msg, size_t len, uint32_t value);
 
+#ifdef CONFIG_TFM_SPM_LOG_DEFERRED
+/**
+ * \brief Store a deferred log record of SPM.
+ *
+ * \param[in]  msg      A string literal, recorded by its address
+ * \param[in]  value    A value output with the message
+ * \param[in]  has_val  Whether the value is recorded
+ *
+ * \retval 0            Always, for compatibility with the direct output.
+ */
+int32_t spm_log_deferred_msgval(const char *msg, uint32_t value, bool has_val);
+#endif
+
 #endif /* __TFM_SPM_LOG_H__ */
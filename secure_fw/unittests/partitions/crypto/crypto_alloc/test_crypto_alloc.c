@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "config_tfm.h"
+#include "tfm_crypto_api.h"
+
+#define NUM_OWNERS  (6)
+#define NUM_STEPS   (20000)
+
+static int32_t caller_id;
+
+psa_status_t tfm_crypto_get_caller_id(int32_t *id)
+{
+    *id = caller_id;
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t alloc(int32_t owner, enum tfm_crypto_operation_type type,
+                          uint32_t *handle)
+{
+    void *ctx;
+
+    caller_id = owner;
+
+    return tfm_crypto_operation_alloc(type, handle, &ctx);
+}
+
+static psa_status_t release(int32_t owner, uint32_t *handle)
+{
+    caller_id = owner;
+
+    return tfm_crypto_operation_release(handle);
+}
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, tfm_crypto_init_alloc());
+}
+
+void test_crypto_alloc_lookup_and_stale_handle(void)
+{
+    uint32_t handle = 0;
+    uint32_t stale;
+    void *ctx;
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      alloc(-1, TFM_CRYPTO_CIPHER_OPERATION, &handle));
+    stale = handle;
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      tfm_crypto_operation_lookup(TFM_CRYPTO_CIPHER_OPERATION,
+                                                  handle, &ctx));
+    TEST_ASSERT_EQUAL(PSA_ERROR_BAD_STATE,
+                      tfm_crypto_operation_lookup(TFM_CRYPTO_MAC_OPERATION,
+                                                  handle, &ctx));
+
+    /* Another owner can neither use nor release the context */
+    caller_id = -2;
+    TEST_ASSERT_EQUAL(PSA_ERROR_BAD_STATE,
+                      tfm_crypto_operation_lookup(TFM_CRYPTO_CIPHER_OPERATION,
+                                                  handle, &ctx));
+    TEST_ASSERT_EQUAL(PSA_ERROR_INVALID_ARGUMENT, release(-2, &stale));
+
+    stale = handle;
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, release(-1, &handle));
+    TEST_ASSERT_EQUAL(0, handle);
+
+    /* The slot is reused, but the old handle does not refer to it any more */
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      alloc(-1, TFM_CRYPTO_CIPHER_OPERATION, &handle));
+    TEST_ASSERT_NOT_EQUAL(stale, handle);
+    caller_id = -1;
+    TEST_ASSERT_EQUAL(PSA_ERROR_BAD_STATE,
+                      tfm_crypto_operation_lookup(TFM_CRYPTO_CIPHER_OPERATION,
+                                                  stale, &ctx));
+    TEST_ASSERT_EQUAL(PSA_ERROR_INVALID_ARGUMENT, release(-1, &stale));
+}
+
+void test_crypto_alloc_owner_quota(void)
+{
+    uint32_t handles[3] = {0};
+    uint32_t other = 0;
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      alloc(-1, TFM_CRYPTO_CIPHER_OPERATION, &handles[0]));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      alloc(-1, TFM_CRYPTO_MAC_OPERATION, &handles[1]));
+    TEST_ASSERT_EQUAL(PSA_ERROR_NOT_PERMITTED,
+                      alloc(-1, TFM_CRYPTO_AEAD_OPERATION, &handles[2]));
+
+    /* The quota is per owner */
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      alloc(-2, TFM_CRYPTO_CIPHER_OPERATION, &other));
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, release(-1, &handles[0]));
+    handles[2] = 0;
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      alloc(-1, TFM_CRYPTO_AEAD_OPERATION, &handles[2]));
+}
+
+void test_crypto_alloc_dedicated_pool(void)
+{
+    uint32_t hash[3] = {0};
+    uint32_t cipher = 0;
+
+    /* The hash contexts come from their own pool of 2 */
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      alloc(-1, TFM_CRYPTO_HASH_OPERATION, &hash[0]));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      alloc(-2, TFM_CRYPTO_HASH_OPERATION, &hash[1]));
+    TEST_ASSERT_EQUAL(PSA_ERROR_NOT_PERMITTED,
+                      alloc(-3, TFM_CRYPTO_HASH_OPERATION, &hash[2]));
+
+    /* The shared pool is still available to other types */
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      alloc(-3, TFM_CRYPTO_CIPHER_OPERATION, &cipher));
+}
+
+/* Allocates and releases contexts in a random order, for several owners, and
+ * checks the results against the expected pool and quota limits.
+ */
+void test_crypto_alloc_random_owners(void)
+{
+    uint32_t handles[NUM_OWNERS][CRYPTO_CONC_OPER_PER_OWNER + 1];
+    uint32_t held[NUM_OWNERS] = {0};
+    uint32_t total = 0;
+    uint32_t rand_state = 1;
+    uint32_t step, owner, k;
+    psa_status_t status;
+
+    memset(handles, 0, sizeof(handles));
+
+    for (step = 0; step < NUM_STEPS; step++) {
+        rand_state = (rand_state * 1103515245u) + 12345u;
+        owner = (rand_state >> 16) % NUM_OWNERS;
+
+        if (((rand_state >> 8) & 1) != 0) {
+            k = held[owner];
+            if (k == CRYPTO_CONC_OPER_PER_OWNER + 1) {
+                continue;
+            }
+
+            status = alloc(-1 - (int32_t)owner, TFM_CRYPTO_CIPHER_OPERATION,
+                           &handles[owner][k]);
+            if ((total < CRYPTO_CONC_OPER_NUM) &&
+                (held[owner] < CRYPTO_CONC_OPER_PER_OWNER)) {
+                TEST_ASSERT_EQUAL(PSA_SUCCESS, status);
+                held[owner]++;
+                total++;
+            } else {
+                TEST_ASSERT_EQUAL(PSA_ERROR_NOT_PERMITTED, status);
+                handles[owner][k] = 0;
+            }
+        } else if (held[owner] != 0) {
+            /* Release the oldest context of the owner, not the newest */
+            TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                              release(-1 - (int32_t)owner,
+                                      &handles[owner][0]));
+            memmove(&handles[owner][0], &handles[owner][1],
+                    (held[owner] - 1) * sizeof(handles[owner][0]));
+            held[owner]--;
+            handles[owner][held[owner]] = 0;
+            total--;
+        }
+    }
+}
+
+void test_crypto_alloc_usage(void)
+{
+    uint32_t hash[2] = {0};
+    uint32_t cipher = 0;
+    uint32_t in_use, high_water;
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      alloc(-1, TFM_CRYPTO_HASH_OPERATION, &hash[0]));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      alloc(-2, TFM_CRYPTO_HASH_OPERATION, &hash[1]));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, release(-1, &hash[0]));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      alloc(-1, TFM_CRYPTO_CIPHER_OPERATION, &cipher));
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      tfm_crypto_operation_usage(TFM_CRYPTO_HASH_OPERATION,
+                                                 &in_use, &high_water));
+    TEST_ASSERT_EQUAL(1, in_use);
+    TEST_ASSERT_EQUAL(2, high_water);
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      tfm_crypto_operation_usage(TFM_CRYPTO_CIPHER_OPERATION,
+                                                 &in_use, &high_water));
+    TEST_ASSERT_EQUAL(1, in_use);
+    TEST_ASSERT_EQUAL(1, high_water);
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      tfm_crypto_operation_usage(TFM_CRYPTO_MAC_OPERATION,
+                                                 &in_use, &high_water));
+    TEST_ASSERT_EQUAL(0, in_use);
+    TEST_ASSERT_EQUAL(0, high_water);
+
+    TEST_ASSERT_EQUAL(PSA_ERROR_INVALID_ARGUMENT,
+                      tfm_crypto_operation_usage(TFM_CRYPTO_OPERATION_NONE,
+                                                 &in_use, &high_water));
+    TEST_ASSERT_EQUAL(PSA_ERROR_INVALID_ARGUMENT,
+                      tfm_crypto_operation_usage(TFM_CRYPTO_HASH_OPERATION,
+                                                 NULL, &high_water));
+}
@@ -0,0 +1,57 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2024, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+set(CRYPTO_DIR ${TFM_ROOT_DIR}/secure_fw/partitions/crypto)
+
+#-------------------------------------------------------------------------------
+# Unit under test
+#-------------------------------------------------------------------------------
+set(UNIT_UNDER_TEST ${CRYPTO_DIR}/crypto_alloc.c)
+
+#-------------------------------------------------------------------------------
+# Test suite
+#-------------------------------------------------------------------------------
+set(UNIT_TEST_SUITE ${CMAKE_CURRENT_LIST_DIR}/test_crypto_alloc.c)
+
+#-------------------------------------------------------------------------------
+# Dependencies
+#-------------------------------------------------------------------------------
+
+#-------------------------------------------------------------------------------
+# Include dirs
+#-------------------------------------------------------------------------------
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${CRYPTO_DIR})
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/secure_fw/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/secure_fw/spm/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/secure_fw/partitions/lib/runtime/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/config)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/interface/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/lib/ext/mbedcrypto/mbedcrypto_config)
+
+#-------------------------------------------------------------------------------
+# Compiledefs for UUT
+#-------------------------------------------------------------------------------
+list(APPEND UNIT_TEST_COMPILE_DEFS TFM_PARTITION_LOG_LEVEL=0)
+list(APPEND UNIT_TEST_COMPILE_DEFS PLATFORM_DEFAULT_CRYPTO_KEYS)
+list(APPEND UNIT_TEST_COMPILE_DEFS MBEDTLS_CONFIG_FILE="tfm_mbedcrypto_config_client.h")
+list(APPEND UNIT_TEST_COMPILE_DEFS MBEDTLS_PSA_CRYPTO_CONFIG_FILE="crypto_config_default.h")
+list(APPEND UNIT_TEST_COMPILE_DEFS CRYPTO_CONC_OPER_NUM=4)
+list(APPEND UNIT_TEST_COMPILE_DEFS CRYPTO_CONC_OPER_NUM_HASH=2)
+list(APPEND UNIT_TEST_COMPILE_DEFS CRYPTO_CONC_OPER_PER_OWNER=2)
+
+#-------------------------------------------------------------------------------
+# Link libs for UUT
+#-------------------------------------------------------------------------------
+
+#-------------------------------------------------------------------------------
+# Mocks for UUT
+#-------------------------------------------------------------------------------
+
+#-------------------------------------------------------------------------------
+# Labels for UT (Optional, tests can be grouped by labels)
+#-------------------------------------------------------------------------------
+list(APPEND UT_LABELS "CRYPTO")
@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __PSA_MANIFEST_PID_H__
+#define __PSA_MANIFEST_PID_H__
+
+/* Partition IDs of the secure partitions used by the unit tests */
+#define TFM_SP_PS               (256)
+#define TFM_SP_ITS              (257)
+#define TFM_SP_CRYPTO           (259)
+
+#endif /* __PSA_MANIFEST_PID_H__ */
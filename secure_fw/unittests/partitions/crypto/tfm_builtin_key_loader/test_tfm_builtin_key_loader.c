@@ -0,0 +1,523 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include "unity.h"
+
+#include "crypto_library.h"
+#include "tfm_builtin_key_loader.h"
+#include "tfm_mbedcrypto_include.h"
+#include "tfm_plat_crypto_keys.h"
+#include "tfm_plat_otp.h"
+
+#define TEST_KEY_ID_HUK     (0x7FFF815B)
+#define HUK_LEN             (32)
+#define SHA256_LEN          (32)
+#define SHA256_BLOCK_LEN    (64)
+#define KEY_ID_IMPORTED     (1)
+#define KEY_ID_DERIVED      (2)
+#define BENCH_ITERATIONS    (20000)
+
+static const uint8_t huk[HUK_LEN] = {
+    0x6b, 0x1a, 0x8f, 0x32, 0x45, 0xd0, 0x9c, 0x7e,
+    0x11, 0x28, 0x3f, 0x56, 0x6d, 0x84, 0x9b, 0xb2,
+    0xc9, 0xe0, 0xf7, 0x0e, 0x25, 0x3c, 0x53, 0x6a,
+    0x81, 0x98, 0xaf, 0xc6, 0xdd, 0xf4, 0x0b, 0x22,
+};
+
+static uint32_t lcs;
+static uint32_t derivations;
+
+/*
+ * Reference SHA-256, HMAC and HKDF, so that the stubbed PSA Crypto layer
+ * below costs as much as a software key derivation.
+ */
+struct sha256_ctx {
+    uint32_t h[8];
+    uint8_t block[SHA256_BLOCK_LEN];
+    size_t block_len;
+    uint64_t total_len;
+};
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha256_block(struct sha256_ctx *ctx)
+{
+    uint32_t w[64];
+    uint32_t v[8];
+    uint32_t t1, t2;
+    size_t i;
+
+    for (i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)ctx->block[4 * i] << 24) |
+               ((uint32_t)ctx->block[4 * i + 1] << 16) |
+               ((uint32_t)ctx->block[4 * i + 2] << 8) |
+               (uint32_t)ctx->block[4 * i + 3];
+    }
+    for (i = 16; i < 64; i++) {
+        w[i] = w[i - 16] + w[i - 7] +
+               (ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3)) +
+               (ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10));
+    }
+
+    memcpy(v, ctx->h, sizeof(v));
+    for (i = 0; i < 64; i++) {
+        t1 = v[7] + (ROTR(v[4], 6) ^ ROTR(v[4], 11) ^ ROTR(v[4], 25)) +
+             ((v[4] & v[5]) ^ (~v[4] & v[6])) + sha256_k[i] + w[i];
+        t2 = (ROTR(v[0], 2) ^ ROTR(v[0], 13) ^ ROTR(v[0], 22)) +
+             ((v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]));
+        memmove(&v[1], &v[0], 7 * sizeof(v[0]));
+        v[4] += t1;
+        v[0] = t1 + t2;
+    }
+    for (i = 0; i < 8; i++) {
+        ctx->h[i] += v[i];
+    }
+}
+
+static void sha256_init(struct sha256_ctx *ctx)
+{
+    static const uint32_t h0[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+
+    memcpy(ctx->h, h0, sizeof(h0));
+    ctx->block_len = 0;
+    ctx->total_len = 0;
+}
+
+static void sha256_update(struct sha256_ctx *ctx, const uint8_t *data,
+                          size_t len)
+{
+    ctx->total_len += len;
+    while (len-- != 0) {
+        ctx->block[ctx->block_len++] = *data++;
+        if (ctx->block_len == SHA256_BLOCK_LEN) {
+            sha256_block(ctx);
+            ctx->block_len = 0;
+        }
+    }
+}
+
+static void sha256_finish(struct sha256_ctx *ctx, uint8_t *out)
+{
+    uint64_t bits = ctx->total_len * 8;
+    uint8_t pad = 0x80;
+    size_t i;
+
+    sha256_update(ctx, &pad, 1);
+    pad = 0;
+    while (ctx->block_len != SHA256_BLOCK_LEN - 8) {
+        sha256_update(ctx, &pad, 1);
+    }
+    for (i = 0; i < 8; i++) {
+        ctx->block[SHA256_BLOCK_LEN - 1 - i] = (uint8_t)(bits >> (8 * i));
+    }
+    sha256_block(ctx);
+
+    for (i = 0; i < 8; i++) {
+        out[4 * i] = (uint8_t)(ctx->h[i] >> 24);
+        out[4 * i + 1] = (uint8_t)(ctx->h[i] >> 16);
+        out[4 * i + 2] = (uint8_t)(ctx->h[i] >> 8);
+        out[4 * i + 3] = (uint8_t)ctx->h[i];
+    }
+}
+
+/* The key must not be longer than a block */
+static void hmac_sha256(const uint8_t *key, size_t key_len,
+                        const uint8_t *data1, size_t len1,
+                        const uint8_t *data2, size_t len2,
+                        uint8_t *out)
+{
+    struct sha256_ctx ctx;
+    uint8_t pad[SHA256_BLOCK_LEN];
+    uint8_t inner[SHA256_LEN];
+    size_t i;
+
+    memset(pad, 0, sizeof(pad));
+    memcpy(pad, key, key_len);
+    for (i = 0; i < sizeof(pad); i++) {
+        pad[i] ^= 0x36;
+    }
+    sha256_init(&ctx);
+    sha256_update(&ctx, pad, sizeof(pad));
+    sha256_update(&ctx, data1, len1);
+    sha256_update(&ctx, data2, len2);
+    sha256_finish(&ctx, inner);
+
+    for (i = 0; i < sizeof(pad); i++) {
+        pad[i] ^= 0x36 ^ 0x5c;
+    }
+    sha256_init(&ctx);
+    sha256_update(&ctx, pad, sizeof(pad));
+    sha256_update(&ctx, inner, sizeof(inner));
+    sha256_finish(&ctx, out);
+}
+
+/* HKDF-SHA256 without salt, and an info shorter than a block */
+static void hkdf_sha256(const uint8_t *secret, size_t secret_len,
+                        const uint8_t *info, size_t info_len,
+                        uint8_t *out, size_t out_len)
+{
+    static const uint8_t salt[SHA256_LEN];
+    uint8_t prk[SHA256_LEN];
+    uint8_t t[SHA256_LEN + SHA256_BLOCK_LEN + 1];
+    size_t t_len = 0;
+    size_t len;
+    uint8_t counter = 1;
+
+    hmac_sha256(salt, sizeof(salt), secret, secret_len, NULL, 0, prk);
+
+    while (out_len != 0) {
+        memcpy(&t[t_len], info, info_len);
+        t[t_len + info_len] = counter++;
+        hmac_sha256(prk, sizeof(prk), t, t_len + info_len + 1, NULL, 0, t);
+        t_len = SHA256_LEN;
+
+        len = (out_len < SHA256_LEN) ? out_len : SHA256_LEN;
+        memcpy(out, t, len);
+        out += len;
+        out_len -= len;
+    }
+}
+
+/* PSA Crypto core, with a single imported and a single derived key */
+static uint8_t imported_key[HUK_LEN];
+static size_t imported_key_len;
+static uint8_t info[sizeof(int32_t)];
+static uint8_t derived_key[TFM_BUILTIN_MAX_KEY_LEN];
+static size_t derived_key_len;
+
+psa_status_t psa_import_key(const psa_key_attributes_t *attributes,
+                            const uint8_t *data, size_t data_length,
+                            mbedtls_svc_key_id_t *key)
+{
+    (void)attributes;
+
+    memcpy(imported_key, data, data_length);
+    imported_key_len = data_length;
+    *key = mbedtls_svc_key_id_make(0, KEY_ID_IMPORTED);
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_key_derivation_setup(psa_key_derivation_operation_t *operation,
+                                      psa_algorithm_t alg)
+{
+    (void)operation;
+
+    TEST_ASSERT_EQUAL(PSA_ALG_HKDF(PSA_ALG_SHA_256), alg);
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_key_derivation_input_key(
+    psa_key_derivation_operation_t *operation,
+    psa_key_derivation_step_t step,
+    mbedtls_svc_key_id_t key)
+{
+    (void)operation;
+
+    TEST_ASSERT_EQUAL(PSA_KEY_DERIVATION_INPUT_SECRET, step);
+    TEST_ASSERT_EQUAL(KEY_ID_IMPORTED, MBEDTLS_SVC_KEY_ID_GET_KEY_ID(key));
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_key_derivation_input_bytes(
+    psa_key_derivation_operation_t *operation,
+    psa_key_derivation_step_t step,
+    const uint8_t *data,
+    size_t data_length)
+{
+    (void)operation;
+
+    TEST_ASSERT_EQUAL(PSA_KEY_DERIVATION_INPUT_INFO, step);
+    TEST_ASSERT_EQUAL(sizeof(info), data_length);
+    memcpy(info, data, data_length);
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_key_derivation_output_key(
+    const psa_key_attributes_t *attributes,
+    psa_key_derivation_operation_t *operation,
+    mbedtls_svc_key_id_t *key)
+{
+    (void)operation;
+
+    derived_key_len = PSA_BITS_TO_BYTES(psa_get_key_bits(attributes));
+    hkdf_sha256(imported_key, imported_key_len, info, sizeof(info),
+                derived_key, derived_key_len);
+    derivations++;
+    *key = mbedtls_svc_key_id_make(0, KEY_ID_DERIVED);
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_export_key(mbedtls_svc_key_id_t key, uint8_t *data,
+                            size_t data_size, size_t *data_length)
+{
+    TEST_ASSERT_EQUAL(KEY_ID_DERIVED, MBEDTLS_SVC_KEY_ID_GET_KEY_ID(key));
+    TEST_ASSERT_EQUAL(derived_key_len, data_size);
+
+    memcpy(data, derived_key, derived_key_len);
+    *data_length = derived_key_len;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_key_derivation_abort(psa_key_derivation_operation_t *operation)
+{
+    (void)operation;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_destroy_key(mbedtls_svc_key_id_t key)
+{
+    (void)key;
+
+    return PSA_SUCCESS;
+}
+
+tfm_crypto_library_key_id_t tfm_crypto_library_key_id_init(int32_t owner,
+                                                           psa_key_id_t key_id)
+{
+    return mbedtls_svc_key_id_make(owner, key_id);
+}
+
+/* Platform */
+enum tfm_plat_err_t tfm_plat_otp_read(enum tfm_otp_element_id_t id,
+                                      size_t out_len, uint8_t *out)
+{
+    TEST_ASSERT_EQUAL(PLAT_OTP_ID_LCS, id);
+    TEST_ASSERT_EQUAL(sizeof(lcs), out_len);
+
+    memcpy(out, &lcs, sizeof(lcs));
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
+
+static enum tfm_plat_err_t load_huk(const void *ctx, uint8_t *buf,
+                                    size_t buf_len, size_t *key_len,
+                                    psa_key_bits_t *key_bits,
+                                    psa_algorithm_t *algorithm,
+                                    psa_key_type_t *type)
+{
+    (void)ctx;
+    (void)buf_len;
+
+    memcpy(buf, huk, sizeof(huk));
+    *key_len = sizeof(huk);
+    *key_bits = PSA_BYTES_TO_BITS(sizeof(huk));
+    *algorithm = PSA_ALG_HKDF(PSA_ALG_SHA_256);
+    *type = PSA_KEY_TYPE_DERIVE;
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
+
+static const tfm_plat_builtin_key_descriptor_t desc_table[] = {
+    {
+        .key_id = TEST_KEY_ID_HUK,
+        .slot_number = TFM_BUILTIN_KEY_SLOT_HUK,
+        .lifetime = TFM_BUILTIN_KEY_LOADER_LIFETIME,
+        .loader_key_func = load_huk,
+        .loader_key_ctx = NULL,
+    },
+};
+
+static const tfm_plat_builtin_key_policy_t policy_table[] = {
+    {
+        .key_id = TEST_KEY_ID_HUK,
+        .per_user_policy = 0,
+        .usage = PSA_KEY_USAGE_DERIVE,
+    },
+};
+
+size_t tfm_plat_builtin_key_get_desc_table_ptr(
+    const tfm_plat_builtin_key_descriptor_t *desc_ptr[])
+{
+    *desc_ptr = desc_table;
+
+    return sizeof(desc_table) / sizeof(desc_table[0]);
+}
+
+size_t tfm_plat_builtin_key_get_policy_table_ptr(
+    const tfm_plat_builtin_key_policy_t *desc_ptr[])
+{
+    *desc_ptr = policy_table;
+
+    return sizeof(policy_table) / sizeof(policy_table[0]);
+}
+
+/* Gets the key the user derives from the HUK, and checks its value */
+static void get_huk(int32_t user, size_t len)
+{
+    psa_key_attributes_t attr = PSA_KEY_ATTRIBUTES_INIT;
+    uint8_t key[TFM_BUILTIN_MAX_KEY_LEN];
+    uint8_t expected[TFM_BUILTIN_MAX_KEY_LEN];
+    size_t key_len;
+
+    psa_set_key_id(&attr, mbedtls_svc_key_id_make(user, TEST_KEY_ID_HUK));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      tfm_builtin_key_loader_get_builtin_key(
+                          TFM_BUILTIN_KEY_SLOT_HUK, &attr, key, len,
+                          &key_len));
+    TEST_ASSERT_EQUAL(len, key_len);
+
+    hkdf_sha256(huk, sizeof(huk), (const uint8_t *)&user, sizeof(user),
+                expected, len);
+    TEST_ASSERT_EQUAL_MEMORY(expected, key, len);
+}
+
+void setUp(void)
+{
+    lcs = PLAT_OTP_LCS_SECURED;
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, tfm_builtin_key_loader_init());
+    derivations = 0;
+}
+
+void test_tfm_builtin_key_loader_reference_hkdf(void)
+{
+    /* RFC 5869 test case 3 */
+    static const uint8_t okm[42] = {
+        0x8d, 0xa4, 0xe7, 0x75, 0xa5, 0x63, 0xc1, 0x8f, 0x71, 0x5f, 0x80,
+        0x2a, 0x06, 0x3c, 0x5a, 0x31, 0xb8, 0xa1, 0x1f, 0x5c, 0x5e, 0xe1,
+        0x87, 0x9e, 0xc3, 0x45, 0x4e, 0x5f, 0x3c, 0x73, 0x8d, 0x2d, 0x9d,
+        0x20, 0x13, 0x95, 0xfa, 0xa4, 0xb6, 0x1a, 0x96, 0xc8,
+    };
+    uint8_t ikm[22];
+    uint8_t out[sizeof(okm)];
+
+    memset(ikm, 0x0b, sizeof(ikm));
+    hkdf_sha256(ikm, sizeof(ikm), NULL, 0, out, sizeof(out));
+    TEST_ASSERT_EQUAL_MEMORY(okm, out, sizeof(okm));
+}
+
+void test_tfm_builtin_key_loader_derived_cache_hit(void)
+{
+    get_huk(1, 32);
+    get_huk(1, 32);
+    TEST_ASSERT_EQUAL(1, derivations);
+
+    /* The length is part of the entry */
+    get_huk(1, 48);
+    TEST_ASSERT_EQUAL(2, derivations);
+    get_huk(1, 32);
+    get_huk(1, 48);
+    TEST_ASSERT_EQUAL(2, derivations);
+}
+
+void test_tfm_builtin_key_loader_derived_cache_lru(void)
+{
+    get_huk(1, 32);
+    get_huk(2, 32);
+    get_huk(1, 32);
+    TEST_ASSERT_EQUAL(2, derivations);
+
+    /* The key of user 2 is the least recently used one */
+    get_huk(3, 32);
+    TEST_ASSERT_EQUAL(3, derivations);
+    get_huk(1, 32);
+    TEST_ASSERT_EQUAL(3, derivations);
+    get_huk(2, 32);
+    TEST_ASSERT_EQUAL(4, derivations);
+}
+
+void test_tfm_builtin_key_loader_derived_cache_lcs(void)
+{
+    get_huk(1, 32);
+
+    /* The keys derived in another lifecycle state are not used */
+    lcs = PLAT_OTP_LCS_DECOMMISSIONED;
+    get_huk(1, 32);
+    get_huk(1, 32);
+    TEST_ASSERT_EQUAL(2, derivations);
+
+    /* Nothing is cached when the lifecycle state is not known */
+    lcs = PLAT_OTP_LCS_UNKNOWN;
+    get_huk(1, 32);
+    get_huk(1, 32);
+    TEST_ASSERT_EQUAL(4, derivations);
+
+    /* Loading the builtin keys again erases the cache */
+    lcs = PLAT_OTP_LCS_SECURED;
+    get_huk(1, 32);
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, tfm_builtin_key_loader_init());
+    get_huk(1, 32);
+    TEST_ASSERT_EQUAL(6, derivations);
+}
+
+static uint64_t time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t bench_get_huk(void)
+{
+    psa_key_attributes_t attr;
+    uint8_t key[32];
+    size_t key_len;
+    uint64_t start;
+    uint32_t i;
+
+    start = time_ns();
+    for (i = 0; i < BENCH_ITERATIONS; i++) {
+        attr = psa_key_attributes_init();
+        psa_set_key_id(&attr, mbedtls_svc_key_id_make(1, TEST_KEY_ID_HUK));
+        (void)tfm_builtin_key_loader_get_builtin_key(TFM_BUILTIN_KEY_SLOT_HUK,
+                                                     &attr, key, sizeof(key),
+                                                     &key_len);
+    }
+
+    return (time_ns() - start) / BENCH_ITERATIONS;
+}
+
+/* Access by a partition to the HUK, as done to get the key of each
+ * psa_its_set() with ITS encryption. The cache is bypassed when the lifecycle
+ * state is unknown, which runs the same code as with the cache disabled.
+ */
+void test_tfm_builtin_key_loader_benchmark(void)
+{
+    uint64_t miss_ns, hit_ns;
+
+    lcs = PLAT_OTP_LCS_UNKNOWN;
+    miss_ns = bench_get_huk();
+    TEST_ASSERT_EQUAL(BENCH_ITERATIONS, derivations);
+
+    lcs = PLAT_OTP_LCS_SECURED;
+    get_huk(1, 32);
+    derivations = 0;
+    hit_ns = bench_get_huk();
+    TEST_ASSERT_EQUAL(0, derivations);
+
+    TEST_PRINTF("tfm_builtin_key_loader_get_builtin_key: %u ns per access "
+                "without the cache, %u ns with a cache hit",
+                (unsigned)miss_ns, (unsigned)hit_ns);
+}
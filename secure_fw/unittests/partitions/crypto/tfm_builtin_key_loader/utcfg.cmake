@@ -0,0 +1,61 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2024, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+set(CRYPTO_DIR ${TFM_ROOT_DIR}/secure_fw/partitions/crypto)
+set(CRYPTO_UNITTESTS_DIR ${TFM_ROOT_DIR}/secure_fw/unittests/partitions/crypto)
+
+#-------------------------------------------------------------------------------
+# Unit under test
+#-------------------------------------------------------------------------------
+set(UNIT_UNDER_TEST ${CRYPTO_DIR}/psa_driver_api/tfm_builtin_key_loader.c)
+
+#-------------------------------------------------------------------------------
+# Test suite
+#-------------------------------------------------------------------------------
+set(UNIT_TEST_SUITE ${CMAKE_CURRENT_LIST_DIR}/test_tfm_builtin_key_loader.c)
+
+#-------------------------------------------------------------------------------
+# Dependencies
+#-------------------------------------------------------------------------------
+
+#-------------------------------------------------------------------------------
+# Include dirs
+#-------------------------------------------------------------------------------
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${CRYPTO_UNITTESTS_DIR}/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${CRYPTO_DIR})
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${CRYPTO_DIR}/psa_driver_api)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/secure_fw/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/secure_fw/spm/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/config)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/interface/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/platform/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/lib/ext/mbedcrypto/mbedcrypto_config)
+
+#-------------------------------------------------------------------------------
+# Compiledefs for UUT
+#-------------------------------------------------------------------------------
+list(APPEND UNIT_TEST_COMPILE_DEFS MBEDTLS_CONFIG_FILE="tfm_mbedcrypto_config_client.h")
+list(APPEND UNIT_TEST_COMPILE_DEFS MBEDTLS_PSA_CRYPTO_CONFIG_FILE="crypto_config_default.h")
+list(APPEND UNIT_TEST_COMPILE_DEFS MBEDTLS_PSA_CRYPTO_KEY_ID_ENCODES_OWNER)
+# The PSA Crypto functions are stubbed by the test with their client names
+list(APPEND UNIT_TEST_COMPILE_DEFS CRYPTO_SPE_H)
+list(APPEND UNIT_TEST_COMPILE_DEFS PLATFORM_DEFAULT_OTP)
+list(APPEND UNIT_TEST_COMPILE_DEFS CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM=2)
+
+#-------------------------------------------------------------------------------
+# Link libs for UUT
+#-------------------------------------------------------------------------------
+
+#-------------------------------------------------------------------------------
+# Mocks for UUT
+#-------------------------------------------------------------------------------
+
+#-------------------------------------------------------------------------------
+# Labels for UT (Optional, tests can be grouped by labels)
+#-------------------------------------------------------------------------------
+list(APPEND UT_LABELS "CRYPTO")
+list(APPEND UT_LABELS "BENCHMARK")
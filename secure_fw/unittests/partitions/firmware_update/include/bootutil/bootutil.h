@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __BOOTUTIL_H__
+#define __BOOTUTIL_H__
+
+#include <stdint.h>
+
+#include "flash_map_backend/flash_map_backend.h"
+
+#define ALIGN_UP(num, align)    (((num) + ((align) - 1)) & ~((align) - 1))
+#define ALIGN_DOWN(num, align)  ((num) & ~((align) - 1))
+
+#define BOOT_MAX_ALIGN          8
+#define BOOT_MAGIC_SZ           16
+#define BOOT_MAGIC_ALIGN_SIZE   ALIGN_UP(BOOT_MAGIC_SZ, BOOT_MAX_ALIGN)
+
+#define BOOT_FLAG_SET           1
+#define BOOT_FLAG_UNSET         3
+
+int boot_set_pending_multi(int image_index, int permanent);
+int boot_set_confirmed_multi(int image_index);
+int boot_read_image_ok(const struct flash_area *fap, uint8_t *image_ok);
+
+#endif /* __BOOTUTIL_H__ */
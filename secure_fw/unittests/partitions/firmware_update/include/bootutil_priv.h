@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __BOOTUTIL_PRIV_H__
+#define __BOOTUTIL_PRIV_H__
+
+#include "bootutil/bootutil.h"
+#include "bootutil/image.h"
+#include "flash_map_backend/flash_map_backend.h"
+
+/* The image trailer of MCUboot with swap using scratch */
+#define BOOT_STATUS_STATE_COUNT     3
+#define BOOT_STATUS_MAX_ENTRIES     256
+
+#define BOOT_TMPBUF_SZ              256
+
+#endif /* __BOOTUTIL_PRIV_H__ */
@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __SYSFLASH_H__
+#define __SYSFLASH_H__
+
+#define FLASH_AREA_IMAGE_PRIMARY(x)     (((x) * 2) + 1)
+#define FLASH_AREA_IMAGE_SECONDARY(x)   (((x) * 2) + 2)
+
+#endif /* __SYSFLASH_H__ */
@@ -0,0 +1,508 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "bootutil_priv.h"
+#include "config_tfm.h"
+#include "psa/crypto.h"
+#include "service_api.h"
+#include "sysflash/sysflash.h"
+#include "tfm_boot_status.h"
+#include "tfm_bootloader_fwu_abstraction.h"
+
+#define SECTOR_SIZE             (0x1000)
+#define SLOT_SECTORS            (32)
+#define SLOT_SIZE               (SECTOR_SIZE * SLOT_SECTORS)
+#define ERASED_VAL              (0xFF)
+#define BLOCK_SIZE              (TFM_CONFIG_FWU_MAX_WRITE_SIZE)
+
+/* Size of the trailer with the configuration of bootutil_priv.h */
+#define TRAILER_SIZE            (BOOT_STATUS_MAX_ENTRIES * \
+                                 BOOT_STATUS_STATE_COUNT * BOOT_MAX_ALIGN + \
+                                 BOOT_MAX_ALIGN * 4 + BOOT_MAGIC_ALIGN_SIZE)
+#define TRAILER_FIRST_SECTOR    ((SLOT_SIZE - TRAILER_SIZE) / SECTOR_SIZE)
+
+#define COMPONENT               (0)
+
+/* NOR flash, with the primary and secondary slots of the component */
+static const struct flash_area areas[] = {
+    {.fa_id = FLASH_AREA_IMAGE_PRIMARY(COMPONENT), .fa_off = 0,
+     .fa_size = SLOT_SIZE},
+    {.fa_id = FLASH_AREA_IMAGE_SECONDARY(COMPONENT), .fa_off = SLOT_SIZE,
+     .fa_size = SLOT_SIZE},
+};
+static uint8_t flash[2 * SLOT_SIZE];
+static uint32_t sector_erases[2 * SLOT_SECTORS];
+static uint32_t secondary_erases;
+
+static uint8_t image[SLOT_SIZE];
+
+int flash_area_driver_init(void)
+{
+    return 0;
+}
+
+int flash_area_open(uint8_t id, const struct flash_area **area)
+{
+    uint32_t i;
+
+    for (i = 0; i < sizeof(areas) / sizeof(areas[0]); i++) {
+        if (areas[i].fa_id == id) {
+            *area = &areas[i];
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+void flash_area_close(const struct flash_area *area)
+{
+    (void)area;
+}
+
+int flash_area_read(const struct flash_area *area, uint32_t off, void *dst,
+                    uint32_t len)
+{
+    TEST_ASSERT_LESS_OR_EQUAL(area->fa_size, off + len);
+
+    memcpy(dst, &flash[area->fa_off + off], len);
+
+    return 0;
+}
+
+/* Bits are only programmed from 1 to 0, so an area must be erased first */
+int flash_area_write(const struct flash_area *area, uint32_t off,
+                     const void *src, uint32_t len)
+{
+    uint32_t i;
+
+    if (off + len > area->fa_size) {
+        return -1;
+    }
+
+    for (i = 0; i < len; i++) {
+        TEST_ASSERT_EQUAL_HEX8(ERASED_VAL, flash[area->fa_off + off + i]);
+    }
+    memcpy(&flash[area->fa_off + off], src, len);
+
+    return 0;
+}
+
+int flash_area_erase(const struct flash_area *area, uint32_t off, uint32_t len)
+{
+    uint32_t sector;
+
+    TEST_ASSERT_EQUAL(0, off % SECTOR_SIZE);
+    TEST_ASSERT_EQUAL(0, len % SECTOR_SIZE);
+    TEST_ASSERT_LESS_OR_EQUAL(area->fa_size, off + len);
+
+    memset(&flash[area->fa_off + off], ERASED_VAL, len);
+    for (sector = off / SECTOR_SIZE; sector < (off + len) / SECTOR_SIZE;
+         sector++) {
+        sector_erases[(area->fa_off / SECTOR_SIZE) + sector]++;
+    }
+    if (area->fa_id == FLASH_AREA_IMAGE_SECONDARY(COMPONENT)) {
+        secondary_erases += len / SECTOR_SIZE;
+    }
+
+    return 0;
+}
+
+uint32_t flash_area_align(const struct flash_area *area)
+{
+    (void)area;
+
+    return 4;
+}
+
+uint8_t flash_area_erased_val(const struct flash_area *fap)
+{
+    (void)fap;
+
+    return ERASED_VAL;
+}
+
+int flash_area_get_sector(const struct flash_area *fa, uint32_t off,
+                          struct flash_sector *sector)
+{
+    (void)fa;
+
+    sector->fs_off = (off / SECTOR_SIZE) * SECTOR_SIZE;
+    sector->fs_size = SECTOR_SIZE;
+
+    return 0;
+}
+
+/* MCUboot, which writes the magic in the trailer of the staging area */
+int boot_set_pending_multi(int image_index, int permanent)
+{
+    static const uint8_t magic[BOOT_MAGIC_SZ] = {0x77, 0xC2, 0x95, 0xF3};
+    const struct flash_area *fap;
+
+    (void)permanent;
+
+    TEST_ASSERT_EQUAL(0,
+        flash_area_open(FLASH_AREA_IMAGE_SECONDARY(image_index), &fap));
+
+    return flash_area_write(fap, fap->fa_size - BOOT_MAGIC_SZ, magic,
+                            sizeof(magic));
+}
+
+int boot_set_confirmed_multi(int image_index)
+{
+    (void)image_index;
+
+    return 0;
+}
+
+int boot_read_image_ok(const struct flash_area *fap, uint8_t *image_ok)
+{
+    (void)fap;
+
+    *image_ok = BOOT_FLAG_SET;
+
+    return 0;
+}
+
+/* The version of the running image, shared by MCUboot */
+psa_status_t tfm_core_get_boot_data(uint8_t major_type,
+                                    struct tfm_boot_data *boot_data,
+                                    uint32_t len)
+{
+    const struct image_version version = {1, 2, 3, 4};
+    struct shared_data_tlv_entry entry;
+
+    TEST_ASSERT_EQUAL(TLV_MAJOR_FWU, major_type);
+    TEST_ASSERT_GREATER_OR_EQUAL(SHARED_DATA_HEADER_SIZE +
+                                 SHARED_DATA_ENTRY_SIZE(sizeof(version)), len);
+
+    entry.tlv_type = SET_TLV_TYPE(TLV_MAJOR_FWU,
+                                  SET_FWU_MINOR(COMPONENT, SW_VERSION));
+    entry.tlv_len = sizeof(version);
+    memcpy(boot_data->data, &entry, SHARED_DATA_ENTRY_HEADER_SIZE);
+    memcpy(&boot_data->data[SHARED_DATA_ENTRY_HEADER_SIZE], &version,
+           sizeof(version));
+    boot_data->header.tlv_magic = SHARED_DATA_TLV_INFO_MAGIC;
+    boot_data->header.tlv_tot_len = SHARED_DATA_HEADER_SIZE +
+                                    SHARED_DATA_ENTRY_SIZE(sizeof(version));
+
+    return PSA_SUCCESS;
+}
+
+/* Hash of the FWU images. It is not SHA-256, but depends on all the bytes
+ * and their position.
+ */
+#define HASH_OPS                (4)
+
+static struct {
+    bool active;
+    uint64_t state[4];
+    size_t len;
+} hash_ops[HASH_OPS];
+
+psa_status_t psa_hash_setup(psa_hash_operation_t *operation,
+                            psa_algorithm_t alg)
+{
+    uint32_t i;
+
+    TEST_ASSERT_EQUAL(PSA_ALG_SHA_256, alg);
+
+    for (i = 0; i < HASH_OPS; i++) {
+        if (!hash_ops[i].active) {
+            memset(&hash_ops[i], 0, sizeof(hash_ops[i]));
+            hash_ops[i].active = true;
+            hash_ops[i].state[0] = 0xCBF29CE484222325ULL;
+            hash_ops[i].state[1] = 0x84222325CBF29CE4ULL;
+            hash_ops[i].state[2] = 0x100000001B3ULL;
+            hash_ops[i].state[3] = 0x1B300000001ULL;
+            operation->handle = i + 1;
+            return PSA_SUCCESS;
+        }
+    }
+
+    return PSA_ERROR_INSUFFICIENT_MEMORY;
+}
+
+psa_status_t psa_hash_update(psa_hash_operation_t *operation,
+                             const uint8_t *input, size_t input_length)
+{
+    uint64_t *state = hash_ops[operation->handle - 1].state;
+    size_t *len = &hash_ops[operation->handle - 1].len;
+    size_t i;
+
+    TEST_ASSERT_TRUE(hash_ops[operation->handle - 1].active);
+
+    for (i = 0; i < input_length; i++, (*len)++) {
+        state[*len % 4] = (state[*len % 4] ^ input[i]) * 0x100000001B3ULL;
+        state[(*len + 1) % 4] += state[*len % 4] >> 7;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_hash_finish(psa_hash_operation_t *operation,
+                             uint8_t *hash, size_t hash_size,
+                             size_t *hash_length)
+{
+    uint64_t *state = hash_ops[operation->handle - 1].state;
+
+    TEST_ASSERT_TRUE(hash_ops[operation->handle - 1].active);
+    TEST_ASSERT_GREATER_OR_EQUAL(sizeof(hash_ops[0].state), hash_size);
+
+    state[0] ^= hash_ops[operation->handle - 1].len;
+    memcpy(hash, state, sizeof(hash_ops[0].state));
+    *hash_length = sizeof(hash_ops[0].state);
+
+    return psa_hash_abort(operation);
+}
+
+psa_status_t psa_hash_abort(psa_hash_operation_t *operation)
+{
+    if (operation->handle != 0) {
+        hash_ops[operation->handle - 1].active = false;
+        operation->handle = 0;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_hash_clone(const psa_hash_operation_t *source_operation,
+                            psa_hash_operation_t *target_operation)
+{
+    psa_status_t status;
+
+    status = psa_hash_setup(target_operation, PSA_ALG_SHA_256);
+    if (status == PSA_SUCCESS) {
+        hash_ops[target_operation->handle - 1] =
+            hash_ops[source_operation->handle - 1];
+    }
+
+    return status;
+}
+
+static void write_image(size_t offset, size_t size)
+{
+    size_t len;
+
+    while (size > 0) {
+        len = (size > BLOCK_SIZE) ? BLOCK_SIZE : size;
+        TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                          fwu_bootloader_load_image(COMPONENT, offset,
+                                                    &image[offset], len));
+        offset += len;
+        size -= len;
+    }
+}
+
+/* Digest of the first 'size' bytes of the image */
+static void image_digest(size_t size, uint8_t *digest)
+{
+    psa_hash_operation_t op = psa_hash_operation_init();
+    size_t digest_size;
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, psa_hash_setup(&op, PSA_ALG_SHA_256));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, psa_hash_update(&op, image, size));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      psa_hash_finish(&op, digest, TFM_FWU_MAX_DIGEST_SIZE,
+                                      &digest_size));
+}
+
+static void assert_candidate_digest(size_t size)
+{
+    psa_fwu_component_info_t info;
+    uint8_t digest[TFM_FWU_MAX_DIGEST_SIZE];
+
+    image_digest(size, digest);
+
+    memset(&info, 0, sizeof(info));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      fwu_bootloader_get_image_info(COMPONENT, false, true,
+                                                    &info));
+    TEST_ASSERT_EQUAL_MEMORY(digest, info.impl.candidate_digest,
+                             sizeof(digest));
+}
+
+static void assert_secondary_erased_once(uint32_t first, uint32_t end)
+{
+    uint32_t sector;
+
+    for (sector = first; sector < end; sector++) {
+        TEST_ASSERT_EQUAL_MESSAGE(1, sector_erases[SLOT_SECTORS + sector],
+                                  "secondary slot sector");
+    }
+}
+
+void setUp(void)
+{
+    uint32_t i;
+
+    /* The staging area holds a previous image */
+    memset(flash, 0x5A, sizeof(flash));
+    memset(sector_erases, 0, sizeof(sector_erases));
+    secondary_erases = 0;
+
+    for (i = 0; i < sizeof(image); i++) {
+        image[i] = (uint8_t)((i * 7) ^ (i >> 8));
+    }
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, fwu_bootloader_init());
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      fwu_bootloader_staging_area_init(COMPONENT, NULL, 0));
+}
+
+void tearDown(void)
+{
+    uint32_t i;
+
+    (void)fwu_bootloader_clean_component(COMPONENT);
+
+    /* No hash operation is left behind */
+    for (i = 0; i < HASH_OPS; i++) {
+        TEST_ASSERT_FALSE(hash_ops[i].active);
+    }
+}
+
+void test_tfm_mcuboot_fwu_erase_progressive(void)
+{
+    const size_t image_size = (10 * SECTOR_SIZE) + (SECTOR_SIZE / 2);
+
+    /* Nothing is erased before the first block */
+    TEST_ASSERT_EQUAL(0, secondary_erases);
+
+    /* The sector of the block and the next ones are erased */
+    write_image(0, BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(1 + FWU_ERASE_AHEAD_SECTORS, secondary_erases);
+
+    write_image(BLOCK_SIZE, image_size - BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(11 + FWU_ERASE_AHEAD_SECTORS, secondary_erases);
+    assert_secondary_erased_once(0, 11 + FWU_ERASE_AHEAD_SECTORS);
+
+    TEST_ASSERT_EQUAL_MEMORY(image, &flash[SLOT_SIZE], image_size);
+}
+
+void test_tfm_mcuboot_fwu_erase_out_of_order(void)
+{
+    const size_t image_size = 4 * SECTOR_SIZE;
+
+    /* The blocks before a block are erased with it */
+    write_image(2 * SECTOR_SIZE, image_size - (2 * SECTOR_SIZE));
+    write_image(0, 2 * SECTOR_SIZE);
+    assert_secondary_erased_once(0, 4 + FWU_ERASE_AHEAD_SECTORS);
+
+    TEST_ASSERT_EQUAL_MEMORY(image, &flash[SLOT_SIZE], image_size);
+}
+
+void test_tfm_mcuboot_fwu_install_erases_trailer(void)
+{
+    const size_t image_size = (10 * SECTOR_SIZE) + (SECTOR_SIZE / 2);
+    const psa_fwu_component_t candidate = COMPONENT;
+    uint32_t erased_before;
+
+    /* The trailer of the test spans two sectors */
+    TEST_ASSERT_EQUAL(SLOT_SECTORS - 2, TRAILER_FIRST_SECTOR);
+
+    write_image(0, image_size);
+    erased_before = secondary_erases;
+
+    /* Only the trailer sectors are erased, then the magic is written */
+    TEST_ASSERT_EQUAL(PSA_SUCCESS_REBOOT,
+                      fwu_bootloader_install_image(&candidate, 1));
+    TEST_ASSERT_EQUAL(erased_before + 2, secondary_erases);
+    assert_secondary_erased_once(TRAILER_FIRST_SECTOR, SLOT_SECTORS);
+
+    /* The sectors between the image and the trailer are not erased */
+    TEST_ASSERT_EQUAL(0, sector_erases[SLOT_SECTORS + TRAILER_FIRST_SECTOR - 1]);
+    TEST_ASSERT_EQUAL_HEX8(0x5A,
+                           flash[SLOT_SIZE +
+                                 (TRAILER_FIRST_SECTOR * SECTOR_SIZE) - 1]);
+
+    TEST_ASSERT_EQUAL_MEMORY(image, &flash[SLOT_SIZE], image_size);
+}
+
+void test_tfm_mcuboot_fwu_install_image_before_trailer(void)
+{
+    const size_t image_size = TRAILER_FIRST_SECTOR * SECTOR_SIZE;
+    const psa_fwu_component_t candidate = COMPONENT;
+
+    /* The image ends where the trailer sectors start, the sectors erased
+     * ahead of it are not erased again.
+     */
+    write_image(0, image_size);
+    TEST_ASSERT_EQUAL(PSA_SUCCESS_REBOOT,
+                      fwu_bootloader_install_image(&candidate, 1));
+    assert_secondary_erased_once(0, SLOT_SECTORS);
+
+    TEST_ASSERT_EQUAL_MEMORY(image, &flash[SLOT_SIZE], image_size);
+}
+
+void test_tfm_mcuboot_fwu_digest_running(void)
+{
+    const size_t image_size = (5 * SECTOR_SIZE) + 100;
+    psa_fwu_component_info_t info;
+
+    /* The digest of the blocks written in order is the running hash */
+    write_image(0, image_size);
+    assert_candidate_digest(image_size);
+
+    /* It is computed from the staging area when the blocks are written out
+     * of order. Both give the same digest.
+     */
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, fwu_bootloader_clean_component(COMPONENT));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      fwu_bootloader_staging_area_init(COMPONENT, NULL, 0));
+    write_image(2 * SECTOR_SIZE, image_size - (2 * SECTOR_SIZE));
+    write_image(0, 2 * SECTOR_SIZE);
+    assert_candidate_digest(image_size);
+
+    memset(&info, 0, sizeof(info));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      fwu_bootloader_get_image_info(COMPONENT, true, false,
+                                                    &info));
+    TEST_ASSERT_EQUAL(1, info.version.major);
+    TEST_ASSERT_EQUAL(4, info.version.build);
+}
+
+void test_tfm_mcuboot_fwu_digest_during_download(void)
+{
+    const size_t image_size = 8 * SECTOR_SIZE;
+    const psa_fwu_component_t candidate = COMPONENT;
+
+    /* A query does not end the running hash */
+    write_image(0, image_size / 2);
+    assert_candidate_digest(image_size / 2);
+    assert_candidate_digest(image_size / 2);
+
+    write_image(image_size / 2, image_size / 2);
+    assert_candidate_digest(image_size);
+
+    /* The digest is kept after the installation */
+    TEST_ASSERT_EQUAL(PSA_SUCCESS_REBOOT,
+                      fwu_bootloader_install_image(&candidate, 1));
+    assert_candidate_digest(image_size);
+}
+
+void test_tfm_mcuboot_fwu_digest_restart(void)
+{
+    const size_t image_size = 3 * SECTOR_SIZE;
+
+    write_image(0, image_size);
+    assert_candidate_digest(image_size);
+
+    /* A new FWU process starts a new running hash */
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, fwu_bootloader_clean_component(COMPONENT));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      fwu_bootloader_staging_area_init(COMPONENT, NULL, 0));
+    image[0] ^= 0xFF;
+    write_image(0, image_size);
+    assert_candidate_digest(image_size);
+}
@@ -0,0 +1,71 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2024, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+set(FWU_DIR ${TFM_ROOT_DIR}/secure_fw/partitions/firmware_update)
+set(FWU_UNITTESTS_DIR ${TFM_ROOT_DIR}/secure_fw/unittests/partitions/firmware_update)
+
+#-------------------------------------------------------------------------------
+# Unit under test
+#-------------------------------------------------------------------------------
+set(UNIT_UNDER_TEST ${FWU_DIR}/bootloader/mcuboot/tfm_mcuboot_fwu.c)
+
+#-------------------------------------------------------------------------------
+# Test suite
+#-------------------------------------------------------------------------------
+set(UNIT_TEST_SUITE ${CMAKE_CURRENT_LIST_DIR}/test_tfm_mcuboot_fwu.c)
+
+#-------------------------------------------------------------------------------
+# Dependencies
+#-------------------------------------------------------------------------------
+
+#-------------------------------------------------------------------------------
+# Generated headers
+#-------------------------------------------------------------------------------
+set(MCUBOOT_IMAGE_NUMBER 1)
+set(TFM_CONFIG_FWU_MAX_WRITE_SIZE 1024)
+set(TFM_CONFIG_FWU_MAX_MANIFEST_SIZE 0)
+set(FWU_SUPPORT_TRIAL_STATE ON)
+configure_file(${TFM_ROOT_DIR}/interface/include/psa/fwu_config.h.in
+               ${CMAKE_BINARY_DIR}/generated/tfm_mcuboot_fwu/psa/fwu_config.h)
+
+#-------------------------------------------------------------------------------
+# Include dirs
+#-------------------------------------------------------------------------------
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${FWU_UNITTESTS_DIR}/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${CMAKE_BINARY_DIR}/generated/tfm_mcuboot_fwu)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${FWU_DIR}/bootloader)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/secure_fw/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/secure_fw/spm/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/secure_fw/spm/include/boot)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/secure_fw/partitions/lib/runtime/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/config)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/interface/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/platform/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/lib/ext/mbedcrypto/mbedcrypto_config)
+
+#-------------------------------------------------------------------------------
+# Compiledefs for UUT
+#-------------------------------------------------------------------------------
+list(APPEND UNIT_TEST_COMPILE_DEFS TFM_PARTITION_LOG_LEVEL=0)
+list(APPEND UNIT_TEST_COMPILE_DEFS MBEDTLS_CONFIG_FILE="tfm_mbedcrypto_config_client.h")
+list(APPEND UNIT_TEST_COMPILE_DEFS MBEDTLS_PSA_CRYPTO_CONFIG_FILE="crypto_config_default.h")
+list(APPEND UNIT_TEST_COMPILE_DEFS FWU_DEVICE_CONFIG_FILE="psa/fwu_config.h")
+list(APPEND UNIT_TEST_COMPILE_DEFS MCUBOOT_IMAGE_NUMBER=1)
+list(APPEND UNIT_TEST_COMPILE_DEFS MCUBOOT_SWAP_USING_SCRATCH)
+
+#-------------------------------------------------------------------------------
+# Link libs for UUT
+#-------------------------------------------------------------------------------
+
+#-------------------------------------------------------------------------------
+# Mocks for UUT
+#-------------------------------------------------------------------------------
+
+#-------------------------------------------------------------------------------
+# Labels for UT (Optional, tests can be grouped by labels)
+#-------------------------------------------------------------------------------
+list(APPEND UT_LABELS "FWU")
@@ -0,0 +1,618 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "unity.h"
+
+#include "array.h"
+#include "attest.h"
+#include "attest_boot_data.h"
+#include "attest_key.h"
+#include "attest_token.h"
+#include "tfm_attest_hal.h"
+#include "tfm_attest_iat_defs.h"
+#include "tfm_crypto_defs.h"
+#include "tfm_plat_boot_seed.h"
+#include "tfm_plat_device_id.h"
+
+#define TOKEN_BUF_SIZE          (0x400)
+#define SW_COMPONENTS_DEFAULT   (2)
+#define BENCH_ITERATIONS        (20000)
+
+/*
+ * The tokens are COSE_Sign1 structures: a tag, an array of the protected
+ * header, the unprotected header, the payload and the signature.
+ */
+static const uint8_t cose_sign1_head[] = {
+    0xD2, 0x84, 0x43, 0xA1, 0x01, 0x26, 0xA0,
+};
+#define COSE_SIGNATURE_SIZE     (64)
+/* Room for the longest head of the payload byte string */
+#define PAYLOAD_HEAD_MAX_SIZE   (3)
+#define PAYLOAD_OFFSET          (sizeof(cose_sign1_head) + PAYLOAD_HEAD_MAX_SIZE)
+
+/* Number of calls to the platform for the claims */
+struct hal_calls_t {
+    uint32_t boot_seed;
+    uint32_t instance_id;
+    uint32_t implementation_id;
+    uint32_t client_id;
+    uint32_t security_lifecycle;
+    uint32_t sw_components;
+    uint32_t profile_definition;
+    uint32_t verification_service;
+    uint32_t cert_ref;
+};
+
+static struct hal_calls_t hal_calls;
+static bool boot_seed_unavailable;
+static int32_t client_id;
+static enum tfm_security_lifecycle_t security_lifecycle;
+static uint32_t sw_components;
+
+static uint8_t challenge[PSA_INITIAL_ATTEST_CHALLENGE_SIZE_64];
+
+/* CBOR encoder of the tokens, which only counts the bytes without a buffer */
+static void cbor_put(QCBOREncodeContext *ctx, const void *data, size_t len)
+{
+    if (ctx->buf != NULL) {
+        if (len > ctx->size - ctx->len) {
+            ctx->err = 1;
+            return;
+        }
+        if (data != NULL) {
+            memcpy(&ctx->buf[ctx->len], data, len);
+        }
+    }
+    ctx->len += len;
+}
+
+static size_t cbor_head(uint8_t *head, uint8_t major_type, uint64_t value)
+{
+    size_t len, i;
+
+    if (value < 24) {
+        head[0] = (uint8_t)((major_type << 5) | value);
+        return 1;
+    } else if (value <= UINT8_MAX) {
+        len = 1;
+    } else if (value <= UINT16_MAX) {
+        len = 2;
+    } else if (value <= UINT32_MAX) {
+        len = 4;
+    } else {
+        len = 8;
+    }
+
+    head[0] = (uint8_t)((major_type << 5) | (24 + (len == 1 ? 0 :
+                                                   len == 2 ? 1 :
+                                                   len == 4 ? 2 : 3)));
+    for (i = 0; i < len; i++) {
+        head[len - i] = (uint8_t)(value >> (8 * i));
+    }
+
+    return len + 1;
+}
+
+static void cbor_put_head(QCBOREncodeContext *ctx, uint8_t major_type,
+                          uint64_t value)
+{
+    uint8_t head[9];
+
+    cbor_put(ctx, head, cbor_head(head, major_type, value));
+}
+
+static void cbor_put_int(QCBOREncodeContext *ctx, int64_t value)
+{
+    if (value >= 0) {
+        cbor_put_head(ctx, 0, (uint64_t)value);
+    } else {
+        cbor_put_head(ctx, 1, (uint64_t)(-1 - value));
+    }
+}
+
+static void cbor_put_string(QCBOREncodeContext *ctx, uint8_t major_type,
+                            const void *data, size_t len)
+{
+    cbor_put_head(ctx, major_type, len);
+    cbor_put(ctx, data, len);
+}
+
+static void cbor_open_map(QCBOREncodeContext *ctx)
+{
+    ctx->map_head = ctx->len;
+    ctx->map_items = 0;
+    /* The maps have less than 24 items, their head is one byte */
+    cbor_put(ctx, NULL, 1);
+}
+
+static void cbor_close_map(QCBOREncodeContext *ctx)
+{
+    TEST_ASSERT_LESS_THAN(24, ctx->map_items);
+
+    if ((ctx->buf != NULL) && (ctx->err == 0)) {
+        ctx->buf[ctx->map_head] = (uint8_t)(0xA0 | ctx->map_items);
+    }
+}
+
+/* Token encoding, with the API of attest_token_encode.c */
+enum attest_token_err_t
+attest_token_encode_start(struct attest_token_encode_ctx *me,
+                          int32_t key_select,
+                          int32_t cose_alg_id,
+                          const struct q_useful_buf *out_buf)
+{
+    QCBOREncodeContext *ctx = &me->cbor_enc_ctx;
+
+    TEST_ASSERT_EQUAL(T_COSE_ALGORITHM_ES256, cose_alg_id);
+
+    memset(me, 0, sizeof(*me));
+    me->key_select = key_select;
+    ctx->buf = out_buf->ptr;
+    ctx->size = out_buf->len;
+
+    cbor_put(ctx, cose_sign1_head, sizeof(cose_sign1_head));
+    cbor_put(ctx, NULL, PAYLOAD_HEAD_MAX_SIZE);
+    cbor_open_map(ctx);
+
+    return ATTEST_TOKEN_ERR_SUCCESS;
+}
+
+QCBOREncodeContext *
+attest_token_encode_borrow_cbor_cntxt(struct attest_token_encode_ctx *me)
+{
+    return &me->cbor_enc_ctx;
+}
+
+void attest_token_encode_claims_start(struct attest_token_encode_ctx *me,
+                                      const struct q_useful_buf *out_buf)
+{
+    memset(me, 0, sizeof(*me));
+    me->cbor_enc_ctx.buf = out_buf->ptr;
+    me->cbor_enc_ctx.size = out_buf->len;
+
+    cbor_open_map(&me->cbor_enc_ctx);
+}
+
+enum attest_token_err_t
+attest_token_encode_claims_finish(struct attest_token_encode_ctx *me,
+                                  struct q_useful_buf_c *encoded_claims)
+{
+    QCBOREncodeContext *ctx = &me->cbor_enc_ctx;
+
+    cbor_close_map(ctx);
+    if (ctx->err != 0) {
+        return ATTEST_TOKEN_ERR_TOO_SMALL;
+    }
+
+    encoded_claims->ptr = ctx->buf;
+    encoded_claims->len = ctx->len;
+
+    return ATTEST_TOKEN_ERR_SUCCESS;
+}
+
+void attest_token_encode_add_integer(struct attest_token_encode_ctx *me,
+                                     int32_t label,
+                                     int64_t value)
+{
+    cbor_put_int(&me->cbor_enc_ctx, label);
+    cbor_put_int(&me->cbor_enc_ctx, value);
+    me->cbor_enc_ctx.map_items++;
+}
+
+void attest_token_encode_add_bstr(struct attest_token_encode_ctx *me,
+                                  int32_t label,
+                                  const struct q_useful_buf_c *bstr)
+{
+    cbor_put_int(&me->cbor_enc_ctx, label);
+    cbor_put_string(&me->cbor_enc_ctx, 2, bstr->ptr, bstr->len);
+    me->cbor_enc_ctx.map_items++;
+}
+
+void attest_token_encode_add_tstr(struct attest_token_encode_ctx *me,
+                                  int32_t label,
+                                  const struct q_useful_buf_c *tstr)
+{
+    cbor_put_int(&me->cbor_enc_ctx, label);
+    cbor_put_string(&me->cbor_enc_ctx, 3, tstr->ptr, tstr->len);
+    me->cbor_enc_ctx.map_items++;
+}
+
+void attest_token_encode_add_cbor(struct attest_token_encode_ctx *me,
+                                  int32_t label,
+                                  const struct q_useful_buf_c *encoded)
+{
+    cbor_put_int(&me->cbor_enc_ctx, label);
+    cbor_put(&me->cbor_enc_ctx, encoded->ptr, encoded->len);
+    me->cbor_enc_ctx.map_items++;
+}
+
+/* Wraps the payload in a byte string, and appends the signature */
+enum attest_token_err_t
+attest_token_encode_finish(struct attest_token_encode_ctx *me,
+                           struct q_useful_buf_c *completed_token)
+{
+    QCBOREncodeContext *ctx = &me->cbor_enc_ctx;
+    size_t payload_len = ctx->len - PAYLOAD_OFFSET;
+    uint8_t head[9];
+    size_t head_len = cbor_head(head, 2, payload_len);
+    size_t token_len = sizeof(cose_sign1_head) + head_len + payload_len +
+                       2 + COSE_SIGNATURE_SIZE;
+    size_t i;
+
+    cbor_close_map(ctx);
+    if ((ctx->err != 0) || ((ctx->buf != NULL) && (token_len > ctx->size))) {
+        return ATTEST_TOKEN_ERR_TOO_SMALL;
+    }
+
+    if (ctx->buf != NULL) {
+        memmove(&ctx->buf[sizeof(cose_sign1_head) + head_len],
+                &ctx->buf[PAYLOAD_OFFSET], payload_len);
+        memcpy(&ctx->buf[sizeof(cose_sign1_head)], head, head_len);
+
+        ctx->len = sizeof(cose_sign1_head) + head_len + payload_len;
+        cbor_put_head(ctx, 2, COSE_SIGNATURE_SIZE);
+        for (i = 0; i < COSE_SIGNATURE_SIZE; i++) {
+            ctx->buf[ctx->len++] = (uint8_t)i;
+        }
+    }
+
+    completed_token->ptr = ctx->buf;
+    completed_token->len = token_len;
+
+    return ATTEST_TOKEN_ERR_SUCCESS;
+}
+
+/* Platform, boot data and crypto */
+enum psa_attest_err_t attest_boot_data_init(void)
+{
+    return PSA_ATTEST_ERR_SUCCESS;
+}
+
+enum psa_attest_err_t
+attest_encode_sw_components_array(QCBOREncodeContext *encode_ctx,
+                                  const int32_t *map_label,
+                                  uint32_t *cnt)
+{
+    static const uint8_t measurement[32] = {0x5A};
+    static const uint8_t signer_id[32] = {0xC3};
+    uint32_t i;
+
+    hal_calls.sw_components++;
+
+    *cnt = sw_components;
+    if (sw_components == 0) {
+        return PSA_ATTEST_ERR_SUCCESS;
+    }
+
+    cbor_put_int(encode_ctx, *map_label);
+    cbor_put_head(encode_ctx, 4, sw_components);
+    encode_ctx->map_items++;
+
+    /* As encoded by MCUboot in the boot records */
+    for (i = 0; i < sw_components; i++) {
+        cbor_put_head(encode_ctx, 5, 5);
+        cbor_put_int(encode_ctx, IAT_SW_COMPONENT_MEASUREMENT_TYPE);
+        cbor_put_string(encode_ctx, 3, "SPE", 3);
+        cbor_put_int(encode_ctx, IAT_SW_COMPONENT_MEASUREMENT_VALUE);
+        cbor_put_string(encode_ctx, 2, measurement, sizeof(measurement));
+        cbor_put_int(encode_ctx, IAT_SW_COMPONENT_VERSION);
+        cbor_put_string(encode_ctx, 3, "2.1.0+0", 7);
+        cbor_put_int(encode_ctx, IAT_SW_COMPONENT_SIGNER_ID);
+        cbor_put_string(encode_ctx, 2, signer_id, sizeof(signer_id));
+        cbor_put_int(encode_ctx, IAT_SW_COMPONENT_MEASUREMENT_DESC);
+        cbor_put_string(encode_ctx, 3, "SHA256", 6);
+    }
+
+    return PSA_ATTEST_ERR_SUCCESS;
+}
+
+enum psa_attest_err_t attest_get_instance_id(struct q_useful_buf_c *id_buf)
+{
+    static const uint8_t instance_id[INSTANCE_ID_MAX_SIZE] = {0x01, 0xA0};
+
+    hal_calls.instance_id++;
+
+    id_buf->ptr = instance_id;
+    id_buf->len = sizeof(instance_id);
+
+    return PSA_ATTEST_ERR_SUCCESS;
+}
+
+enum psa_attest_err_t attest_get_caller_client_id(int32_t *caller_id)
+{
+    hal_calls.client_id++;
+
+    *caller_id = client_id;
+
+    return PSA_ATTEST_ERR_SUCCESS;
+}
+
+enum tfm_plat_err_t tfm_plat_get_boot_seed(uint32_t size, uint8_t *buf)
+{
+    hal_calls.boot_seed++;
+
+    if (boot_seed_unavailable) {
+        return TFM_PLAT_ERR_SYSTEM_ERR;
+    }
+
+    memset(buf, 0xB5, size);
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
+
+enum tfm_plat_err_t tfm_plat_get_implementation_id(uint32_t *size,
+                                                   uint8_t *buf)
+{
+    hal_calls.implementation_id++;
+
+    memset(buf, 0xAA, IMPLEMENTATION_ID_MAX_SIZE);
+    *size = IMPLEMENTATION_ID_MAX_SIZE;
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
+
+enum tfm_plat_err_t tfm_plat_get_cert_ref(uint32_t *size, uint8_t *buf)
+{
+    hal_calls.cert_ref++;
+
+    memcpy(buf, "0604565272829-10010", CERTIFICATION_REF_MAX_SIZE);
+    *size = CERTIFICATION_REF_MAX_SIZE;
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
+
+enum tfm_security_lifecycle_t tfm_attest_hal_get_security_lifecycle(void)
+{
+    hal_calls.security_lifecycle++;
+
+    return security_lifecycle;
+}
+
+enum tfm_plat_err_t
+tfm_attest_hal_get_profile_definition(uint32_t *size, uint8_t *buf)
+{
+    hal_calls.profile_definition++;
+
+    memcpy(buf, "PSA_IOT_PROFILE_1", 17);
+    *size = 17;
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
+
+enum tfm_plat_err_t
+tfm_attest_hal_get_verification_service(uint32_t *size, uint8_t *buf)
+{
+    hal_calls.verification_service++;
+
+    memcpy(buf, "www.trustedfirmware.org", 23);
+    *size = 23;
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
+
+psa_status_t psa_get_key_attributes(psa_key_id_t key,
+                                    psa_key_attributes_t *attributes)
+{
+    TEST_ASSERT_EQUAL(TFM_BUILTIN_KEY_ID_IAK, key);
+
+    *attributes = psa_key_attributes_init();
+    psa_set_key_type(attributes,
+                     PSA_KEY_TYPE_ECC_KEY_PAIR(PSA_ECC_FAMILY_SECP_R1));
+    psa_set_key_bits(attributes, 256);
+
+    return PSA_SUCCESS;
+}
+
+static uint32_t hal_calls_total(void)
+{
+    return hal_calls.boot_seed + hal_calls.instance_id +
+           hal_calls.implementation_id + hal_calls.client_id +
+           hal_calls.security_lifecycle + hal_calls.sw_components +
+           hal_calls.profile_definition + hal_calls.verification_service +
+           hal_calls.cert_ref;
+}
+
+/* Initialises the service, with or without the static claims encoded */
+static void init(bool static_claims)
+{
+    boot_seed_unavailable = !static_claims;
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, attest_init());
+    boot_seed_unavailable = false;
+
+    memset(&hal_calls, 0, sizeof(hal_calls));
+}
+
+static size_t get_token(size_t challenge_size, uint8_t *token)
+{
+    size_t token_size = 0;
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      initial_attest_get_token(challenge, challenge_size,
+                                               token, TOKEN_BUF_SIZE,
+                                               &token_size));
+
+    return token_size;
+}
+
+void setUp(void)
+{
+    memset(challenge, 0x3C, sizeof(challenge));
+    client_id = -1;
+    security_lifecycle = TFM_SLC_SECURED;
+    sw_components = SW_COMPONENTS_DEFAULT;
+}
+
+void test_attest_core_static_claims_same_token(void)
+{
+    static uint8_t token[2][TOKEN_BUF_SIZE];
+    size_t token_size[2];
+
+    init(false);
+    token_size[0] = get_token(sizeof(challenge), token[0]);
+
+    /* All the claims are read for each token */
+    TEST_ASSERT_EQUAL(1, hal_calls.boot_seed);
+    TEST_ASSERT_EQUAL(1, hal_calls.instance_id);
+    TEST_ASSERT_EQUAL(1, hal_calls.sw_components);
+    TEST_ASSERT_EQUAL(1, hal_calls.cert_ref);
+
+    init(true);
+    token_size[1] = get_token(sizeof(challenge), token[1]);
+
+    /* Only the dynamic claims are read for each token */
+    TEST_ASSERT_EQUAL(2, hal_calls_total());
+    TEST_ASSERT_EQUAL(1, hal_calls.client_id);
+    TEST_ASSERT_EQUAL(1, hal_calls.security_lifecycle);
+
+    TEST_ASSERT_EQUAL(token_size[0], token_size[1]);
+    TEST_ASSERT_EQUAL_MEMORY(token[0], token[1], token_size[0]);
+}
+
+void test_attest_core_static_claims_dynamic_values(void)
+{
+    static uint8_t token[2][TOKEN_BUF_SIZE];
+    size_t token_size[2];
+
+    init(false);
+    client_id = 0x1234;
+    security_lifecycle = TFM_SLC_NON_PSA_ROT_DEBUG;
+    token_size[0] = get_token(PSA_INITIAL_ATTEST_CHALLENGE_SIZE_32, token[0]);
+
+    init(true);
+    client_id = -1;
+    (void)get_token(PSA_INITIAL_ATTEST_CHALLENGE_SIZE_32, token[1]);
+
+    /* The claims read for each token have their current value */
+    client_id = 0x1234;
+    security_lifecycle = TFM_SLC_NON_PSA_ROT_DEBUG;
+    token_size[1] = get_token(PSA_INITIAL_ATTEST_CHALLENGE_SIZE_32, token[1]);
+
+    TEST_ASSERT_EQUAL(token_size[0], token_size[1]);
+    TEST_ASSERT_EQUAL_MEMORY(token[0], token[1], token_size[0]);
+}
+
+void test_attest_core_static_claims_dont_fit(void)
+{
+    static uint8_t token[2][TOKEN_BUF_SIZE];
+    size_t token_size[2];
+
+    /* The SW components don't fit in the static claims buffer */
+    sw_components = 6;
+
+    init(false);
+    token_size[0] = get_token(sizeof(challenge), token[0]);
+
+    init(true);
+    token_size[1] = get_token(sizeof(challenge), token[1]);
+
+    /* All the claims are read for each token */
+    TEST_ASSERT_EQUAL(1, hal_calls.boot_seed);
+    TEST_ASSERT_EQUAL(1, hal_calls.sw_components);
+
+    TEST_ASSERT_EQUAL(token_size[0], token_size[1]);
+    TEST_ASSERT_EQUAL_MEMORY(token[0], token[1], token_size[0]);
+}
+
+/* The size returned without creating the token is the size of the token,
+ * with the payload length on one or two bytes.
+ */
+void test_attest_core_token_size(void)
+{
+    static const size_t challenge_sizes[] = {
+        PSA_INITIAL_ATTEST_CHALLENGE_SIZE_32,
+        PSA_INITIAL_ATTEST_CHALLENGE_SIZE_48,
+        PSA_INITIAL_ATTEST_CHALLENGE_SIZE_64,
+    };
+    static const int32_t client_ids[] = {-1, 0x1234, INT32_MIN, INT32_MAX};
+    static const enum tfm_security_lifecycle_t lifecycles[] = {
+        TFM_SLC_SECURED, TFM_SLC_NON_PSA_ROT_DEBUG,
+    };
+    static uint8_t token[TOKEN_BUF_SIZE];
+    bool payload_head_size[2] = {false, false};
+    size_t token_size, expected_size;
+    uint32_t mode, n, c, i, l;
+
+    for (mode = 0; mode < 2; mode++) {
+        for (n = 0; n <= 3; n++) {
+            sw_components = n;
+            init(mode != 0);
+
+            for (c = 0; c < ARRAY_SIZE(challenge_sizes); c++) {
+                for (i = 0; i < ARRAY_SIZE(client_ids); i++) {
+                    for (l = 0; l < ARRAY_SIZE(lifecycles); l++) {
+                        client_id = client_ids[i];
+                        security_lifecycle = lifecycles[l];
+
+                        TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                            initial_attest_get_token_size(challenge_sizes[c],
+                                                          &token_size));
+                        expected_size = get_token(challenge_sizes[c], token);
+                        TEST_ASSERT_EQUAL(expected_size, token_size);
+
+                        /* Head of the payload byte string */
+                        TEST_ASSERT_TRUE((token[sizeof(cose_sign1_head)] ==
+                                          0x58) ||
+                                         (token[sizeof(cose_sign1_head)] ==
+                                          0x59));
+                        payload_head_size[token[sizeof(cose_sign1_head)] -
+                                          0x58] = true;
+                    }
+                }
+            }
+        }
+    }
+
+    /* Both payload lengths below and above 256 bytes were checked */
+    TEST_ASSERT_TRUE(payload_head_size[0]);
+    TEST_ASSERT_TRUE(payload_head_size[1]);
+}
+
+static uint64_t time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_get_token(bool static_claims)
+{
+    static uint8_t token[TOKEN_BUF_SIZE];
+    uint64_t start, elapsed;
+    uint32_t i;
+
+    init(static_claims);
+
+    start = time_ns();
+    for (i = 0; i < BENCH_ITERATIONS; i++) {
+        (void)get_token(sizeof(challenge), token);
+    }
+    elapsed = time_ns() - start;
+
+    TEST_PRINTF("initial_attest_get_token, %s: %u platform calls, %u ns "
+                "per token without signing",
+                static_claims ? "static claims encoded at init" :
+                                "all claims encoded per token",
+                (unsigned)(hal_calls_total() / BENCH_ITERATIONS),
+                (unsigned)(elapsed / BENCH_ITERATIONS));
+}
+
+/* Creates tokens of the PSA IoT profile with the optional claims and two SW
+ * components, with and without the static claims encoded in advance. The
+ * signature is not computed.
+ */
+void test_attest_core_benchmark(void)
+{
+    bench_get_token(false);
+    bench_get_token(true);
+}
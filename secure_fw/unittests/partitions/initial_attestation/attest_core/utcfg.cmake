@@ -0,0 +1,70 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2024, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+set(ATTEST_DIR ${TFM_ROOT_DIR}/secure_fw/partitions/initial_attestation)
+set(ATTEST_UNITTESTS_DIR ${TFM_ROOT_DIR}/secure_fw/unittests/partitions/initial_attestation)
+
+#-------------------------------------------------------------------------------
+# Unit under test
+#-------------------------------------------------------------------------------
+set(UNIT_UNDER_TEST ${ATTEST_DIR}/attest_core.c)
+
+#-------------------------------------------------------------------------------
+# Test suite
+#-------------------------------------------------------------------------------
+set(UNIT_TEST_SUITE ${CMAKE_CURRENT_LIST_DIR}/test_attest_core.c)
+
+#-------------------------------------------------------------------------------
+# Dependencies
+#-------------------------------------------------------------------------------
+
+#-------------------------------------------------------------------------------
+# Generated headers
+#-------------------------------------------------------------------------------
+set(PSA_INITIAL_ATTEST_MAX_TOKEN_SIZE 0x250)
+configure_file(${TFM_ROOT_DIR}/interface/include/psa/initial_attestation.h.in
+               ${CMAKE_BINARY_DIR}/generated/attest_core/psa/initial_attestation.h)
+
+#-------------------------------------------------------------------------------
+# Include dirs
+#-------------------------------------------------------------------------------
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${ATTEST_UNITTESTS_DIR}/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${CMAKE_BINARY_DIR}/generated/attest_core)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${ATTEST_DIR})
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/secure_fw/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/secure_fw/spm/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/secure_fw/spm/include/boot)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/secure_fw/partitions/lib/runtime/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/config)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/interface/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/platform/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/lib/ext/mbedcrypto/mbedcrypto_config)
+
+#-------------------------------------------------------------------------------
+# Compiledefs for UUT
+#-------------------------------------------------------------------------------
+list(APPEND UNIT_TEST_COMPILE_DEFS TFM_PARTITION_LOG_LEVEL=0)
+list(APPEND UNIT_TEST_COMPILE_DEFS PLATFORM_DEFAULT_CRYPTO_KEYS)
+list(APPEND UNIT_TEST_COMPILE_DEFS MBEDTLS_CONFIG_FILE="tfm_mbedcrypto_config_client.h")
+list(APPEND UNIT_TEST_COMPILE_DEFS MBEDTLS_PSA_CRYPTO_CONFIG_FILE="crypto_config_default.h")
+list(APPEND UNIT_TEST_COMPILE_DEFS ATTEST_TOKEN_PROFILE_PSA_IOT_1=1)
+list(APPEND UNIT_TEST_COMPILE_DEFS ATTEST_INCLUDE_OPTIONAL_CLAIMS=1)
+list(APPEND UNIT_TEST_COMPILE_DEFS ATTEST_STATIC_CLAIMS_BUF_SIZE=0x200)
+
+#-------------------------------------------------------------------------------
+# Link libs for UUT
+#-------------------------------------------------------------------------------
+
+#-------------------------------------------------------------------------------
+# Mocks for UUT
+#-------------------------------------------------------------------------------
+
+#-------------------------------------------------------------------------------
+# Labels for UT (Optional, tests can be grouped by labels)
+#-------------------------------------------------------------------------------
+list(APPEND UT_LABELS "ATTESTATION")
+list(APPEND UT_LABELS "BENCHMARK")
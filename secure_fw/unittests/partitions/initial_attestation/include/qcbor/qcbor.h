@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __QCBOR_H__
+#define __QCBOR_H__
+
+#include <stdint.h>
+#include "t_cose/q_useful_buf.h"
+
+/*
+ * CBOR encoding context of the token encoder provided by the tests. The
+ * attestation service only passes it around.
+ */
+typedef struct {
+    uint8_t *buf;           /* NULL to only compute the size */
+    size_t size;
+    size_t len;
+    size_t map_head;        /* Offset of the head of the open map */
+    uint32_t map_items;
+    int err;
+} QCBOREncodeContext;
+
+#endif /* __QCBOR_H__ */
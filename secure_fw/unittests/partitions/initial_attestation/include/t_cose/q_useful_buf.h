@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __Q_USEFUL_BUF_H__
+#define __Q_USEFUL_BUF_H__
+
+#include <stddef.h>
+
+/* Minimal useful buffer types, as used by the attestation service */
+struct q_useful_buf {
+    void *ptr;
+    size_t len;
+};
+
+struct q_useful_buf_c {
+    const void *ptr;
+    size_t len;
+};
+
+#define NULL_Q_USEFUL_BUF_C ((struct q_useful_buf_c){NULL, 0})
+
+#endif /* __Q_USEFUL_BUF_H__ */
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __T_COSE_COMMON_H__
+#define __T_COSE_COMMON_H__
+
+#define T_COSE_ALGORITHM_ES256    (-7)
+#define T_COSE_ALGORITHM_ES384    (-35)
+#define T_COSE_ALGORITHM_ES512    (-36)
+#define T_COSE_ALGORITHM_HMAC256  (5)
+#define T_COSE_ALGORITHM_HMAC384  (6)
+#define T_COSE_ALGORITHM_HMAC512  (7)
+
+#endif /* __T_COSE_COMMON_H__ */
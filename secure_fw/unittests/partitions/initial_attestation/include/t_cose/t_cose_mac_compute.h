@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __T_COSE_MAC_COMPUTE_H__
+#define __T_COSE_MAC_COMPUTE_H__
+
+#include "t_cose/t_cose_common.h"
+
+struct t_cose_mac_calculate_ctx {
+    int32_t cose_algorithm_id;
+};
+
+#endif /* __T_COSE_MAC_COMPUTE_H__ */
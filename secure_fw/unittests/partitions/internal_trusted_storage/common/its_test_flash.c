@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "its_test_flash.h"
+
+#define FLASH_SIZE  (ITS_TEST_FLASH_BLOCK_SIZE * ITS_TEST_FLASH_NUM_BLOCKS)
+#define NUM_UNITS   (FLASH_SIZE / TFM_HAL_ITS_PROGRAM_UNIT)
+
+static uint8_t flash[FLASH_SIZE];
+static uint32_t fail_write;
+static bool ecc;
+/* Program units programmed since the last erase */
+static bool programmed[NUM_UNITS];
+
+struct its_test_flash_stats_t its_test_flash_stats;
+
+const struct its_flash_fs_config_t its_test_flash_cfg = {
+    .flash_dev = flash,
+    .flash_area_addr = 0,
+    .sector_size = ITS_TEST_FLASH_BLOCK_SIZE,
+    .block_size = ITS_TEST_FLASH_BLOCK_SIZE,
+    .num_blocks = ITS_TEST_FLASH_NUM_BLOCKS,
+    .program_unit = TFM_HAL_ITS_PROGRAM_UNIT,
+    .max_file_size = ITS_TEST_FLASH_MAX_FILE,
+    .max_num_files = ITS_TEST_FLASH_NUM_FILES,
+    .erase_val = 0xFF,
+#if ITS_APPEND_IN_PLACE
+    .reprogram_erased = true,
+#endif
+};
+
+static uint8_t *block_addr(uint32_t block_id, size_t offset, size_t size)
+{
+    TEST_ASSERT_LESS_THAN(ITS_TEST_FLASH_NUM_BLOCKS, block_id);
+    TEST_ASSERT_LESS_OR_EQUAL(ITS_TEST_FLASH_BLOCK_SIZE, offset + size);
+
+    return &flash[block_id * ITS_TEST_FLASH_BLOCK_SIZE + offset];
+}
+
+static psa_status_t flash_init(const struct its_flash_fs_config_t *cfg)
+{
+    (void)cfg;
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t flash_read(const struct its_flash_fs_config_t *cfg,
+                               uint32_t block_id, uint8_t *buf, size_t offset,
+                               size_t size)
+{
+    (void)cfg;
+
+    memcpy(buf, block_addr(block_id, offset, size), size);
+    its_test_flash_stats.reads++;
+    its_test_flash_stats.read_bytes += size;
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t flash_write(const struct its_flash_fs_config_t *cfg,
+                                uint32_t block_id, const uint8_t *buf,
+                                size_t offset, size_t size)
+{
+    uint8_t *p = block_addr(block_id, offset, size);
+    size_t unit = ((block_id * ITS_TEST_FLASH_BLOCK_SIZE) + offset) /
+                  TFM_HAL_ITS_PROGRAM_UNIT;
+    size_t i;
+
+    (void)cfg;
+
+    if ((fail_write != 0) && (--fail_write == 0)) {
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+
+    TEST_ASSERT_EQUAL_MESSAGE(0, offset % TFM_HAL_ITS_PROGRAM_UNIT,
+                              "Unaligned program");
+    TEST_ASSERT_EQUAL_MESSAGE(0, size % TFM_HAL_ITS_PROGRAM_UNIT,
+                              "Partial program unit");
+
+    /* NOR flash can only program erased bytes */
+    for (i = 0; i < size; i++) {
+        TEST_ASSERT_EQUAL_HEX8_MESSAGE(0xFF, p[i], "Programmed twice");
+    }
+
+    /* Flash with ECC cannot program a unit again, even with the erase value */
+    for (i = 0; i < size / TFM_HAL_ITS_PROGRAM_UNIT; i++) {
+        if (ecc) {
+            TEST_ASSERT_FALSE_MESSAGE(programmed[unit + i],
+                                      "Programmed twice with ECC");
+        }
+        programmed[unit + i] = true;
+    }
+
+    memcpy(p, buf, size);
+    its_test_flash_stats.writes++;
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t flash_flush(const struct its_flash_fs_config_t *cfg,
+                                uint32_t block_id)
+{
+    (void)cfg;
+    (void)block_id;
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t flash_erase(const struct its_flash_fs_config_t *cfg,
+                                uint32_t block_id)
+{
+    (void)cfg;
+
+    memset(block_addr(block_id, 0, ITS_TEST_FLASH_BLOCK_SIZE), 0xFF,
+           ITS_TEST_FLASH_BLOCK_SIZE);
+    memset(&programmed[(block_id * ITS_TEST_FLASH_BLOCK_SIZE) /
+                       TFM_HAL_ITS_PROGRAM_UNIT], 0,
+           ITS_TEST_FLASH_BLOCK_SIZE / TFM_HAL_ITS_PROGRAM_UNIT);
+    its_test_flash_stats.erases++;
+
+    return PSA_SUCCESS;
+}
+
+const struct its_flash_fs_ops_t its_test_flash_ops = {
+    .init = flash_init,
+    .read = flash_read,
+    .write = flash_write,
+    .flush = flash_flush,
+    .erase = flash_erase,
+};
+
+void its_test_flash_erase_all(void)
+{
+    memset(flash, 0xFF, sizeof(flash));
+    memset(programmed, 0, sizeof(programmed));
+    memset(&its_test_flash_stats, 0, sizeof(its_test_flash_stats));
+    fail_write = 0;
+    ecc = false;
+}
+
+void its_test_flash_set_ecc(bool enable)
+{
+    ecc = enable;
+}
+
+void its_test_flash_fail_write(uint32_t n)
+{
+    fail_write = n;
+}
+
+void its_test_flash_fid(uint32_t n, uint8_t *fid)
+{
+    memset(fid, 0, ITS_FILE_ID_SIZE);
+    fid[0] = 1;
+    fid[4] = (uint8_t)(n + 1);
+    fid[5] = (uint8_t)((n + 1) >> 8);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __ITS_TEST_FLASH_H__
+#define __ITS_TEST_FLASH_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "flash_fs/its_flash_fs.h"
+
+#define ITS_TEST_FLASH_BLOCK_SIZE   (4096)
+#define ITS_TEST_FLASH_NUM_BLOCKS   (6)
+#define ITS_TEST_FLASH_NUM_FILES    (11)
+#define ITS_TEST_FLASH_MAX_FILE     (512)
+
+/* Flash operations counted by the RAM flash model */
+struct its_test_flash_stats_t {
+    uint32_t reads;
+    uint32_t read_bytes;
+    uint32_t writes;
+    uint32_t erases;
+};
+
+extern struct its_test_flash_stats_t its_test_flash_stats;
+extern const struct its_flash_fs_ops_t its_test_flash_ops;
+extern const struct its_flash_fs_config_t its_test_flash_cfg;
+
+/* Erases the whole flash model and clears the statistics */
+void its_test_flash_erase_all(void);
+
+/* Makes the n-th next write fail, 0 disables the fault injection */
+void its_test_flash_fail_write(uint32_t n);
+
+/* Models flash with ECC, which fails when a program unit is programmed twice
+ * between erases, even with the erase value. Disabled by
+ * its_test_flash_erase_all().
+ */
+void its_test_flash_set_ecc(bool enable);
+
+/* Fills a file ID derived from a number */
+void its_test_flash_fid(uint32_t n, uint8_t *fid);
+
+#endif /* __ITS_TEST_FLASH_H__ */
@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __FLASH_LAYOUT_H__
+#define __FLASH_LAYOUT_H__
+
+/* Dummy flash device, the tests pass their own flash operations */
+#define TFM_HAL_ITS_FLASH_DRIVER    UNITTEST_ITS_FLASH_DEV
+#ifndef TFM_HAL_ITS_PROGRAM_UNIT
+#define TFM_HAL_ITS_PROGRAM_UNIT    (4)
+#endif
+
+#endif /* __FLASH_LAYOUT_H__ */
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+
+#include "unity.h"
+
+#include "flash_fs/its_flash_fs.h"
+#include "its_test_flash.h"
+
+#define NUM_FILLER_FILES    (8)
+#define APPEND_FILE         (NUM_FILLER_FILES)
+#define CHUNK_SIZE          (64)
+#define NUM_CHUNKS          (ITS_TEST_FLASH_MAX_FILE / CHUNK_SIZE)
+
+static struct its_flash_fs_ctx_t fs_ctx;
+static struct its_flash_fs_config_t fs_cfg;
+
+static void fs_init(bool reprogram_erased)
+{
+    fs_cfg = its_test_flash_cfg;
+    fs_cfg.reprogram_erased = reprogram_erased;
+
+    memset(&fs_ctx, 0, sizeof(fs_ctx));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      its_flash_fs_init_ctx(&fs_ctx, &fs_cfg,
+                                            &its_test_flash_ops));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, its_flash_fs_wipe_all(&fs_ctx));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, its_flash_fs_prepare(&fs_ctx));
+}
+
+/* Fills the data block shared with the metadata, so that the appended file is
+ * stored in a dedicated data block.
+ */
+static void write_filler_file(uint32_t n)
+{
+    uint8_t fid[ITS_FILE_ID_SIZE];
+    uint8_t data[ITS_TEST_FLASH_MAX_FILE];
+    struct its_flash_fs_file_info_t info = {
+        .size_max = sizeof(data),
+        .flags = ITS_FLASH_FS_FLAG_CREATE | ITS_FLASH_FS_FLAG_TRUNCATE,
+    };
+
+    memset(data, 0xA5, sizeof(data));
+    its_test_flash_fid(n, fid);
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      its_flash_fs_file_write(&fs_ctx, fid, &info,
+                                              sizeof(data), 0, data));
+}
+
+static void write_filler_files(void)
+{
+    uint32_t n;
+
+    for (n = 0; n < NUM_FILLER_FILES; n++) {
+        write_filler_file(n);
+    }
+}
+
+/* Writes the file in chunks, the way ITS writes assets larger than its buffer,
+ * and returns the number of erases the chunks after the first caused. If
+ * requested, the last filler file, which shares the data block of the file, is
+ * rewritten after the first chunk.
+ */
+static uint32_t write_in_chunks(uint32_t flags, bool rewrite_neighbour)
+{
+    uint8_t fid[ITS_FILE_ID_SIZE];
+    uint8_t data[ITS_TEST_FLASH_MAX_FILE];
+    struct its_flash_fs_file_info_t info = {
+        .size_max = NUM_CHUNKS * CHUNK_SIZE,
+        .flags = ITS_FLASH_FS_FLAG_CREATE | ITS_FLASH_FS_FLAG_TRUNCATE | flags,
+    };
+    uint32_t erases = 0;
+    size_t i;
+
+    for (i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)i;
+    }
+
+    its_test_flash_fid(APPEND_FILE, fid);
+    for (i = 0; i < NUM_CHUNKS; i++) {
+        if (i == 1) {
+            erases = its_test_flash_stats.erases;
+            /* Later chunks are written to the existing file */
+            info.flags &= ~(ITS_FLASH_FS_FLAG_CREATE |
+                            ITS_FLASH_FS_FLAG_TRUNCATE);
+        }
+        TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                          its_flash_fs_file_write(&fs_ctx, fid, &info,
+                                                  CHUNK_SIZE, i * CHUNK_SIZE,
+                                                  &data[i * CHUNK_SIZE]));
+        if ((i == 0) && rewrite_neighbour) {
+            write_filler_file(NUM_FILLER_FILES - 1);
+        }
+    }
+
+    return its_test_flash_stats.erases - erases;
+}
+
+static void check_file(size_t size)
+{
+    uint8_t fid[ITS_FILE_ID_SIZE];
+    uint8_t data[ITS_TEST_FLASH_MAX_FILE];
+    struct its_flash_fs_file_info_t info;
+    size_t i;
+
+    its_test_flash_fid(APPEND_FILE, fid);
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      its_flash_fs_file_get_info(&fs_ctx, fid, &info));
+    TEST_ASSERT_EQUAL(size, info.size_current);
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      its_flash_fs_file_read(&fs_ctx, fid, size, 0, data));
+    for (i = 0; i < size; i++) {
+        TEST_ASSERT_EQUAL_HEX8(i & 0xFF, data[i]);
+    }
+}
+
+void setUp(void)
+{
+    its_test_flash_erase_all();
+}
+
+void test_its_flash_fs_append_in_place(void)
+{
+    uint32_t erases_rewrite, erases_in_place;
+
+    fs_init(true);
+    write_filler_files();
+    erases_rewrite = write_in_chunks(0, false);
+    check_file(NUM_CHUNKS * CHUNK_SIZE);
+
+    its_test_flash_erase_all();
+    fs_init(true);
+    write_filler_files();
+    erases_in_place = write_in_chunks(ITS_FLASH_FS_FLAG_APPEND, false);
+    check_file(NUM_CHUNKS * CHUNK_SIZE);
+
+    /* Appending in place does not erase the scratch data block */
+    TEST_ASSERT_LESS_THAN(erases_rewrite, erases_in_place);
+
+    /* The appended data is found after a reboot */
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, its_flash_fs_prepare(&fs_ctx));
+    check_file(NUM_CHUNKS * CHUNK_SIZE);
+}
+
+void test_its_flash_fs_append_ignored_without_flash_support(void)
+{
+    uint32_t erases_rewrite, erases_append;
+
+    fs_init(false);
+    write_filler_files();
+    erases_rewrite = write_in_chunks(0, false);
+
+    its_test_flash_erase_all();
+    fs_init(false);
+    write_filler_files();
+    erases_append = write_in_chunks(ITS_FLASH_FS_FLAG_APPEND, false);
+    check_file(NUM_CHUNKS * CHUNK_SIZE);
+
+    /* The data block is rewritten as if the flag was not set */
+    TEST_ASSERT_EQUAL(erases_rewrite, erases_append);
+}
+
+void test_its_flash_fs_append_ecc_flash(void)
+{
+    /* Rewriting the neighbour file copies the unused space of the file to a
+     * new data block, which programs it with the erase value. Flash with ECC
+     * cannot program it again, so the writes must not append in place.
+     */
+    fs_init(false);
+    its_test_flash_set_ecc(true);
+    write_filler_files();
+    (void)write_in_chunks(ITS_FLASH_FS_FLAG_APPEND, true);
+    check_file(NUM_CHUNKS * CHUNK_SIZE);
+}
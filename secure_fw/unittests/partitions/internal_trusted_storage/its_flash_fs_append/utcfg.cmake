@@ -0,0 +1,59 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2024, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+set(ITS_DIR ${TFM_ROOT_DIR}/secure_fw/partitions/internal_trusted_storage)
+set(ITS_UNITTESTS_DIR ${TFM_ROOT_DIR}/secure_fw/unittests/partitions/internal_trusted_storage)
+
+#-------------------------------------------------------------------------------
+# Unit under test
+#-------------------------------------------------------------------------------
+set(UNIT_UNDER_TEST ${ITS_DIR}/flash_fs/its_flash_fs.c)
+
+#-------------------------------------------------------------------------------
+# Test suite
+#-------------------------------------------------------------------------------
+set(UNIT_TEST_SUITE ${CMAKE_CURRENT_LIST_DIR}/test_its_flash_fs_append.c)
+
+#-------------------------------------------------------------------------------
+# Dependencies
+#-------------------------------------------------------------------------------
+list(APPEND UNIT_TEST_DEPS ${ITS_DIR}/flash_fs/its_flash_fs_dblock.c)
+list(APPEND UNIT_TEST_DEPS ${ITS_DIR}/flash_fs/its_flash_fs_mblock.c)
+list(APPEND UNIT_TEST_DEPS ${ITS_DIR}/its_utils.c)
+list(APPEND UNIT_TEST_DEPS ${ITS_UNITTESTS_DIR}/common/its_test_flash.c)
+
+#-------------------------------------------------------------------------------
+# Include dirs
+#-------------------------------------------------------------------------------
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${ITS_UNITTESTS_DIR}/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${ITS_UNITTESTS_DIR}/common)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${ITS_DIR})
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${ITS_DIR}/flash_fs)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${ITS_DIR}/flash)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/secure_fw/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/secure_fw/spm/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/config)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/interface/include)
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${TFM_ROOT_DIR}/platform/include)
+
+#-------------------------------------------------------------------------------
+# Compiledefs for UUT
+#-------------------------------------------------------------------------------
+list(APPEND UNIT_TEST_COMPILE_DEFS ITS_APPEND_IN_PLACE=1)
+
+#-------------------------------------------------------------------------------
+# Link libs for UUT
+#-------------------------------------------------------------------------------
+
+#-------------------------------------------------------------------------------
+# Mocks for UUT
+#-------------------------------------------------------------------------------
+
+#-------------------------------------------------------------------------------
+# Labels for UT (Optional, tests can be grouped by labels)
+#-------------------------------------------------------------------------------
+list(APPEND UT_LABELS "ITS")
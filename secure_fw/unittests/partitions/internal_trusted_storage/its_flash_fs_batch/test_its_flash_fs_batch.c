@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+
+#include "unity.h"
+
+#include "flash_fs/its_flash_fs.h"
+#include "its_test_flash.h"
+
+#define FILE_SIZE   (32)
+
+static struct its_flash_fs_ctx_t fs_ctx;
+static uint8_t file_data[ITS_BATCH_MAX_OPS + 2][FILE_SIZE];
+
+static void fs_prepare(void)
+{
+    memset(&fs_ctx, 0, sizeof(fs_ctx));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      its_flash_fs_init_ctx(&fs_ctx, &its_test_flash_cfg,
+                                            &its_test_flash_ops));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, its_flash_fs_prepare(&fs_ctx));
+}
+
+static struct its_flash_fs_file_info_t file_info(void)
+{
+    return (struct its_flash_fs_file_info_t){
+        .size_max = FILE_SIZE,
+        .flags = ITS_FLASH_FS_FLAG_CREATE | ITS_FLASH_FS_FLAG_TRUNCATE,
+    };
+}
+
+/* The content of a file is derived from the file and a version number */
+static const uint8_t *file_content(uint32_t n, uint8_t version)
+{
+    memset(file_data[n], (int)((n << 4) | version), FILE_SIZE);
+
+    return file_data[n];
+}
+
+static void write_file(uint32_t n, uint8_t version)
+{
+    uint8_t fid[ITS_FILE_ID_SIZE];
+    struct its_flash_fs_file_info_t info = file_info();
+
+    its_test_flash_fid(n, fid);
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      its_flash_fs_file_write(&fs_ctx, fid, &info, FILE_SIZE,
+                                              0, file_content(n, version)));
+}
+
+static psa_status_t stage_write(uint32_t n, uint8_t version)
+{
+    uint8_t fid[ITS_FILE_ID_SIZE];
+    struct its_flash_fs_file_info_t info = file_info();
+
+    its_test_flash_fid(n, fid);
+
+    return its_flash_fs_batch_stage_write(&fs_ctx, fid, &info, FILE_SIZE,
+                                          file_content(n, version));
+}
+
+static psa_status_t stage_delete(uint32_t n)
+{
+    uint8_t fid[ITS_FILE_ID_SIZE];
+
+    its_test_flash_fid(n, fid);
+
+    return its_flash_fs_batch_stage_delete(&fs_ctx, fid);
+}
+
+/* Checks the version of a file, 0 if the file must not exist */
+static void check_file(uint32_t n, uint8_t version)
+{
+    uint8_t fid[ITS_FILE_ID_SIZE];
+    uint8_t data[FILE_SIZE];
+    uint8_t expected[FILE_SIZE];
+
+    its_test_flash_fid(n, fid);
+    if (version == 0) {
+        TEST_ASSERT_EQUAL(PSA_ERROR_DOES_NOT_EXIST,
+                          its_flash_fs_file_read(&fs_ctx, fid, FILE_SIZE, 0,
+                                                 data));
+        return;
+    }
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      its_flash_fs_file_read(&fs_ctx, fid, FILE_SIZE, 0,
+                                             data));
+    memset(expected, (int)((n << 4) | version), FILE_SIZE);
+    TEST_ASSERT_EQUAL_MEMORY(expected, data, FILE_SIZE);
+}
+
+void setUp(void)
+{
+    its_test_flash_erase_all();
+
+    memset(&fs_ctx, 0, sizeof(fs_ctx));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      its_flash_fs_init_ctx(&fs_ctx, &its_test_flash_cfg,
+                                            &its_test_flash_ops));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, its_flash_fs_wipe_all(&fs_ctx));
+    fs_prepare();
+
+    write_file(0, 1);
+    write_file(1, 1);
+}
+
+void test_its_flash_fs_batch_commit(void)
+{
+    uint32_t erases, erases_single;
+
+    /* Erases caused by the metadata block update of a single operation */
+    erases = its_test_flash_stats.erases;
+    write_file(3, 1);
+    erases_single = its_test_flash_stats.erases - erases;
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, its_flash_fs_batch_begin(&fs_ctx));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, stage_write(0, 2));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, stage_delete(1));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, stage_write(2, 1));
+
+    /* Nothing is visible before the commit */
+    check_file(0, 1);
+    check_file(1, 1);
+    check_file(2, 0);
+
+    erases = its_test_flash_stats.erases;
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, its_flash_fs_batch_commit(&fs_ctx));
+
+    /* All the operations are applied with a single metadata block update */
+    TEST_ASSERT_EQUAL(erases_single, its_test_flash_stats.erases - erases);
+
+    check_file(0, 2);
+    check_file(1, 0);
+    check_file(2, 1);
+
+    /* The committed state is found after a reboot */
+    fs_prepare();
+    check_file(0, 2);
+    check_file(1, 0);
+    check_file(2, 1);
+}
+
+void test_its_flash_fs_batch_abort(void)
+{
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, its_flash_fs_batch_begin(&fs_ctx));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, stage_write(0, 2));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, stage_delete(1));
+    its_flash_fs_batch_abort(&fs_ctx);
+
+    check_file(0, 1);
+    check_file(1, 1);
+
+    /* No batch is active after an abort */
+    TEST_ASSERT_EQUAL(PSA_ERROR_BAD_STATE, stage_write(0, 3));
+    TEST_ASSERT_EQUAL(PSA_ERROR_BAD_STATE, its_flash_fs_batch_commit(&fs_ctx));
+}
+
+void test_its_flash_fs_batch_bad_state(void)
+{
+    TEST_ASSERT_EQUAL(PSA_ERROR_BAD_STATE, stage_write(0, 2));
+    TEST_ASSERT_EQUAL(PSA_ERROR_BAD_STATE, stage_delete(0));
+    TEST_ASSERT_EQUAL(PSA_ERROR_BAD_STATE, its_flash_fs_batch_commit(&fs_ctx));
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, its_flash_fs_batch_begin(&fs_ctx));
+    TEST_ASSERT_EQUAL(PSA_ERROR_BAD_STATE, its_flash_fs_batch_begin(&fs_ctx));
+    its_flash_fs_batch_abort(&fs_ctx);
+}
+
+void test_its_flash_fs_batch_full(void)
+{
+    uint32_t n;
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, its_flash_fs_batch_begin(&fs_ctx));
+    for (n = 0; n < ITS_BATCH_MAX_OPS; n++) {
+        TEST_ASSERT_EQUAL(PSA_SUCCESS, stage_write(n, 2));
+    }
+
+    TEST_ASSERT_EQUAL(PSA_ERROR_INSUFFICIENT_MEMORY,
+                      stage_write(ITS_BATCH_MAX_OPS, 2));
+
+    /* Staging another operation on a staged file replaces it */
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, stage_write(0, 3));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, stage_delete(1));
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, its_flash_fs_batch_commit(&fs_ctx));
+
+    check_file(0, 3);
+    check_file(1, 0);
+    for (n = 2; n < ITS_BATCH_MAX_OPS; n++) {
+        check_file(n, 2);
+    }
+    check_file(ITS_BATCH_MAX_OPS, 0);
+}
+
+void test_its_flash_fs_batch_write_failure(void)
+{
+    uint32_t n;
+
+    /* Fail each write of the commit in turn */
+    for (n = 1; ; n++) {
+        TEST_ASSERT_EQUAL(PSA_SUCCESS, its_flash_fs_batch_begin(&fs_ctx));
+        TEST_ASSERT_EQUAL(PSA_SUCCESS, stage_write(0, 2));
+        TEST_ASSERT_EQUAL(PSA_SUCCESS, stage_delete(1));
+        TEST_ASSERT_EQUAL(PSA_SUCCESS, stage_write(2, 1));
+
+        its_test_flash_fail_write(n);
+        if (its_flash_fs_batch_commit(&fs_ctx) == PSA_SUCCESS) {
+            its_test_flash_fail_write(0);
+            break;
+        }
+
+        /* None of the operations is visible, before and after a reboot */
+        check_file(0, 1);
+        check_file(1, 1);
+        check_file(2, 0);
+        fs_prepare();
+        check_file(0, 1);
+        check_file(1, 1);
+        check_file(2, 0);
+    }
+
+    TEST_ASSERT_GREATER_THAN(1, n);
+    check_file(0, 2);
+    check_file(1, 0);
+    check_file(2, 1);
+}
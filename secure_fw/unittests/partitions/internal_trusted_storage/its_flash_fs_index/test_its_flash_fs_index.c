@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include "unity.h"
+
+#include "flash_fs/its_flash_fs.h"
+#include "flash_fs/its_flash_fs_index.h"
+#include "its_test_flash.h"
+
+#define NUM_FILES           (ITS_TEST_FLASH_NUM_FILES - 1)
+#define BENCH_ITERATIONS    (1000)
+
+static struct its_flash_fs_ctx_t fs_ctx;
+
+static void fs_prepare(void)
+{
+    memset(&fs_ctx, 0, sizeof(fs_ctx));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      its_flash_fs_init_ctx(&fs_ctx, &its_test_flash_cfg,
+                                            &its_test_flash_ops));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, its_flash_fs_prepare(&fs_ctx));
+}
+
+static void write_file(uint32_t n, size_t size)
+{
+    uint8_t fid[ITS_FILE_ID_SIZE];
+    uint8_t data[ITS_TEST_FLASH_MAX_FILE];
+    struct its_flash_fs_file_info_t info = {
+        .size_max = size,
+        .flags = (n & 0xF) | ITS_FLASH_FS_FLAG_CREATE |
+                 ITS_FLASH_FS_FLAG_TRUNCATE,
+    };
+
+    its_test_flash_fid(n, fid);
+    memset(data, (int)n, size);
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      its_flash_fs_file_write(&fs_ctx, fid, &info, size, 0,
+                                              data));
+}
+
+static void check_file(uint32_t n, size_t size)
+{
+    uint8_t fid[ITS_FILE_ID_SIZE];
+    struct its_flash_fs_file_info_t info;
+
+    its_test_flash_fid(n, fid);
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      its_flash_fs_file_get_info(&fs_ctx, fid, &info));
+    TEST_ASSERT_EQUAL(size, info.size_max);
+    TEST_ASSERT_EQUAL(size, info.size_current);
+    TEST_ASSERT_EQUAL(n & 0xF, info.flags);
+}
+
+static size_t file_size(uint32_t n)
+{
+    return 4 + (n * 36);
+}
+
+void setUp(void)
+{
+    its_test_flash_erase_all();
+
+    memset(&fs_ctx, 0, sizeof(fs_ctx));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      its_flash_fs_init_ctx(&fs_ctx, &its_test_flash_cfg,
+                                            &its_test_flash_ops));
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, its_flash_fs_wipe_all(&fs_ctx));
+    fs_prepare();
+}
+
+void test_its_flash_fs_index_get_info_no_flash_read(void)
+{
+    uint32_t n;
+
+    for (n = 0; n < NUM_FILES; n++) {
+        write_file(n, file_size(n));
+    }
+
+    its_test_flash_stats.reads = 0;
+    for (n = 0; n < NUM_FILES; n++) {
+        check_file(n, file_size(n));
+    }
+
+    TEST_ASSERT_EQUAL(0, its_test_flash_stats.reads);
+}
+
+void test_its_flash_fs_index_missing_file_no_flash_read(void)
+{
+    uint8_t fid[ITS_FILE_ID_SIZE];
+    struct its_flash_fs_file_info_t info;
+
+    write_file(0, 16);
+
+    its_test_flash_stats.reads = 0;
+    its_test_flash_fid(NUM_FILES, fid);
+    TEST_ASSERT_EQUAL(PSA_ERROR_DOES_NOT_EXIST,
+                      its_flash_fs_file_get_info(&fs_ctx, fid, &info));
+    TEST_ASSERT_EQUAL(0, its_test_flash_stats.reads);
+}
+
+void test_its_flash_fs_index_survives_updates_and_reinit(void)
+{
+    uint8_t fid[ITS_FILE_ID_SIZE];
+    struct its_flash_fs_file_info_t info;
+    uint32_t n;
+
+    for (n = 0; n < NUM_FILES; n++) {
+        write_file(n, file_size(n));
+    }
+
+    /* Delete every other file and rewrite the others with a new size */
+    for (n = 0; n < NUM_FILES; n += 2) {
+        its_test_flash_fid(n, fid);
+        TEST_ASSERT_EQUAL(PSA_SUCCESS, its_flash_fs_file_delete(&fs_ctx, fid));
+    }
+    for (n = 1; n < NUM_FILES; n += 2) {
+        write_file(n, file_size(n) + 8);
+    }
+
+    /* The index rebuilt from flash must give the same answers */
+    fs_prepare();
+
+    for (n = 0; n < NUM_FILES; n++) {
+        its_test_flash_fid(n, fid);
+        if (n % 2 == 0) {
+            TEST_ASSERT_EQUAL(PSA_ERROR_DOES_NOT_EXIST,
+                              its_flash_fs_file_get_info(&fs_ctx, fid, &info));
+        } else {
+            check_file(n, file_size(n) + 8);
+        }
+    }
+}
+
+void test_its_flash_fs_index_fallback_when_invalid(void)
+{
+    uint32_t n;
+
+    for (n = 0; n < NUM_FILES; n++) {
+        write_file(n, file_size(n));
+    }
+
+    its_flash_fs_index_invalidate(&fs_ctx);
+
+    its_test_flash_stats.reads = 0;
+    for (n = 0; n < NUM_FILES; n++) {
+        check_file(n, file_size(n));
+    }
+
+    /* Without the index the metadata table is read from flash */
+    TEST_ASSERT_GREATER_THAN(0, its_test_flash_stats.reads);
+}
+
+static uint64_t time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+/* Runs get_info on every file and on one missing file */
+static void bench_get_info(const char *name, uint32_t *reads)
+{
+    uint8_t fid[ITS_FILE_ID_SIZE];
+    struct its_flash_fs_file_info_t info;
+    uint64_t start, elapsed;
+    uint32_t i, n;
+
+    its_test_flash_stats.reads = 0;
+    its_test_flash_stats.read_bytes = 0;
+
+    start = time_ns();
+    for (i = 0; i < BENCH_ITERATIONS; i++) {
+        for (n = 0; n <= NUM_FILES; n++) {
+            its_test_flash_fid(n, fid);
+            (void)its_flash_fs_file_get_info(&fs_ctx, fid, &info);
+        }
+    }
+    elapsed = time_ns() - start;
+
+    *reads = its_test_flash_stats.reads;
+
+    TEST_PRINTF("get_info %s: %u flash reads, %u bytes read, %u ns per call",
+                name,
+                (unsigned)(its_test_flash_stats.reads / BENCH_ITERATIONS),
+                (unsigned)(its_test_flash_stats.read_bytes / BENCH_ITERATIONS),
+                (unsigned)(elapsed / (BENCH_ITERATIONS * (NUM_FILES + 1))));
+}
+
+void test_its_flash_fs_index_get_info_benchmark(void)
+{
+    uint32_t reads_index, reads_flash;
+    uint32_t n;
+
+    for (n = 0; n < NUM_FILES; n++) {
+        write_file(n, file_size(n));
+    }
+
+    its_flash_fs_index_invalidate(&fs_ctx);
+    bench_get_info("metadata scan", &reads_flash);
+
+    fs_prepare();
+    bench_get_info("RAM index", &reads_index);
+
+    TEST_ASSERT_LESS_THAN(reads_flash, reads_index);
+}
@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __CMSIS_COMPILER_H
+#define __CMSIS_COMPILER_H
+
+/* The host versions of the CMSIS helpers used by the mailbox. The barriers
+ * are needed, as the tests run NSPE and SPE in different threads.
+ */
+
+#define __STATIC_INLINE         static inline
+#define __ALIGNED(x)            __attribute__((aligned(x)))
+#define __CLZ(x)                ((uint8_t)__builtin_clz(x))
+#define __DMB()                 __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __DSB()                 __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#endif /* __CMSIS_COMPILER_H */
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _TFM_MAILBOX_CONFIG_
+#define _TFM_MAILBOX_CONFIG_
+
+#define NUM_MAILBOX_QUEUE_SLOT              4
+
+#define TFM_MAILBOX_RING_TRANSPORT
+
+#ifndef MAILBOX_RING_SIZE
+#define MAILBOX_RING_SIZE                   8
+#endif
+
+/* NSPE and SPE must agree on the layout of the shared memory. SPE takes the
+ * default values from config_base.h.
+ */
+#ifndef MAILBOX_IS_UNCACHED_S
+#define MAILBOX_IS_UNCACHED_S               1
+#endif
+
+#ifndef MAILBOX_IS_UNCACHED_NS
+#define MAILBOX_IS_UNCACHED_NS              1
+#endif
+
+#endif /* _TFM_MAILBOX_CONFIG_ */
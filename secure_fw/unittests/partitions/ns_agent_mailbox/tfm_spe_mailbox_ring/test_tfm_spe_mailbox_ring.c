@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "internal_status_code.h"
+#include "tfm_ns_mailbox.h"
+#include "tfm_mailbox_ring.h"
+#include "tfm_hal_mailbox.h"
+#include "tfm_multi_core.h"
+#include "tfm_rpc.h"
+
+#define TEST_SERVICE_HANDLE     (0x40000100)
+#define NUM_THREAD_REQUESTS     (200000)
+
+static struct mailbox_ring_shared_t rings;
+static const struct tfm_rpc_ops_t *rpc_ops;
+
+/* Owners of the asynchronous requests that SPM did not reply to yet */
+static const void *owners[MAILBOX_RING_SIZE];
+static uint32_t nr_owners;
+static psa_status_t owner_results[MAILBOX_RING_SIZE];
+
+static uint32_t psa_calls;
+static volatile uint32_t spe_notifications;
+
+static psa_outvec out_vec[1];
+
+/* NSPE platform */
+int32_t tfm_ns_mailbox_hal_ring_init(struct mailbox_ring_shared_t *r)
+{
+    (void)r;
+
+    return MAILBOX_SUCCESS;
+}
+
+int32_t tfm_ns_mailbox_hal_notify_peer(void)
+{
+    return MAILBOX_SUCCESS;
+}
+
+/* SPE platform */
+int32_t tfm_mailbox_hal_ring_init(struct mailbox_ring_shared_t **r)
+{
+    *r = &rings;
+
+    return MAILBOX_SUCCESS;
+}
+
+int32_t tfm_mailbox_hal_notify_peer(void)
+{
+    spe_notifications++;
+
+    return MAILBOX_SUCCESS;
+}
+
+int32_t tfm_multi_core_hal_client_id_translate(void *owner,
+                                               int32_t client_id_in,
+                                               int32_t *client_id_out)
+{
+    (void)owner;
+
+    *client_id_out = client_id_in;
+
+    return SPM_SUCCESS;
+}
+
+/* SPM, with the IPC backend. The requests are replied to asynchronously. */
+int32_t tfm_rpc_register_ops(const struct tfm_rpc_ops_t *ops_ptr)
+{
+    rpc_ops = ops_ptr;
+
+    return TFM_RPC_SUCCESS;
+}
+
+void tfm_rpc_unregister_ops(void)
+{
+    rpc_ops = NULL;
+}
+
+uint32_t tfm_rpc_psa_framework_version(void)
+{
+    return PSA_FRAMEWORK_VERSION;
+}
+
+uint32_t tfm_rpc_psa_version(uint32_t sid)
+{
+    return sid + 1;
+}
+
+psa_status_t tfm_rpc_psa_call(psa_handle_t handle, uint32_t control,
+                              const struct client_params_t *params,
+                              const void *client_data_stateless)
+{
+    (void)control;
+
+    psa_calls++;
+
+    /* The service writes the output vector and returns its handle */
+    if (params->p_outvecs[0].len != 0) {
+        params->p_outvecs[0].len = 1;
+    }
+
+    /* The result identifies the service the request was sent to */
+    owner_results[nr_owners] = (psa_status_t)(handle - TEST_SERVICE_HANDLE);
+    owners[nr_owners++] = client_data_stateless;
+
+    return PSA_SUCCESS;
+}
+
+/* Completes all the requests dispatched to SPM, and publishes the replies */
+static void spm_reply_all(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < nr_owners; i++) {
+        rpc_ops->reply(owners[i], owner_results[i]);
+    }
+    nr_owners = 0;
+
+    rpc_ops->flush_replies();
+}
+
+static void spe_handle_requests(void)
+{
+    uint32_t nr_msg;
+
+    TEST_ASSERT_EQUAL(MAILBOX_SUCCESS, rpc_ops->process_new_msg(&nr_msg));
+}
+
+static void post_call(uint32_t token, psa_handle_t handle, size_t out_len)
+{
+    struct psa_client_params_t params;
+
+    memset(&params, 0, sizeof(params));
+    params.psa_call_params.handle = handle;
+    params.psa_call_params.out_vec = out_vec;
+    params.psa_call_params.out_len = out_len;
+
+    TEST_ASSERT_EQUAL(MAILBOX_SUCCESS,
+                      tfm_ns_mailbox_ring_post(MAILBOX_PSA_CALL, &params, -1,
+                                               token));
+}
+
+void setUp(void)
+{
+    nr_owners = 0;
+    psa_calls = 0;
+    spe_notifications = 0;
+
+    TEST_ASSERT_EQUAL(MAILBOX_SUCCESS, tfm_ns_mailbox_ring_init(&rings));
+    TEST_ASSERT_EQUAL(MAILBOX_SUCCESS, tfm_inter_core_comm_init());
+}
+
+void test_tfm_spe_mailbox_ring_call(void)
+{
+    struct mailbox_ring_cpl_t cpl;
+
+    out_vec[0].len = 8;
+    post_call(7, TEST_SERVICE_HANDLE, 1);
+    tfm_ns_mailbox_ring_submit();
+
+    spe_handle_requests();
+    TEST_ASSERT_EQUAL(1, psa_calls);
+
+    /* Nothing is completed before SPM replies */
+    TEST_ASSERT_EQUAL(0, tfm_ns_mailbox_ring_reap(&cpl, 1));
+
+    spm_reply_all();
+    TEST_ASSERT_EQUAL(1, tfm_ns_mailbox_ring_reap(&cpl, 1));
+    TEST_ASSERT_EQUAL(7, cpl.token);
+    TEST_ASSERT_EQUAL(PSA_SUCCESS, cpl.return_val);
+
+    /* The output length written by the service is returned to NSPE */
+    TEST_ASSERT_EQUAL(1, out_vec[0].len);
+}
+
+void test_tfm_spe_mailbox_ring_batch(void)
+{
+    struct mailbox_ring_cpl_t cpl[MAILBOX_RING_SIZE];
+    uint32_t i;
+
+    for (i = 0; i < MAILBOX_RING_SIZE; i++) {
+        post_call(i, TEST_SERVICE_HANDLE + i, 0);
+    }
+
+    /* NSPE cannot have more requests than entries in flight */
+    TEST_ASSERT_EQUAL(MAILBOX_QUEUE_FULL,
+                      tfm_ns_mailbox_ring_post(MAILBOX_PSA_FRAMEWORK_VERSION,
+                                               &(struct psa_client_params_t){0},
+                                               -1, 0));
+    tfm_ns_mailbox_ring_submit();
+
+    spe_handle_requests();
+    TEST_ASSERT_EQUAL(MAILBOX_RING_SIZE, psa_calls);
+
+    /* All the replies are published with a single notification */
+    spm_reply_all();
+    TEST_ASSERT_EQUAL(1, spe_notifications);
+
+    TEST_ASSERT_EQUAL(MAILBOX_RING_SIZE,
+                      tfm_ns_mailbox_ring_reap(cpl, MAILBOX_RING_SIZE));
+    for (i = 0; i < MAILBOX_RING_SIZE; i++) {
+        TEST_ASSERT_EQUAL(i, cpl[i].token);
+        TEST_ASSERT_EQUAL(i, cpl[i].return_val);
+    }
+}
+
+void test_tfm_spe_mailbox_ring_invalid_msg(void)
+{
+    struct psa_client_params_t params;
+    struct mailbox_ring_cpl_t cpl[3];
+
+    /* Unknown call type */
+    memset(&params, 0, sizeof(params));
+    TEST_ASSERT_EQUAL(MAILBOX_SUCCESS,
+                      tfm_ns_mailbox_ring_post(0x77, &params, -1, 1));
+
+    /* Too many vectors */
+    params.psa_call_params.in_vec = (const psa_invec *)out_vec;
+    params.psa_call_params.in_len = PSA_MAX_IOVEC;
+    params.psa_call_params.out_vec = out_vec;
+    params.psa_call_params.out_len = 1;
+    TEST_ASSERT_EQUAL(MAILBOX_SUCCESS,
+                      tfm_ns_mailbox_ring_post(MAILBOX_PSA_CALL, &params, -1,
+                                               2));
+
+    /* Output vectors without an array */
+    params.psa_call_params.in_len = 0;
+    params.psa_call_params.out_vec = NULL;
+    TEST_ASSERT_EQUAL(MAILBOX_SUCCESS,
+                      tfm_ns_mailbox_ring_post(MAILBOX_PSA_CALL, &params, -1,
+                                               3));
+    tfm_ns_mailbox_ring_submit();
+
+    spe_handle_requests();
+
+    /* The requests are not dispatched, but completed with an error */
+    TEST_ASSERT_EQUAL(0, psa_calls);
+    TEST_ASSERT_EQUAL(3, tfm_ns_mailbox_ring_reap(cpl, 3));
+    TEST_ASSERT_EQUAL(1, cpl[0].token);
+    TEST_ASSERT_EQUAL(PSA_ERROR_INVALID_ARGUMENT, cpl[0].return_val);
+    TEST_ASSERT_EQUAL(2, cpl[1].token);
+    TEST_ASSERT_EQUAL(PSA_ERROR_INVALID_ARGUMENT, cpl[1].return_val);
+    TEST_ASSERT_EQUAL(3, cpl[2].token);
+    TEST_ASSERT_EQUAL(PSA_ERROR_INVALID_ARGUMENT, cpl[2].return_val);
+}
+
+void test_tfm_spe_mailbox_ring_corrupt_head(void)
+{
+    uint32_t nr_msg;
+
+    post_call(1, TEST_SERVICE_HANDLE, 0);
+    tfm_ns_mailbox_ring_submit();
+
+    /* A head index past the ring size is ignored */
+    rings.req_head.val += MAILBOX_RING_SIZE;
+    TEST_ASSERT_EQUAL(MAILBOX_SUCCESS, rpc_ops->process_new_msg(&nr_msg));
+    TEST_ASSERT_EQUAL(0, nr_msg);
+    TEST_ASSERT_EQUAL(0, psa_calls);
+}
+
+/* SPE side of the two-thread test */
+static volatile bool spe_stop;
+
+static void *spe_thread(void *arg)
+{
+    unsigned int seed = 1;
+    uint32_t nr_msg;
+
+    (void)arg;
+
+    while (!spe_stop) {
+        (void)rpc_ops->process_new_msg(&nr_msg);
+
+        /* Reply in batches of random size, sometimes later */
+        if ((nr_owners != 0) && ((rand_r(&seed) & 3) != 0)) {
+            spm_reply_all();
+        } else if (nr_msg == 0) {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+/* NSPE and SPE run in parallel, as on two cores. Requests are posted in
+ * batches of random size, and each one must be completed once.
+ */
+void test_tfm_spe_mailbox_ring_two_threads(void)
+{
+    struct mailbox_ring_cpl_t cpl[MAILBOX_RING_SIZE];
+    uint32_t posted = 0, reaped = 0, batch, n, i;
+    uint32_t queue_full = 0;
+    static bool completed[NUM_THREAD_REQUESTS];
+    pthread_t thread;
+    int32_t ret;
+
+    srand(1);
+    spe_stop = false;
+    TEST_ASSERT_EQUAL(0, pthread_create(&thread, NULL, spe_thread, NULL));
+
+    while (reaped < NUM_THREAD_REQUESTS) {
+        batch = (rand() % MAILBOX_RING_SIZE) + 1;
+        for (n = 0; (n < batch) && (posted < NUM_THREAD_REQUESTS); n++) {
+            struct psa_client_params_t params = {0};
+
+            params.psa_call_params.handle = TEST_SERVICE_HANDLE +
+                                            (psa_handle_t)(posted & 0xFFFF);
+            ret = tfm_ns_mailbox_ring_post(MAILBOX_PSA_CALL, &params, -1,
+                                           posted);
+            if (ret == MAILBOX_QUEUE_FULL) {
+                queue_full++;
+                break;
+            }
+            TEST_ASSERT_EQUAL(MAILBOX_SUCCESS, ret);
+            posted++;
+        }
+        tfm_ns_mailbox_ring_submit();
+
+        n = tfm_ns_mailbox_ring_reap(cpl, MAILBOX_RING_SIZE);
+        if (n == 0) {
+            sched_yield();
+        }
+        for (i = 0; i < n; i++) {
+            TEST_ASSERT_LESS_THAN(posted, cpl[i].token);
+            TEST_ASSERT_FALSE(completed[cpl[i].token]);
+            TEST_ASSERT_EQUAL(cpl[i].token & 0xFFFF, cpl[i].return_val);
+            completed[cpl[i].token] = true;
+            reaped++;
+        }
+    }
+
+    spe_stop = true;
+    TEST_ASSERT_EQUAL(0, pthread_join(thread, NULL));
+
+    /* The full ring was reached, and the completions were batched */
+    TEST_ASSERT_GREATER_THAN(0, queue_full);
+    TEST_ASSERT_LESS_THAN(NUM_THREAD_REQUESTS, spe_notifications);
+}
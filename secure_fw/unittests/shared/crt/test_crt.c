@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "unity.h"
+
+/*
+ * memcpy(), memset() and memcmp() are the functions of the secure runtime.
+ * The references below are plain byte loops.
+ */
+
+#define BUF_SIZE            (16 * 1024 + 64)
+#define CHECK_MAX_SIZE      (300)
+#define BENCH_BYTES         (4 * 1024 * 1024)
+
+static uint8_t src_buf[BUF_SIZE] __attribute__((aligned(16)));
+static uint8_t dst_buf[BUF_SIZE] __attribute__((aligned(16)));
+static uint8_t ref_buf[BUF_SIZE] __attribute__((aligned(16)));
+
+static const size_t bench_sizes[] = {1, 4, 16, 64, 256, 1024, 4096, 16384};
+
+/* Offsets of the source and the destination from a word boundary */
+static const struct {
+    uint32_t src;
+    uint32_t dst;
+} bench_align[] = {
+    {0, 0}, {1, 1}, {0, 1}, {2, 0}, {3, 1},
+};
+
+static void ref_copy(uint8_t *dst, const uint8_t *src, size_t n)
+{
+    while (n--) {
+        *dst++ = *src++;
+    }
+}
+
+static void ref_set(uint8_t *dst, uint8_t c, size_t n)
+{
+    while (n--) {
+        *dst++ = c;
+    }
+}
+
+static int ref_cmp(const uint8_t *p1, const uint8_t *p2, size_t n)
+{
+    for (; n > 0; n--, p1++, p2++) {
+        if (*p1 != *p2) {
+            return (*p1 < *p2) ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+static int sign(int v)
+{
+    return (v > 0) - (v < 0);
+}
+
+static void fill_random(uint8_t *buf, size_t n, uint32_t seed)
+{
+    while (n--) {
+        seed = (seed * 1103515245u) + 12345u;
+        *buf++ = (uint8_t)(seed >> 16);
+    }
+}
+
+void setUp(void)
+{
+    fill_random(src_buf, sizeof(src_buf), 1);
+}
+
+/* The bytes around the destination must not be written */
+void test_crt_memcpy(void)
+{
+    size_t n;
+    uint32_t sa, da;
+
+    for (n = 0; n < CHECK_MAX_SIZE; n++) {
+        for (sa = 0; sa < 4; sa++) {
+            for (da = 0; da < 4; da++) {
+                ref_set(dst_buf, 0xEE, CHECK_MAX_SIZE + 8);
+                ref_set(ref_buf, 0xEE, CHECK_MAX_SIZE + 8);
+
+                TEST_ASSERT_EQUAL_PTR(dst_buf + da,
+                                      memcpy(dst_buf + da, src_buf + sa, n));
+                ref_copy(ref_buf + da, src_buf + sa, n);
+
+                TEST_ASSERT_EQUAL_MEMORY(ref_buf, dst_buf, CHECK_MAX_SIZE + 8);
+            }
+        }
+    }
+}
+
+void test_crt_memset(void)
+{
+    size_t n;
+    uint32_t da;
+
+    for (n = 0; n < CHECK_MAX_SIZE; n++) {
+        for (da = 0; da < 4; da++) {
+            ref_set(dst_buf, 0xEE, CHECK_MAX_SIZE + 8);
+            ref_set(ref_buf, 0xEE, CHECK_MAX_SIZE + 8);
+
+            /* Only the low byte of the value is used */
+            TEST_ASSERT_EQUAL_PTR(dst_buf + da, memset(dst_buf + da, 0x1A5, n));
+            ref_set(ref_buf + da, 0xA5, n);
+
+            TEST_ASSERT_EQUAL_MEMORY(ref_buf, dst_buf, CHECK_MAX_SIZE + 8);
+        }
+    }
+}
+
+void test_crt_memcmp(void)
+{
+    size_t n;
+    uint32_t sa, da;
+
+    for (n = 0; n < CHECK_MAX_SIZE; n++) {
+        for (sa = 0; sa < 4; sa++) {
+            for (da = 0; da < 4; da++) {
+                ref_copy(dst_buf + da, src_buf + sa, n);
+                TEST_ASSERT_EQUAL(0, memcmp(src_buf + sa, dst_buf + da, n));
+
+                if (n == 0) {
+                    continue;
+                }
+
+                /* A difference at the end, then one in the middle */
+                dst_buf[da + n - 1] ^= 0x80;
+                TEST_ASSERT_EQUAL(ref_cmp(src_buf + sa, dst_buf + da, n),
+                                  sign(memcmp(src_buf + sa, dst_buf + da, n)));
+                dst_buf[da + (n / 2)] ^= 0x01;
+                TEST_ASSERT_EQUAL(ref_cmp(src_buf + sa, dst_buf + da, n),
+                                  sign(memcmp(src_buf + sa, dst_buf + da, n)));
+                TEST_ASSERT_EQUAL(ref_cmp(dst_buf + da, src_buf + sa, n),
+                                  sign(memcmp(dst_buf + da, src_buf + sa, n)));
+            }
+        }
+    }
+}
+
+static uint64_t time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+/* Nanoseconds per MiB, to compare the sizes with each other */
+static uint32_t ns_per_mib(uint64_t elapsed)
+{
+    return (uint32_t)((elapsed * 1024U * 1024U) / BENCH_BYTES);
+}
+
+void test_crt_benchmark(void)
+{
+    uint64_t start, t_cpy, t_set, t_cmp, t_ref;
+    uint32_t i, a, iterations;
+    size_t n;
+    uint8_t *src, *dst;
+    volatile int res;
+
+    for (i = 0; i < sizeof(bench_sizes) / sizeof(bench_sizes[0]); i++) {
+        n = bench_sizes[i];
+        iterations = BENCH_BYTES / n;
+
+        for (a = 0; a < sizeof(bench_align) / sizeof(bench_align[0]); a++) {
+            src = src_buf + bench_align[a].src;
+            dst = dst_buf + bench_align[a].dst;
+            ref_copy(dst, src, n);
+
+            start = time_ns();
+            for (uint32_t k = 0; k < iterations; k++) {
+                (void)memcpy(dst, src, n);
+            }
+            t_cpy = time_ns() - start;
+
+            start = time_ns();
+            for (uint32_t k = 0; k < iterations; k++) {
+                (void)memset(dst, (int)k, n);
+            }
+            t_set = time_ns() - start;
+
+            ref_copy(dst, src, n);
+            start = time_ns();
+            for (uint32_t k = 0; k < iterations; k++) {
+                res = memcmp(dst, src, n);
+            }
+            t_cmp = time_ns() - start;
+            (void)res;
+
+            start = time_ns();
+            for (uint32_t k = 0; k < iterations; k++) {
+                ref_copy(dst, src, n);
+            }
+            t_ref = time_ns() - start;
+
+            TEST_PRINTF("%5u B src+%u dst+%u: memcpy %u, memset %u, "
+                        "memcmp %u, byte copy %u ns/MiB",
+                        (unsigned)n, (unsigned)bench_align[a].src,
+                        (unsigned)bench_align[a].dst,
+                        (unsigned)ns_per_mib(t_cpy),
+                        (unsigned)ns_per_mib(t_set),
+                        (unsigned)ns_per_mib(t_cmp),
+                        (unsigned)ns_per_mib(t_ref));
+        }
+    }
+}
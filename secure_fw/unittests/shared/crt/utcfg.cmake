@@ -0,0 +1,51 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2024, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+set(SECURE_FW_DIR ${TFM_ROOT_DIR}/secure_fw)
+
+#-------------------------------------------------------------------------------
+# Unit under test
+#-------------------------------------------------------------------------------
+set(UNIT_UNDER_TEST ${SECURE_FW_DIR}/shared/crt_memcpy.c)
+
+#-------------------------------------------------------------------------------
+# Test suite
+#-------------------------------------------------------------------------------
+set(UNIT_TEST_SUITE ${CMAKE_CURRENT_LIST_DIR}/test_crt.c)
+
+#-------------------------------------------------------------------------------
+# Dependencies
+#-------------------------------------------------------------------------------
+list(APPEND UNIT_TEST_DEPS ${SECURE_FW_DIR}/shared/crt_memset.c)
+list(APPEND UNIT_TEST_DEPS ${SECURE_FW_DIR}/partitions/lib/runtime/crt_memcmp.c)
+
+#-------------------------------------------------------------------------------
+# Include dirs
+#-------------------------------------------------------------------------------
+list(APPEND UNIT_TEST_INCLUDE_DIRS ${SECURE_FW_DIR}/include)
+
+#-------------------------------------------------------------------------------
+# Compiledefs for UUT
+#-------------------------------------------------------------------------------
+# The functions under test must not replace the ones of the host C library
+list(APPEND UNIT_TEST_COMPILE_DEFS memcpy=crt_memcpy)
+list(APPEND UNIT_TEST_COMPILE_DEFS memset=crt_memset)
+list(APPEND UNIT_TEST_COMPILE_DEFS memcmp=crt_memcmp)
+
+#-------------------------------------------------------------------------------
+# Link libs for UUT
+#-------------------------------------------------------------------------------
+
+#-------------------------------------------------------------------------------
+# Mocks for UUT
+#-------------------------------------------------------------------------------
+
+#-------------------------------------------------------------------------------
+# Labels for UT (Optional, tests can be grouped by labels)
+#-------------------------------------------------------------------------------
+list(APPEND UT_LABELS "CRT")
+list(APPEND UT_LABELS "BENCHMARK")
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __CONFIG_IMPL_H__
+#define __CONFIG_IMPL_H__
+
+#include "config_tfm.h"
+
+/*
+ * The configuration that the build generates for an SFN backend image. A test
+ * can select the IPC backend in its compile definitions.
+ */
+#ifndef CONFIG_TFM_SPM_BACKEND_IPC
+#define CONFIG_TFM_SPM_BACKEND_IPC                  0
+#endif
+#define CONFIG_TFM_SPM_BACKEND_SFN                  (!CONFIG_TFM_SPM_BACKEND_IPC)
+
+#define CONFIG_TFM_CONNECTION_BASED_SERVICE_API     0
+#define CONFIG_TFM_MMIO_REGION_ENABLE               0
+#define CONFIG_TFM_FLIH_API                         0
+#define CONFIG_TFM_SLIH_API                         0
+
+#endif /* __CONFIG_IMPL_H__ */
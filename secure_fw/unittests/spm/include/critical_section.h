@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_CRITICAL_SECTION_H__ /* TFM prefix to avoid clash */
+#define __TFM_CRITICAL_SECTION_H__
+
+#include <stdint.h>
+
+/* The host tests run single threaded, so there is nothing to mask */
+struct critical_section_t {
+    uint32_t   state;
+};
+
+#define CRITICAL_SECTION_STATIC_INIT   {.state = 0,}
+#define CRITICAL_SECTION_INIT(cs)      (cs).state = (0)
+#define CRITICAL_SECTION_ENTER(cs)     (cs).state = (0)
+#define CRITICAL_SECTION_LEAVE(cs)     (void)(cs).state
+
+#endif /* __TFM_CRITICAL_SECTION_H__ */
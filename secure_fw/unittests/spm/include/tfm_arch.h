@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_ARCH_H__
+#define __TFM_ARCH_H__
+
+/* The SPM code under test does not use the architecture operations, so the
+ * host build only needs the types the real header brings in.
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include "fih.h"
+
+/* Context control, embedded in the partition runtime data of the IPC model */
+struct context_ctrl_t {
+    uint32_t                sp;
+    uint32_t                exc_ret;
+    uint32_t                sp_limit;
+    uint32_t                sp_base;
+};
+
+#endif /* __TFM_ARCH_H__ */
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include "unity.h"
+
+#include "ffm/psa_api.h"
+#include "spm.h"
+#include "tfm_hal_isolation.h"
+#include "tfm_psa_call_pack.h"
+
+#define BENCH_ITERATIONS    (100000)
+
+struct partition_t *p_current_partition;
+
+static struct partition_t client;
+static struct connection_t connection;
+static uint8_t in_buf[2][16];
+static uint8_t out_buf[16];
+
+/* Number of isolation checks, and the base address to reject */
+static uint32_t memory_checks;
+static uintptr_t bad_base;
+
+FIH_RET_TYPE(enum tfm_hal_status_t) tfm_hal_memory_check(uintptr_t boundary,
+                                                         uintptr_t base,
+                                                         size_t size,
+                                                         uint32_t access_type)
+{
+    (void)boundary;
+    (void)size;
+    (void)access_type;
+
+    memory_checks++;
+
+    FIH_RET(fih_int_encode((base == bad_base) ? TFM_HAL_ERROR_MEM_FAULT :
+                                                TFM_HAL_SUCCESS));
+}
+
+bool tfm_spm_is_ns_caller(void)
+{
+    return false;
+}
+
+int32_t tfm_spm_get_client_id(bool ns_caller)
+{
+    (void)ns_caller;
+
+    return 1;
+}
+
+psa_status_t spm_get_idle_connection(struct connection_t **p_connection,
+                                     psa_handle_t handle,
+                                     int32_t client_id)
+{
+    (void)handle;
+    (void)client_id;
+
+    *p_connection = &connection;
+
+    return PSA_SUCCESS;
+}
+
+void spm_free_connection(struct connection_t *p_connection)
+{
+    (void)p_connection;
+}
+
+psa_status_t backend_messaging(struct connection_t *p_connection)
+{
+    (void)p_connection;
+
+    return PSA_SUCCESS;
+}
+
+void setUp(void)
+{
+    memset(&connection, 0, sizeof(connection));
+    p_current_partition = &client;
+    memory_checks = 0;
+    bad_base = 0;
+}
+
+void test_psa_call_api_no_iovec_clears_sizes(void)
+{
+    psa_invec in_vec[] = {{in_buf[0], sizeof(in_buf[0]), }};
+    psa_outvec out_vec[] = {{out_buf, sizeof(out_buf), }};
+    uint32_t i;
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      spm_associate_call_params(&connection,
+                                                PARAM_PACK(1, 1, 1),
+                                                in_vec, out_vec));
+    TEST_ASSERT_EQUAL(sizeof(in_buf[0]), connection.msg.in_size[0]);
+    TEST_ASSERT_EQUAL(sizeof(out_buf), connection.msg.out_size[0]);
+
+    /* A later call without vectors on the same connection exposes no sizes */
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      spm_associate_call_params(&connection,
+                                                PARAM_PACK(2, 0, 0),
+                                                NULL, NULL));
+    TEST_ASSERT_EQUAL(2, connection.msg.type);
+    for (i = 0; i < PSA_MAX_IOVEC; i++) {
+        TEST_ASSERT_EQUAL(0, connection.msg.in_size[i]);
+        TEST_ASSERT_EQUAL(0, connection.msg.out_size[i]);
+    }
+}
+
+void test_psa_call_api_sizes(void)
+{
+    psa_invec in_vec[] = {{in_buf[0], 3, }, {in_buf[1], 5, }};
+    psa_outvec out_vec[] = {{out_buf, 7, }};
+
+    memset(connection.msg.in_size, 0xFF, sizeof(connection.msg.in_size));
+    memset(connection.msg.out_size, 0xFF, sizeof(connection.msg.out_size));
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      spm_associate_call_params(&connection,
+                                                PARAM_PACK(0, 2, 1),
+                                                in_vec, out_vec));
+
+    TEST_ASSERT_EQUAL(3, connection.msg.in_size[0]);
+    TEST_ASSERT_EQUAL(5, connection.msg.in_size[1]);
+    TEST_ASSERT_EQUAL(0, connection.msg.in_size[2]);
+    TEST_ASSERT_EQUAL(0, connection.msg.in_size[3]);
+    TEST_ASSERT_EQUAL(7, connection.msg.out_size[0]);
+    TEST_ASSERT_EQUAL(0, connection.msg.out_size[1]);
+    TEST_ASSERT_EQUAL(0, connection.msg.out_size[2]);
+    TEST_ASSERT_EQUAL(0, connection.msg.out_size[3]);
+
+    TEST_ASSERT_EQUAL_PTR(in_buf[1], connection.invec_base[1]);
+    TEST_ASSERT_EQUAL_PTR(out_buf, connection.outvec_base[0]);
+    TEST_ASSERT_EQUAL_PTR(out_vec, connection.caller_outvec);
+}
+
+void test_psa_call_api_zero_length_vector_not_checked(void)
+{
+    psa_invec in_vec[] = {{in_buf[0], 4, }, {in_buf[1], 0, }};
+    psa_outvec out_vec[] = {{out_buf, 0, }};
+
+    /* The base of a zero-length vector is ignored */
+    bad_base = (uintptr_t)in_buf[1];
+
+    TEST_ASSERT_EQUAL(PSA_SUCCESS,
+                      spm_associate_call_params(&connection,
+                                                PARAM_PACK(0, 2, 1),
+                                                in_vec, out_vec));
+
+    /* The two vector arrays and the only non-empty vector */
+    TEST_ASSERT_EQUAL(3, memory_checks);
+    TEST_ASSERT_EQUAL(0, connection.msg.in_size[1]);
+    TEST_ASSERT_EQUAL(0, connection.msg.out_size[0]);
+}
+
+void test_psa_call_api_invalid_vectors(void)
+{
+    psa_invec in_vec[] = {{in_buf[0], 8, }, {&in_buf[0][4], 8, }};
+    psa_outvec out_vec[] = {{out_buf, 4, }};
+
+    /* Negative type */
+    TEST_ASSERT_EQUAL(PSA_ERROR_PROGRAMMER_ERROR,
+                      spm_associate_call_params(&connection,
+                                                PARAM_PACK(-1, 1, 0),
+                                                in_vec, out_vec));
+
+    /* Overlapping input vectors */
+    TEST_ASSERT_EQUAL(PSA_ERROR_PROGRAMMER_ERROR,
+                      spm_associate_call_params(&connection,
+                                                PARAM_PACK(0, 2, 0),
+                                                in_vec, out_vec));
+
+    /* More than PSA_MAX_IOVEC vectors */
+    TEST_ASSERT_EQUAL(PSA_ERROR_PROGRAMMER_ERROR,
+                      spm_associate_call_params(&connection,
+                                                PARAM_PACK(0, 4, 1),
+                                                in_vec, out_vec));
+
+    /* Output vector the caller cannot write */
+    bad_base = (uintptr_t)out_buf;
+    TEST_ASSERT_EQUAL(PSA_ERROR_PROGRAMMER_ERROR,
+                      spm_associate_call_params(&connection,
+                                                PARAM_PACK(0, 1, 1),
+                                                in_vec, out_vec));
+}
+
+static uint64_t time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+/* Associates the vectors of a typical call, with an empty output vector that
+ * is only used on errors.
+ */
+void test_psa_call_api_benchmark(void)
+{
+    psa_invec in_vec[] = {{in_buf[0], 8, }, {in_buf[1], 16, }};
+    psa_outvec out_vec[] = {{out_buf, 0, }};
+    uint64_t start, elapsed;
+    uint32_t i;
+
+    start = time_ns();
+    for (i = 0; i < BENCH_ITERATIONS; i++) {
+        (void)spm_associate_call_params(&connection, PARAM_PACK(0, 2, 1),
+                                        in_vec, out_vec);
+    }
+    elapsed = time_ns() - start;
+
+    TEST_PRINTF("spm_associate_call_params: %u isolation checks, %u ns per call",
+                (unsigned)(memory_checks / BENCH_ITERATIONS),
+                (unsigned)(elapsed / BENCH_ITERATIONS));
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <setjmp.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "log_deferred_defs.h"
+#include "spm.h"
+#include "spm_log_deferred.h"
+#include "tfm_hal_isolation.h"
+#include "tfm_spm_log.h"
+#include "load/partition_defs.h"
+
+#define TEST_SP_PID         (0x105)
+#define LOG_BUF_WORDS       (CONFIG_TFM_SPM_LOG_DEFERRED_BUF_SIZE / \
+                             sizeof(uint32_t))
+
+struct partition_t *p_current_partition;
+
+static struct partition_load_info_t sp_ldinf = {.pid = TEST_SP_PID};
+static struct partition_load_info_t idle_ldinf = {.pid = TFM_SP_IDLE};
+static struct partition_t sp = {.p_ldinf = &sp_ldinf};
+static struct partition_t idle = {.p_ldinf = &idle_ldinf};
+
+/* The words output by the log device */
+static uint32_t output[4 * LOG_BUF_WORDS];
+static uint32_t output_words;
+static uint32_t output_calls;
+
+static bool args_readable;
+static jmp_buf panic_jmp;
+
+int32_t tfm_hal_output_spm_log(const char *str, uint32_t len)
+{
+    TEST_ASSERT_EQUAL(0, len % sizeof(uint32_t));
+    TEST_ASSERT_LESS_OR_EQUAL(sizeof(output) - (output_words * 4), len);
+
+    memcpy(&output[output_words], str, len);
+    output_words += len / sizeof(uint32_t);
+    output_calls++;
+
+    return (int32_t)len;
+}
+
+FIH_RET_TYPE(enum tfm_hal_status_t) tfm_hal_memory_check(uintptr_t boundary,
+                                                         uintptr_t base,
+                                                         size_t size,
+                                                         uint32_t access_type)
+{
+    (void)boundary;
+    (void)base;
+    (void)size;
+    (void)access_type;
+
+    FIH_RET(fih_int_encode(args_readable ? TFM_HAL_SUCCESS :
+                                           TFM_HAL_ERROR_MEM_FAULT));
+}
+
+void tfm_core_panic(void)
+{
+    longjmp(panic_jmp, 1);
+}
+
+/*
+ * A record read back from the output. The test runs in the image which wrote
+ * the records, so the strings are read at the recorded addresses.
+ */
+struct record_t {
+    uint32_t source;
+    const char *fmt;
+    uint32_t nargs;
+    const uint32_t *args;
+};
+
+static uint32_t read_pos;
+
+static bool read_record(struct record_t *rec)
+{
+    uint32_t hdr;
+
+    if (read_pos + 2 > output_words) {
+        return false;
+    }
+
+    hdr = output[read_pos];
+    TEST_ASSERT_EQUAL_HEX32(LOG_DEFERRED_SYNC, hdr >> 24);
+
+    rec->source = hdr & 0xFFFF;
+    rec->nargs = (hdr >> 16) & 0xFF;
+    rec->fmt = (const char *)(uintptr_t)output[read_pos + 1];
+    rec->args = &output[read_pos + 2];
+
+    read_pos += 2 + rec->nargs;
+    TEST_ASSERT_LESS_OR_EQUAL(output_words, read_pos);
+
+    return true;
+}
+
+static void record_partition(const char *fmt, uint32_t *args, uint32_t nargs)
+{
+    uint32_t svc_args[3] = {(uint32_t)(uintptr_t)fmt,
+                            (uint32_t)(uintptr_t)args, nargs};
+
+    p_current_partition = &sp;
+    tfm_spm_log_deferred_record_handler(svc_args);
+    TEST_ASSERT_EQUAL(0, svc_args[0]);
+}
+
+void setUp(void)
+{
+    /* Empty the buffer left by the previous test */
+    spm_log_deferred_flush();
+
+    output_words = 0;
+    output_calls = 0;
+    read_pos = 0;
+    args_readable = true;
+}
+
+void test_spm_log_deferred_round_trip(void)
+{
+    static const char sp_fmt[] = "Value %d, ID %x\r\n";
+    static uint32_t sp_args[] = {(uint32_t)-5, 0xBEEF};
+    struct record_t rec;
+
+    SPMLOG_ERRMSG("SPM message\r\n");
+    SPMLOG_INFMSGVAL("SPM value: ", 0x1234);
+    record_partition(sp_fmt, sp_args, 2);
+
+    /* Nothing is output before the drain */
+    TEST_ASSERT_EQUAL(0, output_words);
+    spm_log_deferred_flush();
+
+    TEST_ASSERT_TRUE(read_record(&rec));
+    TEST_ASSERT_EQUAL(LOG_DEFERRED_SOURCE_SPM, rec.source);
+    TEST_ASSERT_EQUAL(0, rec.nargs);
+    TEST_ASSERT_EQUAL_STRING("SPM message\r\n", rec.fmt);
+
+    TEST_ASSERT_TRUE(read_record(&rec));
+    TEST_ASSERT_EQUAL(LOG_DEFERRED_SOURCE_SPM, rec.source);
+    TEST_ASSERT_EQUAL(1, rec.nargs);
+    TEST_ASSERT_EQUAL_STRING("SPM value: ", rec.fmt);
+    TEST_ASSERT_EQUAL_HEX32(0x1234, rec.args[0]);
+
+    /* The format of a partition is recorded by its address, not copied */
+    TEST_ASSERT_TRUE(read_record(&rec));
+    TEST_ASSERT_EQUAL(TEST_SP_PID, rec.source);
+    TEST_ASSERT_EQUAL(2, rec.nargs);
+    TEST_ASSERT_EQUAL_PTR(sp_fmt, rec.fmt);
+    TEST_ASSERT_EQUAL_HEX32((uint32_t)-5, rec.args[0]);
+    TEST_ASSERT_EQUAL_HEX32(0xBEEF, rec.args[1]);
+
+    TEST_ASSERT_FALSE(read_record(&rec));
+}
+
+void test_spm_log_deferred_dropped(void)
+{
+    struct record_t rec;
+    uint32_t i, stored = 0, dropped = 0;
+
+    /* More records than the buffer holds, of 3 words each */
+    for (i = 0; i < LOG_BUF_WORDS; i++) {
+        SPMLOG_INFMSGVAL("Record ", i);
+    }
+    spm_log_deferred_flush();
+
+    while (read_record(&rec)) {
+        if (rec.fmt == NULL) {
+            /* The count of the records lost, after the stored ones */
+            TEST_ASSERT_EQUAL(1, rec.nargs);
+            dropped += rec.args[0];
+            continue;
+        }
+
+        TEST_ASSERT_EQUAL(0, dropped);
+        TEST_ASSERT_EQUAL_STRING("Record ", rec.fmt);
+        TEST_ASSERT_EQUAL(stored, rec.args[0]);
+        stored++;
+    }
+
+    TEST_ASSERT_EQUAL(LOG_BUF_WORDS / 3, stored);
+    TEST_ASSERT_EQUAL(LOG_BUF_WORDS, stored + dropped);
+
+    /* Records are stored again once the buffer is drained */
+    output_words = 0;
+    read_pos = 0;
+    SPMLOG_INFMSG("After\r\n");
+    spm_log_deferred_flush();
+    TEST_ASSERT_TRUE(read_record(&rec));
+    TEST_ASSERT_EQUAL_STRING("After\r\n", rec.fmt);
+    TEST_ASSERT_FALSE(read_record(&rec));
+}
+
+void test_spm_log_deferred_drain_idle_only(void)
+{
+    uint32_t args[1];
+    uint32_t i;
+
+    for (i = 0; i < 4; i++) {
+        SPMLOG_INFMSGVAL("Drain ", i);
+    }
+
+    /* Other partitions do not output the log */
+    p_current_partition = &sp;
+    tfm_spm_log_deferred_drain_handler(args);
+    TEST_ASSERT_EQUAL(0, args[0]);
+    TEST_ASSERT_EQUAL(0, output_calls);
+
+    /* The idle partition outputs a bounded part at each call */
+    p_current_partition = &idle;
+    tfm_spm_log_deferred_drain_handler(args);
+    TEST_ASSERT_EQUAL(1, output_calls);
+    TEST_ASSERT_EQUAL((12 - output_words) * sizeof(uint32_t), args[0]);
+
+    while (args[0] != 0) {
+        tfm_spm_log_deferred_drain_handler(args);
+    }
+    TEST_ASSERT_EQUAL(12, output_words);
+}
+
+void test_spm_log_deferred_bad_args(void)
+{
+    static uint32_t sp_args[] = {1};
+
+    /* Arguments the partition cannot read are not recorded */
+    args_readable = false;
+    if (setjmp(panic_jmp) == 0) {
+        record_partition("%d", sp_args, 1);
+        TEST_FAIL_MESSAGE("No panic");
+    }
+
+    spm_log_deferred_flush();
+    TEST_ASSERT_EQUAL(0, output_words);
+}
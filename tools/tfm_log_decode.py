@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+#-------------------------------------------------------------------------------
+# Copyright (c) 2024, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+"""
+Decode the output of the deferred log (CONFIG_TFM_SPM_LOG_DEFERRED).
+
+The secure image outputs binary records holding the address of the format
+string and the raw arguments. The strings are read back from the ELF file of
+the same image. The record layout is described in
+secure_fw/spm/include/interface/log_deferred_defs.h.
+"""
+
+import argparse
+import struct
+import sys
+
+from elftools.elf.elffile import ELFFile
+
+LOG_DEFERRED_SYNC = 0xA5
+LOG_DEFERRED_MAX_ARGS = 8
+LOG_DEFERRED_SOURCE_SPM = 0
+
+class ImageStrings:
+    """The strings of the allocated sections of the image, by address"""
+
+    def __init__(self, elf_file):
+        self.sections = []
+        elf = ELFFile(elf_file)
+        for section in elf.iter_sections():
+            if (section['sh_flags'] & 0x2) and section['sh_type'] == 'SHT_PROGBITS':
+                self.sections.append((section['sh_addr'], section.data()))
+
+    def get(self, addr):
+        for base, data in self.sections:
+            if base <= addr < base + len(data):
+                end = data.find(b'\0', addr - base)
+                if end < 0:
+                    end = len(data)
+                return data[addr - base:end].decode('ascii', errors='replace')
+        return None
+
+def format_partition(fmt, args, strings):
+    """Format as the direct output of the partition log does"""
+    out = []
+    args = list(args)
+    i = 0
+
+    def next_arg():
+        return args.pop(0) if args else 0
+
+    while i < len(fmt):
+        c = fmt[i]
+        if c != '%':
+            out.append(c)
+            i += 1
+            continue
+
+        i += 1
+        if fmt[i:i + 3] in ('02x', '02X'):
+            val = next_arg()
+            digits = '{:02x}' if fmt[i + 2] == 'x' else '{:02X}'
+            out.append(digits.format(val & 0xFF))
+            i += 3
+            continue
+
+        tag = fmt[i:i + 1]
+        if tag in ('d', 'i'):
+            val = next_arg()
+            out.append(str(val - (1 << 32) if val & 0x80000000 else val))
+        elif tag == 'u':
+            out.append(str(next_arg()))
+        elif tag == 'x':
+            out.append('{:x}'.format(next_arg()))
+        elif tag == 'X':
+            out.append('{:X}'.format(next_arg()))
+        elif tag == 'p':
+            out.append('0x{:x}'.format(next_arg()))
+        elif tag == 's':
+            addr = next_arg()
+            s = strings.get(addr)
+            out.append(s if s is not None else '<string at 0x{:08x}>'.format(addr))
+        elif tag == 'c':
+            out.append(chr(next_arg() & 0xFF))
+        elif tag == '%':
+            out.append('%')
+        else:
+            # As the direct output, the tag itself is output afterwards
+            out.append('[Unsupported Tag]')
+            continue
+        i += 1
+
+    return ''.join(out)
+
+def decode_record(source, fmt_addr, args, strings, show_source):
+    if fmt_addr == 0:
+        return '[{} log records dropped]\n'.format(args[0] if args else 0)
+
+    fmt = strings.get(fmt_addr)
+    if fmt is None:
+        return '[Unknown format at 0x{:08x}, args {}]\n'.format(
+               fmt_addr, ' '.join('0x{:x}'.format(a) for a in args))
+
+    if source == LOG_DEFERRED_SOURCE_SPM:
+        text = fmt
+        if args:
+            text += '0x{:08X}\r\n'.format(args[0])
+        prefix = '[SPM] '
+    else:
+        text = format_partition(fmt, args, strings)
+        prefix = '[SP 0x{:x}] '.format(source)
+
+    return (prefix + text) if show_source else text
+
+def decode_stream(data, strings, show_source):
+    out = []
+    pos = 0
+
+    while pos + 8 <= len(data):
+        hdr, fmt_addr = struct.unpack_from('<II', data, pos)
+        nargs = (hdr >> 16) & 0xFF
+        if (hdr >> 24) != LOG_DEFERRED_SYNC or nargs > LOG_DEFERRED_MAX_ARGS:
+            # Not aligned on a record, the capture may start in the middle of one
+            pos += 1
+            continue
+
+        end = pos + 8 + 4 * nargs
+        if end > len(data):
+            break
+
+        args = struct.unpack_from('<{}I'.format(nargs), data, pos + 8)
+        out.append(decode_record(hdr & 0xFFFF, fmt_addr, args, strings,
+                                 show_source))
+        pos = end
+
+    return ''.join(out).replace('\r\n', '\n')
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                            formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--elf', required=True,
+                        help='ELF file of the secure image which output the log')
+    parser.add_argument('--show-source', action='store_true',
+                        help='Prefix each message with SPM or the partition ID')
+    parser.add_argument('input', nargs='?', default='-',
+                        help='Binary capture of the log output, stdin by default')
+    args = parser.parse_args()
+
+    with open(args.elf, 'rb') as elf_file:
+        strings = ImageStrings(elf_file)
+
+    if args.input == '-':
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.input, 'rb') as f:
+            data = f.read()
+
+    sys.stdout.write(decode_stream(data, strings, args.show_source))
+
+if __name__ == '__main__':
+    main()